@@ -29,6 +29,115 @@
 //#define DEBUG
 
 
+/*
+ * Outcome of a non-blocking attempt on a node
+ */
+enum {
+	DC_NODE_LOCKED = 0,
+	DC_NODE_BUSY = 1,
+	DC_NODE_END = -1
+};
+
+static void dc_circular_buffer_wake(CircularBuffer *circular_buf, Node *node, Waiter **waiters, volatile int *num_waiting)
+{
+	Waiter *w, *next, **prev;
+	/*nobody sleeping, no need to touch the mutex*/
+	if (!dc_atomic_get(num_waiting))
+		return;
+
+	gf_mx_p(circular_buf->mutex);
+	prev = waiters;
+	w = *waiters;
+	while (w) {
+		next = w->next;
+		if (w->node == node) {
+			*prev = next;
+			dc_atomic_dec(num_waiting);
+			gf_sema_notify(w->sema, 1);
+		} else {
+			prev = &w->next;
+		}
+		w = next;
+	}
+	gf_mx_v(circular_buf->mutex);
+}
+
+static int dc_node_consumer_try_lock(CircularBuffer *circular_buf, Node *node)
+{
+	int marked = dc_atomic_get(&node->marked);
+	if (marked == 2)
+		return DC_NODE_END;
+	if (!marked || dc_atomic_get(&node->num_producers))
+		return DC_NODE_BUSY;
+
+	/*claim the node, then check no producer grabbed it in the meantime*/
+	dc_atomic_inc(&node->num_consumers);
+	marked = dc_atomic_get(&node->marked);
+	if ((marked == 1) && !dc_atomic_get(&node->num_producers)) {
+		dc_atomic_inc(&node->num_consumers_accessed);
+		return DC_NODE_LOCKED;
+	}
+	dc_atomic_dec(&node->num_consumers);
+	dc_circular_buffer_wake(circular_buf, node, &circular_buf->producers_waiting, &circular_buf->num_producers_waiting);
+	return (marked == 2) ? DC_NODE_END : DC_NODE_BUSY;
+}
+
+static int dc_node_producer_try_lock(CircularBuffer *circular_buf, Node *node)
+{
+	if (dc_atomic_get(&node->num_consumers) || dc_atomic_get(&node->marked))
+		return DC_NODE_BUSY;
+
+	/*claim the node, then check no consumer grabbed it in the meantime*/
+	if (!dc_atomic_cas(&node->num_producers, 0, 1))
+		return DC_NODE_BUSY;
+	if (!dc_atomic_get(&node->num_consumers) && !dc_atomic_get(&node->marked))
+		return DC_NODE_LOCKED;
+
+	dc_atomic_set(&node->num_producers, 0);
+	dc_circular_buffer_wake(circular_buf, node, &circular_buf->consumers_waiting, &circular_buf->num_consumers_waiting);
+	return DC_NODE_BUSY;
+}
+
+/*
+ * Blocks until try_lock succeeds or reports the end of the buffer. The waiter is registered
+ * before the last attempt so that a concurrent wake-up cannot be missed.
+ */
+static int dc_circular_buffer_wait(CircularBuffer *circular_buf, Node *node, Waiter **waiters, volatile int *num_waiting,
+                                   int (*try_lock)(CircularBuffer *, Node *))
+{
+	int ret;
+	Waiter w;
+	w.node = node;
+	w.sema = gf_sema_new(1, 0);
+
+	while (1) {
+		gf_mx_p(circular_buf->mutex);
+		w.next = *waiters;
+		*waiters = &w;
+		dc_atomic_inc(num_waiting);
+
+		ret = try_lock(circular_buf, node);
+		if (ret != DC_NODE_BUSY) {
+			Waiter **prev = waiters;
+			/*still registered unless a wake-up raced with the attempt*/
+			while (*prev && (*prev != &w)) prev = &(*prev)->next;
+			if (*prev) {
+				*prev = w.next;
+				dc_atomic_dec(num_waiting);
+				gf_mx_v(circular_buf->mutex);
+			} else {
+				gf_mx_v(circular_buf->mutex);
+				gf_sema_wait(w.sema);
+			}
+			break;
+		}
+		gf_mx_v(circular_buf->mutex);
+		gf_sema_wait(w.sema);
+	}
+	gf_sema_del(w.sema);
+	return ret;
+}
+
 void dc_circular_buffer_create(CircularBuffer *circular_buf, u32 size, LockMode mode, int max_num_consumers)
 {
 	u32 i;
@@ -36,27 +145,24 @@ void dc_circular_buffer_create(CircularBuffer *circular_buf, u32 size, LockMode
 	circular_buf->list = (Node*)gf_malloc(size * sizeof(Node));
 	circular_buf->mode = mode;
 	circular_buf->max_num_consumers = max_num_consumers;
+	circular_buf->consumers_waiting = NULL;
+	circular_buf->producers_waiting = NULL;
+	circular_buf->num_consumers_waiting = 0;
+	circular_buf->num_producers_waiting = 0;
+	circular_buf->mutex = gf_mx_new("Circular Buffer Mutex");
 
 	for (i=0; i<size; i++) {
 		circular_buf->list[i].num_producers = 0;
 		circular_buf->list[i].num_consumers = 0;
 		circular_buf->list[i].num_consumers_accessed = 0;
 		circular_buf->list[i].marked = 0;
-		circular_buf->list[i].num_consumers_waiting = 0;
-		circular_buf->list[i].consumers_semaphore = gf_sema_new(1000, 0);
-		circular_buf->list[i].producers_semaphore = gf_sema_new(1000, 0);
-		circular_buf->list[i].mutex = gf_mx_new("Circular Buffer Mutex");
 	}
 }
 
 void dc_circular_buffer_destroy(CircularBuffer *circular_buf)
 {
-	u32 i;
-	for (i = 0; i < circular_buf->size; i++) {
-		gf_sema_del(circular_buf->list[i].consumers_semaphore);
-		gf_sema_del(circular_buf->list[i].producers_semaphore);
-		gf_mx_del(circular_buf->list[i].mutex);
-	}
+	if (circular_buf->mutex)
+		gf_mx_del(circular_buf->mutex);
 
 	gf_free(circular_buf->list);
 }
@@ -76,82 +182,48 @@ void * dc_consumer_consume(Consumer *consumer, CircularBuffer *circular_buf)
 int dc_consumer_lock(Consumer *consumer, CircularBuffer *circular_buf)
 {
 	Node *node = &circular_buf->list[consumer->idx];
+	int ret = dc_node_consumer_try_lock(circular_buf, node);
 
-	gf_mx_p(node->mutex);
-	if (node->marked == 2) {
-		gf_mx_v(node->mutex);
-		return -1;
-	}
-
-	node->num_consumers_waiting++;
-	while (node->num_producers || !node->marked) {
-		gf_mx_v(node->mutex);
-		gf_sema_wait(node->consumers_semaphore);
-		gf_mx_p(node->mutex);
-
-		if (node->marked == 2) {
-			gf_mx_v(node->mutex);
-			return -1;
-		}
-	}
-	node->num_consumers_waiting--;
+	if (ret == DC_NODE_BUSY)
+		ret = dc_circular_buffer_wait(circular_buf, node, &circular_buf->consumers_waiting, &circular_buf->num_consumers_waiting, dc_node_consumer_try_lock);
 
-	if (node->marked == 2) {
-		gf_mx_v(node->mutex);
-		return -1;
-	}
-	node->num_consumers++;
-	node->num_consumers_accessed++;
-	gf_mx_v(node->mutex);
-
-	return 0;
+	return (ret == DC_NODE_END) ? -1 : 0;
 }
 
-int dc_consumer_unlock(Consumer *consumer, CircularBuffer *circular_buf)
+static int dc_node_consumer_unlock(CircularBuffer *circular_buf, Node *node, Bool keep_end)
 {
 	int last_consumer = 0;
-	Node *node = &circular_buf->list[consumer->idx];
-
-	gf_mx_p(node->mutex);
-	node->num_consumers--;
-
-	if (node->num_consumers_accessed == circular_buf->max_num_consumers) {
-		node->marked = 0;
-		node->num_consumers_accessed = 0;
+	int nb;
+
+	/*never go below 0, the previous node may not have been locked by this consumer yet*/
+	do {
+		nb = dc_atomic_get(&node->num_consumers);
+		if (nb <= 0) break;
+	} while (!dc_atomic_cas(&node->num_consumers, nb, nb-1));
+
+	if (dc_atomic_cas(&node->num_consumers_accessed, (int) circular_buf->max_num_consumers, 0)) {
+		if (keep_end) {
+			dc_atomic_cas(&node->marked, 1, 0);
+		} else {
+			dc_atomic_set(&node->marked, 0);
+		}
 		last_consumer = 1;
 	}
 
-	gf_sema_notify(node->producers_semaphore, 1);
-
-	gf_mx_v(node->mutex);
+	dc_circular_buffer_wake(circular_buf, node, &circular_buf->producers_waiting, &circular_buf->num_producers_waiting);
 
 	return last_consumer;
 }
 
+int dc_consumer_unlock(Consumer *consumer, CircularBuffer *circular_buf)
+{
+	return dc_node_consumer_unlock(circular_buf, &circular_buf->list[consumer->idx], GF_FALSE);
+}
+
 int dc_consumer_unlock_previous(Consumer *consumer, CircularBuffer *circular_buf)
 {
 	int node_idx = (consumer->idx - 1 + consumer->max_idx) % consumer->max_idx;
-	int last_consumer = 0;
-	Node *node = &circular_buf->list[node_idx];
-
-	gf_mx_p(node->mutex);
-
-	node->num_consumers--;
-	if (node->num_consumers < 0)
-		node->num_consumers = 0;
-
-	if (node->num_consumers_accessed == circular_buf->max_num_consumers) {
-		if (node->marked != 2)
-			node->marked = 0;
-		node->num_consumers_accessed = 0;
-		last_consumer = 1;
-	}
-
-	gf_sema_notify(node->producers_semaphore, 1);
-
-	gf_mx_v(node->mutex);
-
-	return last_consumer;
+	return dc_node_consumer_unlock(circular_buf, &circular_buf->list[node_idx], GF_TRUE);
 }
 
 void dc_consumer_advance(Consumer *consumer)
@@ -174,27 +246,19 @@ void * dc_producer_produce(Producer *producer, CircularBuffer *circular_buf)
 int dc_producer_lock(Producer *producer, CircularBuffer *circular_buf)
 {
 	Node *node = &circular_buf->list[producer->idx];
+	int ret = dc_node_producer_try_lock(circular_buf, node);
 
-	gf_mx_p(node->mutex);
-
-	if ( (circular_buf->mode == LIVE_CAMERA || circular_buf->mode == LIVE_MEDIA) && (node->num_consumers || node->marked)) {
-		gf_mx_v(node->mutex);
-		return -1;
-	}
-
-	while (node->num_consumers || node->marked) {
-		gf_mx_v(node->mutex);
-		gf_sema_wait(node->producers_semaphore);
-		gf_mx_p(node->mutex);
+	if (ret == DC_NODE_BUSY) {
+		/*live sources never wait for the consumers*/
+		if (circular_buf->mode == LIVE_CAMERA || circular_buf->mode == LIVE_MEDIA)
+			return -1;
+		dc_circular_buffer_wait(circular_buf, node, &circular_buf->producers_waiting, &circular_buf->num_producers_waiting, dc_node_producer_try_lock);
 	}
 
-	node->num_producers++;
 	if (circular_buf->size>1) {
-		node->marked = 1;
+		dc_atomic_set(&node->marked, 1);
 	}
 
-	gf_mx_v(node->mutex);
-
 	return 0;
 }
 
@@ -202,10 +266,8 @@ void dc_producer_unlock(Producer *producer, CircularBuffer *circular_buf)
 {
 	Node *node = &circular_buf->list[producer->idx];
 
-	gf_mx_p(node->mutex);
-	node->num_producers--;
-	gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
-	gf_mx_v(node->mutex);
+	dc_atomic_dec(&node->num_producers);
+	dc_circular_buffer_wake(circular_buf, node, &circular_buf->consumers_waiting, &circular_buf->num_consumers_waiting);
 }
 
 void dc_producer_unlock_previous(Producer *producer, CircularBuffer *circular_buf)
@@ -213,20 +275,16 @@ void dc_producer_unlock_previous(Producer *producer, CircularBuffer *circular_bu
 	int node_idx = (producer->idx - 1 + producer->max_idx) % producer->max_idx;
 	Node *node = &circular_buf->list[node_idx];
 
-	gf_mx_p(node->mutex);
-	node->num_producers = 0;
-	gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
-	gf_mx_v(node->mutex);
+	dc_atomic_set(&node->num_producers, 0);
+	dc_circular_buffer_wake(circular_buf, node, &circular_buf->consumers_waiting, &circular_buf->num_consumers_waiting);
 }
 
 void dc_producer_advance(Producer *producer, CircularBuffer *circular_buf)
 {
 	if (circular_buf->size == 1) {
 		Node *node = &circular_buf->list[producer->idx];
-		gf_mx_p(node->mutex);
-		node->marked = 1;
-		gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
-		gf_mx_v(node->mutex);
+		dc_atomic_set(&node->marked, 1);
+		dc_circular_buffer_wake(circular_buf, node, &circular_buf->consumers_waiting, &circular_buf->num_consumers_waiting);
 	}
 	producer->idx = (producer->idx + 1) % producer->max_idx;
 }
@@ -235,11 +293,9 @@ void dc_producer_end_signal(Producer *producer, CircularBuffer *circular_buf)
 {
 	Node *node = &circular_buf->list[producer->idx];
 
-	gf_mx_p(node->mutex);
-	node->marked = 2;
-	gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
+	dc_atomic_set(&node->marked, 2);
+	dc_circular_buffer_wake(circular_buf, node, &circular_buf->consumers_waiting, &circular_buf->num_consumers_waiting);
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("producer %s sends end signal %d \n", producer->name, producer->idx));
-	gf_mx_v(node->mutex);
 }
 
 void dc_producer_end_signal_previous(Producer *producer, CircularBuffer *circular_buf)
@@ -247,9 +303,7 @@ void dc_producer_end_signal_previous(Producer *producer, CircularBuffer *circula
 	int i_node = (producer->max_idx + producer->idx - 1) % producer->max_idx;
 	Node *node = &circular_buf->list[i_node];
 
-	gf_mx_p(node->mutex);
-	node->marked = 2;
-	gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
-	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("producer %s sends end signal %d \n", producer->name, node));
-	gf_mx_v(node->mutex);
+	dc_atomic_set(&node->marked, 2);
+	dc_circular_buffer_wake(circular_buf, node, &circular_buf->consumers_waiting, &circular_buf->num_consumers_waiting);
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("producer %s sends end signal %d \n", producer->name, i_node));
 }
@@ -46,33 +46,57 @@ typedef enum {
 } LockMode;
 
 /*
- * Every node of the circular buffer has a data, plus
- * all the variables needed for multithread management.
+ * Atomic helpers used on the node counters. Consumers and producers only take
+ * the buffer mutex when they actually have to sleep, the common case where a
+ * node is ready is handled with these operations alone.
+ */
+#if defined(WIN32) && !defined(__GNUC__)
+#include <windows.h>
+#define dc_atomic_inc(_v)	InterlockedIncrement((volatile LONG *) (_v))
+#define dc_atomic_dec(_v)	InterlockedDecrement((volatile LONG *) (_v))
+#define dc_atomic_get(_v)	InterlockedCompareExchange((volatile LONG *) (_v), 0, 0)
+#define dc_atomic_set(_v, _val)	InterlockedExchange((volatile LONG *) (_v), (_val))
+#define dc_atomic_cas(_v, _old, _new)	(InterlockedCompareExchange((volatile LONG *) (_v), (_new), (_old)) == (_old))
+#else
+#define dc_atomic_inc(_v)	__sync_add_and_fetch((_v), 1)
+#define dc_atomic_dec(_v)	__sync_sub_and_fetch((_v), 1)
+#define dc_atomic_get(_v)	__sync_add_and_fetch((_v), 0)
+#define dc_atomic_set(_v, _val)	{ __sync_synchronize(); *(_v) = (_val); __sync_synchronize(); }
+#define dc_atomic_cas(_v, _old, _new)	__sync_bool_compare_and_swap((_v), (_old), (_new))
+#endif
+
+/*
+ * Every node of the circular buffer has a data, plus the counters
+ * needed for multithread management. All counters are accessed atomically.
  */
 typedef struct {
 	/* Pointer to the data on the node */
 	void *data;
 	/* The number of the producer currently using this node */
-	int num_producers;
+	volatile int num_producers;
 	/* The number of consumer currently using this node */
-	int num_consumers;
-	/* The number of consumer currently waiting for this node */
-	int num_consumers_waiting;
-	/* Mutex used for synchronizing the users of this node. */
-	GF_Mutex *mutex;
-	/* Semaphore for producer */
-	GF_Semaphore *producers_semaphore;
-	/* Semaphore for consumers */
-	GF_Semaphore *consumers_semaphore;
+	volatile int num_consumers;
 	/* If marked is 0 it means the data on this node is not valid.
 	 * If marked is 1 it means that the data on this node is valid.
 	 * If marked is 2 it means this node is the last node. */
-	int marked;
+	volatile int marked;
 	/* Indicates the number of consumers which already accessed this node.
 	 * It is used for the case where the last consumer has to do something. */
-	int num_consumers_accessed;
+	volatile int num_consumers_accessed;
 } Node;
 
+/*
+ * A thread sleeping on a node of the circular buffer. Waiters are only
+ * allocated on the stack of the blocked thread, and each has its own
+ * semaphore so that a wake-up cannot be stolen by a thread waiting for
+ * another node.
+ */
+typedef struct __dc_waiter {
+	Node *node;
+	GF_Semaphore *sema;
+	struct __dc_waiter *next;
+} Waiter;
+
 /*
  * The circular buffer has a size, a list of nodes and it
  * has the number of consumers using it. Also it needs to know which
@@ -87,8 +111,29 @@ typedef struct {
 	LockMode mode;
 	/* The maximum number of the consumers using the circular buffer */
 	u32 max_num_consumers;
+	/* Mutex protecting the waiter lists, only taken by threads about to sleep
+	 * and by threads waking them up */
+	GF_Mutex *mutex;
+	/* Consumers (resp. producers) currently sleeping */
+	Waiter *consumers_waiting;
+	Waiter *producers_waiting;
+	/* The number of consumers (resp. producers) currently sleeping, read without the mutex */
+	volatile int num_consumers_waiting;
+	volatile int num_producers_waiting;
 } CircularBuffer;
 
+/*
+ * Processing time of one stage of the pipeline (decoder, scaler, encoder).
+ * Each structure is only written by the thread running the stage and is
+ * read by the MPD thread when reporting.
+ */
+typedef struct {
+	char name[GF_MAX_PATH];
+	/* number of frames processed and cumulated processing time in microseconds */
+	u32 nb_frames;
+	u64 time_spent;
+} StageStats;
+
 /*
  * Producer has an index to the circular buffer.
  */
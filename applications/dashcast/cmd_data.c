@@ -366,6 +366,7 @@ void dc_cmd_data_init(CmdData *cmd_data)
 	cmd_data->video_lst = gf_list_new();
 	cmd_data->asrc = gf_list_new();
 	cmd_data->vsrc = gf_list_new();
+	cmd_data->stage_stats = gf_list_new();
 }
 
 void dc_cmd_data_destroy(CmdData *cmd_data)
@@ -386,6 +387,13 @@ void dc_cmd_data_destroy(CmdData *cmd_data)
 
 	gf_list_del(cmd_data->asrc);
 	gf_list_del(cmd_data->vsrc);
+
+	while (gf_list_count(cmd_data->stage_stats)) {
+		StageStats *stats = (StageStats*)gf_list_last(cmd_data->stage_stats);
+		gf_list_rem_last(cmd_data->stage_stats);
+		gf_free(stats);
+	}
+	gf_list_del(cmd_data->stage_stats);
 	gf_cfg_del(cmd_data->conf);
 	gf_cfg_del(cmd_data->switch_conf);
 	if (cmd_data->logfile)
@@ -396,6 +404,30 @@ void dc_cmd_data_destroy(CmdData *cmd_data)
 	gf_sys_close();
 }
 
+StageStats *dc_cmd_data_new_stage_stats(CmdData *cmd_data, const char *name)
+{
+	StageStats *stats;
+	GF_SAFEALLOC(stats, StageStats);
+	if (!stats) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Cannot allocate stage statistics\n"));
+		return NULL;
+	}
+	strncpy(stats->name, name, GF_MAX_PATH-1);
+	gf_list_add(cmd_data->stage_stats, stats);
+	return stats;
+}
+
+void dc_cmd_data_log_stage_stats(CmdData *cmd_data)
+{
+	u32 i;
+	for (i=0; i<gf_list_count(cmd_data->stage_stats); i++) {
+		StageStats *stats = (StageStats*)gf_list_get(cmd_data->stage_stats, i);
+		u32 nb_frames = stats->nb_frames;
+		u64 time_spent = stats->time_spent;
+		GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DashCast] %s: %d frames in "LLU" ms (%d us per frame)\n", stats->name, nb_frames, time_spent/1000, nb_frames ? (u32) (time_spent/nb_frames) : 0));
+	}
+}
+
 static void on_dc_log(void *cbk, GF_LOG_Level ll, GF_LOG_Tool lm, const char *av_fmt_ctx, va_list list)
 {
 	FILE *logs = (FILE*)cbk;
@@ -455,6 +487,7 @@ int dc_parse_command(int argc, char **argv, CmdData *cmd_data)
 	    "    -vres WxH                force the video resolution (e.g. 640x480)\n"
 	    "    -vcrop XxY               crop the source video from X pixels left and Y pixels top. Must be used with -vres.\n"
 	    "    -demux-buffer SIZE       sets demux buffer size to SIZE.\n"
+	    "    -scale-cascade           scale each video resolution from the next larger one instead of the source\n"
 	    "* Audio options:\n"
 	    "    -a string                set the source name for an audio input\n"
 	    "                                - if input is from microphone, use \"plughw:[x],[y]\"\n"
@@ -775,6 +808,9 @@ int dc_parse_command(int argc, char **argv, CmdData *cmd_data)
 			}
 			strncpy(cmd_data->base_url, argv[i], GF_MAX_PATH-1);
 			i++;
+		} else if (strcmp(argv[i], "-scale-cascade") == 0) {
+			cmd_data->cascade_scaling = 1;
+			i++;
 		} else if (strcmp(argv[i], "-low-delay") == 0) {
 			cmd_data->video_data_conf.low_delay = 1;
 			i++;
@@ -110,6 +110,10 @@ typedef struct {
 	Bool use_source_timing;
     GF_MemTrackerType mem_track;
 	Bool no_mpd_rewrite;
+	/* scale each video resolution from the next larger one instead of the source */
+	int cascade_scaling;
+	/* StageStats of the running pipeline, reported by the MPD thread */
+	GF_List *stage_stats;
 } CmdData;
 
 /*
@@ -135,4 +139,21 @@ void dc_cmd_data_destroy(CmdData *cmd_data);
  */
 int dc_parse_command(int argc, char **argv, CmdData *cmd_data);
 
+/*
+ * Create a StageStats for a pipeline stage. The structure is owned by the command data.
+ *
+ * @param cmd_data [in] command data
+ * @param name [in] name of the stage used when reporting
+ *
+ * @return the new stage statistics, NULL on failure
+ */
+StageStats *dc_cmd_data_new_stage_stats(CmdData *cmd_data, const char *name);
+
+/*
+ * Log the processing time of all the pipeline stages
+ *
+ * @param cmd_data [in] command data
+ */
+void dc_cmd_data_log_stage_stats(CmdData *cmd_data);
+
 #endif /* CMD_DATA_H_ */
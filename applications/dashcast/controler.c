@@ -356,6 +356,7 @@ static u32 mpd_thread(void *params)
 			}
 
 			dc_write_mpd(cmddata, audio_data_conf, video_data_conf, presentation_duration, availability_start_time, time_shift, main_seg_time.segnum+1, cmddata->ast_offset);
+			dc_cmd_data_log_stage_stats(cmddata);
 		}
 		
 		if (cmddata->no_mpd_rewrite) return 0;
@@ -399,6 +400,7 @@ static u32 mpd_thread(void *params)
 		
 
 	dc_write_mpd(cmddata, audio_data_conf, video_data_conf, presentation_duration, availability_start_time, 0, main_seg_time.segnum+1, 0);
+	dc_cmd_data_log_stage_stats(cmddata);
 
 	return 0;
 }
@@ -686,6 +688,7 @@ u32 video_encoder_thread(void *params)
 		in_data->exit_signal = 1;
 		return -1;
 	}
+	out_file.stats = thread_params->stats;
 
 	if (in_data->mode == LIVE_MEDIA || in_data->mode == LIVE_CAMERA) {
 		init_mpd = GF_TRUE;
@@ -1087,6 +1090,8 @@ int dc_run_controler(CmdData *in_data)
 	int ret = 0;
 	u32 video_cb_size = VIDEO_CB_DEFAULT_SIZE;
 	u32 i, j;
+	int nb_video_consumers = 0;
+	char stats_name[GF_MAX_PATH];
 
 	ThreadParam keyboard_th_params;
 	ThreadParam mpd_th_params;
@@ -1133,15 +1138,20 @@ int dc_run_controler(CmdData *in_data)
 		dc_video_scaler_list_init(&video_scaled_data_list, in_data->video_lst);
 		vscaler_th_params = (VideoThreadParam*)gf_malloc(video_scaled_data_list.size * sizeof(VideoThreadParam));
 
+		/* In cascaded mode only the largest resolutions read the decoded frames */
+		nb_video_consumers = video_scaled_data_list.size;
+		if (in_data->cascade_scaling)
+			nb_video_consumers = dc_video_scaler_list_cascade(&video_scaled_data_list);
+
 		/* Open input video */
-		if (dc_video_decoder_open(video_input_file[0], &in_data->video_data_conf, in_data->mode, in_data->no_loop, video_scaled_data_list.size) < 0) {
+		if (dc_video_decoder_open(video_input_file[0], &in_data->video_data_conf, in_data->mode, in_data->no_loop, nb_video_consumers) < 0) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Cannot open input video.\n"));
 			ret = -1;
 			goto exit;
 		}
 
 		if (dc_video_input_data_init(&video_input_data, /*video_input_file[0]->width, video_input_file[0]->height,
-		  video_input_file[0]->pix_fmt,*/video_scaled_data_list.size, in_data->mode, MAX_SOURCE_NUMBER, video_cb_size) < 0) {
+		  video_input_file[0]->pix_fmt,*/nb_video_consumers, in_data->mode, MAX_SOURCE_NUMBER, video_cb_size) < 0) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Cannot initialize audio data.\n"));
 			ret = -1;
 			goto exit;
@@ -1150,7 +1160,7 @@ int dc_run_controler(CmdData *in_data)
 		/* open other input videos for source switching */
 		for (i = 0; i < gf_list_count(in_data->vsrc); i++) {
 			VideoDataConf *video_data_conf = (VideoDataConf*)gf_list_get(in_data->vsrc, i);
-			if (dc_video_decoder_open(video_input_file[i + 1], video_data_conf, LIVE_MEDIA, 1, video_scaled_data_list.size) < 0) {
+			if (dc_video_decoder_open(video_input_file[i + 1], video_data_conf, LIVE_MEDIA, 1, nb_video_consumers) < 0) {
 				GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Cannot open input video.\n"));
 				ret = -1;
 				goto exit;
@@ -1161,8 +1171,17 @@ int dc_run_controler(CmdData *in_data)
 			dc_video_input_data_set_prop(&video_input_data, i, video_input_file[i]->width, video_input_file[i]->height, in_data->video_data_conf.crop_x, in_data->video_data_conf.crop_y, video_input_file[i]->pix_fmt, video_input_file[i]->sar);
 		}
 
+		video_input_data.stats = dc_cmd_data_new_stage_stats(in_data, "video decoder");
+
 		for (i=0; i<video_scaled_data_list.size; i++) {
-			dc_video_scaler_data_init(&video_input_data, video_scaled_data_list.video_scaled_data[i], MAX_SOURCE_NUMBER, video_cb_size);
+			VideoScaledData *video_scaled_data = video_scaled_data_list.video_scaled_data[i];
+			if (dc_video_scaler_data_init(&video_input_data, video_scaled_data, MAX_SOURCE_NUMBER, video_cb_size) < 0) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Cannot initialize video scaler.\n"));
+				ret = -1;
+				goto exit;
+			}
+			snprintf(stats_name, sizeof(stats_name), "video scaler %dx%d", video_scaled_data->out_width, video_scaled_data->out_height);
+			video_scaled_data->stats = dc_cmd_data_new_stage_stats(in_data, stats_name);
 
 			for (j=0; j<gf_list_count(in_data->vsrc) + 1; j++) {
 				dc_video_scaler_data_set_prop(&video_input_data, video_scaled_data_list.video_scaled_data[i], j);
@@ -1177,8 +1196,12 @@ int dc_run_controler(CmdData *in_data)
 		}
 
 		/* Initialize video encoder threads */
-		for (i=0; i<gf_list_count(in_data->video_lst); i++)
+		for (i=0; i<gf_list_count(in_data->video_lst); i++) {
+			VideoDataConf *video_data_conf = (VideoDataConf*)gf_list_get(in_data->video_lst, i);
 			vencoder_th_params[i].thread = gf_th_new("video_encoder_thread");
+			snprintf(stats_name, sizeof(stats_name), "video encoder %dx%d@%d", video_data_conf->width, video_data_conf->height, video_data_conf->bitrate);
+			vencoder_th_params[i].stats = dc_cmd_data_new_stage_stats(in_data, stats_name);
+		}
 	}
 
 	/* When video and audio share the same source, open it once. This allow to read from unicast streams */
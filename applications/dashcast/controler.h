@@ -67,6 +67,9 @@ typedef struct {
 	MessageQueue *mq;
 	MessageQueue *delete_seg_mq;
 	MessageQueue *send_seg_mq;
+
+	/* Processing time of the thread, may be NULL */
+	StageStats *stats;
 } VideoThreadParam;
 
 /* Audio thread parameters */
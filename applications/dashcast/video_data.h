@@ -113,6 +113,9 @@ typedef struct {
 	//int height;
 	//int pix_fmt;
 	u64 frame_duration;
+
+	/* decoding time, may be NULL */
+	StageStats *stats;
 } VideoInputData;
 
 
@@ -213,6 +213,7 @@ int dc_video_decoder_read(VideoInputFile *video_input_file, VideoInputData *vide
 #endif
 	AVPacket packet;
 	int ret, got_frame, already_locked = 0;
+	u64 time_spent;
 	AVCodecContext *codec_ctx;
 	VideoDataNode *video_data_node;
 
@@ -318,6 +319,7 @@ int dc_video_decoder_read(VideoInputFile *video_input_file, VideoInputData *vide
 			video_data_node->frame_utc = gf_net_get_utc();
 
 			/* Decode video frame */
+			time_spent = gf_sys_clock_high_res();
 			if (avcodec_decode_video2(codec_ctx, video_data_node->vframe, &got_frame, &packet) < 0) {
 				av_free_packet(&packet);
 				GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Error while decoding video.\n"));
@@ -325,6 +327,10 @@ int dc_video_decoder_read(VideoInputFile *video_input_file, VideoInputData *vide
 				dc_producer_unlock(&video_input_data->producer, &video_input_data->circular_buf);
 				return -1;
 			}
+			if (got_frame && video_input_data->stats) {
+				video_input_data->stats->time_spent += gf_sys_clock_high_res() - time_spent;
+				video_input_data->stats->nb_frames++;
+			}
 
 			/* Did we get a video frame? */
 			if (got_frame) {
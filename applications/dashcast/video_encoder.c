@@ -216,6 +216,10 @@ int dc_video_encoder_encode(VideoOutputFile *video_output_file, VideoScaledData
 #endif
 
 	time_spent = gf_sys_clock_high_res() - time_spent;
+	if (video_output_file->stats) {
+		video_output_file->stats->time_spent += time_spent;
+		video_output_file->stats->nb_frames++;
+	}
 	//this is not true with libav !
 #ifndef GPAC_USE_LIBAV
 	if (video_output_file->encoded_frame_size >= 0)
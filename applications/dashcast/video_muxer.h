@@ -101,6 +101,9 @@ typedef struct {
 	const char *rep_id;
 
 	u64 frame_ntp, frame_utc;
+
+	/* encoding time, may be NULL */
+	StageStats *stats;
 } VideoOutputFile;
 
 int dc_video_muxer_init(VideoOutputFile *video_output_file, VideoDataConf *video_data_conf, VideoMuxerType muxer_type, int frame_per_segment, int frame_per_fragment, u32 seg_marker, int gdr, int seg_dur, int frag_dur, int frame_dur, int gop_size, int video_cb_size);
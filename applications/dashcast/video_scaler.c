@@ -30,38 +30,39 @@
 #define av_frame_free	av_free
 #endif
 
-VideoScaledDataNode * dc_video_scaler_node_create(int width, int height, int crop_x, int crop_y, int pix_fmt)
+VideoScaledDataNode * dc_video_scaler_node_create(uint8_t *picture, int width, int height, int crop_x, int crop_y, int pix_fmt)
 {
-	VideoScaledDataNode *video_scaled_data_node = (VideoScaledDataNode*)gf_malloc(sizeof(VideoDataNode));
+	VideoScaledDataNode *video_scaled_data_node;
+	GF_SAFEALLOC(video_scaled_data_node, VideoScaledDataNode);
 	if (video_scaled_data_node) {
 		video_scaled_data_node->vframe = FF_ALLOC_FRAME();
+		/*the cropped frame only points into the source frame, see av_picture_crop*/
 		if (crop_x || crop_y) {
 			video_scaled_data_node->cropped_frame = FF_ALLOC_FRAME();
-		} else {
-			video_scaled_data_node->cropped_frame = NULL;
 		}
 	}
 	if (!video_scaled_data_node || !video_scaled_data_node->vframe || ((crop_x || crop_y) && !video_scaled_data_node->cropped_frame)) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Cannot allocate VideoNode!\n"));
-		av_frame_free(&video_scaled_data_node->vframe);
-		av_frame_free(&video_scaled_data_node->cropped_frame);
-		gf_free(video_scaled_data_node);
+		if (video_scaled_data_node) {
+			av_frame_free(&video_scaled_data_node->vframe);
+			av_frame_free(&video_scaled_data_node->cropped_frame);
+			gf_free(video_scaled_data_node);
+		}
 		return NULL;
 	}
 
-	/* Determine required buffer size and allocate buffer */
-	avpicture_alloc((AVPicture*)video_scaled_data_node->vframe, pix_fmt, width, height);
-	if (video_scaled_data_node->cropped_frame) {
-		avpicture_alloc((AVPicture*)video_scaled_data_node->cropped_frame, pix_fmt, width-crop_x, height-crop_y);
-	}
+	/* The picture buffer is a slice of the frame pool of the scaled data */
+	avpicture_fill((AVPicture*)video_scaled_data_node->vframe, picture, pix_fmt, width, height);
 
 	return video_scaled_data_node;
 }
 
 void dc_video_scaler_node_destroy(VideoScaledDataNode *video_scaled_data_node)
 {
+	if (!video_scaled_data_node) return;
 #ifndef GPAC_USE_LIBAV
 	av_frame_free(&video_scaled_data_node->vframe);
+	av_frame_free(&video_scaled_data_node->cropped_frame);
 #endif
 	gf_free(video_scaled_data_node);
 }
@@ -104,6 +105,41 @@ void dc_video_scaler_list_init(VideoScaledDataList *video_scaled_data_list, GF_L
 	}
 }
 
+int dc_video_scaler_list_cascade(VideoScaledDataList *video_scaled_data_list)
+{
+	u32 i, j;
+	int nb_roots = 0;
+	VideoScaledData **list = video_scaled_data_list->video_scaled_data;
+
+	/*sort by decreasing size so that a resolution always comes after the ones it can be scaled from*/
+	for (i=1; i<video_scaled_data_list->size; i++) {
+		VideoScaledData *video_scaled_data = list[i];
+		j = i;
+		while (j && (list[j-1]->out_width * list[j-1]->out_height < video_scaled_data->out_width * video_scaled_data->out_height)) {
+			list[j] = list[j-1];
+			j--;
+		}
+		list[j] = video_scaled_data;
+	}
+
+	for (i=0; i<video_scaled_data_list->size; i++) {
+		VideoScaledData *video_scaled_data = list[i];
+		video_scaled_data->parent = NULL;
+		/*pick the smallest larger resolution, the scaler of this one becomes one more consumer of it*/
+		for (j=i; j>0; j--) {
+			VideoScaledData *parent = list[j-1];
+			if ((parent->out_width >= video_scaled_data->out_width) && (parent->out_height >= video_scaled_data->out_height)) {
+				video_scaled_data->parent = parent;
+				parent->num_consumers++;
+				break;
+			}
+		}
+		if (!video_scaled_data->parent)
+			nb_roots++;
+	}
+	return nb_roots;
+}
+
 void dc_video_scaler_list_destroy(VideoScaledDataList *video_scaled_data_list)
 {
 	u32 i;
@@ -121,7 +157,7 @@ void dc_video_scaler_end_signal(VideoScaledData *video_scaled_data)
 
 int dc_video_scaler_data_init(VideoInputData *video_input_data, VideoScaledData *video_scaled_data, int max_source, int video_cb_size)
 {
-	int i;
+	int i, picture_size;
 	char name[GF_MAX_PATH];
 	snprintf(name, sizeof(name), "video scaler %dx%d", video_scaled_data->out_width, video_scaled_data->out_height);
 
@@ -133,9 +169,21 @@ int dc_video_scaler_data_init(VideoInputData *video_input_data, VideoScaledData
 	GF_SAFE_ALLOC_N(video_scaled_data->vsprop, max_source, VideoScaledProp);
 	memset(video_scaled_data->vsprop, 0, max_source * sizeof(VideoScaledProp));
 
+	/*allocate the pictures of all nodes at once, each slice being kept 32-bytes aligned*/
+	picture_size = avpicture_get_size(video_scaled_data->out_pix_fmt, video_scaled_data->out_width, video_scaled_data->out_height);
+	picture_size = (picture_size + 31) & ~31;
+	video_scaled_data->frame_pool = (uint8_t *) av_malloc(picture_size * video_cb_size);
+	if (!video_scaled_data->frame_pool) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Cannot allocate video scaler frame pool\n"));
+		return -1;
+	}
+
 	dc_circular_buffer_create(&video_scaled_data->circular_buf, video_cb_size, video_input_data->circular_buf.mode, video_scaled_data->num_consumers);
 	for (i=0; i<video_cb_size; i++) {
-		video_scaled_data->circular_buf.list[i].data = dc_video_scaler_node_create(video_scaled_data->out_width, video_scaled_data->out_height, video_input_data->vprop[i].crop_x, video_input_data->vprop[i].crop_y, video_scaled_data->out_pix_fmt);
+		/*cascaded resolutions are scaled from already cropped frames*/
+		int crop_x = video_scaled_data->parent ? 0 : video_input_data->vprop[i].crop_x;
+		int crop_y = video_scaled_data->parent ? 0 : video_input_data->vprop[i].crop_y;
+		video_scaled_data->circular_buf.list[i].data = dc_video_scaler_node_create(video_scaled_data->frame_pool + i*picture_size, video_scaled_data->out_width, video_scaled_data->out_height, crop_x, crop_y, video_scaled_data->out_pix_fmt);
 	}
 
 	video_scaled_data->vsprop->video_input_data = video_input_data;
@@ -144,9 +192,15 @@ int dc_video_scaler_data_init(VideoInputData *video_input_data, VideoScaledData
 
 int dc_video_scaler_data_set_prop(VideoInputData *video_input_data, VideoScaledData *video_scaled_data, int index)
 {
-	video_scaled_data->vsprop[index].in_width   = video_input_data->vprop[index].width - video_input_data->vprop[index].crop_x;
-	video_scaled_data->vsprop[index].in_height  = video_input_data->vprop[index].height - video_input_data->vprop[index].crop_y;
-	video_scaled_data->vsprop[index].in_pix_fmt = video_input_data->vprop[index].pix_fmt;
+	if (video_scaled_data->parent) {
+		video_scaled_data->vsprop[index].in_width   = video_scaled_data->parent->out_width;
+		video_scaled_data->vsprop[index].in_height  = video_scaled_data->parent->out_height;
+		video_scaled_data->vsprop[index].in_pix_fmt = video_scaled_data->parent->out_pix_fmt;
+	} else {
+		video_scaled_data->vsprop[index].in_width   = video_input_data->vprop[index].width - video_input_data->vprop[index].crop_x;
+		video_scaled_data->vsprop[index].in_height  = video_input_data->vprop[index].height - video_input_data->vprop[index].crop_y;
+		video_scaled_data->vsprop[index].in_pix_fmt = video_input_data->vprop[index].pix_fmt;
+	}
 
 	video_scaled_data->sar  = video_input_data->vprop[index].sar;
 
@@ -164,13 +218,74 @@ int dc_video_scaler_data_set_prop(VideoInputData *video_input_data, VideoScaledD
 	return 0;
 }
 
+/*
+ * Same as dc_video_scaler_scale, but the frames are read from the scaled data of the parent resolution
+ */
+static int dc_video_scaler_scale_cascaded(VideoScaledData *video_scaled_data)
+{
+	int ret;
+	u64 time_spent;
+	VideoScaledData *parent = video_scaled_data->parent;
+	VideoScaledDataNode *src_node, *video_scaled_data_node;
+
+	//step 1: try to lock output slot. If none available, return ....
+	if (parent->circular_buf.size > 1)
+		dc_consumer_unlock_previous(&video_scaled_data->consumer, &parent->circular_buf);
+
+	ret = dc_producer_lock(&video_scaled_data->producer, &video_scaled_data->circular_buf);
+	//not ready
+	if (ret<0) {
+		return -1;
+	}
+	dc_producer_unlock_previous(&video_scaled_data->producer, &video_scaled_data->circular_buf);
+
+	//step 2: lock input
+	ret = dc_consumer_lock(&video_scaled_data->consumer, &parent->circular_buf);
+	if (ret < 0) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Video scaler got an end of input tbuffer!\n"));
+		return -2;
+	}
+
+	//step 3 - grab source and dest images, all sources share the same parent resolution
+	src_node = (VideoScaledDataNode*)dc_consumer_consume(&video_scaled_data->consumer, &parent->circular_buf);
+	video_scaled_data_node = (VideoScaledDataNode*)dc_producer_produce(&video_scaled_data->producer, &video_scaled_data->circular_buf);
+
+	time_spent = gf_sys_clock_high_res();
+	ret = sws_scale(video_scaled_data->vsprop[0].sws_ctx,
+	                (const uint8_t * const *)src_node->vframe->data, src_node->vframe->linesize, 0, parent->out_height,
+	                video_scaled_data_node->vframe->data, video_scaled_data_node->vframe->linesize);
+
+	if (!ret) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Video scaler: error while resizing picture.\n"));
+		return -1;
+	}
+	if (video_scaled_data->stats) {
+		video_scaled_data->stats->time_spent += gf_sys_clock_high_res() - time_spent;
+		video_scaled_data->stats->nb_frames++;
+	}
+	video_scaled_data_node->vframe->pts = src_node->vframe->pts;
+	video_scaled_data_node->frame_ntp = src_node->frame_ntp;
+	video_scaled_data_node->frame_utc = src_node->frame_utc;
+
+	dc_consumer_advance(&video_scaled_data->consumer);
+	dc_producer_advance(&video_scaled_data->producer, &video_scaled_data->circular_buf);
+
+	if (parent->circular_buf.size == 1)
+		dc_consumer_unlock_previous(&video_scaled_data->consumer, &parent->circular_buf);
+	return 0;
+}
+
 int dc_video_scaler_scale(VideoInputData *video_input_data, VideoScaledData *video_scaled_data)
 {
 	int ret, index, src_height;
+	u64 time_spent;
 	VideoDataNode *video_data_node;
 	VideoScaledDataNode *video_scaled_data_node;
 	AVFrame *src_vframe;
 
+	if (video_scaled_data->parent)
+		return dc_video_scaler_scale_cascaded(video_scaled_data);
+
 	//step 1: try to lock output slot. If none available, return ....
 	if (video_input_data->circular_buf.size > 1)
 		dc_consumer_unlock_previous(&video_scaled_data->consumer, &video_input_data->circular_buf);
@@ -194,6 +309,7 @@ int dc_video_scaler_scale(VideoInputData *video_input_data, VideoScaledData *vid
 	video_scaled_data_node = (VideoScaledDataNode*)dc_producer_produce(&video_scaled_data->producer, &video_scaled_data->circular_buf);
 	index = video_data_node->source_number;
 
+	time_spent = gf_sys_clock_high_res();
 	//crop if necessary
 	if (video_input_data->vprop[index].crop_x || video_input_data->vprop[index].crop_y) {
 #if 0
@@ -223,6 +339,10 @@ int dc_video_scaler_scale(VideoInputData *video_input_data, VideoScaledData *vid
 		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Video scaler: error while resizing picture.\n"));
 		return -1;
 	}
+	if (video_scaled_data->stats) {
+		video_scaled_data->stats->time_spent += gf_sys_clock_high_res() - time_spent;
+		video_scaled_data->stats->nb_frames++;
+	}
 	video_scaled_data_node->vframe->pts = video_data_node->vframe->pts;
 	video_scaled_data_node->frame_ntp = video_data_node->frame_ntp;
 	video_scaled_data_node->frame_utc = video_data_node->frame_utc;
@@ -261,6 +381,7 @@ int dc_video_scaler_data_destroy(VideoScaledData *video_scaled_data)
 	}
 	gf_free(video_scaled_data->vsprop);
 	//av_free(video_scaled_data->sws_ctx);
+	av_free(video_scaled_data->frame_pool);
 
 	dc_circular_buffer_destroy(&video_scaled_data->circular_buf);
 
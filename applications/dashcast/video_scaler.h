@@ -47,7 +47,7 @@ typedef struct {
  * VideoScaledData keeps a circular buffer
  * of video frame with a defined resolution.
  */
-typedef struct {
+typedef struct __video_scaled_data {
 	VideoScaledProp *vsprop;
 
 	int out_width;
@@ -75,6 +75,16 @@ typedef struct {
 	 * (Which are the encoders who are using this resolution) */
 	int num_consumers;
 	int num_producers;
+
+	/* In cascaded mode, the larger resolution this one is scaled from (the consumer
+	 * then reads from the parent circular buffer). NULL when scaled from the source. */
+	struct __video_scaled_data *parent;
+	/* Single allocation holding the pictures of all the nodes of the circular buffer. The pool
+	 * belongs to this resolution, decoded frames are still owned by the decoder circular buffer */
+	uint8_t *frame_pool;
+
+	/* scaling time of this resolution, may be NULL */
+	StageStats *stats;
 } VideoScaledData;
 
 /*
@@ -104,6 +114,16 @@ typedef struct {
  */
 void dc_video_scaler_list_init(VideoScaledDataList *video_scaled_data_list, GF_List *video_lst);
 
+/*
+ * Chain the resolutions of the list so that each one is scaled from the smallest
+ * larger resolution instead of the source. Must be called before dc_video_scaler_data_init.
+ *
+ * @param video_scaled_data_list [in] the list to be chained
+ *
+ * @return the number of resolutions still scaled from the source
+ */
+int dc_video_scaler_list_cascade(VideoScaledDataList *video_scaled_data_list);
+
 /*
  * Destroy a video scaled data list.
  *
@@ -68,6 +68,8 @@ void PrintStreamerUsage()
 	        "-ifce=IFCE   IP address of the physical interface to use. Default: NULL (ANY)\n"
 	        "-ttl=TTL     time to live for multicast packets. Default: 1\n"
 	        "-sdp=Name    file name of the generated SDP. Default: \"session.sdp\"\n"
+	        "-sessions=N  streams N sessions of each input file on consecutive port ranges. Default: 1\n"
+	        "             When several sessions or input files are used, SDP files are named Name_1.sdp, Name_2.sdp, ...\n"
 	        "\n"
 	       );
 }
@@ -82,10 +84,11 @@ static void on_logs(void *cbk, GF_LOG_Level ll, GF_LOG_Tool lm, const char *fmt,
 int stream_file_rtp(int argc, char **argv)
 {
 	GF_ISOMRTPStreamer *file_streamer;
+	GF_ISOMRTPScheduler *sched;
+	GF_List *streamers;
 	char *sdp_file = "session.sdp";
 	char *ip_dest = "127.0.0.1";
 	char *ifce_addr = NULL;
-	char *inName = NULL;
 	char *logs=NULL;
 	FILE *logfile=NULL;
 	u16 port = 7000;
@@ -95,18 +98,13 @@ int stream_file_rtp(int argc, char **argv)
 	Bool force_mpeg4 = GF_FALSE;
     u32 path_mtu = 1450;
     Double run_for = -1.0;
-	u32 i;
+	u32 i, j, nb_sessions = 1, nb_inputs = 0;
+	int ret = 0;
 
 	for (i = 1; i < (u32) argc ; i++) {
 		char *arg = argv[i];
 
-		if (arg[0] != '-') {
-			if (inName) {
-				fprintf(stderr, "Error - 2 input names specified, please check usage\n");
-				return 1;
-			}
-			inName = arg;
-		}
+		if (arg[0] != '-') nb_inputs++;
 		else if (!stricmp(arg, "-noloop")) loop = GF_FALSE;
 		else if (!stricmp(arg, "-mpeg4")) force_mpeg4 = GF_TRUE;
 		else if (!strnicmp(arg, "-port=", 6)) port = atoi(arg+6);
@@ -115,12 +113,14 @@ int stream_file_rtp(int argc, char **argv)
 		else if (!strnicmp(arg, "-ttl=", 5)) ttl = atoi(arg+5);
 		else if (!strnicmp(arg, "-ifce=", 6)) ifce_addr = arg+6;
 		else if (!strnicmp(arg, "-sdp=", 5)) sdp_file = arg+5;
+		else if (!strnicmp(arg, "-sessions=", 10)) nb_sessions = atoi(arg+10);
         else if (!stricmp(arg, "-mem-track")) mem_track = GF_MemTrackerSimple;
         else if (!stricmp(arg, "-mem-track-stack")) mem_track = GF_MemTrackerBackTrace;
 		else if (!strnicmp(arg, "-logs=", 6)) logs = arg+6;
 		else if (!strnicmp(arg, "-lf=", 4)) logfile = gf_fopen(arg+4, "wt");
         else if (!strnicmp(arg, "-run-for=", 9)) run_for = atof(arg+9);
 	}
+	if (!nb_sessions) nb_sessions = 1;
 
 	gf_sys_init(mem_track);
 	if (logs)
@@ -131,26 +131,66 @@ int stream_file_rtp(int argc, char **argv)
 		gf_log_set_callback(logfile, on_logs);
 	}
 
-	if (!gf_isom_probe_file(inName)) {
-		fprintf(stderr, "File %s is not a valid ISO Media file and cannot be streamed\n", inName);
-		if (logfile) gf_fclose(logfile);
-		gf_sys_close();
-		return 1;
+	streamers = gf_list_new();
+	sched = gf_isom_streamer_scheduler_new(0);
+
+	for (i = 1; i < (u32) argc ; i++) {
+		GF_ISOFile *file;
+		u32 nb_tracks;
+		char *inName = argv[i];
+		if (inName[0] == '-') continue;
+
+		if (!gf_isom_probe_file(inName)) {
+			fprintf(stderr, "File %s is not a valid ISO Media file and cannot be streamed\n", inName);
+			ret = 1;
+			goto exit;
+		}
+		/*each session uses 2 ports per track, sessions of the same file use consecutive port ranges*/
+		file = gf_isom_open(inName, GF_ISOM_OPEN_READ, NULL);
+		nb_tracks = file ? gf_isom_get_track_count(file) : 1;
+		if (file) gf_isom_close(file);
+
+		for (j=0; j<nb_sessions; j++) {
+			file_streamer = gf_isom_streamer_new(inName, ip_dest, port, loop, force_mpeg4, path_mtu, ttl, ifce_addr);
+			if (!file_streamer) {
+				fprintf(stderr, "Cannot create file streamer\n");
+				ret = 1;
+				goto exit;
+			}
+			gf_list_add(streamers, file_streamer);
+			fprintf(stderr, "Starting streaming %s to %s:%d\n", inName, ip_dest, port);
+
+			if ((nb_inputs==1) && (nb_sessions==1)) {
+				gf_isom_streamer_write_sdp(file_streamer, sdp_file);
+			} else {
+				char szSDP[GF_MAX_PATH];
+				char *ext = strrchr(sdp_file, '.');
+				u32 len = ext ? (u32) (ext - sdp_file) : (u32) strlen(sdp_file);
+				if (len > GF_MAX_PATH - 20) len = GF_MAX_PATH - 20;
+				strncpy(szSDP, sdp_file, len);
+				sprintf(szSDP + len, "_%d%s", gf_list_count(streamers), ext ? ext : ".sdp");
+				gf_isom_streamer_write_sdp(file_streamer, szSDP);
+			}
+			port += 2*nb_tracks;
+		}
 	}
 
-	file_streamer = gf_isom_streamer_new(inName, ip_dest, port, loop, force_mpeg4, path_mtu, ttl, ifce_addr);
-	if (!file_streamer) {
-		fprintf(stderr, "Cannot create file streamer\n");
-	} else {
-        Bool run = GF_TRUE;
-		u32 check = 50;
-		fprintf(stderr, "Starting streaming %s to %s:%d\n", inName, ip_dest, port);
-		gf_isom_streamer_write_sdp(file_streamer, sdp_file);
+	if (!gf_list_count(streamers)) {
+		fprintf(stderr, "No input file specified, please check usage\n");
+		ret = 1;
+		goto exit;
+	}
 
-        if (run_for==0) run=GF_FALSE;
+	if (run_for != 0) {
+		u32 check = 50;
+		file_streamer = (GF_ISOMRTPStreamer *) gf_list_get(streamers, 0);
 
-		while (run) {
-			gf_isom_streamer_send_next_packet(file_streamer, 0, 0);
+		for (i=0; i<gf_list_count(streamers); i++) {
+			gf_isom_streamer_scheduler_add(sched, (GF_ISOMRTPStreamer *) gf_list_get(streamers, i));
+		}
+		while (1) {
+			if (gf_isom_streamer_scheduler_process(sched, 0) == GF_EOS)
+				break;
 			check--;
 			if (!check) {
 				if (gf_prompt_has_input()) {
@@ -162,11 +202,18 @@ int stream_file_rtp(int argc, char **argv)
             if ((run_for > 0) && (run_for < gf_isom_streamer_get_current_time(file_streamer)) )
                 break;
 		}
+	}
+
+exit:
+	gf_isom_streamer_scheduler_del(sched);
+	while (gf_list_count(streamers)) {
+		file_streamer = (GF_ISOMRTPStreamer *) gf_list_pop_back(streamers);
 		gf_isom_streamer_del(file_streamer);
 	}
+	gf_list_del(streamers);
 	if (logfile) gf_fclose(logfile);
 	gf_sys_close();
-	return 0;
+	return ret;
 }
 
 
@@ -225,6 +225,9 @@ void PrintGeneralUsage()
 	        " -tight               performs tight interleaving (sample based) of the file\n"
 	        "                       * Note: reduces disk seek but increases file size\n"
 	        " -flat                stores file with all media data first, non-interleaved\n"
+	        " -moov-reserve SIZE   when creating a new file with -add, writes media data directly in the destination\n"
+	        "                       and reserves SIZE bytes for the moov box before the media data (fast-start)\n"
+	        "                       * Note: media data is moved only if the moov is larger than SIZE\n"
 	        " -frag time_in_ms     fragments file (track fragments of time_in_ms)\n"
 	        "                       * Note: Always disables interleaving\n"
 	        " -out filename        specifies output file name\n"
@@ -233,7 +236,7 @@ void PrintGeneralUsage()
 	        "                       * Note: Default temp dir is OS-dependent\n"
 			" -for-test            disables all creation/modif dates and GPAC versions in files\n"
 			" -co64                forces usage of 64-bit chunk offsets for ISOBMF files\n"
-	        " -write-buffer SIZE   specifies write buffer in bytes for ISOBMF files\n"
+	        " -write-buffer SIZE   specifies write buffer in bytes for ISOBMF files. Default: 1 MB\n"
 	        " -no-sys              removes all MPEG-4 Systems info except IOD (profiles)\n"
 	        "                       * Note: Set by default whith '-add' and '-cat'\n"
 	        " -no-iod              removes InitialObjectDescriptor from file\n"
@@ -413,6 +416,7 @@ void PrintDASHUsage()
 	        " -pssh=MODE           sets pssh store mode. Mode can be v (moov), f (frag), m (mpd) mv/vm (moov+mpd) mf/fm (moof+mpd).\n"
 	        " -sample-groups-traf  stores sample group descriptions in traf (duplicated for each traf). If not used, sample group descriptions are stored in the movie box.\n"
 			" -mvex-after-traks    Stores mvex box after trak boxes within the moov box. If not used, mvex is before.\n"
+	        " -hls                 generates HLS master and media playlists (.m3u8) along with the MPD, using the same segments\n"
 	        " -no-cache            disable file cache for dash inputs .\n"
 	        " -no-loop             disables looping content in live mode and uses period switch instead.\n"
 	        " -bound               enables video segmentation with same method as audio (i.e.: always try to split before or at the segment boundary - not after)\n"
@@ -724,6 +728,8 @@ void PrintHintUsage()
 	        "                       * Note: this includes the RTP header (12 bytes)\n"
 	        " -copy                copies media data to hint track rather than reference\n"
 	        "                       * Note: speeds up server but takes much more space\n"
+	        " -hint-threads N      hints up to N tracks in parallel. Default is 1 (sequential)\n"
+	        "                       * Note: the hinted file is the same as with sequential hinting\n"
 	        " -multi [maxptime]    enables frame concatenation in RTP packets if possible\n"
 	        "        maxptime       max packet duration in ms (optional, default 100ms)\n"
 	        " -rate ck_rate        specifies rtp rate in Hz when no default for payload\n"
@@ -1002,7 +1008,7 @@ void SetupClockReferences(GF_ISOFile *file)
 /*base RTP payload type used (you can specify your own types if needed)*/
 #define BASE_PAYT		96
 
-GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32 base_flags, Bool copy_data, Bool interleave, Bool regular_iod, Bool single_group)
+GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32 base_flags, Bool copy_data, Bool interleave, Bool regular_iod, Bool single_group, u32 nb_threads)
 {
 	GF_ESD *esd;
 	GF_InitialObjectDescriptor *iod;
@@ -1017,6 +1023,7 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 	GF_SDP_IODProfile iod_mode = GF_SDP_IOD_NONE;
 	u32 media_group = 0;
 	u8 media_prio = 0;
+	GF_List *hinters = NULL;
 
 	tot_bw = 0;
 	prev_ocr = 0;
@@ -1044,6 +1051,9 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 		}
 	}
 
+	/*in parallel mode, all hinters are created first, processed at once and then finalized in track order*/
+	if (nb_threads > 1) hinters = gf_list_new();
+
 	nb_done = 0;
 	for (i=0; i<gf_isom_get_track_count(file); i++) {
 		sl_mode = base_flags;
@@ -1132,7 +1142,10 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 		if (!hinter) {
 			if (e) {
 				fprintf(stderr, "Cannot create hinter (%s)\n", gf_error_to_string(e));
-				if (!nb_done) return e;
+				if (!nb_done && (!hinters || !gf_list_count(hinters))) {
+					if (hinters) gf_list_del(hinters);
+					return e;
+				}
 			}
 			continue;
 		}
@@ -1150,6 +1163,11 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 				if (flags & GP_RTP_PCK_FORCE_MPEG4) fprintf(stderr, "\tMPEG4 transport forced\n");
 				if (flags & GP_RTP_PCK_USE_MULTI) fprintf(stderr, "\tRTP aggregation enabled\n");
 		*/
+		init_payt++;
+		if (hinters) {
+			gf_list_add(hinters, hinter);
+			continue;
+		}
 		e = gf_hinter_track_process(hinter);
 
 		if (!e) e = gf_hinter_track_finalize(hinter, has_iod);
@@ -1159,10 +1177,38 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 			fprintf(stderr, "Error while hinting (%s)\n", gf_error_to_string(e));
 			if (!nb_done) return e;
 		}
-		init_payt++;
 		nb_done ++;
 	}
 
+	if (hinters) {
+		u32 count = gf_list_count(hinters);
+		GF_RTPHinter **hinter_tab = NULL;
+		GF_Err *track_errors = NULL;
+		e = GF_OK;
+		if (count) {
+			hinter_tab = (GF_RTPHinter **)gf_malloc(sizeof(GF_RTPHinter *) * count);
+			track_errors = (GF_Err *)gf_malloc(sizeof(GF_Err) * count);
+			for (i=0; i<count; i++) hinter_tab[i] = (GF_RTPHinter *)gf_list_get(hinters, i);
+			gf_hinter_tracks_process(hinter_tab, count, nb_threads, track_errors);
+		}
+		for (i=0; i<count; i++) {
+			if (!e) {
+				e = track_errors[i];
+				if (!e) e = gf_hinter_track_finalize(hinter_tab[i], has_iod);
+				if (e) {
+					fprintf(stderr, "Error while hinting (%s)\n", gf_error_to_string(e));
+					if (nb_done) e = GF_OK;
+				}
+				if (!e) nb_done ++;
+			}
+			gf_hinter_track_del(hinter_tab[i]);
+		}
+		if (hinter_tab) gf_free(hinter_tab);
+		if (track_errors) gf_free(track_errors);
+		gf_list_del(hinters);
+		if (e) return e;
+	}
+
 	if (has_iod) {
 		iod_mode = GF_SDP_IOD_ISMA;
 		if (regular_iod) iod_mode = GF_SDP_IOD_REGULAR;
@@ -2240,6 +2286,7 @@ Bool chunk_mode = GF_FALSE;
 #endif
 #ifndef GPAC_DISABLE_ISOM_HINTING
 Bool HintCopy = 0;
+u32 hint_threads = 1;
 u32 MTUSize = 1450;
 #endif
 #ifndef GPAC_DISABLE_CORE_TOOLS
@@ -2253,6 +2300,7 @@ Double mpd_update_time = GF_FALSE;
 Bool stream_rtp = GF_FALSE;
 Bool force_test_mode = GF_FALSE;
 Bool force_co64 = GF_FALSE;
+u32 moov_reserve = 0;
 Bool live_scene = GF_FALSE;
 Bool use_mfra = GF_FALSE;
 GF_MemTrackerType mem_track = GF_MemTrackerNone;
@@ -2261,6 +2309,7 @@ Bool dump_iod = GF_FALSE;
 GF_DASHPSSHMode pssh_mode = 0;
 Bool samplegroups_in_traf = GF_FALSE;
 Bool mvex_after_traks = GF_FALSE;
+Bool hls_output = GF_FALSE;
 Bool daisy_chain_sidx = GF_FALSE;
 Bool use_ssix = GF_FALSE;
 Bool single_segment = GF_FALSE;
@@ -2422,6 +2471,11 @@ u32 mp4box_parse_args_continue(int argc, char **argv, u32 *current_index)
 			remove_hint = 1;
 		}
 		else if (!stricmp(arg, "-copy")) HintCopy = 1;
+		else if (!stricmp(arg, "-hint-threads")) {
+			CHECK_NEXT_ARG
+			hint_threads = atoi(argv[i + 1]);
+			i++;
+		}
 		else if (!stricmp(arg, "-tight")) {
 			FullInter = 1;
 			open_edit = GF_TRUE;
@@ -2536,6 +2590,13 @@ u32 mp4box_parse_args_continue(int argc, char **argv, u32 *current_index)
 			open_edit = GF_TRUE;
 			do_flat = GF_TRUE;
 		}
+		else if (!stricmp(arg, "-moov-reserve")) {
+			CHECK_NEXT_ARG
+			moov_reserve = atoi(argv[i + 1]);
+			open_edit = GF_TRUE;
+			do_flat = GF_TRUE;
+			i++;
+		}
 		else if (!stricmp(arg, "-keep-utc")) keep_utc = GF_TRUE;
 		else if (!stricmp(arg, "-new")) force_new = GF_TRUE;
 		else if (!stricmp(arg, "-timescale")) {
@@ -3215,7 +3276,8 @@ Bool mp4box_parse_args(int argc, char **argv)
 					}
 					dash_inputs = set_dash_input(dash_inputs, arg_val, &nb_dash_inputs);
 				}
-				else {
+				/*the file streamer handles several inputs*/
+				else if (!stream_rtp) {
 					fprintf(stderr, "Error - 2 input names specified, please check usage\n");
 					return 2;
 				}
@@ -3868,6 +3930,9 @@ Bool mp4box_parse_args(int argc, char **argv)
 		else if (!stricmp(arg, "-mvex-after-traks")) {
 			mvex_after_traks = GF_TRUE;
 		}
+		else if (!stricmp(arg, "-hls")) {
+			hls_output = GF_TRUE;
+		}
 		else if (!stricmp(arg, "-dash-profile") || !stricmp(arg, "-profile")) {
 			CHECK_NEXT_ARG
 			if (!stricmp(argv[i + 1], "live") || !stricmp(argv[i + 1], "simple")) dash_profile = GF_DASH_PROFILE_LIVE;
@@ -4335,6 +4400,10 @@ int mp4boxMain(int argc, char **argv)
 			fprintf(stderr, "Cannot open destination file %s: %s\n", inName, gf_error_to_string(gf_isom_last_error(NULL)) );
 			return mp4box_cleanup(1);
 		}
+		if (moov_reserve) {
+			if (open_mode == GF_ISOM_OPEN_WRITE) gf_isom_reserve_moov_space(file, moov_reserve);
+			else fprintf(stderr, "Warning: moov reservation is only possible when creating a new file, ignoring\n");
+		}
 
 		for (i=0; i<(u32) argc; i++) {
 			if (!strcmp(argv[i], "-add")) {
@@ -4512,6 +4581,8 @@ int mp4boxMain(int argc, char **argv)
 				gf_delete_file(dash_ctx_file);
 
 			dash_ctx = gf_cfg_force_new(NULL, dash_ctx_file);
+			/*the context is reloaded and saved at each call, only append the changes*/
+			if (dash_ctx) gf_cfg_set_journal_mode(dash_ctx, GF_TRUE);
 		}
 
 		if (dash_profile==GF_DASH_PROFILE_UNKNOWN)
@@ -4586,6 +4657,7 @@ int mp4boxMain(int argc, char **argv)
 		if (!e) e = gf_dasher_set_split_on_closest(dasher, split_on_closest);
 		if (!e && dash_cues) e = gf_dasher_set_cues(dasher, dash_cues, strict_cues);
 		if (!e) e = gf_dasher_set_isobmff_options(dasher, mvex_after_traks);
+		if (!e) e = gf_dasher_enable_hls(dasher, hls_output);
 
 		for (i=0; i < nb_dash_inputs; i++) {
 			if (!e) e = gf_dasher_add_input(dasher, &dash_inputs[i]);
@@ -4702,7 +4774,8 @@ int mp4boxMain(int argc, char **argv)
 		}
 		switch (get_file_type_by_ext(inName)) {
 		case 1:
-			file = gf_isom_open(inName, (u8) (force_new ? GF_ISOM_WRITE_EDIT : (open_edit ? GF_ISOM_OPEN_EDIT : ( ((dump_isom>0) || print_info) ? GF_ISOM_OPEN_READ_DUMP : GF_ISOM_OPEN_READ) ) ), tmpdir);
+			/*info only needs sample tables for the inspected tracks, let them load on demand*/
+			file = gf_isom_open(inName, (u32) (force_new ? GF_ISOM_WRITE_EDIT : (open_edit ? GF_ISOM_OPEN_EDIT : ( (dump_isom>0) ? GF_ISOM_OPEN_READ_DUMP : (print_info ? (GF_ISOM_OPEN_READ_DUMP | GF_ISOM_OPEN_LAZY) : GF_ISOM_OPEN_READ) ) ) ), tmpdir);
 			if (!file && (gf_isom_last_error(NULL) == GF_ISOM_INCOMPLETE_FILE) && !open_edit) {
 				u64 missing_bytes;
 				e = gf_isom_open_progressive(inName, 0, 0, &file, &missing_bytes);
@@ -4994,40 +5067,49 @@ int mp4boxMain(int argc, char **argv)
 #ifndef GPAC_DISABLE_MEDIA_EXPORT
 	if (track_dump_type) {
 		char szFile[1024];
-		GF_MediaExporter mdump;
+		u32 nb_dumps = 0;
+		GF_MediaExporter *dumps = NULL;
 		for (i=0; i<nb_track_act; i++) {
+			u32 j, count;
 			TrackAction *tka = &tracks[i];
 			if (tka->act_type != TRAC_ACTION_RAW_EXTRACT) continue;
-			memset(&mdump, 0, sizeof(mdump));
-			mdump.file = file;
-			mdump.flags = tka->dump_type;
-			mdump.trackID = tka->trackID;
-			mdump.sample_num = tka->sample_num;
-			if (tka->out_name) {
-				mdump.out_name = tka->out_name;
-			} else if (outName) {
-				mdump.out_name = outName;
-				mdump.flags |= GF_EXPORT_MERGE;
-			} else {
-				sprintf(szFile, "%s_track%d", outfile, mdump.trackID);
-				mdump.out_name = szFile;
-				mdump.flags |= GF_EXPORT_FORCE_EXT;
-			}
-			if (tka->trackID==(u32) -1) {
-				u32 j;
-				for (j=0; j<gf_isom_get_track_count(file); j++) {
-					mdump.trackID = gf_isom_get_track_id(file, j+1);
-					sprintf(szFile, "%s_track%d", outfile, mdump.trackID);
-					mdump.out_name = szFile;
-					mdump.flags |= GF_EXPORT_FORCE_EXT;
-					e = gf_media_export(&mdump);
-					if (e) goto err_exit;
+			count = (tka->trackID==(u32) -1) ? gf_isom_get_track_count(file) : 1;
+			dumps = (GF_MediaExporter *)gf_realloc(dumps, sizeof(GF_MediaExporter) * (nb_dumps + count));
+			for (j=0; j<count; j++) {
+				GF_MediaExporter *mdump = &dumps[nb_dumps++];
+				memset(mdump, 0, sizeof(GF_MediaExporter));
+				mdump->file = file;
+				mdump->flags = tka->dump_type;
+				mdump->trackID = tka->trackID;
+				mdump->sample_num = tka->sample_num;
+				if (tka->trackID==(u32) -1) {
+					mdump->trackID = gf_isom_get_track_id(file, j+1);
+					if (!tka->out_name && outName) mdump->flags |= GF_EXPORT_MERGE;
+					sprintf(szFile, "%s_track%d", outfile, mdump->trackID);
+					mdump->out_name = gf_strdup(szFile);
+					mdump->flags |= GF_EXPORT_FORCE_EXT;
+				} else if (tka->out_name) {
+					mdump->out_name = gf_strdup(tka->out_name);
+				} else if (outName) {
+					mdump->out_name = gf_strdup(outName);
+					mdump->flags |= GF_EXPORT_MERGE;
+				} else {
+					sprintf(szFile, "%s_track%d", outfile, mdump->trackID);
+					mdump->out_name = gf_strdup(szFile);
+					mdump->flags |= GF_EXPORT_FORCE_EXT;
 				}
-			} else {
-				e = gf_media_export(&mdump);
-				if (e) goto err_exit;
 			}
 		}
+		e = GF_OK;
+		/*several tracks: read the file once and write all tracks at the same time*/
+		if (nb_dumps>1) {
+			e = gf_media_export_tracks(dumps, nb_dumps);
+		} else if (nb_dumps) {
+			e = gf_media_export(&dumps[0]);
+		}
+		for (i=0; i<nb_dumps; i++) gf_free(dumps[i].out_name);
+		if (dumps) gf_free(dumps);
+		if (e) goto err_exit;
 	} else if (do_saf) {
 		GF_MediaExporter mdump;
 		memset(&mdump, 0, sizeof(mdump));
@@ -5704,7 +5786,7 @@ int mp4boxMain(int argc, char **argv)
 		if (force_ocr) SetupClockReferences(file);
 		fprintf(stderr, "Hinting file with Path-MTU %d Bytes\n", MTUSize);
 		MTUSize -= 12;
-		e = HintFile(file, MTUSize, max_ptime, rtp_rate, hint_flags, HintCopy, HintInter, regular_iod, single_group);
+		e = HintFile(file, MTUSize, max_ptime, rtp_rate, hint_flags, HintCopy, HintInter, regular_iod, single_group, hint_threads);
 		if (e) goto err_exit;
 		needSave = GF_TRUE;
 		if (print_sdp) dump_isom_sdp(file, dump_std ? NULL : (outName ? outName : outfile), outName ? GF_TRUE : GF_FALSE);
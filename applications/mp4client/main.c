@@ -2942,6 +2942,7 @@ void ViewOD(GF_Terminal *term, u32 OD_ID, u32 number, const char *szURL)
 	else fprintf(stderr, "Not buffering - ");
 	fprintf(stderr, "Clock drift: %d ms\n", odi.clock_drift);
 	if (odi.db_unit_count) fprintf(stderr, "%d AU in DB\n", odi.db_unit_count);
+	if (odi.db_pool_count) fprintf(stderr, "%d AU buffers pooled (%d bytes)\n", odi.db_pool_count, odi.db_pool_size);
 	if (odi.cb_max_count) fprintf(stderr, "Composition Buffer: %d CU (%d max)\n", odi.cb_unit_count, odi.cb_max_count);
 	fprintf(stderr, "\n");
 
@@ -3074,6 +3075,7 @@ void PrintODBuffer(GF_Terminal *term, GF_ObjectManager *odm, u32 indent)
 		}
 		if (odi.buffer>=0) fprintf(stderr, " - Buffer: %d ms", odi.buffer);
 		if (odi.db_unit_count) fprintf(stderr, " - DB: %d AU", odi.db_unit_count);
+		if (odi.db_pool_count) fprintf(stderr, " - Pool: %d AU", odi.db_pool_count);
 		if (odi.cb_max_count) fprintf(stderr, " - CB: %d/%d CUs", odi.cb_unit_count, odi.cb_max_count);
 
 		fprintf(stderr, "\n");
@@ -0,0 +1,122 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / CRC32 benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+#include <gpac/tools.h>
+
+static void usage()
+{
+	fprintf(stdout, "crc32bench [options]\n"
+	        "Checks gf_crc_32 against a bitwise MPEG-2 CRC32 and reports its throughput\n"
+	        "\t-size N       buffer size in bytes (default: 1024, 4096 and 1048576)\n"
+	        "\t-mb N         amount of data to process per buffer size in MBytes (default 256)\n"
+	        );
+}
+
+/*reference: one bit at a time, MSB first, polynomial 0x04c11db7*/
+static u32 crc_32_ref(const u8 *data, u32 len)
+{
+	u32 i, crc = 0xffffffff;
+	while (len--) {
+		crc ^= (u32) (*data++) << 24;
+		for (i=0; i<8; i++)
+			crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04c11db7 : (crc << 1);
+	}
+	return crc;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, j, nb_sizes, sizes[3], nb_mb = 256, nb_bad = 0, res = 0;
+	u8 *buf;
+
+	sizes[0] = 1024;
+	sizes[1] = 4096;
+	sizes[2] = 1024*1024;
+	nb_sizes = 3;
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if ((i+1 < (u32) argc) && !strcmp(arg, "-size")) {
+			sizes[0] = atoi(argv[++i]);
+			nb_sizes = 1;
+		}
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-mb")) nb_mb = atoi(argv[++i]);
+		else {
+			usage();
+			return 1;
+		}
+	}
+	for (i=0; i<nb_sizes; i++) {
+		if (!sizes[i]) sizes[i] = 1;
+	}
+	if (!nb_mb) nb_mb = 1;
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_rand_init(GF_TRUE);
+
+	buf = gf_malloc(sizeof(u8) * (1024*1024 + 64));
+	for (i=0; i<1024*1024 + 64; i++) buf[i] = gf_rand() & 0xFF;
+
+	/*all lengths up to 1024 bytes and all misalignments, then a few large buffers*/
+	for (i=0; i<=1024; i++) {
+		for (j=0; j<8; j++) {
+			if (gf_crc_32((char *) buf + j, i) != crc_32_ref(buf + j, i)) nb_bad++;
+		}
+	}
+	for (i=0; i<16; i++) {
+		u32 len = 1024 + gf_rand() % (1024*1024 - 1024);
+		if (gf_crc_32((char *) buf + i, len) != crc_32_ref(buf + i, len)) nb_bad++;
+	}
+	if (nb_bad) {
+		fprintf(stderr, "%d CRC mismatches against the bitwise reference\n", nb_bad);
+		gf_free(buf);
+		gf_sys_close();
+		return 1;
+	}
+	fprintf(stdout, "CRC32 matches the bitwise reference\n");
+
+	for (i=0; i<nb_sizes; i++) {
+		u64 start, dur;
+		u32 size = sizes[i];
+		u32 nb_iter = (u32) (((u64) nb_mb * 1024 * 1024) / size);
+		if (size > 1024*1024) {
+			gf_free(buf);
+			buf = gf_malloc(sizeof(u8) * size);
+			memset(buf, 0x5A, size);
+		}
+		if (!nb_iter) nb_iter = 1;
+
+		start = gf_sys_clock_high_res();
+		for (j=0; j<nb_iter; j++)
+			res ^= gf_crc_32((char *) buf, size);
+		dur = gf_sys_clock_high_res() - start;
+
+		fprintf(stdout, "%d bytes buffers: %d CRCs in "LLU" us - %.2f MB/s\n", size, nb_iter, dur, dur ? ((Double) nb_iter*size) / dur : 0);
+	}
+	/*keep the CRC loop from being optimized away*/
+	if (!res) fprintf(stdout, "\n");
+
+	gf_free(buf);
+	gf_sys_close();
+	return 0;
+}
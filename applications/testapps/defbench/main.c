@@ -0,0 +1,149 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / scene graph DEF lookup benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+#include <gpac/scenegraph_vrml.h>
+#include <gpac/nodes_mpeg4.h>
+
+static void usage()
+{
+	fprintf(stdout, "defbench [options]\n"
+	        "Creates DEF nodes in a scene graph and reports the cost of DEF creation and lookups\n"
+	        "\t-nodes N      number of DEF nodes (default: 1000, 10000 and 50000)\n"
+	        "\t-lookups N    number of lookups per test (default 1000000)\n"
+	        );
+}
+
+#ifndef GPAC_DISABLE_VRML
+
+static u32 run_bench(u32 nb_nodes, u32 nb_lookups)
+{
+	u32 i, id, nb_bad = 0;
+	u64 start, dur_def, dur_id, dur_name, dur_node, dur_reset;
+	char szName[100];
+	GF_Node **nodes;
+	GF_SceneGraph *sg = gf_sg_new();
+
+	nodes = gf_malloc(sizeof(GF_Node *) * nb_nodes);
+
+	/*DEF all nodes, IDs are allocated the way scene loaders do*/
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb_nodes; i++) {
+		nodes[i] = gf_node_new(sg, TAG_MPEG4_Transform2D);
+		gf_node_register(nodes[i], NULL);
+		id = gf_sg_get_next_available_node_id(sg);
+		sprintf(szName, "N%d", i);
+		gf_node_set_id(nodes[i], id, szName);
+	}
+	dur_def = gf_sys_clock_high_res() - start;
+
+	/*check lookups before timing them*/
+	for (i=0; i<nb_nodes; i++) {
+		sprintf(szName, "N%d", i);
+		id = gf_node_get_id(nodes[i]);
+		if (gf_sg_find_node(sg, id) != nodes[i]) nb_bad++;
+		if (gf_sg_find_node_by_name(sg, szName) != nodes[i]) nb_bad++;
+		if (strcmp(gf_node_get_name(nodes[i]), szName)) nb_bad++;
+	}
+	if (nb_bad) {
+		fprintf(stderr, "%d nodes: %d lookup mismatches\n", nb_nodes, nb_bad);
+	}
+
+	/*pseudo-random access order, the same for all tests*/
+	id = 0;
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb_lookups; i++) {
+		GF_Node *n = nodes[(i * 7919) % nb_nodes];
+		id += gf_node_get_id(gf_sg_find_node(sg, gf_node_get_id(n)));
+	}
+	dur_id = gf_sys_clock_high_res() - start;
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb_lookups; i++) {
+		sprintf(szName, "N%d", (i * 7919) % nb_nodes);
+		if (gf_sg_find_node_by_name(sg, szName)) id++;
+	}
+	dur_name = gf_sys_clock_high_res() - start;
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb_lookups; i++) {
+		GF_Node *n = nodes[(i * 7919) % nb_nodes];
+		if (gf_node_get_name(n)) id++;
+	}
+	dur_node = gf_sys_clock_high_res() - start;
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb_nodes; i++) {
+		gf_node_unregister(nodes[i], NULL);
+	}
+	gf_sg_del(sg);
+	dur_reset = gf_sys_clock_high_res() - start;
+
+	fprintf(stdout, "%d nodes: DEF "LLU" us - find by ID %.3f us - find by name %.3f us - node name %.3f us - destroy "LLU" us\n",
+	        nb_nodes, dur_def, ((Double) dur_id) / nb_lookups, ((Double) dur_name) / nb_lookups, ((Double) dur_node) / nb_lookups, dur_reset);
+
+	/*keep the lookup loops from being optimized away*/
+	if (!id) fprintf(stdout, "\n");
+
+	gf_free(nodes);
+	return nb_bad;
+}
+
+#endif /*GPAC_DISABLE_VRML*/
+
+int main(int argc, char **argv)
+{
+	u32 i, nb_sizes, sizes[3], nb_lookups = 1000000, nb_bad = 0;
+
+	sizes[0] = 1000;
+	sizes[1] = 10000;
+	sizes[2] = 50000;
+	nb_sizes = 3;
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if ((i+1 < (u32) argc) && !strcmp(arg, "-nodes")) {
+			sizes[0] = atoi(argv[++i]);
+			nb_sizes = 1;
+		}
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-lookups")) nb_lookups = atoi(argv[++i]);
+		else {
+			usage();
+			return 1;
+		}
+	}
+	for (i=0; i<nb_sizes; i++) {
+		if (!sizes[i]) sizes[i] = 1;
+	}
+	if (!nb_lookups) nb_lookups = 1;
+
+#ifndef GPAC_DISABLE_VRML
+	gf_sys_init(GF_MemTrackerNone);
+	for (i=0; i<nb_sizes; i++) {
+		nb_bad += run_bench(sizes[i], nb_lookups);
+	}
+	gf_sys_close();
+#else
+	fprintf(stderr, "VRML scene graph disabled in this build\n");
+#endif
+	return nb_bad ? 1 : 0;
+}
@@ -0,0 +1,129 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / DASH segment parsing benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+#include <gpac/isomedia.h>
+
+#ifndef GPAC_DISABLE_ISOM_FRAGMENTS
+
+static void usage()
+{
+	fprintf(stdout, "isosegbench [options] init_segment segment1 [segment2 ...]\n"
+	        "Opens media segments one after the other as done by the DASH client, fetches all sample properties and reports parsing time\n"
+	        "\t-runs N       number of times the segment list is played (default 10)\n"
+	        );
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, j, k, nb_runs = 10, nb_segs = 0, nb_tracks, nb_samples = 0;
+	u32 hash = 2166136261U;
+	u64 start, dur, missing_bytes;
+	char *init_seg = NULL;
+	char **segs;
+	GF_Err e;
+
+	segs = gf_malloc(sizeof(char *) * argc);
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if ((i+1 < (u32) argc) && !strcmp(arg, "-runs")) nb_runs = atoi(argv[++i]);
+		else if (arg[0] == '-') {
+			usage();
+			gf_free(segs);
+			return 1;
+		}
+		else if (!init_seg) init_seg = arg;
+		else segs[nb_segs++] = arg;
+	}
+	if (!init_seg || !nb_segs) {
+		usage();
+		gf_free(segs);
+		return 1;
+	}
+	if (!nb_runs) nb_runs = 1;
+
+	gf_sys_init(GF_MemTrackerNone);
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb_runs; i++) {
+		GF_ISOFile *mov = NULL;
+		e = gf_isom_open_progressive(init_seg, 0, 0, &mov, &missing_bytes);
+		if (!mov) {
+			fprintf(stderr, "Cannot open init segment %s: %s\n", init_seg, gf_error_to_string(e));
+			gf_free(segs);
+			gf_sys_close();
+			return 1;
+		}
+		nb_tracks = gf_isom_get_track_count(mov);
+
+		for (j=0; j<nb_segs; j++) {
+			/*same sequence as the isom_in segment switch*/
+			if (j) gf_isom_release_segment(mov, 1);
+			gf_isom_reset_sample_count(mov);
+			e = gf_isom_open_segment(mov, segs[j], 0, 0, 0);
+			if (e<0) {
+				fprintf(stderr, "Cannot open segment %s: %s\n", segs[j], gf_error_to_string(e));
+				break;
+			}
+			for (k=0; k<nb_tracks; k++) {
+				u32 s, count = gf_isom_get_sample_count(mov, k+1);
+				for (s=0; s<count; s++) {
+					u32 di;
+					u64 offset;
+					GF_ISOSample *samp = gf_isom_get_sample_info(mov, k+1, s+1, &di, &offset);
+					if (!samp) continue;
+					if (!i) {
+						hash = (hash ^ samp->dataLength) * 16777619U;
+						hash = (hash ^ (u32) samp->DTS) * 16777619U;
+						hash = (hash ^ samp->CTS_Offset) * 16777619U;
+						hash = (hash ^ samp->IsRAP) * 16777619U;
+						hash = (hash ^ (u32) offset) * 16777619U;
+						nb_samples++;
+					}
+					gf_isom_sample_del(&samp);
+				}
+			}
+		}
+		gf_isom_release_segment(mov, 1);
+		gf_isom_close(mov);
+	}
+	dur = gf_sys_clock_high_res() - start;
+
+	fprintf(stdout, "%d segments - %d samples - %d runs\n", nb_segs, nb_samples, nb_runs);
+	fprintf(stdout, "Parsed in "LLU" us per run - "LLU" us per segment\n", dur / nb_runs, dur / nb_runs / nb_segs);
+	fprintf(stdout, "Samples hash %08X\n", hash);
+
+	gf_free(segs);
+	gf_sys_close();
+	return 0;
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+	fprintf(stderr, "GPAC compiled without ISO fragments support\n");
+	return 1;
+}
+
+#endif /*GPAC_DISABLE_ISOM_FRAGMENTS*/
@@ -0,0 +1,198 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / MPEG-2 TS multiplexer benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+#include <gpac/mpegts.h>
+#include <gpac/constants.h>
+
+#ifndef GPAC_DISABLE_MPEG2TS_MUX
+
+static void usage()
+{
+	fprintf(stdout, "m2tsmuxbench [options]\n"
+	        "Multiplexes synthetic programs into a constant rate MPTS and reports throughput\n"
+	        "\t-rate N       multiplex rate in kbps (default 200000)\n"
+	        "\t-progs N      number of programs (default 30)\n"
+	        "\t-audio N      number of audio streams per program, in addition to the video stream (default 4)\n"
+	        "\t-dur N        duration to multiplex in seconds (default 10)\n"
+	        "\t-dst FILE     writes the multiplex to FILE\n"
+	        );
+}
+
+typedef struct
+{
+	u32 au_size, au_dur, nb_aus, au_num, rap_period;
+} BenchSource;
+
+/*all AUs share the same payload, never released by the muxer in pull mode*/
+static char *au_data = NULL;
+
+static GF_Err bench_input_ctrl(GF_ESInterface *ifce, u32 act_type, void *param)
+{
+	GF_ESIPacket *pck;
+	BenchSource *src = (BenchSource *)ifce->input_udta;
+
+	switch (act_type) {
+	case GF_ESI_INPUT_DATA_PULL:
+		pck = (GF_ESIPacket *)param;
+		memset(pck, 0, sizeof(GF_ESIPacket));
+		pck->data = au_data;
+		pck->data_len = src->au_size;
+		pck->flags = GF_ESI_DATA_AU_START | GF_ESI_DATA_AU_END | GF_ESI_DATA_HAS_CTS | GF_ESI_DATA_HAS_DTS;
+		if (!(src->au_num % src->rap_period)) pck->flags |= GF_ESI_DATA_AU_RAP;
+		pck->dts = pck->cts = (u64) src->au_num * src->au_dur;
+		pck->duration = src->au_dur;
+		src->au_num++;
+		if (src->au_num == src->nb_aus) ifce->caps |= GF_ESI_STREAM_IS_OVER;
+		return GF_OK;
+	case GF_ESI_INPUT_DATA_RELEASE:
+		return GF_OK;
+	}
+	return GF_OK;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, j, rate = 200000, nb_progs = 30, nb_audio = 4, dur = 10, nb_streams, video_rate, status, usec_till_next;
+	u32 hash = 2166136261U;
+	u64 start, mux_time, nb_pck = 0, nb_pad = 0;
+	const char *ts_pck;
+	char *dst = NULL;
+	FILE *out = NULL;
+	GF_M2TS_Mux *muxer;
+	GF_ESInterface *ifces;
+	BenchSource *srcs;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if ((i+1 < (u32) argc) && !strcmp(arg, "-rate")) rate = atoi(argv[++i]);
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-progs")) nb_progs = atoi(argv[++i]);
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-audio")) nb_audio = atoi(argv[++i]);
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-dur")) dur = atoi(argv[++i]);
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-dst")) dst = argv[++i];
+		else {
+			usage();
+			return 1;
+		}
+	}
+	if (!nb_progs || !rate || !dur) {
+		usage();
+		return 1;
+	}
+
+	gf_sys_init(GF_MemTrackerNone);
+	if (dst) {
+		out = gf_fopen(dst, "wb");
+		if (!out) {
+			fprintf(stderr, "Cannot open destination %s\n", dst);
+			gf_sys_close();
+			return 1;
+		}
+	}
+
+	nb_streams = nb_progs * (1 + nb_audio);
+	ifces = gf_malloc(sizeof(GF_ESInterface) * nb_streams);
+	srcs = gf_malloc(sizeof(BenchSource) * nb_streams);
+	memset(ifces, 0, sizeof(GF_ESInterface) * nb_streams);
+	memset(srcs, 0, sizeof(BenchSource) * nb_streams);
+
+	/*audio at 128 kbps (24 ms frames), video gets 80% of what remains*/
+	video_rate = (u32) (((u64) rate * 1000 / nb_progs - nb_audio * 128000) * 8 / 10);
+	au_data = gf_malloc(sizeof(char) * (video_rate / 25 / 8 + 1));
+	memset(au_data, 0, video_rate / 25 / 8 + 1);
+
+	muxer = gf_m2ts_mux_new(rate * 1000, GF_M2TS_PSI_DEFAULT_REFRESH_RATE, GF_FALSE);
+	gf_m2ts_mux_set_initial_pcr(muxer, 0);
+
+	for (i=0; i<nb_progs; i++) {
+		GF_M2TS_Mux_Program *program = gf_m2ts_mux_program_add(muxer, i+1, 100 + i*16, GF_M2TS_PSI_DEFAULT_REFRESH_RATE, 0, GF_FALSE, 0, GF_FALSE);
+
+		for (j=0; j<1+nb_audio; j++) {
+			u32 idx = i*(1+nb_audio) + j;
+			GF_ESInterface *ifce = &ifces[idx];
+			BenchSource *src = &srcs[idx];
+
+			ifce->caps = GF_ESI_AU_PULL_CAP | GF_ESI_SIGNAL_DTS;
+			ifce->stream_id = idx+1;
+			ifce->program_number = i+1;
+			ifce->timescale = 90000;
+			ifce->input_ctrl = bench_input_ctrl;
+			ifce->input_udta = src;
+			if (!j) {
+				ifce->stream_type = GF_STREAM_VISUAL;
+				ifce->object_type_indication = GPAC_OTI_VIDEO_AVC;
+				ifce->bit_rate = video_rate;
+				src->au_dur = 3600;
+				src->au_size = video_rate / 25 / 8;
+				src->rap_period = 25;
+			} else {
+				ifce->stream_type = GF_STREAM_AUDIO;
+				ifce->object_type_indication = GPAC_OTI_AUDIO_MPEG1;
+				ifce->bit_rate = 128000;
+				src->au_dur = 2160;
+				src->au_size = 384;
+				src->rap_period = 1;
+			}
+			src->nb_aus = dur * 90000 / src->au_dur;
+			ifce->duration = dur;
+			gf_m2ts_program_stream_add(program, ifce, 100 + i*16 + 1 + j, j ? GF_FALSE : GF_TRUE, GF_FALSE);
+		}
+	}
+	gf_m2ts_mux_update_config(muxer, GF_TRUE);
+
+	start = gf_sys_clock_high_res();
+	while (1) {
+		ts_pck = gf_m2ts_mux_process(muxer, &status, &usec_till_next);
+		if (ts_pck) {
+			nb_pck++;
+			if (status == GF_M2TS_STATE_PADDING) nb_pad++;
+			for (i=0; i<188; i++) hash = (hash ^ (u8) ts_pck[i]) * 16777619U;
+			if (out) gf_fwrite(ts_pck, 1, 188, out);
+		}
+		if (status == GF_M2TS_STATE_EOS) break;
+	}
+	mux_time = gf_sys_clock_high_res() - start;
+
+	fprintf(stdout, "%d programs - %d streams - %d kbps - %d sec\n", nb_progs, nb_streams, rate, dur);
+	fprintf(stdout, "Muxed "LLU" packets ("LLU" padding) in "LLU" us - %.2f Mbps - %.2f x real-time\n", nb_pck, nb_pad, mux_time,
+	        mux_time ? ((Double) nb_pck*188*8) / mux_time : 0, mux_time ? ((Double) muxer->time.sec*1000000 + muxer->time.nanosec/1000) / mux_time : 0);
+	fprintf(stdout, "Output hash %08X\n", hash);
+
+	if (out) gf_fclose(out);
+	gf_m2ts_mux_del(muxer);
+	gf_free(ifces);
+	gf_free(srcs);
+	gf_free(au_data);
+	gf_sys_close();
+	return 0;
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+	fprintf(stderr, "GPAC compiled without MPEG-2 TS multiplexer support\n");
+	return 1;
+}
+
+#endif /*GPAC_DISABLE_MPEG2TS_MUX*/
@@ -0,0 +1,254 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / audio mixer benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+#include <gpac/internal/compositor_dev.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI	3.14159265358979323846
+#endif
+
+#define MAX_INPUTS	64
+#define OUT_SAMPLES	2048
+
+static void usage()
+{
+	fprintf(stdout, "mixerbench [options]\n"
+	        "Mixes synthetic 16-bit stereo sine inputs through the audio mixer and reports its throughput and resampling quality\n"
+	        "\t-inputs N     number of mixed inputs (default 8, max %d)\n"
+	        "\t-buffers N    number of %d samples output buffers per test (default 2000)\n"
+	        , MAX_INPUTS, OUT_SAMPLES);
+}
+
+/*a sine source delivering frames of random sizes, as decoders do*/
+typedef struct
+{
+	GF_AudioInterface ai;
+	u32 sample_rate;
+	s16 *table;
+	u32 table_len;
+	u64 pos;
+	s16 frame[2*2048];
+	u32 frame_samples, frame_used;
+	u32 seed;
+} SineInput;
+
+static char *sine_fetch_frame(void *callback, u32 *size, u32 audio_delay_ms)
+{
+	SineInput *in = (SineInput *) callback;
+	if (!in->frame_samples) {
+		u32 i;
+		in->seed = in->seed*1103515245 + 12345;
+		in->frame_samples = 100 + ((in->seed>>16) & 0x7FFF) % 1500;
+		for (i=0; i<in->frame_samples; i++) {
+			u32 idx = (u32) ((in->pos + i) % in->table_len);
+			in->frame[2*i] = in->table[2*idx];
+			in->frame[2*i+1] = in->table[2*idx+1];
+		}
+		in->frame_used = 0;
+	}
+	*size = 4 * (in->frame_samples - in->frame_used);
+	return (char *) (in->frame + 2*in->frame_used);
+}
+
+static void sine_release_frame(void *callback, u32 nb_bytes)
+{
+	SineInput *in = (SineInput *) callback;
+	in->frame_used += nb_bytes / 4;
+	if (in->frame_used >= in->frame_samples) {
+		in->pos += in->frame_samples;
+		in->frame_samples = 0;
+	}
+}
+
+static Fixed sine_get_speed(void *callback)
+{
+	return FIX_ONE;
+}
+
+static Bool sine_get_channel_volume(void *callback, Fixed *vol)
+{
+	u32 i;
+	for (i=0; i<6; i++) vol[i] = FIX_ONE;
+	return GF_FALSE;
+}
+
+static Bool sine_is_muted(void *callback)
+{
+	return GF_FALSE;
+}
+
+static Bool sine_get_config(GF_AudioInterface *ai, Bool for_reconf)
+{
+	SineInput *in = (SineInput *) ai->callback;
+	ai->chan = 2;
+	ai->bps = 16;
+	ai->samplerate = in->sample_rate;
+	ai->ch_cfg = GF_AUDIO_CH_FRONT_LEFT | GF_AUDIO_CH_FRONT_RIGHT;
+	return GF_TRUE;
+}
+
+static void sine_init(SineInput *in, u32 sample_rate, Double freq, Double amp, u32 seed)
+{
+	u32 i;
+	memset(in, 0, sizeof(SineInput));
+	in->sample_rate = sample_rate;
+	in->seed = seed;
+	in->ai.FetchFrame = sine_fetch_frame;
+	in->ai.ReleaseFrame = sine_release_frame;
+	in->ai.GetSpeed = sine_get_speed;
+	in->ai.GetChannelVolume = sine_get_channel_volume;
+	in->ai.IsMuted = sine_is_muted;
+	in->ai.GetConfig = sine_get_config;
+	in->ai.callback = in;
+	/*4 seconds, the right channel is phase-shifted*/
+	in->table_len = 4*sample_rate;
+	in->table = (s16 *) gf_malloc(sizeof(s16) * 2 * in->table_len);
+	for (i=0; i<in->table_len; i++) {
+		in->table[2*i] = (s16) (amp * sin(2*M_PI*freq*i/sample_rate));
+		in->table[2*i+1] = (s16) (amp * sin(2*M_PI*freq*i/sample_rate + 1));
+	}
+}
+
+/*runs the mixer on the inputs, returns the mixing time in us and fills the output if requested*/
+static u64 run_mixer(SineInput *inputs, u32 nb_inputs, u32 out_sr, u32 nb_buffers, s16 *output, u32 *nb_out_samples)
+{
+	u32 i, nb_samples = 0;
+	u64 start;
+	s16 buffer[2*OUT_SAMPLES];
+	GF_AudioMixer *am = gf_mixer_new(NULL);
+
+	for (i=0; i<nb_inputs; i++) {
+		gf_mixer_add_input(am, &inputs[i].ai);
+	}
+	/*the mixer picks the highest input rate, force the output rate the way the audio renderer does for the hardware*/
+	gf_mixer_reconfig(am);
+	gf_mixer_set_config(am, out_sr, 2, 16, GF_AUDIO_CH_FRONT_LEFT | GF_AUDIO_CH_FRONT_RIGHT);
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb_buffers; i++) {
+		u32 size = gf_mixer_get_output(am, buffer, sizeof(buffer), 0);
+		if (output) memcpy(output + 2*nb_samples, buffer, size);
+		nb_samples += size / 4;
+	}
+	start = gf_sys_clock_high_res() - start;
+	gf_mixer_del(am);
+	*nb_out_samples = nb_samples;
+	return start;
+}
+
+/*number of output samples differing from the sum of the inputs*/
+static u32 check_mix(SineInput *inputs, u32 nb_inputs, s16 *output, u32 nb_samples)
+{
+	u32 i, j, k, nb_bad = 0;
+	for (i=0; i<nb_samples; i++) {
+		for (k=0; k<2; k++) {
+			s32 sum = 0;
+			for (j=0; j<nb_inputs; j++) {
+				sum += inputs[j].table[2*(i % inputs[j].table_len) + k];
+			}
+			if (sum > 32767) sum = 32767;
+			else if (sum < -32768) sum = -32768;
+			if (output[2*i+k] != sum) nb_bad++;
+		}
+	}
+	return nb_bad;
+}
+
+/*SNR of the left channel against the best fitting sine at the given frequency, over a whole number of periods*/
+static Double sine_snr(s16 *output, u32 nb_samples, u32 sample_rate, Double freq)
+{
+	u32 i;
+	Double s=0, c=0, dc=0, sig=0, err=0;
+	for (i=0; i<nb_samples; i++) {
+		Double t = 2*M_PI*freq*i/sample_rate;
+		s += output[2*i] * sin(t);
+		c += output[2*i] * cos(t);
+		dc += output[2*i];
+	}
+	s = 2*s/nb_samples;
+	c = 2*c/nb_samples;
+	dc /= nb_samples;
+	for (i=0; i<nb_samples; i++) {
+		Double t = 2*M_PI*freq*i/sample_rate;
+		Double v = s*sin(t) + c*cos(t);
+		sig += v*v;
+		err += (output[2*i] - dc - v) * (output[2*i] - dc - v);
+	}
+	return err ? 10*log10(sig/err) : 1000;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, nb_inputs = 8, nb_buffers = 2000, nb_samples, nb_bad, skip;
+	u64 dur;
+	s16 *output;
+	SineInput *inputs;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if ((i+1 < (u32) argc) && !strcmp(arg, "-inputs")) nb_inputs = atoi(argv[++i]);
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-buffers")) nb_buffers = atoi(argv[++i]);
+		else {
+			usage();
+			return 1;
+		}
+	}
+	if (!nb_inputs) nb_inputs = 1;
+	if (nb_inputs > MAX_INPUTS) nb_inputs = MAX_INPUTS;
+	if (!nb_buffers) nb_buffers = 1;
+
+	gf_sys_init(GF_MemTrackerNone);
+	inputs = (SineInput *) gf_malloc(sizeof(SineInput) * nb_inputs);
+	output = (s16 *) gf_malloc(sizeof(s16) * 2 * OUT_SAMPLES * nb_buffers);
+
+	/*same rate inputs: the mix must be the exact sum of the inputs*/
+	for (i=0; i<nb_inputs; i++) sine_init(&inputs[i], 44100, 440 + 100*i, 24000 / nb_inputs, i+1);
+	dur = run_mixer(inputs, nb_inputs, 44100, nb_buffers, output, &nb_samples);
+	nb_bad = check_mix(inputs, nb_inputs, output, nb_samples);
+	fprintf(stdout, "%d inputs at 44100 Hz: %d samples in "LLU" us - %.2f Msamples/s per input - %d samples differ from the sum of the inputs\n",
+	        nb_inputs, nb_samples, dur, dur ? ((Double) nb_samples)*nb_inputs / dur : 0, nb_bad);
+	for (i=0; i<nb_inputs; i++) gf_free(inputs[i].table);
+
+	/*every other input at 48 kHz goes through the resampler*/
+	for (i=0; i<nb_inputs; i++) sine_init(&inputs[i], (i%2) ? 48000 : 44100, 440 + 100*i, 24000 / nb_inputs, i+1);
+	dur = run_mixer(inputs, nb_inputs, 44100, nb_buffers, NULL, &nb_samples);
+	fprintf(stdout, "%d inputs at 44100/48000 Hz: %d samples in "LLU" us - %.2f Msamples/s per input\n",
+	        nb_inputs, nb_samples, dur, dur ? ((Double) nb_samples)*nb_inputs / dur : 0);
+	for (i=0; i<nb_inputs; i++) gf_free(inputs[i].table);
+
+	/*resampling quality: a 1 kHz sine at 48 kHz, measured over a whole second of 44.1 kHz output after the first 100 ms*/
+	sine_init(&inputs[0], 48000, 1000, 16000, 1);
+	run_mixer(inputs, 1, 44100, nb_buffers, output, &nb_samples);
+	skip = 4410;
+	if (nb_samples >= skip + 44100) {
+		fprintf(stdout, "1 kHz sine resampled from 48000 to 44100 Hz: SNR %.1f dB\n", sine_snr(output + 2*skip, 44100, 44100, 1000));
+	}
+	gf_free(inputs[0].table);
+
+	gf_free(inputs);
+	gf_free(output);
+	gf_sys_close();
+	return nb_bad ? 1 : 0;
+}
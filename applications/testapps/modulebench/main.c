@@ -0,0 +1,128 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / module manager startup benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+#include <gpac/module.h>
+#include <gpac/config_file.h>
+#include <gpac/modules/audio_out.h>
+#include <gpac/modules/codec.h>
+#include <gpac/modules/font.h>
+#include <gpac/modules/raster2d.h>
+#include <gpac/modules/service.h>
+#include <gpac/modules/term_ext.h>
+#include <gpac/modules/video_out.h>
+
+static void usage()
+{
+	fprintf(stdout, "modulebench [options]\n"
+	        "Measures the module manager startup and interface lookup time with an empty and with a populated module cache\n"
+	        "\t-cfg FILE     configuration file to use (default: GPAC default configuration file)\n"
+	        "\t-mods DIR     modules directory (default: from configuration file)\n"
+	        "\t-runs N       number of runs with a populated cache (default 20)\n"
+	        );
+}
+
+/*interface families probed by the terminal and compositor at startup*/
+static const u32 families[] = {
+	GF_TERM_EXT_INTERFACE,
+	GF_NET_CLIENT_INTERFACE,
+	GF_MEDIA_DECODER_INTERFACE,
+	GF_SCENE_DECODER_INTERFACE,
+	GF_VIDEO_OUTPUT_INTERFACE,
+	GF_AUDIO_OUTPUT_INTERFACE,
+	GF_AUDIO_FILTER_INTERFACE,
+	GF_RASTER_2D_INTERFACE,
+	GF_FONT_READER_INTERFACE,
+	0
+};
+
+/*creates a module manager and loads every interface of every probed family, as done by a player startup*/
+static u64 bench_startup(GF_Config *cfg, u64 *create_time, u32 *nb_modules, u32 *nb_ifces)
+{
+	u32 i, j;
+	u64 start = gf_sys_clock_high_res();
+	GF_ModuleManager *mods = gf_modules_new(NULL, cfg);
+	*create_time = gf_sys_clock_high_res() - start;
+	*nb_modules = gf_modules_get_count(mods);
+	*nb_ifces = 0;
+
+	for (i=0; families[i]; i++) {
+		for (j=0; j<*nb_modules; j++) {
+			GF_BaseInterface *ifce = gf_modules_load_interface(mods, j, families[i]);
+			if (!ifce) continue;
+			(*nb_ifces)++;
+			gf_modules_close_interface(ifce);
+		}
+	}
+	gf_modules_del(mods);
+	return gf_sys_clock_high_res() - start;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, nb_runs = 20, nb_modules, nb_ifces, nb_ifces_cold;
+	u64 dur, create_time, tot_dur = 0, tot_create = 0;
+	char *cfg_file = NULL, *mods_dir = NULL;
+	GF_Config *cfg;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if ((i+1 < (u32) argc) && !strcmp(arg, "-cfg")) cfg_file = argv[++i];
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-mods")) mods_dir = argv[++i];
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-runs")) nb_runs = atoi(argv[++i]);
+		else {
+			usage();
+			return 1;
+		}
+	}
+	if (!nb_runs) nb_runs = 1;
+
+	gf_sys_init(GF_MemTrackerNone);
+	cfg = gf_cfg_init(cfg_file, NULL);
+	if (!cfg) {
+		fprintf(stderr, "Cannot load configuration file\n");
+		gf_sys_close();
+		return 1;
+	}
+	if (mods_dir) gf_cfg_set_key(cfg, "General", "ModulesDirectory", mods_dir);
+
+	/*first run without any cached module information: every module is loaded to query its interfaces*/
+	gf_cfg_del_section(cfg, "PluginsCache");
+	dur = bench_startup(cfg, &create_time, &nb_modules, &nb_ifces_cold);
+	fprintf(stdout, "%d modules - %d interfaces loaded\n", nb_modules, nb_ifces_cold);
+	fprintf(stdout, "Empty cache: manager created in "LLU" us - startup done in "LLU" us\n", create_time, dur);
+
+	for (i=0; i<nb_runs; i++) {
+		dur = bench_startup(cfg, &create_time, &nb_modules, &nb_ifces);
+		tot_dur += dur;
+		tot_create += create_time;
+		if (nb_ifces != nb_ifces_cold) {
+			fprintf(stderr, "Run %d loaded %d interfaces, %d expected\n", i+1, nb_ifces, nb_ifces_cold);
+		}
+	}
+	fprintf(stdout, "Populated cache: manager created in "LLU" us - startup done in "LLU" us (average over %d runs)\n", tot_create / nb_runs, tot_dur / nb_runs, nb_runs);
+
+	gf_cfg_del(cfg);
+	gf_sys_close();
+	return 0;
+}
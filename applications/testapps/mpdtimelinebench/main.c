@@ -0,0 +1,308 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / MPD SegmentTimeline benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+#include <gpac/internal/mpd.h>
+
+#ifndef GPAC_DISABLE_CORE_TOOLS
+
+static void usage()
+{
+	fprintf(stdout, "mpdtimelinebench [options]\n"
+	        "Replays the refreshes of a live MPD with a long SegmentTimeline, checks timeline lookups against a linear scan and reports their cost\n"
+	        "\t-window N     timeshift window in seconds (default 86400)\n"
+	        "\t-refresh N    number of MPD refreshes (default 20)\n"
+	        "\t-lookups N    number of index and time lookups per refresh (default 2000)\n"
+	        );
+}
+
+#define TIMESCALE	90000
+/*segments of 1.99 sec and 2.04 sec, grouped 3 by 3 in the timeline: one S entry for every 2 segments on average*/
+#define SEG_DUR(_k)	(((_k) % 4 == 3) ? 183600 : 178800)
+#define SEG_START(_k)	(((u64) (_k) / 4) * 720000 + ((_k) % 4) * 178800)
+/*segments added between two refreshes*/
+#define REFRESH_SEGS	3
+
+static u32 rand_state = 1;
+static u32 bench_rand()
+{
+	rand_state = rand_state * 1103515245 + 12345;
+	return (rand_state >> 8);
+}
+
+/*MPD of the live window covering segments [first_seg, last_seg[*/
+static char *make_mpd(u32 first_seg, u32 last_seg, u32 window)
+{
+	u32 k, size, alloc;
+	char *mpd, szS[100];
+
+	alloc = 1000 + (last_seg - first_seg) * 40;
+	mpd = gf_malloc(sizeof(char) * alloc);
+	size = sprintf(mpd, "<?xml version=\"1.0\"?>\n<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" type=\"dynamic\" profiles=\"urn:mpeg:dash:profile:isoff-live:2011\""
+	               " availabilityStartTime=\"1970-01-01T00:00:00Z\" minimumUpdatePeriod=\"PT6S\" minBufferTime=\"PT2S\" timeShiftBufferDepth=\"PT%dS\">\n"
+	               "<Period id=\"1\" start=\"PT0S\">\n<AdaptationSet mimeType=\"video/mp4\">\n"
+	               "<SegmentTemplate timescale=\"%d\" media=\"seg_$Time$.m4s\" initialization=\"init.mp4\">\n<SegmentTimeline>\n", window, TIMESCALE);
+
+	k = first_seg;
+	while (k < last_seg) {
+		u32 r = 0;
+		while ((k + r + 1 < last_seg) && (SEG_DUR(k + r + 1) == SEG_DUR(k))) r++;
+		if (k == first_seg) sprintf(szS, "<S t=\""LLU"\" d=\"%d\" r=\"%d\"/>\n", SEG_START(k), SEG_DUR(k), r);
+		else if (r) sprintf(szS, "<S d=\"%d\" r=\"%d\"/>\n", SEG_DUR(k), r);
+		else sprintf(szS, "<S d=\"%d\"/>\n", SEG_DUR(k));
+		if (size + strlen(szS) + 200 > alloc) {
+			alloc *= 2;
+			mpd = gf_realloc(mpd, sizeof(char) * alloc);
+		}
+		strcpy(mpd + size, szS);
+		size += (u32) strlen(szS);
+		k += r + 1;
+	}
+	strcpy(mpd + size, "</SegmentTimeline>\n</SegmentTemplate>\n<Representation id=\"1\" bandwidth=\"1000000\"/>\n</AdaptationSet>\n</Period>\n</MPD>\n");
+	return mpd;
+}
+
+/*reference lookups, scanning the timeline segment by segment*/
+static u64 ref_segment_start(GF_MPD_SegmentTimeline *timeline, u32 segment_index, u32 *duration)
+{
+	u64 start_time = 0;
+	u32 i, k, idx = 0;
+	for (i=0; i<gf_list_count(timeline->entries); i++) {
+		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, i);
+		if (ent->start_time) start_time = ent->start_time;
+		for (k=0; k<ent->repeat_count + 1; k++) {
+			if (idx == segment_index) {
+				*duration = ent->duration;
+				return start_time;
+			}
+			idx++;
+			start_time += ent->duration;
+		}
+	}
+	*duration = 0;
+	return start_time;
+}
+
+static u32 ref_find_segment(GF_MPD_SegmentTimeline *timeline, u64 time, u64 time_scale, u64 timeline_scale)
+{
+	u64 start_time = 0;
+	u32 i, repeat, idx = 0;
+	for (i=0; i<gf_list_count(timeline->entries); i++) {
+		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, i);
+		if (!i || ent->start_time) start_time = ent->start_time;
+		repeat = ent->repeat_count + 1;
+		while (repeat) {
+			if (start_time * time_scale >= time * timeline_scale) return idx;
+			start_time += ent->duration;
+			repeat--;
+			idx++;
+		}
+	}
+	return idx;
+}
+
+/*removes segments from the head of the timeline, as done by the DASH client when purging the timeshift buffer*/
+static void purge_timeline(GF_MPD_SegmentTimeline *timeline, u32 nb_segs)
+{
+	u64 start_time = 0;
+	while (nb_segs) {
+		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, 0);
+		if (!ent) break;
+		if (ent->start_time) start_time = ent->start_time;
+		if (ent->repeat_count) {
+			ent->repeat_count--;
+			start_time += ent->duration;
+			ent->start_time = start_time;
+		} else {
+			start_time += ent->duration;
+			gf_list_rem(timeline->entries, 0);
+			gf_free(ent);
+		}
+		nb_segs--;
+	}
+	gf_mpd_segment_timeline_reset_index(timeline);
+}
+
+/*runs the lookups of one refresh, either through the timeline index or through the reference scan*/
+static u32 run_lookups(GF_MPD_SegmentTimeline *timeline, u32 nb_lookups, u32 seed, Bool use_index, u32 *hash)
+{
+	u32 i, nb_segs, idx, dur;
+	u64 start, end_time;
+
+	nb_segs = gf_mpd_segment_timeline_get_segment_count(timeline, &end_time);
+	rand_state = seed;
+	for (i=0; i<nb_lookups; i++) {
+		u32 seg_idx = bench_rand() % (nb_segs + 1);
+		if (use_index) {
+			gf_mpd_segment_timeline_get_segment(timeline, seg_idx, &start, &dur);
+			if (seg_idx == nb_segs) dur = 0;
+		} else {
+			start = ref_segment_start(timeline, seg_idx, &dur);
+		}
+		*hash = (*hash ^ (u32) start) * 16777619U;
+		*hash = (*hash ^ dur) * 16777619U;
+	}
+	for (i=0; i<nb_lookups; i++) {
+		/*times in ms or in timeline timescale*/
+		u64 time_scale = (i % 2) ? 1000 : TIMESCALE;
+		u64 time = (u64) (bench_rand() % 1000000) * (end_time + TIMESCALE) / 1000000;
+		time = time * time_scale / TIMESCALE;
+		if (use_index) gf_mpd_segment_timeline_find_segment(timeline, time, time_scale, TIMESCALE, &idx, &start);
+		else idx = ref_find_segment(timeline, time, time_scale, TIMESCALE);
+		*hash = (*hash ^ idx) * 16777619U;
+	}
+	return nb_segs;
+}
+
+static GF_MPD_SegmentTimeline *get_timeline(GF_MPD *mpd)
+{
+	GF_MPD_Period *period = gf_list_get(mpd->periods, 0);
+	GF_MPD_AdaptationSet *set = period ? gf_list_get(period->adaptation_sets, 0) : NULL;
+	if (!set || !set->segment_template) return NULL;
+	return set->segment_template->segment_timeline;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, window = 86400, nb_refresh = 20, nb_lookups = 2000, nb_window_segs, live_seg, nb_entries = 0, nb_segs = 0, play_idx = 0, nb_bad = 0;
+	u32 hash = 2166136261U, ref_hash = 2166136261U;
+	u64 start, parse_time = 0, index_time = 0, ref_time = 0, play_time = 0;
+	GF_MPD *prev_mpd = NULL;
+	GF_DOMParser *parser;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if ((i+1 < (u32) argc) && !strcmp(arg, "-window")) window = atoi(argv[++i]);
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-refresh")) nb_refresh = atoi(argv[++i]);
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-lookups")) nb_lookups = atoi(argv[++i]);
+		else {
+			usage();
+			return 1;
+		}
+	}
+	if (!nb_refresh) nb_refresh = 1;
+	nb_window_segs = window / 2;
+	if (nb_window_segs < 100) nb_window_segs = 100;
+
+	gf_sys_init(GF_MemTrackerNone);
+	parser = gf_xml_dom_new();
+	live_seg = nb_window_segs + 1000;
+
+	for (i=0; i<nb_refresh; i++) {
+		GF_Err e;
+		u32 nb_ref_segs, new_idx, ref_idx, dur;
+		u64 play_start;
+		GF_MPD_SegmentTimeline *timeline;
+		GF_MPD *mpd = gf_mpd_new();
+		char *mpd_str = make_mpd(live_seg - nb_window_segs, live_seg, window);
+
+		start = gf_sys_clock_high_res();
+		e = gf_xml_dom_parse_string(parser, mpd_str);
+		if (!e) e = gf_mpd_init_from_dom(gf_xml_dom_get_root(parser), mpd, NULL);
+		parse_time += gf_sys_clock_high_res() - start;
+		gf_free(mpd_str);
+		timeline = e ? NULL : get_timeline(mpd);
+		if (!timeline) {
+			fprintf(stderr, "Failed to parse MPD: %s\n", gf_error_to_string(e ? e : GF_NON_COMPLIANT_BITSTREAM));
+			gf_mpd_del(mpd);
+			nb_bad++;
+			break;
+		}
+		nb_entries += gf_list_count(timeline->entries);
+
+		/*refresh: locate the segment being played in the new timeline, as done when merging timelines*/
+		if (prev_mpd) {
+			GF_MPD_SegmentTimeline *prev_timeline = get_timeline(prev_mpd);
+			start = gf_sys_clock_high_res();
+			gf_mpd_segment_timeline_get_segment(prev_timeline, play_idx, &play_start, &dur);
+			gf_mpd_segment_timeline_get_segment_count(timeline, NULL);
+			gf_mpd_segment_timeline_find_segment(timeline, play_start, TIMESCALE, TIMESCALE, &new_idx, &play_start);
+			play_time += gf_sys_clock_high_res() - start;
+
+			ref_idx = ref_find_segment(timeline, ref_segment_start(prev_timeline, play_idx, &dur), TIMESCALE, TIMESCALE);
+			if (new_idx != ref_idx) {
+				fprintf(stderr, "Refresh %d: segment index %d in updated timeline, %d expected\n", i, new_idx, ref_idx);
+				nb_bad++;
+			}
+			play_idx = new_idx;
+			gf_mpd_del(prev_mpd);
+		} else {
+			/*start playback 30 segments before the live edge*/
+			play_idx = nb_window_segs - 30;
+		}
+		/*segments downloaded between two refreshes*/
+		play_idx += REFRESH_SEGS;
+
+		start = gf_sys_clock_high_res();
+		nb_segs = run_lookups(timeline, nb_lookups, i+1, GF_TRUE, &hash);
+		index_time += gf_sys_clock_high_res() - start;
+
+		start = gf_sys_clock_high_res();
+		nb_ref_segs = run_lookups(timeline, nb_lookups, i+1, GF_FALSE, &ref_hash);
+		ref_time += gf_sys_clock_high_res() - start;
+
+		if ((nb_segs != nb_ref_segs) || (hash != ref_hash)) {
+			fprintf(stderr, "Refresh %d: lookups differ from the reference scan\n", i);
+			nb_bad++;
+			ref_hash = hash;
+		}
+
+		/*purge the oldest minute of the timeshift buffer and check lookups again*/
+		purge_timeline(timeline, 30);
+		play_idx = (play_idx > 30) ? play_idx - 30 : 0;
+		nb_segs = run_lookups(timeline, nb_lookups / 10, i+1000, GF_TRUE, &hash);
+		nb_ref_segs = run_lookups(timeline, nb_lookups / 10, i+1000, GF_FALSE, &ref_hash);
+		if ((nb_segs != nb_ref_segs) || (hash != ref_hash)) {
+			fprintf(stderr, "Refresh %d: lookups after purge differ from the reference scan\n", i);
+			nb_bad++;
+			ref_hash = hash;
+		}
+
+		prev_mpd = mpd;
+		live_seg += REFRESH_SEGS;
+	}
+	if (prev_mpd) gf_mpd_del(prev_mpd);
+	gf_xml_dom_del(parser);
+
+	fprintf(stdout, "%d refreshes - %d sec window - %d segments and %d entries per timeline\n", nb_refresh, window, nb_window_segs, nb_entries / nb_refresh);
+	fprintf(stdout, "MPD parsing: "LLU" us per refresh - timeline update: "LLU" us per refresh\n", parse_time / nb_refresh, play_time / nb_refresh);
+	fprintf(stdout, "Indexed lookups: %.3f us per lookup - linear scan: %.3f us per lookup\n", ((Double) index_time) / nb_refresh / (2*nb_lookups), ((Double) ref_time) / nb_refresh / (2*nb_lookups));
+	fprintf(stdout, "Lookup hash %08X\n", hash);
+	gf_sys_close();
+
+	if (nb_bad) {
+		fprintf(stderr, "%d lookup mismatches against the reference scan\n", nb_bad);
+		return 1;
+	}
+	return 0;
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+	fprintf(stderr, "GPAC compiled without core tools\n");
+	return 1;
+}
+
+#endif /*GPAC_DISABLE_CORE_TOOLS*/
@@ -0,0 +1,121 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2017
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / MPE-FEC benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+#include <gpac/internal/dvb_mpe_dev.h>
+
+#ifdef GPAC_ENABLE_MPE
+
+static void usage()
+{
+	fprintf(stdout, "mpefecbench [options]\n"
+	        "Decodes synthetic MPE-FEC frames and reports throughput\n"
+	        "\t-rows N       number of rows per frame (256, 512, 768 or 1024, default 1024)\n"
+	        "\t-frames N     number of frames to decode (default 20)\n"
+	        "\t-erasures N   number of ADT columns lost per frame, signaled as CRC errors (default 32)\n"
+	        "\t-errors N     number of unsignaled byte errors per frame (default 0)\n"
+	        );
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, k, rows = 1024, nb_frames = 20, nb_erasures = 32, nb_errors = 0, nb_bad = 0;
+	u64 start, enc_time = 0, dec_time = 0;
+	u8 *ref;
+	MPE_FEC_FRAME mff;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if ((i+1 < (u32) argc) && !strcmp(arg, "-rows")) rows = atoi(argv[++i]);
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-frames")) nb_frames = atoi(argv[++i]);
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-erasures")) nb_erasures = atoi(argv[++i]);
+		else if ((i+1 < (u32) argc) && !strcmp(arg, "-errors")) nb_errors = atoi(argv[++i]);
+		else {
+			usage();
+			return 1;
+		}
+	}
+	if (nb_erasures > MPE_ADT_COLS) nb_erasures = MPE_ADT_COLS;
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_rand_init(GF_TRUE);
+
+	memset(&mff, 0, sizeof(MPE_FEC_FRAME));
+	if (!init_frame(&mff, rows)) {
+		fprintf(stderr, "Invalid number of rows %d\n", rows);
+		gf_sys_close();
+		return 1;
+	}
+	ref = gf_malloc(sizeof(u8) * mff.col_adt * rows);
+
+	for (k=0; k<nb_frames; k++) {
+		resetMFF(&mff);
+		for (i=0; i<mff.col_adt*rows; i++) mff.p_adt[i] = gf_rand() & 0xFF;
+		memcpy(ref, mff.p_adt, mff.col_adt*rows);
+
+		start = gf_sys_clock_high_res();
+		encode_fec(&mff);
+		enc_time += gf_sys_clock_high_res() - start;
+
+		/*lost sections: whole columns flagged by the section CRC*/
+		for (i=0; i<nb_erasures; i++) {
+			u32 col = (i * MPE_ADT_COLS) / nb_erasures;
+			memset(mff.p_adt + col*rows, 0, rows);
+			setErrorIndicator(mff.p_error_adt, col*rows, rows*sizeof(u32));
+		}
+		/*unsignaled errors*/
+		for (i=0; i<nb_errors; i++) {
+			mff.p_adt[gf_rand() % (mff.col_adt*rows)] ^= 1 + (gf_rand() % 255);
+		}
+
+		start = gf_sys_clock_high_res();
+		decode_fec(&mff);
+		dec_time += gf_sys_clock_high_res() - start;
+
+		if (memcmp(ref, mff.p_adt, mff.col_adt*rows)) nb_bad++;
+	}
+
+	fprintf(stdout, "%d frames of %d rows - %d erasures %d errors per frame\n", nb_frames, rows, nb_erasures, nb_errors);
+	fprintf(stdout, "Encoding: "LLU" us - %.2f Mbps\n", enc_time, enc_time ? ((Double) nb_frames*rows*MPE_ADT_COLS*8) / enc_time : 0);
+	fprintf(stdout, "Decoding: "LLU" us - %.2f Mbps\n", dec_time, dec_time ? ((Double) nb_frames*rows*MPE_ADT_COLS*8) / dec_time : 0);
+	fprintf(stdout, "%d frames not fully corrected\n", nb_bad);
+
+	gf_free(ref);
+	gf_free(mff.p_adt);
+	gf_free(mff.p_rs);
+	gf_free(mff.p_error_adt);
+	gf_free(mff.p_error_rs);
+	gf_list_del(mff.mpe_holes);
+	gf_sys_close();
+	return nb_bad ? 1 : 0;
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+	fprintf(stderr, "GPAC compiled without MPE-FEC support (use --enable-dvbx)\n");
+	return 1;
+}
+
+#endif /*GPAC_ENABLE_MPE*/
@@ -109,6 +109,13 @@ GF_Err gf_bifs_encoder_get_rap(GF_BifsEncoder *codec, char **out_data, u32 *out_
 
 GF_Err gf_bifs_encoder_set_source_url(GF_BifsEncoder *codec, const char *src_url);
 
+/*enables caching of encoded node subtrees: unmodified subtrees encoded in the same context are copied
+from the cache rather than re-encoded. The caller shall signal node modifications and destructions
+through gf_bifs_encoder_node_modified*/
+GF_Err gf_bifs_encoder_set_node_cache(GF_BifsEncoder *codec, Bool enable);
+/*signals a node has been modified or is being destroyed, discarding cached subtrees containing it*/
+void gf_bifs_encoder_node_modified(GF_BifsEncoder *codec, GF_Node *node);
+
 #endif /*GPAC_DISABLE_BIFS_ENC*/
 
 #endif /*GPAC_DISABLE_BIFS*/
@@ -224,6 +224,17 @@ GF_Err gf_cfg_set_filename(GF_Config *iniFile, const char * fileName);
  */
 GF_Err gf_cfg_discard_changes(GF_Config *iniFile);
 
+/*!
+ * Enables journal mode: when saving, only the keys changed or removed since the last save are appended to the file
+ * (removed keys are written as "!keyName"), and the file is rewritten once the appended data exceeds the size of the
+ * last full write. Section removal and key insertion at a given position also trigger a full rewrite.
+ * This is used for files updated often with few changes, such as the DASH segmenter context.
+ * \param iniFile The Configuration
+ * \param journal_on enables or disables journal mode
+ * \return error code
+ */
+GF_Err gf_cfg_set_journal_mode(GF_Config *iniFile, Bool journal_on);
+
 /*! @} */
 
 #ifdef __cplusplus
@@ -119,6 +119,48 @@ void gf_isom_streamer_reset(GF_ISOMRTPStreamer *streamer, Bool is_loop);
  *	\return media time (DTS) in seconds
  */
 Double gf_isom_streamer_get_current_time(GF_ISOMRTPStreamer *streamer);
+
+/*!
+ *	\brief RTP session scheduler
+ *
+ *	The scheduler drives many file streamers from a single thread: sessions are kept in a timing wheel indexed by the DTS of their next AU, and only the sessions due in the current slot are visited.
+ */
+typedef struct __isom_rtp_scheduler GF_ISOMRTPScheduler;
+
+/*!
+ *	\brief creates a new RTP session scheduler
+ *
+ *	\param slot_us duration in microseconds of a scheduling slot. AUs are sent at most one slot ahead of their DTS. If 0, defaults to 500 microseconds.
+ *	\return new scheduler object
+ */
+GF_ISOMRTPScheduler *gf_isom_streamer_scheduler_new(u32 slot_us);
+
+/*!
+ *	\brief deletes an RTP session scheduler
+ *
+ *	The streamers attached to the scheduler are not destroyed
+ *	\param sched scheduler object
+ */
+void gf_isom_streamer_scheduler_del(GF_ISOMRTPScheduler *sched);
+
+/*!
+ *	\brief attaches a file streamer to the scheduler
+ *
+ *	\param sched scheduler object
+ *	\param streamer RTP streamer object. It shall not be used with \ref gf_isom_streamer_send_next_packet once attached
+ *	\return GF_EOS if the streamer has nothing to send, error if any
+ */
+GF_Err gf_isom_streamer_scheduler_add(GF_ISOMRTPScheduler *sched, GF_ISOMRTPStreamer *streamer);
+
+/*!
+ *	\brief processes the scheduler
+ *
+ *	Sends all AUs due since the last call in all attached sessions, then waits for the next scheduling slot.
+ *	\param sched scheduler object
+ *	\param max_wait_us maximum time to wait in microseconds, 0 means until the next slot
+ *	\return GF_EOS once all sessions are done (only possible if looping is disabled), error if any
+ */
+GF_Err gf_isom_streamer_scheduler_process(GF_ISOMRTPScheduler *sched, u32 max_wait_us);
     
 /*! @} */
 
@@ -644,6 +644,10 @@ GF_Err gf_rtp_send_bye(GF_RTPChannel *ch,
 write the header in place*/
 GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, char *pck, u32 pck_size, Bool fast_send);
 
+/*send several RTP packets in one go, using batched socket emission when available. As in fast_send mode, each
+packet pointer must have 12 bytes available BEFORE it to write the header in place. Headers with CSRC are not supported*/
+GF_Err gf_rtp_send_packets(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdrs, char **pcks, u32 *pck_sizes, u32 nb_pcks);
+
 enum
 {
 	GF_RTCP_INFO_NAME = 0,
@@ -162,6 +162,45 @@ GF_Err gf_bifs_flush_command_list(GF_BifsDecoder *codec);
 
 #ifndef GPAC_DISABLE_BIFS_ENC
 
+/*hashed set of nodes already encoded in the current context, for DEF/USE*/
+typedef struct
+{
+	GF_Node **nodes;
+	u32 size, count;
+} BIFSNodeSet;
+
+/*DEF/USE decision taken while encoding a cached subtree*/
+typedef struct
+{
+	GF_Node *node;
+	Bool is_use;
+} BIFSCachedUse;
+
+/*encoded node subtree, spliced back as is when the subtree and its encoding context are unchanged*/
+typedef struct
+{
+	GF_Node *node;
+	/*encoding context*/
+	BIFSStreamInfo *info;
+	u32 NDT_Tag;
+	Bool UseName;
+	M_QuantizationParameter *qp, *qp_top;
+	u32 nb_qps;
+	/*QP14 state when entering and leaving the node*/
+	u32 num_coord_in, num_coord_out;
+	Bool coord_stored_in, storing_coord_in, coord_stored_out, storing_coord_out;
+	/*DEF/USE decisions in encoding order*/
+	BIFSCachedUse *uses;
+	u32 nb_uses, alloc_uses;
+	/*encoded subtree*/
+	char *data;
+	u32 nb_bits;
+
+	/*recording state*/
+	GF_BitStream *bs;
+	Bool no_cache;
+} BIFSNodeCache;
+
 struct __tag_bifs_enc
 {
 	GF_Err LastError;
@@ -189,9 +228,20 @@ struct __tag_bifs_enc
 	GF_Proto *encoding_proto;
 
 	/*keep track of DEF/USE*/
-	GF_List *encoded_nodes;
+	BIFSNodeSet *encoded_nodes;
 	Bool is_encoding_command;
 
+	/*encoded subtree cache, indexed by node*/
+	Bool use_node_cache;
+	BIFSNodeCache **node_cache;
+	u32 node_cache_size, node_cache_count;
+	/*subtrees being recorded*/
+	GF_List *cache_stack;
+	/*QPs used by cached subtrees*/
+	GF_List *cache_qps;
+	/*nodes already walked when invalidating the cache*/
+	BIFSNodeSet *cache_visited;
+
 	char *src_url;
 };
 
@@ -204,6 +254,11 @@ GF_Err gf_bifs_enc_mf_field(GF_BifsEncoder *codec, GF_BitStream *bs, GF_Node *no
 GF_Err gf_bifs_enc_route(GF_BifsEncoder *codec, GF_Route *r, GF_BitStream *bs);
 void gf_bifs_enc_name(GF_BifsEncoder *codec, GF_BitStream *bs, char *name);
 GF_Node *gf_bifs_enc_find_node(GF_BifsEncoder *codec, u32 nodeID);
+BIFSNodeSet *gf_bifs_enc_node_set_new();
+void gf_bifs_enc_node_set_del(BIFSNodeSet *set);
+void gf_bifs_enc_node_set_reset(BIFSNodeSet *set);
+void gf_bifs_enc_cache_reset(GF_BifsEncoder *codec);
+void gf_bifs_enc_cache_invalidate(GF_BifsEncoder *codec, GF_Node *node);
 
 #define GF_BIFS_WRITE_INT(codec, bs, val, nbBits, str, com)	{\
 		gf_bs_write_int(bs, val, nbBits);	\
@@ -248,6 +248,7 @@ void setErrorIndicator(u32 * data , u32 offset1, u32 length  );
 void resetMFF(MPE_FEC_FRAME * mff) ;
 u32  getErrasurePositions( MPE_FEC_FRAME *mff , u32 row, u32 *errasures);
 
+void encode_fec(MPE_FEC_FRAME * mff);
 void decode_fec(MPE_FEC_FRAME * mff);
 
 
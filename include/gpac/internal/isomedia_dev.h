@@ -583,6 +583,33 @@ typedef struct
 		}\
 		__ptr->size -= bytes; \
 
+/*bitstream cookie flags used while parsing boxes*/
+enum
+{
+	/*don't log box parsing errors (speculative parsing)*/
+	GF_ISOM_BS_COOKIE_NO_LOGS = 1,
+	/*sample tables entries are not parsed, only located (lazy open)*/
+	GF_ISOM_BS_COOKIE_LAZY_TABLES = 1<<1,
+};
+
+/*location of the entries of a sample table box left unparsed at open time. bs is NULL once the table is loaded*/
+typedef struct
+{
+	GF_BitStream *bs;
+	u64 offset;
+	u64 size;
+} GF_LazyTable;
+
+/*in lazy mode, records the location of the remaining payload of the table box and skips it. Returns GF_TRUE if the table is deferred*/
+Bool gf_isom_box_defer_table(GF_Box *s, GF_BitStream *bs, GF_LazyTable *lazy, u64 payload_start, u64 payload_size);
+/*parses the deferred entries of a table box*/
+GF_Err gf_isom_box_load_table(GF_Box *s, GF_LazyTable *lazy);
+
+#define ISOM_LOAD_LAZY_TABLE(__ptr)	if ((__ptr) && (__ptr)->lazy.bs) {\
+			GF_Err __e = gf_isom_box_load_table((GF_Box *) (__ptr), &(__ptr)->lazy); \
+			if (__e) return __e; \
+		}\
+
 /*constructor*/
 GF_Box *gf_isom_box_new(u32 boxType);
 //some boxes may have different syntax based on container. Use this constructor for this case
@@ -998,6 +1025,7 @@ typedef struct
 	GF_ISOM_FULL_BOX
 	GF_SttsEntry *entries;
 	u32 nb_entries, alloc_size;
+	GF_LazyTable lazy;
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
 	/*cache for WRITE*/
@@ -1023,6 +1051,7 @@ typedef struct
 	GF_ISOM_FULL_BOX
 	GF_DttsEntry *entries;
 	u32 nb_entries, alloc_size;
+	GF_LazyTable lazy;
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
 	u32 w_LastSampleNumber;
@@ -1535,6 +1564,7 @@ typedef struct
 	u32 sampleCount;
 	u32 alloc_size;
 	u32 *sizes;
+	GF_LazyTable lazy;
 } GF_SampleSizeBox;
 
 typedef struct
@@ -1544,6 +1574,7 @@ typedef struct
 	u32 alloc_size;
 	u32 *offsets;
 	u32 w_lastSampleNumber;
+	GF_LazyTable lazy;
 } GF_ChunkOffsetBox;
 
 typedef struct
@@ -1553,6 +1584,7 @@ typedef struct
 	u32 alloc_size;
 	u64 *offsets;
 	u32 w_lastSampleNumber;
+	GF_LazyTable lazy;
 } GF_ChunkLargeOffsetBox;
 
 typedef struct
@@ -1569,6 +1601,7 @@ typedef struct
 	GF_ISOM_FULL_BOX
 	GF_StscEntry *entries;
 	u32 alloc_size, nb_entries;
+	GF_LazyTable lazy;
 
 	/*0-based cache for READ. In WRITE mode, we always have 1 sample per chunk so no need for a cache*/
 	u32 currentIndex;
@@ -1586,6 +1619,7 @@ typedef struct
 	GF_ISOM_FULL_BOX
 	u32 alloc_size, nb_entries;
 	u32 *sampleNumbers;
+	GF_LazyTable lazy;
 	/*cache for READ mode (in write we realloc no matter what)*/
 	u32 r_LastSyncSample;
 	/*0-based index in the array*/
@@ -3391,6 +3425,14 @@ typedef struct __tag_data_map
 	GF_ISOM_BASE_DATA_HANDLER
 } GF_DataMap;
 
+/*byte range of a file loaded in memory*/
+typedef struct
+{
+	u64 offset;
+	u32 size;
+	char *data;
+} GF_DataMapRange;
+
 typedef struct
 {
 	GF_ISOM_BASE_DATA_HANDLER
@@ -3400,6 +3442,11 @@ typedef struct
 #ifndef GPAC_DISABLE_ISOM_WRITE
 	char *temp_file;
 #endif
+	/*prefetched byte ranges, sorted by offset and not overlapping, and their storage - both are reused across prefetches*/
+	GF_DataMapRange *ranges;
+	u32 nb_ranges, nb_alloc_ranges;
+	char *prefetch_buf;
+	u64 prefetch_buf_size;
 } GF_FileDataMap;
 
 /*file mapping handler. used if supported, only on read mode for complete files  (not in file download)*/
@@ -3438,6 +3485,9 @@ GF_Err gf_isom_datamap_add_data(GF_DataMap *ptr, char *data, u32 dataSize);
 #endif
 
 void gf_isom_datamap_flush(GF_DataMap *map);
+/*loads the given byte ranges in memory, discarding any previously loaded range. Ranges must be sorted by offset and not overlap.
+If no range is given, the memory used for prefetching is released*/
+GF_Err gf_isom_fdm_prefetch(GF_FileDataMap *ptr, GF_DataMapRange *ranges, u32 nb_ranges);
 
 /*
 		Movie stuff
@@ -3490,6 +3540,8 @@ struct __tag_isom {
 	GF_DataMap *editFileMap;
 	/*the interleaving time for dummy mode (in movie TimeScale)*/
 	u32 interleavingTime;
+	/*size of the free box reserved before the mdat in capture mode, used to store the moov at close time*/
+	u32 moov_reserve;
 #endif
 
 	u8 openMode;
@@ -3513,6 +3565,8 @@ struct __tag_isom {
 	GF_MetaBox *meta;
 
 	Bool dump_mode_alloc;
+	/*sample tables are parsed on first access (GF_ISOM_OPEN_LAZY)*/
+	Bool lazy_tables;
 
 #ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
 	u32 FragmentsFlags, NextMoofNumber;
@@ -3619,6 +3673,8 @@ GF_Err stbl_GetSampleRAP(GF_SyncSampleBox *stss, u32 SampleNumber, SAPType *IsRA
 /*same as above but only look for open-gop RAPs and GDR (roll)*/
 GF_Err stbl_SearchSAPs(GF_SampleTableBox *stbl, u32 SampleNumber, SAPType *IsRAP, u32 *prevRAP, u32 *nextRAP);
 GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offset, u32 *chunkNumber, u32 *descIndex, GF_StscEntry **scsc_entry);
+/*parses all sample tables deferred by a lazy open*/
+GF_Err stbl_LoadLazyTables(GF_SampleTableBox *stbl);
 GF_Err stbl_GetSampleShadow(GF_ShadowSyncBox *stsh, u32 *sampleNumber, u32 *syncNum);
 GF_Err stbl_GetPaddingBits(GF_PaddingBitsBox *padb, u32 SampleNumber, u8 *PadBits);
 GF_Err stbl_GetSampleDepType(GF_SampleDependencyTypeBox *stbl, u32 SampleNumber, u32 *isLeading, u32 *dependsOn, u32 *dependedOn, u32 *redundant);
@@ -4056,6 +4112,8 @@ GF_Err gf_isom_box_dump(void *ptr, FILE * trace);
 GF_Err gf_isom_box_array_dump(GF_List *list, FILE * trace);
 
 void gf_isom_registry_disable(u32 boxCode, Bool disable);
+/*builds the box registry index used when parsing boxes, called once by gf_sys_init*/
+void gf_isom_registry_init();
 
 /*Apple extensions*/
 GF_MetaBox *gf_isom_apple_get_meta_extensions(GF_ISOFile *mov);
@@ -79,9 +79,26 @@ typedef struct
 	u32 repeat_count;
 } GF_MPD_SegmentTimelineEntry;
 
+/*lookup index of a segment timeline entry*/
+typedef struct
+{
+	/*resolved start time of the entry*/
+	u64 start_time;
+	/*number of segments described by the previous entries*/
+	u32 first_segment;
+} GF_MPD_SegmentTimelineIndex;
+
 typedef struct
 {
 	GF_List *entries;
+
+	/*lookup index of the entries, built and updated by the gf_mpd_segment_timeline_* functions - do not modify*/
+	GF_MPD_SegmentTimelineIndex *index;
+	u32 nb_indexed, index_alloc;
+	/*repeat count of the last indexed entry, to detect updates of the last entry*/
+	u32 last_indexed_repeat;
+	/*set when segment start times are not increasing or a negative repeat count is used, lookups by time are then done entry by entry*/
+	Bool index_unordered;
 } GF_MPD_SegmentTimeline;
 
 typedef struct
@@ -461,6 +478,21 @@ GF_Err gf_mpd_get_segment_start_time_with_timescale(s32 in_segment_index,
 	GF_MPD_Period const * const in_period, GF_MPD_AdaptationSet const * const in_set, GF_MPD_Representation const * const in_rep,
 	u64 *out_segment_start_time, u64 *out_opt_segment_duration, u32 *out_opt_scale);
 
+/*segment timeline lookups, in O(log n) with n the number of entries in the timeline. Entries may be appended
+(or the repeat count of the last entry increased) between calls, any other modification of the timeline entries shall be followed
+by a call to gf_mpd_segment_timeline_reset_index. A negative repeat count is handled as an entry without segment*/
+
+/*gets the number of segments in the timeline and optionally the end time of the timeline*/
+u32 gf_mpd_segment_timeline_get_segment_count(GF_MPD_SegmentTimeline *timeline, u64 *end_time);
+/*gets start time and duration of the segment with the given 0-based index in the timeline. Returns GF_EOS if the segment is not in the timeline,
+in which case start_time is set to the end time of the timeline*/
+GF_Err gf_mpd_segment_timeline_get_segment(GF_MPD_SegmentTimeline *timeline, u32 segment_index, u64 *start_time, u32 *duration);
+/*gets the index and start time of the first segment starting at or after the given time, expressed in time_scale units - timeline_scale is the timescale of the timeline.
+Returns GF_EOS if no segment starts at or after the given time, in which case segment_index is the number of segments and segment_start the end time of the timeline*/
+GF_Err gf_mpd_segment_timeline_find_segment(GF_MPD_SegmentTimeline *timeline, u64 time, u64 time_scale, u64 timeline_scale, u32 *segment_index, u64 *segment_start);
+/*resets the lookup index of the timeline after entries have been removed or modified*/
+void gf_mpd_segment_timeline_reset_index(GF_MPD_SegmentTimeline *timeline);
+
 typedef enum {
 	MPD_SEEK_PREV,    /*will return the segment containing the requested time*/
 	MPD_SEEK_NEAREST, /*the nearest segment start time, may be the previous or the next one*/
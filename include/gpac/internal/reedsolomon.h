@@ -53,6 +53,9 @@ extern int RS_DEBUG;
 void initialize_ecc (void);
 int check_syndrome (void);
 void decode_data (unsigned char data[], int nbytes);
+/* number of interleaved codewords processed by decode_data_interleaved */
+#define RS_BLOCK_ROWS	16
+void decode_data_interleaved (unsigned char *cols[], int nbytes, unsigned char syn[]);
 void encode_data (unsigned char msg[], int nbytes, unsigned char dst[]);
 
 
@@ -67,6 +70,7 @@ int gmult(int a, int b);
 
 /* Error location routines */
 int correct_errors_erasures (unsigned char codeword[], int csize,int nerasures, int erasures[]);
+int correct_erasures (unsigned char codeword[], int csize, int nerasures, int erasures[]);
 
 /* polynomial arithmetic */
 void add_polys(int dst[], int src[]) ;
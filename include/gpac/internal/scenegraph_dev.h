@@ -126,6 +126,14 @@ typedef struct __tag_node_id
 	char *NodeName;
 } NodeIDedItem;
 
+/*indexes of the DEF node list*/
+enum
+{
+	SG_INDEX_ID = 0,
+	SG_INDEX_NAME,
+	SG_INDEX_NODE,
+};
+
 typedef struct
 {
 	char *name;
@@ -140,6 +148,12 @@ struct __tag_scene_graph
 
 	/*all DEF nodes (explicit)*/
 	NodeIDedItem *id_node, *id_node_last;
+	/*open-addressing (linear probing) indexes of the id_node list by ID, by name and by node (cf SG_INDEX_*),
+	sizes are powers of 2*/
+	NodeIDedItem **id_index[3];
+	u32 id_index_size[3], id_index_count[3];
+	/*number of DEF nodes reusing an ID already in the list*/
+	u32 nb_dup_ids;
 
 	/*pointer to the root node*/
 	GF_Node *RootNode;
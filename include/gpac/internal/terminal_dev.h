@@ -675,6 +675,9 @@ struct _es_channel
 	u32 AU_Count;
 	/*decoding buffers for push mode*/
 	struct _decoding_buffer * AU_buffer_first, * AU_buffer_last;
+	/*recycled decoding buffers for push mode: units still owning their data buffer, and units without data*/
+	struct _decoding_buffer * AU_pool, * AU_pool_units;
+	u32 AU_pool_count, AU_pool_bytes;
 	/*static decoding buffer for pull mode*/
 	struct _decoding_buffer * AU_buffer_pull;
 	char *pull_reaggregated_buffer;
@@ -81,6 +81,10 @@ enum
 	GF_ISOM_WRITE_EDIT,
 	/*Opens an existing file for fragment concatenation*/
 	GF_ISOM_OPEN_CAT_FRAGMENTS,
+	/*flag to combine with GF_ISOM_OPEN_READ or GF_ISOM_OPEN_READ_DUMP: large sample tables are only located when opening the file
+	and parsed on first access, reducing open time and memory usage when only some tracks or only the track summaries are used.
+	Ignored for other modes*/
+	GF_ISOM_OPEN_LAZY = 1<<8,
 };
 
 /*Movie Options for file writing*/
@@ -587,9 +591,8 @@ u64 gf_isom_get_file_size(GF_ISOFile *the_file);
 
 Bool gf_isom_moov_first(GF_ISOFile *movie);
 
-/*sets write cache size for files when creating them. If size is 0, writing
-only relies on the underlying OS fwrite/fgetc
-If movie is NULL, assigns the default write cache size for any new movie*/
+/*sets write cache size for files when creating them. If size is 0, a default 1 MB write-behind cache is used
+for new files. If movie is NULL, assigns the default write cache size for any new movie*/
 GF_Err gf_isom_set_output_buffering(GF_ISOFile *movie, u32 size);
 
 /********************************************************************
@@ -772,6 +775,15 @@ retrieved (faster)
 */
 GF_ISOSample *gf_isom_get_sample_info(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 *StreamDescriptionIndex, u64 *data_offset);
 
+/*loads in memory the media data of samples first_samples[i] to last_samples[i] of tracks[i], for nb_tracks tracks.
+The byte ranges of all samples are sorted by file offset, ranges close to each other are merged and each merged range is
+read at once. Sample data fetched afterwards in these ranges is copied from memory, until the next call to this function.
+Only data stored in the movie file of read-only files is prefetched.
+@max_size: maximum amount of data to load, 0 means no limit
+	  NOTE: calling with nb_tracks=0 discards all prefetched data
+*/
+GF_Err gf_isom_prefetch_samples(GF_ISOFile *the_file, u32 nb_tracks, u32 *tracks, u32 *first_samples, u32 *last_samples, u32 max_size);
+
 /*retrieves given sample DTS*/
 u64 gf_isom_get_sample_dts(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber);
 
@@ -1197,6 +1209,12 @@ GF_Err gf_isom_set_final_name(GF_ISOFile *the_file, char *filename);
 
 /*set the storage mode of a file (FLAT, STREAMABLE, INTERLEAVED)*/
 GF_Err gf_isom_set_storage_mode(GF_ISOFile *the_file, u8 storageMode);
+
+/*reserves reserved_size bytes at the head of a file created in GF_ISOM_OPEN_WRITE mode to store the moov box at close
+time, producing a fast-start file without rewriting the media data. reserved_size is an estimate of the final moov size,
+the unused space is kept as a free box; media data is only moved if the moov is larger than the estimate.
+Must be called before any sample is added; 0 disables the reservation*/
+GF_Err gf_isom_reserve_moov_space(GF_ISOFile *the_file, u32 reserved_size);
 u8 gf_isom_get_storage_mode(GF_ISOFile *the_file);
 
 /*set the interleaving time of media data (INTERLEAVED mode only)
@@ -945,6 +945,14 @@ GF_Err gf_dasher_set_cues(GF_DASHSegmenter *dasher, const char *cues_file, Bool
  */
 GF_Err gf_dasher_set_isobmff_options(GF_DASHSegmenter *dasher, Bool mvex_after_traks);
 
+/*!
+ Enables HLS playlist generation along with the MPD. The master playlist is named after the MPD with a .m3u8 extension, and one media playlist is generated per representation, referring to the same segments (or byte ranges) as the MPD.
+ *	\param dasher the DASH segmenter object
+ *	\param enable if true, HLS master and media playlists are generated. Default is disabled.
+ *	\return error code if any
+ */
+GF_Err gf_dasher_enable_hls(GF_DASHSegmenter *dasher, Bool enable);
+
 /*!
  Adds a media input to the DASHer
  *	\param dasher the DASH segmenter object
@@ -1089,6 +1097,14 @@ typedef struct __track_exporter
  */
 GF_Err gf_media_export(GF_MediaExporter *dump);
 
+/*!
+  Dumps several tracks of the same file in a single pass. Samples are read in file order and written by one thread per track. Tracks which cannot be exported sample by sample (non-native, merged or piped exports) are dumped one after the other.
+ \param dumpers the track dumper objects, all using the same source file
+ \param nb_dumpers the number of track dumper objects
+ \return  error if any
+ */
+GF_Err gf_media_export_tracks(GF_MediaExporter *dumpers, u32 nb_dumpers);
+
 GF_Err gf_media_export_nhml(GF_MediaExporter *dumper, Bool dims_doc);
 
 #ifndef GPAC_DISABLE_VTT
@@ -1148,6 +1164,17 @@ void gf_hinter_track_del(GF_RTPHinter *tkHinter);
  */
 GF_Err gf_hinter_track_process(GF_RTPHinter *tkHinter);
 
+/*!
+ hints all samples of several media tracks of the same file, using parallel threads. The resulting file is identical to
+ the one obtained by calling \ref gf_hinter_track_process on each hinter in order
+ \param hinters track hinter objects, all created on the same file
+ \param nb_hinters number of track hinter objects
+ \param nb_threads max number of tracks hinted at once. If 0 or 1, tracks are hinted sequentially
+ \param track_errors optional array of nb_hinters error codes receiving the result of each track
+ \return first error encountered if any
+ */
+GF_Err gf_hinter_tracks_process(GF_RTPHinter **hinters, u32 nb_hinters, u32 nb_threads, GF_Err *track_errors);
+
 /*!
  Gets media bandwidth in kbps
  \param tkHinter track hinter object
@@ -1228,6 +1255,16 @@ Bool gf_hinter_can_embbed_data(char *data, u32 data_size, u32 streamType);
 
 /*! SAF Multiplexer object. The multiplexer supports concurencial (multi-threaded) access*/
 typedef struct __saf_muxer GF_SAFMuxer;
+
+/*! SAF output chunk, as produced by \ref gf_saf_mux_for_time_vec*/
+typedef struct
+{
+	/*! chunk data*/
+	char *data;
+	/*! chunk size in bytes*/
+	u32 size;
+} GF_SAFChunk;
+
 /*!
 	Creates a new SAF Multiplexer
  \return the SAF multiplexer object
@@ -1265,7 +1302,7 @@ GF_Err gf_saf_mux_stream_add(GF_SAFMuxer *mux, u32 stream_id, u32 ts_res, u32 bu
 GF_Err gf_saf_mux_stream_rem(GF_SAFMuxer *mux, u32 stream_id);
 
 /*!
- adds an AU to the given Warning, AU data will be freed by the multiplexer. AUs are NOT re-sorted by CTS, in order to enable audio interleaving.
+ adds an AU to the given stream. The multiplexer takes ownership of the AU data, which is not copied and will be freed by the multiplexer. AUs are NOT re-sorted by CTS, in order to enable audio interleaving.
  \param mux the SAF multiplexer object
  \param stream_id ID of the SAF stream to remove
  \param CTS composition timestamp of the AU
@@ -1287,6 +1324,24 @@ GF_Err gf_saf_mux_add_au(GF_SAFMuxer *mux, u32 stream_id, u32 CTS, char *data, u
  */
 GF_Err gf_saf_mux_for_time(GF_SAFMuxer *mux, u32 time_ms, Bool force_end_of_session, char **out_data, u32 *out_size);
 
+/*!
+  Gets the content of the multiplexer for the given time as a list of chunks, without copying AU payloads. The chunks point to SAF packet headers owned by the multiplexer and to the AU data passed to \ref gf_saf_mux_add_au. They are valid until the next call to this function, to \ref gf_saf_mux_for_time or to \ref gf_saf_mux_del; the AU data is released at that time.
+ \param mux the SAF multiplexer object
+ \param time_ms target mux time in ms
+ \param force_end_of_session if set to GF_TRUE, this flushes the SAF Session - no more operations will be allowed on the muxer
+ \param out_chunks output SAF chunks, to be written in order - NULL if nothing to write
+ \param out_nb_chunks number of output SAF chunks
+ \return error if any
+ */
+GF_Err gf_saf_mux_for_time_vec(GF_SAFMuxer *mux, u32 time_ms, Bool force_end_of_session, const GF_SAFChunk **out_chunks, u32 *out_nb_chunks);
+
+/*!
+  Requests all stream declarations to be sent again at the next multiplexing call, for carousel repetitions. Declarations are serialized once and reused.
+ \param mux the SAF multiplexer object
+ \return error if any
+ */
+GF_Err gf_saf_mux_repeat_headers(GF_SAFMuxer *mux);
+
 
 #ifdef __cplusplus
 }
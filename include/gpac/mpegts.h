@@ -730,6 +730,8 @@ typedef struct tag_m2ts_pes
 	unsigned char *prev_data;
 	/*number of bytes not consumed from previous PES - shall be less than 9*/
 	u32 prev_data_len;
+	/*amount of bytes allocated for prev_data*/
+	u32 prev_alloc_len;
 
 	u32 pes_start_packet_number;
 	/* PCR info related to the PES start */
@@ -1214,6 +1216,9 @@ typedef struct __m2ts_mux_stream {
 	u32 last_aac_time;
 	/*list of GF_M2TSDescriptor to add to the MPEG-2 stream. By default set to NULL*/
 	GF_List *loop_descriptors;
+
+	/*scheduler: 1-based position in the muxer heap (0 if not in the heap) and rank of the stream in program order*/
+	u32 sched_heap_pos, sched_order;
 } GF_M2TS_Mux_Stream;
 
 enum {
@@ -1339,6 +1344,19 @@ struct __m2ts_mux {
 	Bool flush_pes_at_rap;
 	/*cf enum above*/
 	u32 force_pat_pmt_state;
+
+	/*scheduler: PES streams in the middle of a packet, ordered by next send time*/
+	GF_M2TS_Mux_Stream **sched_heap;
+	u32 sched_heap_count;
+	/*scheduler: all other streams, processed at each call in program order*/
+	GF_M2TS_Mux_Stream **sched_poll;
+	u32 sched_poll_count;
+	u32 sched_alloc, sched_nb_streams;
+	/*set when programs or streams are added or the mux is reconfigured*/
+	Bool sched_reset;
+	/*earliest PMT send time, if valid*/
+	GF_M2TS_Time sched_pmt_time;
+	Bool sched_pmt_time_valid;
 };
 
 
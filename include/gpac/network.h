@@ -302,6 +302,21 @@ GF_Err gf_sk_connect(GF_Socket *sock, const char *peer_name, u16 port, const cha
  *\param length the data length to send
  */
 GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length);
+
+/*!
+ *\brief maximum number of datagrams sent in a single system call by \ref gf_sk_send_multi
+ */
+#define GF_SK_SEND_MULTI_MAX	64
+/*!
+ *\brief batched data emission
+ *
+ *Sends several buffers on the socket. The socket must be in a bound or connected mode. For UDP sockets, each buffer is sent as a separate datagram, and the datagrams are pushed in as few system calls as possible (sendmmsg on Linux).
+ *\param sock the socket object
+ *\param buffers the data buffers to send
+ *\param lengths the data lengths to send
+ *\param nb_buffers the number of buffers to send
+ */
+GF_Err gf_sk_send_multi(GF_Socket *sock, char **buffers, u32 *lengths, u32 nb_buffers);
 /*!
  *\brief data reception
  *
@@ -150,6 +150,13 @@ GF_Err gf_rtp_streamer_send_rtcp(GF_RTPStreamer *streamer, Bool force_ts, u32 rt
 
 u8 gf_rtp_streamer_get_payload_type(GF_RTPStreamer *streamer);
 
+/*enables batched emission: up to max_packets RTP packets are formed in memory and sent in one go, either when the batch is full or
+when \ref gf_rtp_streamer_flush is called. 0 or 1 disables batching (default), in which case each packet is sent as soon as it is formed*/
+GF_Err gf_rtp_streamer_set_batch(GF_RTPStreamer *streamer, u32 max_packets);
+
+/*sends all packets pending in the batch, if any*/
+GF_Err gf_rtp_streamer_flush(GF_RTPStreamer *streamer);
+
 /*! @} */
 
 #ifdef __cplusplus
@@ -116,6 +116,8 @@ typedef struct
 	u32 min_buffer, max_buffer;
 	/*number of AUs in DB (cumulated on all input channels)*/
 	u32 db_unit_count;
+	/*number of AU buffers kept for reuse and their allocated size in bytes (cumulated on all input channels)*/
+	u32 db_pool_count, db_pool_size;
 	/*number of CUs in composition memory (if any) and CM capacity*/
 	u16 cb_unit_count, cb_max_count;
 	/*inidciate that thye composition memory is bypassed for this decoder (video only) */
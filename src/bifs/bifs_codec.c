@@ -300,7 +300,10 @@ GF_BifsEncoder *gf_bifs_encoder_new(GF_SceneGraph *graph)
 	tmp->QPs = gf_list_new();
 	tmp->streamInfo = gf_list_new();
 	tmp->info = NULL;
-	tmp->encoded_nodes = gf_list_new();
+	tmp->encoded_nodes = gf_bifs_enc_node_set_new();
+	tmp->cache_stack = gf_list_new();
+	tmp->cache_qps = gf_list_new();
+	tmp->cache_visited = gf_bifs_enc_node_set_new();
 	tmp->scene_graph = graph;
 	return tmp;
 }
@@ -329,7 +332,11 @@ void gf_bifs_encoder_del(GF_BifsEncoder *codec)
 		gf_list_rem(codec->streamInfo, 0);
 	}
 	gf_list_del(codec->streamInfo);
-	gf_list_del(codec->encoded_nodes);
+	gf_bifs_enc_node_set_del(codec->encoded_nodes);
+	gf_bifs_enc_cache_reset(codec);
+	gf_list_del(codec->cache_stack);
+	gf_list_del(codec->cache_qps);
+	gf_bifs_enc_node_set_del(codec->cache_visited);
 	if (codec->src_url) gf_free(codec->src_url);
 //	gf_mx_del(codec->mx);
 	gf_free(codec);
@@ -487,6 +494,27 @@ GF_Err gf_bifs_encoder_set_source_url(GF_BifsEncoder *codec, const char *src_url
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_bifs_encoder_set_node_cache(GF_BifsEncoder *codec, Bool enable)
+{
+	if (!codec) return GF_BAD_PARAM;
+	codec->use_node_cache = enable;
+	if (!enable) gf_bifs_enc_cache_reset(codec);
+	return GF_OK;
+}
+
+GF_EXPORT
+void gf_bifs_encoder_node_modified(GF_BifsEncoder *codec, GF_Node *node)
+{
+	if (!codec || !node || !codec->node_cache_count) return;
+	/*a QP change impacts the encoding of all nodes in its scope*/
+	if ((gf_node_get_tag(node) == TAG_MPEG4_QuantizationParameter) && (gf_list_find(codec->cache_qps, node) >= 0)) {
+		gf_bifs_enc_cache_reset(codec);
+		return;
+	}
+	gf_bifs_enc_cache_invalidate(codec, node);
+}
+
 
 #endif /*GPAC_DISABLE_BIFS_ENC*/
 
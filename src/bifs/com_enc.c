@@ -852,7 +852,7 @@ GF_Err gf_bifs_enc_commands(GF_BifsEncoder *codec, GF_List *comList, GF_BitStrea
 		case GF_SG_SCENE_REPLACE:
 		{
 			/*reset node context*/
-			while (gf_list_count(codec->encoded_nodes)) gf_list_rem(codec->encoded_nodes, 0);
+			gf_bifs_enc_node_set_reset(codec->encoded_nodes);
 			GF_BIFS_WRITE_INT(codec, bs, 3, 2, "SceneReplace", NULL);
 
 			if (!com->aggregated) {
@@ -959,11 +959,11 @@ GF_Err gf_bifs_encoder_get_rap(GF_BifsEncoder *codec, char **out_data, u32 *out_
 {
 	GF_BitStream *bs;
 	GF_Err e;
-	GF_List *ctx_bck;
+	BIFSNodeSet *ctx_bck;
 
 	/*reset context for RAP encoding*/
 	ctx_bck = codec->encoded_nodes;
-	codec->encoded_nodes = gf_list_new();
+	codec->encoded_nodes = gf_bifs_enc_node_set_new();
 
 	if (!codec->info) codec->info = (BIFSStreamInfo*)gf_list_get(codec->streamInfo, 0);
 
@@ -977,7 +977,7 @@ GF_Err gf_bifs_encoder_get_rap(GF_BifsEncoder *codec, char **out_data, u32 *out_
 	gf_bs_del(bs);
 
 	/*restore context*/
-	gf_list_del(codec->encoded_nodes);
+	gf_bifs_enc_node_set_del(codec->encoded_nodes);
 	codec->encoded_nodes = ctx_bck;
 
 	return e;
@@ -544,25 +544,359 @@ exit:
 	return e;
 }
 
+/*subtrees smaller than this are not worth caching*/
+#define BIFS_CACHE_MIN_BITS	64
+
+static GFINLINE u32 bifs_cache_hash(GF_Node *node)
+{
+	u64 v = (u64) (PTR_TO_U_CAST node);
+	return ((u32) (v>>4) ^ (u32) (v>>32)) * 2654435761U;
+}
+
+BIFSNodeSet *gf_bifs_enc_node_set_new()
+{
+	BIFSNodeSet *set;
+	GF_SAFEALLOC(set, BIFSNodeSet);
+	return set;
+}
+
+void gf_bifs_enc_node_set_del(BIFSNodeSet *set)
+{
+	if (!set) return;
+	if (set->nodes) gf_free(set->nodes);
+	gf_free(set);
+}
+
+void gf_bifs_enc_node_set_reset(BIFSNodeSet *set)
+{
+	if (set->count) memset(set->nodes, 0, sizeof(GF_Node *) * set->size);
+	set->count = 0;
+}
+
+static Bool bifs_node_set_has(BIFSNodeSet *set, GF_Node *node)
+{
+	u32 pos, mask;
+	if (!set->count) return GF_FALSE;
+	mask = set->size - 1;
+	pos = bifs_cache_hash(node) & mask;
+	while (set->nodes[pos]) {
+		if (set->nodes[pos] == node) return GF_TRUE;
+		pos = (pos+1) & mask;
+	}
+	return GF_FALSE;
+}
+
+static void bifs_node_set_put(GF_Node **nodes, u32 size, GF_Node *node)
+{
+	u32 mask = size - 1;
+	u32 pos = bifs_cache_hash(node) & mask;
+	while (nodes[pos]) pos = (pos+1) & mask;
+	nodes[pos] = node;
+}
+
+/*node shall not be in the set*/
+static void bifs_node_set_add(BIFSNodeSet *set, GF_Node *node)
+{
+	if (2*(set->count+1) > set->size) {
+		u32 i, new_size = set->size ? 2*set->size : 64;
+		GF_Node **nodes = (GF_Node **)gf_malloc(sizeof(GF_Node *) * new_size);
+		if (!nodes) return;
+		memset(nodes, 0, sizeof(GF_Node *) * new_size);
+		for (i=0; i<set->size; i++) {
+			if (set->nodes[i]) bifs_node_set_put(nodes, new_size, set->nodes[i]);
+		}
+		if (set->nodes) gf_free(set->nodes);
+		set->nodes = nodes;
+		set->size = new_size;
+	}
+	bifs_node_set_put(set->nodes, set->size, node);
+	set->count++;
+}
+
+static void bifs_cache_entry_del(BIFSNodeCache *nc)
+{
+	if (nc->bs) gf_bs_del(nc->bs);
+	if (nc->uses) gf_free(nc->uses);
+	if (nc->data) gf_free(nc->data);
+	gf_free(nc);
+}
+
+static BIFSNodeCache *bifs_cache_find(GF_BifsEncoder *codec, GF_Node *node)
+{
+	u32 pos, mask;
+	if (!codec->node_cache_count) return NULL;
+	mask = codec->node_cache_size - 1;
+	pos = bifs_cache_hash(node) & mask;
+	while (codec->node_cache[pos]) {
+		if (codec->node_cache[pos]->node == node) return codec->node_cache[pos];
+		pos = (pos+1) & mask;
+	}
+	return NULL;
+}
+
+static void bifs_cache_remove(GF_BifsEncoder *codec, GF_Node *node)
+{
+	u32 hole, next, home, mask;
+	if (!codec->node_cache_count) return;
+	mask = codec->node_cache_size - 1;
+	hole = bifs_cache_hash(node) & mask;
+	while (codec->node_cache[hole] && (codec->node_cache[hole]->node != node)) {
+		hole = (hole+1) & mask;
+	}
+	if (!codec->node_cache[hole]) return;
+	bifs_cache_entry_del(codec->node_cache[hole]);
+	codec->node_cache[hole] = NULL;
+	codec->node_cache_count--;
+
+	/*backward shift deletion*/
+	next = (hole+1) & mask;
+	while (codec->node_cache[next]) {
+		Bool move;
+		home = bifs_cache_hash(codec->node_cache[next]->node) & mask;
+		if (hole <= next) move = ((home <= hole) || (home > next)) ? GF_TRUE : GF_FALSE;
+		else move = ((home <= hole) && (home > next)) ? GF_TRUE : GF_FALSE;
+		if (move) {
+			codec->node_cache[hole] = codec->node_cache[next];
+			codec->node_cache[next] = NULL;
+			hole = next;
+		}
+		next = (next+1) & mask;
+	}
+}
+
+static void bifs_cache_put(BIFSNodeCache **table, u32 size, BIFSNodeCache *nc)
+{
+	u32 mask = size - 1;
+	u32 pos = bifs_cache_hash(nc->node) & mask;
+	while (table[pos]) pos = (pos+1) & mask;
+	table[pos] = nc;
+}
+
+static void bifs_cache_insert(GF_BifsEncoder *codec, BIFSNodeCache *nc)
+{
+	/*keep load factor below 1/2*/
+	if (2*(codec->node_cache_count+1) > codec->node_cache_size) {
+		u32 i, new_size = codec->node_cache_size ? 2*codec->node_cache_size : 256;
+		BIFSNodeCache **table = (BIFSNodeCache **)gf_malloc(sizeof(BIFSNodeCache *) * new_size);
+		if (!table) {
+			bifs_cache_entry_del(nc);
+			return;
+		}
+		memset(table, 0, sizeof(BIFSNodeCache *) * new_size);
+		for (i=0; i<codec->node_cache_size; i++) {
+			if (codec->node_cache[i]) bifs_cache_put(table, new_size, codec->node_cache[i]);
+		}
+		if (codec->node_cache) gf_free(codec->node_cache);
+		codec->node_cache = table;
+		codec->node_cache_size = new_size;
+	}
+	bifs_cache_put(codec->node_cache, codec->node_cache_size, nc);
+	codec->node_cache_count++;
+}
+
+void gf_bifs_enc_cache_reset(GF_BifsEncoder *codec)
+{
+	u32 i;
+	for (i=0; i<codec->node_cache_size; i++) {
+		if (codec->node_cache[i]) bifs_cache_entry_del(codec->node_cache[i]);
+	}
+	if (codec->node_cache) gf_free(codec->node_cache);
+	codec->node_cache = NULL;
+	codec->node_cache_size = codec->node_cache_count = 0;
+	gf_list_reset(codec->cache_qps);
+}
+
+/*walks each ancestor once, a node USEd several times would otherwise have its ancestors walked once per path*/
+static void bifs_cache_invalidate_node(GF_BifsEncoder *codec, GF_Node *node)
+{
+	GF_ParentList *par;
+	if (bifs_node_set_has(codec->cache_visited, node)) return;
+	bifs_node_set_add(codec->cache_visited, node);
+	bifs_cache_remove(codec, node);
+	par = node->sgprivate->parents;
+	while (par) {
+		bifs_cache_invalidate_node(codec, par->node);
+		par = par->next;
+	}
+}
+
+/*drops the cached encoding of the node and of all subtrees containing it*/
+void gf_bifs_enc_cache_invalidate(GF_BifsEncoder *codec, GF_Node *node)
+{
+	if (!codec->node_cache_count) return;
+	bifs_cache_invalidate_node(codec, node);
+	gf_bifs_enc_node_set_reset(codec->cache_visited);
+}
+
+/*logs a DEF/USE decision in all subtrees being recorded*/
+static void bifs_cache_record_use(GF_BifsEncoder *codec, GF_Node *node, Bool is_use)
+{
+	u32 i, count = gf_list_count(codec->cache_stack);
+	for (i=0; i<count; i++) {
+		BIFSNodeCache *nc = (BIFSNodeCache *)gf_list_get(codec->cache_stack, i);
+		if (nc->nb_uses == nc->alloc_uses) {
+			nc->alloc_uses = nc->alloc_uses ? 2*nc->alloc_uses : 8;
+			nc->uses = (BIFSCachedUse *)gf_realloc(nc->uses, sizeof(BIFSCachedUse) * nc->alloc_uses);
+		}
+		nc->uses[nc->nb_uses].node = node;
+		nc->uses[nc->nb_uses].is_use = is_use;
+		nc->nb_uses++;
+	}
+}
+
+/*nodes whose encoding may change without modification notification from the scene graph, or depending on
+external data or commands, are never cached*/
+static Bool bifs_cache_node_allowed(GF_Node *node)
+{
+	switch (node->sgprivate->tag) {
+	case TAG_ProtoNode:
+	case TAG_MPEG4_CacheTexture:
+	case TAG_MPEG4_Conditional:
+	case TAG_MPEG4_InputSensor:
+	case TAG_MPEG4_ColorInterpolator:
+	case TAG_MPEG4_CoordinateInterpolator:
+	case TAG_MPEG4_CoordinateInterpolator2D:
+	case TAG_MPEG4_NormalInterpolator:
+	case TAG_MPEG4_OrientationInterpolator:
+	case TAG_MPEG4_PositionInterpolator:
+	case TAG_MPEG4_PositionInterpolator2D:
+	case TAG_MPEG4_ScalarInterpolator:
+	case TAG_MPEG4_Valuator:
+	case TAG_MPEG4_PositionInterpolator4D:
+	case TAG_MPEG4_CoordinateInterpolator4D:
+	case TAG_MPEG4_Script:
+	case TAG_MPEG4_PositionAnimator:
+	case TAG_MPEG4_PositionAnimator2D:
+	case TAG_MPEG4_ScalarAnimator:
+		return GF_FALSE;
+	}
+	return GF_TRUE;
+}
+
+static Bool bifs_cache_match(GF_BifsEncoder *codec, BIFSNodeCache *nc, u32 NDT_Tag)
+{
+	u32 i, j;
+	if ((nc->info != codec->info) || (nc->NDT_Tag != NDT_Tag) || (nc->UseName != codec->UseName)) return GF_FALSE;
+	if ((nc->qp != codec->ActiveQP) || (nc->nb_qps != gf_list_count(codec->QPs)) || (nc->qp_top != gf_list_get(codec->QPs, 0)))
+		return GF_FALSE;
+	if ((nc->num_coord_in != codec->NumCoord) || (nc->coord_stored_in != codec->coord_stored) || (nc->storing_coord_in != codec->storing_coord))
+		return GF_FALSE;
+
+	/*all DEF/USE decisions must be the same*/
+	for (i=0; i<nc->nb_uses; i++) {
+		GF_Node *n = nc->uses[i].node;
+		Bool is_use = bifs_node_set_has(codec->encoded_nodes, n);
+		/*node DEF'ed previously in the subtree*/
+		if (!is_use && nc->uses[i].is_use) {
+			for (j=0; j<i; j++) {
+				if ((nc->uses[j].node == n) && !nc->uses[j].is_use) {
+					is_use = GF_TRUE;
+					break;
+				}
+			}
+		}
+		if (is_use != nc->uses[i].is_use) return GF_FALSE;
+	}
+	return GF_TRUE;
+}
+
+static void bifs_cache_write(GF_BitStream *bs, char *data, u32 nb_bits)
+{
+	u32 nb_bytes = nb_bits / 8;
+	u32 rem = nb_bits % 8;
+	if (nb_bytes) gf_bs_write_data(bs, data, nb_bytes);
+	if (rem) gf_bs_write_int(bs, ((u8) data[nb_bytes]) >> (8 - rem), rem);
+}
+
 Bool BE_NodeIsUSE(GF_BifsEncoder * codec, GF_Node *node)
 {
-	u32 i, count;
+	Bool is_use;
 	if (!node || !gf_node_get_id(node) ) return GF_FALSE;
-	count = gf_list_count(codec->encoded_nodes);
-	for (i=0; i<count; i++) {
-		if (gf_list_get(codec->encoded_nodes, i) == node) return GF_TRUE;
+	is_use = bifs_node_set_has(codec->encoded_nodes, node);
+	if (!is_use) bifs_node_set_add(codec->encoded_nodes, node);
+	if (gf_list_count(codec->cache_stack)) bifs_cache_record_use(codec, node, is_use);
+	return is_use;
+}
+
+static GF_Err BE_EncNodeDef(GF_BifsEncoder * codec, GF_Node *node, u32 NDT_Tag, GF_BitStream *bs, GF_Node *parent_node);
+
+/*encodes the node through the subtree cache*/
+static GF_Err BE_EncNodeCached(GF_BifsEncoder * codec, GF_Node *node, u32 NDT_Tag, GF_BitStream *bs, GF_Node *parent_node)
+{
+	GF_Err e;
+	u32 i, size;
+	BIFSNodeCache *nc;
+
+	if (!bifs_cache_node_allowed(node)) {
+		/*enclosing subtrees cannot be cached either*/
+		for (i=0; i<gf_list_count(codec->cache_stack); i++) {
+			nc = (BIFSNodeCache *)gf_list_get(codec->cache_stack, i);
+			nc->no_cache = GF_TRUE;
+		}
+		return BE_EncNodeDef(codec, node, NDT_Tag, bs, parent_node);
 	}
-	gf_list_add(codec->encoded_nodes, node);
-	return GF_FALSE;
+
+	nc = bifs_cache_find(codec, node);
+	if (nc && bifs_cache_match(codec, nc, NDT_Tag)) {
+		/*replay DEF/USE context*/
+		for (i=0; i<nc->nb_uses; i++) {
+			if (!nc->uses[i].is_use) bifs_node_set_add(codec->encoded_nodes, nc->uses[i].node);
+			if (gf_list_count(codec->cache_stack)) bifs_cache_record_use(codec, nc->uses[i].node, nc->uses[i].is_use);
+		}
+		bifs_cache_write(bs, nc->data, nc->nb_bits);
+		codec->NumCoord = nc->num_coord_out;
+		codec->coord_stored = nc->coord_stored_out;
+		codec->storing_coord = nc->storing_coord_out;
+		return GF_OK;
+	}
+	if (nc) bifs_cache_remove(codec, node);
+
+	GF_SAFEALLOC(nc, BIFSNodeCache);
+	if (!nc) return BE_EncNodeDef(codec, node, NDT_Tag, bs, parent_node);
+	nc->node = node;
+	nc->info = codec->info;
+	nc->NDT_Tag = NDT_Tag;
+	nc->UseName = codec->UseName;
+	nc->qp = codec->ActiveQP;
+	nc->nb_qps = gf_list_count(codec->QPs);
+	nc->qp_top = (M_QuantizationParameter *)gf_list_get(codec->QPs, 0);
+	nc->num_coord_in = codec->NumCoord;
+	nc->coord_stored_in = codec->coord_stored;
+	nc->storing_coord_in = codec->storing_coord;
+	nc->bs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
+
+	gf_list_add(codec->cache_stack, nc);
+	e = BE_EncNodeDef(codec, node, NDT_Tag, nc->bs, parent_node);
+	gf_list_rem_last(codec->cache_stack);
+
+	nc->nb_bits = gf_bs_get_bit_offset(nc->bs);
+	gf_bs_get_content(nc->bs, &nc->data, &size);
+	gf_bs_del(nc->bs);
+	nc->bs = NULL;
+	/*copy even on error, as done when encoding directly in the output*/
+	if (nc->nb_bits) bifs_cache_write(bs, nc->data, nc->nb_bits);
+
+	/*the QP context must be the same when leaving the subtree*/
+	if ((nc->qp != codec->ActiveQP) || (nc->nb_qps != gf_list_count(codec->QPs)))
+		nc->no_cache = GF_TRUE;
+
+	if (e || nc->no_cache || (nc->nb_bits < BIFS_CACHE_MIN_BITS)) {
+		bifs_cache_entry_del(nc);
+		return e;
+	}
+	nc->num_coord_out = codec->NumCoord;
+	nc->coord_stored_out = codec->coord_stored;
+	nc->storing_coord_out = codec->storing_coord;
+	if (nc->qp && (gf_list_find(codec->cache_qps, nc->qp) < 0)) gf_list_add(codec->cache_qps, nc->qp);
+	if (nc->qp_top && (gf_list_find(codec->cache_qps, nc->qp_top) < 0)) gf_list_add(codec->cache_qps, nc->qp_top);
+	bifs_cache_insert(codec, nc);
+	return GF_OK;
 }
 
 GF_Err gf_bifs_enc_node(GF_BifsEncoder * codec, GF_Node *node, u32 NDT_Tag, GF_BitStream *bs, GF_Node *parent_node)
 {
-	u32 NDTBits, node_type, node_tag, BVersion, node_id;
-	const char *node_name;
-	Bool flag, reset_qp14;
+	Bool flag;
 	GF_Node *new_node;
-	GF_Err e;
 
 	assert(codec->info);
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_CODEC, ("[BIFS] Encode node %s\n", gf_node_get_class_name(node) ));
@@ -605,6 +939,19 @@ GF_Err gf_bifs_enc_node(GF_BifsEncoder * codec, GF_Node *node, u32 NDT_Tag, GF_B
 		return GF_OK;
 	}
 
+	if (codec->use_node_cache && !codec->encoding_proto && !codec->current_proto_graph)
+		return BE_EncNodeCached(codec, node, NDT_Tag, bs, parent_node);
+
+	return BE_EncNodeDef(codec, node, NDT_Tag, bs, parent_node);
+}
+
+static GF_Err BE_EncNodeDef(GF_BifsEncoder * codec, GF_Node *node, u32 NDT_Tag, GF_BitStream *bs, GF_Node *parent_node)
+{
+	u32 NDTBits, node_type, node_tag, BVersion, node_id;
+	const char *node_name;
+	Bool reset_qp14;
+	GF_Err e;
+
 	BVersion = GF_BIFS_V1;
 	node_tag = node->sgprivate->tag;
 	while (1) {
@@ -25,15 +25,32 @@
 
 #include <gpac/internal/compositor_dev.h>
 
+#if defined(WIN32) && !defined(__GNUC__)
+# include <intrin.h>
+# define GPAC_HAS_SSE2
+#else
+# ifdef __SSE2__
+#  include <emmintrin.h>
+#  define GPAC_HAS_SSE2
+# endif
+#endif
+
 /*max number of channels we support in mixer*/
 #define GF_SR_MAX_CHANNELS	24
 
+/*polyphase resampler: number of taps of each filter phase (multiple of 4) and number of phases*/
+#define GF_SR_RESAMPLE_TAPS	16
+#define GF_SR_RESAMPLE_PHASES	256
+
 /*
 	Notes about the mixer:
 	1- spatialization is out of scope for the mixer (eg that's the sound node responsability)
 	2- mixing is performed by resampling input source & deinterleaving its channels into dedicated buffer.
 	We could directly deinterleave in the main mixer ouput buffer, but this would prevent any future
 	gain correction.
+	3- all processing is done on planar s32 buffers: conversion from the input format, resampling, channel mapping
+	and gain write the input channel buffers, which are then summed in the planar mixer buffer before being
+	interleaved in the output format.
 */
 typedef struct
 {
@@ -45,8 +62,8 @@ typedef struct
 
 	u32 bytes_per_sec;
 
+	/*resampler history is valid*/
 	Bool has_prev;
-	s32 last_channels[GF_SR_MAX_CHANNELS];
 
 	u32 in_bytes_used, out_samples_written, out_samples_to_write;
 
@@ -54,6 +71,15 @@ typedef struct
 	Fixed pan[6];
 
 	Bool muted;
+
+	/*polyphase resampler state: input history (each sample written twice so that the last GF_SR_RESAMPLE_TAPS
+	samples are always contiguous), filter bank, input step and position of next output sample (32.32 fixed point)*/
+	Float *rs_hist;
+	u32 rs_hist_pos, rs_hist_ch;
+	Float *rs_coefs;
+	u32 rs_in_sr, rs_out_sr;
+	Fixed rs_speed;
+	u64 rs_step, rs_pos;
 } MixerInput;
 
 struct __audiomix
@@ -74,10 +100,22 @@ struct __audiomix
 	/*set to non null if this outputs directly to the driver, in which case audio formats have to be checked*/
 	struct _audio_render *ar;
 
+	/*planar mix buffer*/
 	s32 *output;
 	u32 output_size;
 };
 
+static void gf_mixer_input_del(MixerInput *in)
+{
+	u32 j;
+	for (j=0; j<GF_SR_MAX_CHANNELS; j++) {
+		if (in->ch_buf[j]) gf_free(in->ch_buf[j]);
+	}
+	if (in->rs_hist) gf_free(in->rs_hist);
+	if (in->rs_coefs) gf_free(in->rs_coefs);
+	gf_free(in);
+}
+
 GF_EXPORT
 GF_AudioMixer *gf_mixer_new(struct _audio_render *ar)
 {
@@ -114,15 +152,11 @@ void gf_mixer_del(GF_AudioMixer *am)
 
 void gf_mixer_remove_all(GF_AudioMixer *am)
 {
-	u32 j;
 	gf_mixer_lock(am, GF_TRUE);
 	while (gf_list_count(am->sources)) {
 		MixerInput *in = (MixerInput *)gf_list_get(am->sources, 0);
 		gf_list_rem(am->sources, 0);
-		for (j=0; j<GF_SR_MAX_CHANNELS; j++) {
-			if (in->ch_buf[j]) gf_free(in->ch_buf[j]);
-		}
-		gf_free(in);
+		gf_mixer_input_del(in);
 	}
 	am->isEmpty = GF_TRUE;
 	gf_mixer_lock(am, GF_FALSE);
@@ -191,7 +225,7 @@ void gf_mixer_add_input(GF_AudioMixer *am, GF_AudioInterface *src)
 
 void gf_mixer_remove_input(GF_AudioMixer *am, GF_AudioInterface *src)
 {
-	u32 i, j, count;
+	u32 i, count;
 	if (am->isEmpty) return;
 	gf_mixer_lock(am, GF_TRUE);
 	count = gf_list_count(am->sources);
@@ -199,10 +233,7 @@ void gf_mixer_remove_input(GF_AudioMixer *am, GF_AudioInterface *src)
 		MixerInput *in = (MixerInput *)gf_list_get(am->sources, i);
 		if (in->src != src) continue;
 		gf_list_rem(am->sources, i);
-		for (j=0; j<GF_SR_MAX_CHANNELS; j++) {
-			if (in->ch_buf[j]) gf_free(in->ch_buf[j]);
-		}
-		gf_free(in);
+		gf_mixer_input_del(in);
 		break;
 	}
 	am->isEmpty = gf_list_count(am->sources) ? GF_FALSE : GF_TRUE;
@@ -331,7 +362,6 @@ Bool gf_mixer_reconfig(GF_AudioMixer *am)
 		/*cfg has changed, we must reconfig everything*/
 		if (cfg_changed || (max_sample_rate != am->sample_rate) ) {
 			in->has_prev = GF_FALSE;
-			memset(&in->last_channels, 0, sizeof(s32)*GF_SR_MAX_CHANNELS);
 		}
 	}
 
@@ -498,137 +528,285 @@ static GFINLINE s32 make_s24_int(u8 *ptr)
 	return (((s32)res) << 8 ) | ptr[0];
 }
 
+/*converts nb_samp interleaved input samples to planar s32, starting at offset in the channel buffers*/
+static void gf_mixer_convert_input(s32 **ch_buf, u32 offset, char *data, u32 bps, u32 nb_ch, u32 nb_samp)
+{
+	u32 i, j;
+	i = 0;
+	if (bps == 16) {
+		s16 *in_s16 = (s16 *)data;
+#ifdef GPAC_HAS_SSE2
+		if (nb_ch==2) {
+			s32 *left = ch_buf[0] + offset;
+			s32 *right = ch_buf[1] + offset;
+			for (; i+4<=nb_samp; i+=4) {
+				__m128i v = _mm_loadu_si128((__m128i *) (in_s16 + 2*i));
+				/*sign-extend to L0 R0 L1 R1 / L2 R2 L3 R3*/
+				__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+				__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+				/*deinterleave to L0 L1 R0 R1 / L2 L3 R2 R3*/
+				lo = _mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0));
+				hi = _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0));
+				_mm_storeu_si128((__m128i *) (left + i), _mm_unpacklo_epi64(lo, hi));
+				_mm_storeu_si128((__m128i *) (right + i), _mm_unpackhi_epi64(lo, hi));
+			}
+		} else if (nb_ch==1) {
+			s32 *mono = ch_buf[0] + offset;
+			for (; i+8<=nb_samp; i+=8) {
+				__m128i v = _mm_loadu_si128((__m128i *) (in_s16 + i));
+				_mm_storeu_si128((__m128i *) (mono + i), _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+				_mm_storeu_si128((__m128i *) (mono + i + 4), _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+			}
+		}
+#endif
+		for (; i<nb_samp; i++) {
+			for (j=0; j<nb_ch; j++) ch_buf[j][offset + i] = in_s16[nb_ch*i + j];
+		}
+	} else if (bps == 24) {
+		u8 *in_s24 = (u8 *)data;
+		for (; i<nb_samp; i++) {
+			for (j=0; j<nb_ch; j++) ch_buf[j][offset + i] = make_s24_int(&in_s24[3*(nb_ch*i + j)]);
+		}
+	} else if (bps == 32) {
+		s32 *in_s32 = (s32 *)data;
+		for (; i<nb_samp; i++) {
+			for (j=0; j<nb_ch; j++) ch_buf[j][offset + i] = in_s32[nb_ch*i + j];
+		}
+	} else {
+		s8 *in_s8 = (s8 *)data;
+		for (; i<nb_samp; i++) {
+			for (j=0; j<nb_ch; j++) ch_buf[j][offset + i] = in_s8[nb_ch*i + j];
+		}
+	}
+}
+
+/*(re)builds the polyphase filter bank if the input rate, output rate or speed changed. The filter is a Blackman-windowed
+sinc with cutoff below the lowest of the input and output Nyquist frequencies, each phase being normalized to unity gain*/
+static Bool gf_mixer_setup_resampler(MixerInput *in, u32 out_sr)
+{
+	u32 p, k;
+	Double ratio, cutoff;
+
+	if (in->rs_coefs && (in->rs_in_sr == in->src->samplerate) && (in->rs_out_sr == out_sr)
+	        && (in->rs_speed == in->speed) && (in->rs_hist_ch == in->src->chan))
+		return GF_TRUE;
+
+	if (!in->rs_coefs) {
+		in->rs_coefs = (Float *) gf_malloc(sizeof(Float) * GF_SR_RESAMPLE_PHASES * GF_SR_RESAMPLE_TAPS);
+		if (!in->rs_coefs) return GF_FALSE;
+	}
+	if (in->rs_hist_ch != in->src->chan) {
+		if (in->rs_hist) gf_free(in->rs_hist);
+		in->rs_hist = (Float *) gf_malloc(sizeof(Float) * 2 * GF_SR_RESAMPLE_TAPS * in->src->chan);
+		if (!in->rs_hist) {
+			in->rs_hist_ch = 0;
+			return GF_FALSE;
+		}
+		in->rs_hist_ch = in->src->chan;
+	}
+
+	ratio = FIX2FLT(in->speed) * in->src->samplerate / out_sr;
+	in->rs_step = (u64) (ratio * 4294967296.0);
+	if (!in->rs_step) in->rs_step = 1;
+	cutoff = (ratio > 1) ? 0.9 / ratio : 0.9;
+
+	for (p=0; p<GF_SR_RESAMPLE_PHASES; p++) {
+		Double sum = 0;
+		Float *coefs = in->rs_coefs + p*GF_SR_RESAMPLE_TAPS;
+		Double frac = (Double) p / GF_SR_RESAMPLE_PHASES;
+		for (k=0; k<GF_SR_RESAMPLE_TAPS; k++) {
+			/*distance to the output sample, located between the two middle taps*/
+			Double x = (Double) k - (GF_SR_RESAMPLE_TAPS/2 - 1) - frac;
+			Double w = 0.42 + 0.5 * cos(GF_PI * x / (GF_SR_RESAMPLE_TAPS/2)) + 0.08 * cos(2 * GF_PI * x / (GF_SR_RESAMPLE_TAPS/2));
+			Double h = (x==0) ? 1 : sin(GF_PI * cutoff * x) / (GF_PI * cutoff * x);
+			coefs[k] = (Float) (h*w);
+			sum += coefs[k];
+		}
+		for (k=0; k<GF_SR_RESAMPLE_TAPS; k++) coefs[k] = (Float) (coefs[k] / sum);
+	}
+	in->rs_in_sr = in->src->samplerate;
+	in->rs_out_sr = out_sr;
+	in->rs_speed = in->speed;
+	in->has_prev = GF_FALSE;
+	return GF_TRUE;
+}
+
+static GFINLINE Float gf_mixer_filter(const Float *hist, const Float *coefs)
+{
+#ifdef GPAC_HAS_SSE2
+	u32 k;
+	__m128 acc = _mm_mul_ps(_mm_loadu_ps(hist), _mm_loadu_ps(coefs));
+	for (k=4; k<GF_SR_RESAMPLE_TAPS; k+=4) {
+		acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(hist+k), _mm_loadu_ps(coefs+k)));
+	}
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+	return _mm_cvtss_f32(acc);
+#else
+	u32 k;
+	Float res = 0;
+	for (k=0; k<GF_SR_RESAMPLE_TAPS; k++) res += hist[k]*coefs[k];
+	return res;
+#endif
+}
+
+static GFINLINE s32 gf_mixer_float_to_s32(Float v)
+{
+	if (v >= 2147483647.0f) return 0x7FFFFFFF;
+	if (v <= -2147483648.0f) return (s32) 0x80000000;
+	return (s32) ((v<0) ? v - 0.5f : v + 0.5f);
+}
+
+static GFINLINE s32 gf_mixer_get_sample(char *data, u32 bps, u32 idx)
+{
+	switch (bps) {
+	case 16:
+		return ((s16 *)data)[idx];
+	case 24:
+		return make_s24_int((u8 *) data + 3*idx);
+	case 32:
+		return ((s32 *)data)[idx];
+	default:
+		return ((s8 *)data)[idx];
+	}
+}
+
+/*resamples up to nb_samp interleaved input samples into the planar channel buffers starting at offset, producing
+at most max_out samples. Returns the number of samples produced and sets the number of input samples consumed*/
+static u32 gf_mixer_resample(MixerInput *in, char *data, u32 nb_samp, u32 offset, u32 max_out, u32 *nb_consumed)
+{
+	u32 j, nb_out, consumed;
+	u32 nb_ch = in->src->chan;
+	u32 bps = in->src->bps;
+
+	if (!in->has_prev) {
+		memset(in->rs_hist, 0, sizeof(Float) * 2 * GF_SR_RESAMPLE_TAPS * nb_ch);
+		in->rs_hist_pos = 0;
+		/*wait until the first input sample reaches the middle of the filter*/
+		in->rs_pos = ((u64) (GF_SR_RESAMPLE_TAPS/2 + 1)) << 32;
+		in->has_prev = GF_TRUE;
+	}
+
+	nb_out = consumed = 0;
+	while (nb_out < max_out) {
+		Float *coefs;
+		/*push input samples until the next output position is between the two middle taps*/
+		if (in->rs_pos >= ((u64)1<<32)) {
+			u32 pos = in->rs_hist_pos;
+			if (consumed == nb_samp) break;
+			for (j=0; j<nb_ch; j++) {
+				Float *hist = in->rs_hist + j*2*GF_SR_RESAMPLE_TAPS;
+				hist[pos] = hist[pos + GF_SR_RESAMPLE_TAPS] = (Float) gf_mixer_get_sample(data, bps, nb_ch*consumed + j);
+			}
+			in->rs_hist_pos = (pos+1) % GF_SR_RESAMPLE_TAPS;
+			in->rs_pos -= ((u64)1<<32);
+			consumed++;
+			continue;
+		}
+		/*nearest phase from the 32 bit fractional position*/
+		coefs = in->rs_coefs + GF_SR_RESAMPLE_TAPS * (u32) ((in->rs_pos & 0xFFFFFFFF) * GF_SR_RESAMPLE_PHASES >> 32);
+		for (j=0; j<nb_ch; j++) {
+			Float *hist = in->rs_hist + j*2*GF_SR_RESAMPLE_TAPS + in->rs_hist_pos;
+			in->ch_buf[j][offset + nb_out] = gf_mixer_float_to_s32( gf_mixer_filter(hist, coefs) );
+		}
+		nb_out++;
+		in->rs_pos += in->rs_step;
+	}
+	*nb_consumed = consumed;
+	return nb_out;
+}
+
 static void gf_mixer_fetch_input(GF_AudioMixer *am, MixerInput *in, u32 audio_delay)
 {
-	u32 i, j, in_ch, out_ch, prev, next, src_samp, ratio, src_size;
-	Bool use_prev;
-	s32 *in_s32 = NULL;
-	s16 *in_s16 = NULL;
-	s8 *in_s24 = NULL;
-	s8 *in_s8 = NULL;
-	s32 frac, inChan[GF_SR_MAX_CHANNELS], inChanNext[GF_SR_MAX_CHANNELS];
-	
-	in_s8 = (s8 *) in->src->FetchFrame(in->src->callback, &src_size, audio_delay);
-	if (!in_s8 || !src_size) {
+	u32 i, j, in_ch, out_ch, src_samp, src_size, nb_out, nb_used;
+	s32 inChan[GF_SR_MAX_CHANNELS];
+	char *data;
+
+	data = in->src->FetchFrame(in->src->callback, &src_size, audio_delay);
+	if (!data || !src_size) {
 		in->has_prev = GF_FALSE;
 		/*done, stop fill*/
 		in->out_samples_to_write = 0;
 		return;
 	}
-	
-	ratio = (u32) (in->src->samplerate * FIX2INT(255*in->speed) / am->sample_rate);
-	src_samp = (u32) (src_size * 8 / in->src->bps / in->src->chan);
+
 	in_ch = in->src->chan;
 	out_ch = am->nb_channels;
-	if (in->src->bps == 16) {
-		in_s16 = (s16 *)in_s8;
-		in_s8 = NULL;
-	}
-	else if (in->src->bps == 24) {
-		in_s24 = (s8 *)in_s8;
-		in_s8 = NULL;
-	} else if (in->src->bps == 32) {
-		in_s32 = (s32 *)in_s8;
-		in_s8 = NULL;
+	src_samp = (u32) (src_size * 8 / in->src->bps / in_ch);
+	/*less than one sample in frame, discard it*/
+	if (!src_samp) {
+		in->in_bytes_used = src_size + 1;
+		return;
 	}
 
-	/*just in case, if only 1 sample available in src, copy over and discard frame since we cannot
-	interpolate audio*/
-	if (src_samp==1) {
-		in->has_prev = GF_TRUE;
-		for (j=0; j<in_ch; j++) in->last_channels[j] = in_s32 ? in_s32[j] : (in_s24 ? make_s24_int(&in_s24[3*j]) : (in_s16 ? in_s16[j] : in_s8[j] ) );
-		in->in_bytes_used = src_size;
-		return;
+	/*same rate, convert what fits in the output*/
+	if ((in->src->samplerate == am->sample_rate) && (in->speed == FIX_ONE)) {
+		nb_used = nb_out = MIN(src_samp, in->out_samples_to_write - in->out_samples_written);
+		gf_mixer_convert_input(in->ch_buf, in->out_samples_written, data, in->src->bps, in_ch, nb_out);
+		in->has_prev = GF_FALSE;
+	} else {
+		if (!gf_mixer_setup_resampler(in, am->sample_rate)) {
+			in->out_samples_to_write = 0;
+			return;
+		}
+		nb_out = gf_mixer_resample(in, data, src_samp, in->out_samples_written, in->out_samples_to_write - in->out_samples_written, &nb_used);
 	}
 
-	/*while space to fill and input data, convert*/
-	use_prev = in->has_prev;
-	memset(inChan, 0, sizeof(s32)*GF_SR_MAX_CHANNELS);
-	memset(inChanNext, 0, sizeof(s32)*GF_SR_MAX_CHANNELS);
-	i = 0;
-	next = prev = 0;
-	while (1) {
-		prev = (u32) (i*ratio) / 255;
-		if (prev>=src_samp) break;
-
-		next = prev+1;
-		frac = (i*ratio) - 255*prev;
-		if (frac && (next==src_samp)) break;
-		if (use_prev && prev)
-			use_prev = GF_FALSE;
-
-		if (in_s32) {
-			for (j = 0; j < in_ch; j++) {
-				inChan[j] = use_prev ? in->last_channels[j] : in_s32[in_ch*prev + j];
-				inChanNext[j] = in_s32[in_ch*next + j];
-				inChan[j] = (frac*inChanNext[j] + (255 - frac)*inChan[j]) / 255;
-			}
-		} else if (in_s24) {
-			for (j = 0; j<in_ch; j++) {
-				inChan[j] = use_prev ? in->last_channels[j] : make_s24_int(&in_s24[3*(in_ch*prev + j)]);
-				inChanNext[j] = make_s24_int(&in_s24[3*(in_ch*next + j)]);
-				inChan[j] = (frac*inChanNext[j] + (255 - frac)*inChan[j]) / 255;
-			}
-		} else if (in_s16) {
-			for (j = 0; j<in_ch; j++) {
-				inChan[j] = use_prev ? in->last_channels[j] : in_s16[in_ch*prev + j];
-				inChanNext[j] = in_s16[in_ch*next + j];
-				inChan[j] = (frac*inChanNext[j] + (255 - frac)*inChan[j]) / 255;
-			}
-		} else {
-			for (j=0; j<in_ch; j++) {
-				inChan[j] = use_prev ? in->last_channels[j] : in_s8[in_ch*prev + j];
-				inChanNext[j] = in_s8[in_ch*next + j];
-				inChan[j] = (frac*inChanNext[j] + (255-frac)*inChan[j]) / 255;
-			}
+	//map input channels to the output channel config
+	if (in_ch != out_ch) {
+		memset(inChan, 0, sizeof(s32)*GF_SR_MAX_CHANNELS);
+		for (i=0; i<nb_out; i++) {
+			for (j=0; j<in_ch; j++) inChan[j] = in->ch_buf[j][in->out_samples_written + i];
+			gf_mixer_map_channels(inChan, in_ch, in->src->ch_cfg, in->src->forced_layout, out_ch, am->channel_cfg);
+			for (j=0; j<out_ch; j++) in->ch_buf[j][in->out_samples_written + i] = inChan[j];
 		}
-		//map inChannel to the output channel config
-		gf_mixer_map_channels(inChan, in_ch, in->src->ch_cfg, in->src->forced_layout, out_ch, am->channel_cfg);
-		//don't apply pan when forced layout is used
-		if (!in->src->forced_layout) {
-			for (j=0; j<out_ch ; j++) {
-				*(in->ch_buf[j] + in->out_samples_written) = (s32) (inChan[j] * FIX2INT(100*in->pan[j]) / 100 );
-			}
-		} else {
-			for (j=0; j<out_ch ; j++) {
-				*(in->ch_buf[j] + in->out_samples_written) = (s32) inChan[j];
-			}
+	}
+	//don't apply pan when forced layout is used
+	if (!in->src->forced_layout) {
+		for (j=0; j<out_ch; j++) {
+			s32 *buf = in->ch_buf[j] + in->out_samples_written;
+			s32 gain = (j<6) ? FIX2INT(100*in->pan[j]) : 100;
+			if (gain == 100) continue;
+			for (i=0; i<nb_out; i++) buf[i] = buf[i] * gain / 100;
 		}
-
-		in->out_samples_written ++;
-		if (in->out_samples_written == in->out_samples_to_write) break;
-		i++;
 	}
+	in->out_samples_written += nb_out;
+	in->in_bytes_used = nb_used * in_ch * in->src->bps / 8;
+	/*cf below, make sure we call release*/
+	in->in_bytes_used += 1;
+}
 
-	if (!(ratio%255)) {
-		in->has_prev = GF_FALSE;
-		if (next==src_samp) {
-			in->in_bytes_used = src_size;
-		} else {
-			in->in_bytes_used = MIN(src_size, prev*in->src->bps * in->src->chan / 8);
+/*adds a planar channel to the mix buffer, adjusting its bit depth*/
+static void gf_mixer_add_channel(s32 *mix, s32 *src, u32 nb_samp, s32 shift)
+{
+	u32 i = 0;
+#ifdef GPAC_HAS_SSE2
+	if (shift > 0) {
+		__m128i cnt = _mm_cvtsi32_si128(shift);
+		for (; i+4<=nb_samp; i+=4) {
+			__m128i v = _mm_sll_epi32(_mm_loadu_si128((__m128i *) (src+i)), cnt);
+			_mm_storeu_si128((__m128i *) (mix+i), _mm_add_epi32(_mm_loadu_si128((__m128i *) (mix+i)), v));
+		}
+	} else if (shift < 0) {
+		__m128i cnt = _mm_cvtsi32_si128(-shift);
+		for (; i+4<=nb_samp; i+=4) {
+			__m128i v = _mm_sra_epi32(_mm_loadu_si128((__m128i *) (src+i)), cnt);
+			_mm_storeu_si128((__m128i *) (mix+i), _mm_add_epi32(_mm_loadu_si128((__m128i *) (mix+i)), v));
 		}
 	} else {
-		in->has_prev = GF_TRUE;
-		if (next==src_samp) {
-			for (j=0; j<in_ch; j++) in->last_channels[j] = inChanNext[j];
-			in->in_bytes_used = src_size;
-		} else {
-			in->in_bytes_used = prev*in->src->bps * in->src->chan / 8;
-			if (in->in_bytes_used>src_size) {
-				in->in_bytes_used = src_size;
-				for (j=0; j<in_ch; j++) in->last_channels[j] = inChanNext[j];
-			} else {
-				u32 idx;
-				idx = (prev>=src_samp) ? in_ch*(src_samp-1) : in_ch*prev;
-				for (j=0; j<in_ch; j++) {
-					assert(idx + j < src_size/2);
-					in->last_channels[j] = in_s32 ? in_s32[idx + j] : (in_s24 ? make_s24_int(&in_s24[3*(idx + j)]) : (in_s16 ? in_s16[idx + j] : in_s8[idx + j]) );
-				}
-			}
+		for (; i+4<=nb_samp; i+=4) {
+			__m128i v = _mm_loadu_si128((__m128i *) (src+i));
+			_mm_storeu_si128((__m128i *) (mix+i), _mm_add_epi32(_mm_loadu_si128((__m128i *) (mix+i)), v));
 		}
 	}
-	/*cf below, make sure we call release*/
-	in->in_bytes_used += 1;
+#endif
+	if (shift > 0) {
+		for (; i<nb_samp; i++) mix[i] += src[i] << shift;
+	} else if (shift < 0) {
+		for (; i<nb_samp; i++) mix[i] += src[i] >> (-shift);
+	} else {
+		for (; i<nb_samp; i++) mix[i] += src[i];
+	}
 }
 
 GF_EXPORT
@@ -638,7 +816,7 @@ u32 gf_mixer_get_output(GF_AudioMixer *am, void *buffer, u32 buffer_size, u32 de
 	Fixed pan[6];
 	Bool is_muted, force_mix;
 	u32 i, j, count, size, in_size, nb_samples, nb_written;
-	s32 *out_mix, nb_act_src;
+	s32 nb_act_src;
 	char *data, *ptr;
 
 	//reset buffer whatever the state of the mixer is
@@ -815,44 +993,16 @@ do_mix:
 		//only resync on the first fill
 		delay=0;
 	}
-	/*step 3, mix the final buffer*/
-	memset(am->output, 0, sizeof(s32) * buffer_size);
+	/*step 3, mix the final buffer - am->output holds one plane of nb_samples per output channel*/
+	memset(am->output, 0, sizeof(s32) * nb_samples * am->nb_channels);
 
 	nb_written = 0;
 	for (i=0; i<count; i++) {
-		u32 k;
-		out_mix = am->output;
 		in = (MixerInput *)gf_list_get(am->sources, i);
 		if (!in->out_samples_to_write) continue;
 		/*only write what has been filled in the source buffer (may be less than output size)*/
-		if (am->bits_per_sample > in->src->bps) {
-			s32 mul = am->bits_per_sample - in->src->bps;
-			for (j = 0; j < in->out_samples_written; j++) {
-				for (k = 0; k < am->nb_channels; k++) {
-					s32 res = *(in->ch_buf[k] + j);
-					res <<= mul;
-					(*out_mix) += res;
-					out_mix += 1;
-				}
-			}
-		}
-		else if (am->bits_per_sample < in->src->bps) {
-			s32 div = in->src->bps - am->bits_per_sample;
-			for (j = 0; j < in->out_samples_written; j++) {
-				for (k = 0; k < am->nb_channels; k++) {
-					s32 res = *(in->ch_buf[k] + j);
-					res >>= div;
-					(*out_mix) += res;
-					out_mix += 1;
-				}
-			}
-		} else {
-			for (j = 0; j < in->out_samples_written; j++) {
-				for (k = 0; k < am->nb_channels; k++) {
-					(*out_mix) += *(in->ch_buf[k] + j);
-					out_mix += 1;
-				}
-			}
+		for (j = 0; j < am->nb_channels; j++) {
+			gf_mixer_add_channel(am->output + j*nb_samples, in->ch_buf[j], in->out_samples_written, (s32) am->bits_per_sample - (s32) in->src->bps);
 		}
 		if (nb_written < in->out_samples_written) nb_written = in->out_samples_written;
 	}
@@ -865,15 +1015,12 @@ do_mix:
 	//TODO big-endian support (output is assumed to be little endian PCM)
 
 	//we do not re-normalize based on the numbner of input, this is the author's responsability
-	out_mix = am->output;
 	if (am->bits_per_sample == 32) {
 		s32 *out_s32 = (s32 *)buffer;
 		for (i = 0; i < nb_written; i++) {
 			for (j = 0; j < am->nb_channels; j++) {
-				s32 samp = (*out_mix);
-				(*out_s32) = samp;
+				(*out_s32) = am->output[j*nb_samples + i];
 				out_s32 += 1;
-				out_mix += 1;
 			}
 		}
 	}
@@ -883,7 +1030,7 @@ do_mix:
 		s8 *out_s24 = (s8 *)buffer;
 		for (i = 0; i<nb_written; i++) {
 			for (j = 0; j<am->nb_channels; j++) {
-				s32 samp = (*out_mix);
+				s32 samp = am->output[j*nb_samples + i];
 				u8 lsb;
 				if (samp > GF_S24_MAX) samp = GF_S24_MAX;
 				else if (samp < GF_S24_MIN) samp = GF_S24_MIN;
@@ -892,19 +1039,38 @@ do_mix:
 				*((s16 *)&out_s24[1]) = (s16)samp;
 				out_s24[0] = lsb;
 				out_s24 += 3;
-				out_mix += 1;
 			}
 		}
 	} else if (am->bits_per_sample == 16) {
 		s16 *out_s16 = (s16 *)buffer;
-		for (i = 0; i<nb_written; i++) {
+		i = 0;
+#ifdef GPAC_HAS_SSE2
+		/*interleave and saturate 4 (stereo) or 8 (mono) samples at once*/
+		if (am->nb_channels == 2) {
+			s32 *left = am->output;
+			s32 *right = am->output + nb_samples;
+			for (; i+4<=nb_written; i+=4) {
+				__m128i l = _mm_loadu_si128((__m128i *) (left+i));
+				__m128i r = _mm_loadu_si128((__m128i *) (right+i));
+				_mm_storeu_si128((__m128i *) (out_s16 + 2*i), _mm_packs_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r)));
+			}
+		} else if (am->nb_channels == 1) {
+			s32 *mono = am->output;
+			for (; i+8<=nb_written; i+=8) {
+				__m128i lo = _mm_loadu_si128((__m128i *) (mono+i));
+				__m128i hi = _mm_loadu_si128((__m128i *) (mono+i+4));
+				_mm_storeu_si128((__m128i *) (out_s16 + i), _mm_packs_epi32(lo, hi));
+			}
+		}
+		out_s16 += i * am->nb_channels;
+#endif
+		for (; i<nb_written; i++) {
 			for (j = 0; j<am->nb_channels; j++) {
-				s32 samp = (*out_mix);
+				s32 samp = am->output[j*nb_samples + i];
 				if (samp > GF_SHORT_MAX) samp = GF_SHORT_MAX;
 				else if (samp < GF_SHORT_MIN) samp = GF_SHORT_MIN;
 				(*out_s16) = samp;
 				out_s16 += 1;
-				out_mix += 1;
 			}
 		}
 	}
@@ -912,12 +1078,11 @@ do_mix:
 		s8 *out_s8 = (s8 *) buffer;
 		for (i=0; i<nb_written; i++) {
 			for (j=0; j<am->nb_channels; j++) {
-				s32 samp = (*out_mix ) / 255;
+				s32 samp = am->output[j*nb_samples + i] / 255;
 				if (samp > 127) samp = 127;
 				else if (samp < -128) samp = -128;
 				(*out_s8) = samp;
 				out_s8 += 1;
-				out_mix += 1;
 			}
 		}
 	}
@@ -271,6 +271,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_bind) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_connect) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_send) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_send_multi) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_listen) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_accept) )
@@ -339,6 +340,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_cfg_get_filename) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_cfg_set_filename) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_cfg_discard_changes) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_cfg_set_journal_mode) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_cfg_get_ikey) )
 
 #ifndef GPAC_DISABLE_PLAYER
@@ -782,6 +784,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_sample_padding) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_info) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_prefetch_samples) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_flags) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_for_media_time) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_for_movie_time) )
@@ -960,6 +963,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_remove_sample) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_final_name) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_storage_mode) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_reserve_moov_space) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_force_64bit_chunk_offset) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_storage_mode) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_interleave_time) )
@@ -1163,6 +1167,8 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_disable_auto_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_send_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_get_payload_type) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_set_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_flush) )
 
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_streamer_new) )
@@ -1203,6 +1209,10 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_image_sequence_coding_constraints) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_sample_cenc_default) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_streamer_get_current_time) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_streamer_scheduler_new) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_streamer_scheduler_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_streamer_scheduler_add) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_streamer_scheduler_process) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_svc_config_new) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_vp_config_get) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_vp_config_new) )
@@ -1331,6 +1341,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_rtcp_report) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_bye) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_packet) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_packets) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_set_info_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_is_unicast) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_is_interleaved) )
@@ -1392,6 +1403,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_new) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_del) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_process) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_hinter_tracks_process) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_finalize) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_finalize) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_get_bandwidth) )
@@ -1458,6 +1470,7 @@
 
 #ifndef GPAC_DISABLE_MEDIA_EXPORT
 #pragma comment (linker, EXPORT_SYMBOL(gf_media_export) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_media_export_tracks) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_media_export_nhml) )
 #endif /*GPAC_DISABLE_MEDIA_EXPORT*/
 
@@ -1635,6 +1648,8 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_bifs_encoder_get_version) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_bifs_encoder_get_rap) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_bifs_encoder_set_source_url) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_bifs_encoder_set_node_cache) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_bifs_encoder_node_modified) )
 #endif
 #endif /*GPAC_DISABLE_BIFS*/
 
@@ -2114,6 +2129,10 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_init_smooth_from_dom) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_complete_from_dom) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_get_segment_start_time_with_timescale) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_segment_timeline_get_segment_count) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_segment_timeline_get_segment) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_segment_timeline_find_segment) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_segment_timeline_reset_index) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_seek_in_period) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_seek_to_time) )
 
@@ -2194,6 +2213,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_dasher_set_split_on_closest) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dasher_set_cues) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dasher_set_isobmff_options) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dasher_enable_hls) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dasher_set_test_mode) )
 
 
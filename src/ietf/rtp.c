@@ -637,6 +637,68 @@ GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, char *pck, u
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_rtp_send_packets(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdrs, char **pcks, u32 *pck_sizes, u32 nb_pcks)
+{
+	GF_Err e;
+	u32 i, j, nb_send;
+	char *bufs[GF_SK_SEND_MULTI_MAX];
+	u32 sizes[GF_SK_SEND_MULTI_MAX];
+
+	if (!ch || !ch->send_buffer || (nb_pcks && (!rtp_hdrs || !pcks || !pck_sizes))) return GF_BAD_PARAM;
+
+	for (i=0; i<nb_pcks; i+=nb_send) {
+		nb_send = MIN(nb_pcks - i, GF_SK_SEND_MULTI_MAX);
+		for (j=0; j<nb_send; j++) {
+			GF_RTPHeader *hdr = &rtp_hdrs[i+j];
+			char *ptr = pcks[i+j] - 12;
+
+			/*CSRC lists cannot be written in place, use the regular path*/
+			if (hdr->CSRCCount) return GF_NOT_SUPPORTED;
+			if (12 + pck_sizes[i+j] > ch->send_buffer_size) return GF_IO_ERR;
+
+			ptr[0] = (hdr->Version << 6) | ((hdr->Padding & 1) << 5) | ((hdr->Extension & 1) << 4);
+			ptr[1] = ((hdr->Marker & 1) << 7) | (hdr->PayloadType & 0x7F);
+			ptr[2] = (hdr->SequenceNumber >> 8) & 0xFF;
+			ptr[3] = hdr->SequenceNumber & 0xFF;
+			ptr[4] = (hdr->TimeStamp >> 24) & 0xFF;
+			ptr[5] = (hdr->TimeStamp >> 16) & 0xFF;
+			ptr[6] = (hdr->TimeStamp >> 8) & 0xFF;
+			ptr[7] = hdr->TimeStamp & 0xFF;
+			ptr[8] = (ch->SSRC >> 24) & 0xFF;
+			ptr[9] = (ch->SSRC >> 16) & 0xFF;
+			ptr[10] = (ch->SSRC >> 8) & 0xFF;
+			ptr[11] = ch->SSRC & 0xFF;
+
+			bufs[j] = ptr;
+			sizes[j] = pck_sizes[i+j] + 12;
+		}
+		e = gf_sk_send_multi(ch->rtp, bufs, sizes, nb_send);
+		if (e) return e;
+
+		//Update RTCP for sender reports
+		for (j=0; j<nb_send; j++) {
+			ch->pck_sent_since_last_sr += 1;
+			if (ch->first_SR) {
+				gf_rtp_get_next_report_time(ch);
+				ch->num_payload_bytes = 0;
+				ch->num_pck_sent = 0;
+				ch->first_SR = 0;
+			}
+			ch->num_payload_bytes += pck_sizes[i+j];
+			ch->num_pck_sent += 1;
+		}
+		ch->last_pck_ts = rtp_hdrs[i+nb_send-1].TimeStamp;
+	}
+	if (!nb_pcks) return GF_OK;
+
+	//store timing
+	gf_net_get_ntp(&ch->last_pck_ntp_sec, &ch->last_pck_ntp_frac);
+
+	if (!ch->no_auto_rtcp) gf_rtp_send_rtcp_report(ch, NULL, NULL);
+	return GF_OK;
+}
+
 GF_EXPORT
 u32 gf_rtp_is_unicast(GF_RTPChannel *ch)
 {
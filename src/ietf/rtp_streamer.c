@@ -43,6 +43,13 @@ struct __rtp_streamer
 	char *buffer;
 	u32 payload_len, buffer_alloc;
 
+	/*batched emission: packets are formed in consecutive slots of batch_buffer and sent in one go*/
+	u32 batch_size, nb_queued;
+	char *batch_buffer;
+	GF_RTPHeader *queued_hdrs;
+	char **queued_pcks;
+	u32 *queued_sizes;
+
 	Double ts_scale;
 };
 
@@ -55,8 +62,24 @@ static void rtp_stream_on_new_packet(void *cbk, GF_RTPHeader *header)
 
 static void rtp_stream_on_packet_done(void *cbk, GF_RTPHeader *header)
 {
+	GF_Err e;
 	GF_RTPStreamer *rtp = (GF_RTPStreamer*)cbk;
-	GF_Err e = gf_rtp_send_packet(rtp->channel, header, rtp->buffer+12, rtp->payload_len, GF_TRUE);
+
+	if (rtp->batch_size) {
+		rtp->queued_hdrs[rtp->nb_queued] = *header;
+		rtp->queued_pcks[rtp->nb_queued] = rtp->buffer+12;
+		rtp->queued_sizes[rtp->nb_queued] = rtp->payload_len;
+		rtp->nb_queued++;
+		rtp->payload_len = 0;
+		if (rtp->nb_queued == rtp->batch_size) {
+			gf_rtp_streamer_flush(rtp);
+		} else {
+			rtp->buffer = rtp->batch_buffer + rtp->nb_queued * rtp->buffer_alloc;
+		}
+		return;
+	}
+
+	e = gf_rtp_send_packet(rtp->channel, header, rtp->buffer+12, rtp->payload_len, GF_TRUE);
 
 #ifndef GPAC_DISABLE_LOG
 	if (e) {
@@ -511,11 +534,103 @@ void gf_rtp_streamer_del(GF_RTPStreamer *streamer)
 	if (streamer) {
 		if (streamer->channel) gf_rtp_del(streamer->channel);
 		if (streamer->packetizer) gf_rtp_builder_del(streamer->packetizer);
-		if (streamer->buffer) gf_free(streamer->buffer);
+		if (streamer->batch_buffer) gf_free(streamer->batch_buffer);
+		else if (streamer->buffer) gf_free(streamer->buffer);
+		if (streamer->queued_hdrs) gf_free(streamer->queued_hdrs);
+		if (streamer->queued_pcks) gf_free(streamer->queued_pcks);
+		if (streamer->queued_sizes) gf_free(streamer->queued_sizes);
 		gf_free(streamer);
 	}
 }
 
+GF_EXPORT
+GF_Err gf_rtp_streamer_set_batch(GF_RTPStreamer *rtp, u32 max_packets)
+{
+	GF_Err e;
+	if (!rtp) return GF_BAD_PARAM;
+	/*send anything pending before changing the packet slots*/
+	e = gf_rtp_streamer_flush(rtp);
+	if (e) return e;
+	if (max_packets == rtp->batch_size) return GF_OK;
+
+	if (rtp->batch_buffer) {
+		gf_free(rtp->batch_buffer);
+		gf_free(rtp->queued_hdrs);
+		gf_free(rtp->queued_pcks);
+		gf_free(rtp->queued_sizes);
+		rtp->batch_buffer = NULL;
+		rtp->queued_hdrs = NULL;
+		rtp->queued_pcks = NULL;
+		rtp->queued_sizes = NULL;
+	} else {
+		gf_free(rtp->buffer);
+	}
+	rtp->buffer = NULL;
+	rtp->batch_size = 0;
+
+	if (max_packets<=1) {
+		rtp->buffer = (char*)gf_malloc(sizeof(char) * rtp->buffer_alloc);
+		return rtp->buffer ? GF_OK : GF_OUT_OF_MEM;
+	}
+
+	rtp->batch_buffer = (char*)gf_malloc(sizeof(char) * rtp->buffer_alloc * max_packets);
+	rtp->queued_hdrs = (GF_RTPHeader*)gf_malloc(sizeof(GF_RTPHeader) * max_packets);
+	rtp->queued_pcks = (char**)gf_malloc(sizeof(char*) * max_packets);
+	rtp->queued_sizes = (u32*)gf_malloc(sizeof(u32) * max_packets);
+	if (!rtp->batch_buffer || !rtp->queued_hdrs || !rtp->queued_pcks || !rtp->queued_sizes) {
+		if (rtp->batch_buffer) gf_free(rtp->batch_buffer);
+		if (rtp->queued_hdrs) gf_free(rtp->queued_hdrs);
+		if (rtp->queued_pcks) gf_free(rtp->queued_pcks);
+		if (rtp->queued_sizes) gf_free(rtp->queued_sizes);
+		rtp->batch_buffer = NULL;
+		rtp->queued_hdrs = NULL;
+		rtp->queued_pcks = NULL;
+		rtp->queued_sizes = NULL;
+		rtp->buffer = (char*)gf_malloc(sizeof(char) * rtp->buffer_alloc);
+		return GF_OUT_OF_MEM;
+	}
+	rtp->batch_size = max_packets;
+	rtp->buffer = rtp->batch_buffer;
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_rtp_streamer_flush(GF_RTPStreamer *rtp)
+{
+	u32 i;
+	GF_Err e;
+	if (!rtp) return GF_BAD_PARAM;
+	if (!rtp->nb_queued) return GF_OK;
+
+	e = gf_rtp_send_packets(rtp->channel, rtp->queued_hdrs, rtp->queued_pcks, rtp->queued_sizes, rtp->nb_queued);
+	/*CSRC lists, send one by one*/
+	if (e==GF_NOT_SUPPORTED) {
+		e = GF_OK;
+		for (i=0; i<rtp->nb_queued; i++) {
+			GF_Err an_e = gf_rtp_send_packet(rtp->channel, &rtp->queued_hdrs[i], rtp->queued_pcks[i], rtp->queued_sizes[i], GF_TRUE);
+			if (an_e) e = an_e;
+		}
+	}
+
+#ifndef GPAC_DISABLE_LOG
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("Error %s sending %d RTP packets\n", gf_error_to_string(e), rtp->nb_queued));
+	} else if (gf_log_tool_level_on(GF_LOG_RTP, GF_LOG_DEBUG)) {
+		for (i=0; i<rtp->nb_queued; i++) {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("RTP SN %u - TS %u - M %u - Size %u\n", rtp->queued_hdrs[i].SequenceNumber, rtp->queued_hdrs[i].TimeStamp, rtp->queued_hdrs[i].Marker, rtp->queued_sizes[i] + 12));
+		}
+	}
+#endif
+
+	/*the packet being formed (if any) always sits in the first slot*/
+	if (rtp->payload_len && (rtp->payload_len + 12 <= rtp->buffer_alloc)) {
+		memmove(rtp->batch_buffer + 12, rtp->buffer + 12, rtp->payload_len);
+	}
+	rtp->nb_queued = 0;
+	rtp->buffer = rtp->batch_buffer;
+	return e;
+}
+
 #if !defined(GPAC_DISABLE_ISOM) && !defined(GPAC_DISABLE_STREAMING)
 
 void gf_media_format_ttxt_sdp(GP_RTPPacketizer *builder, char *payload_name, char *sdpLine, GF_ISOFile *file, u32 track)
@@ -42,6 +42,8 @@ GF_Err co64_Read(GF_Box *s,GF_BitStream *bs)
 {
 	u32 entries;
 	GF_ChunkLargeOffsetBox *ptr = (GF_ChunkLargeOffsetBox *) s;
+	u64 start = gf_bs_get_position(bs);
+	u64 payload_size = s->size;
 	ptr->nb_entries = gf_bs_read_u32(bs);
 
 	ISOM_DECREASE_SIZE(ptr, 4)
@@ -50,6 +52,7 @@ GF_Err co64_Read(GF_Box *s,GF_BitStream *bs)
 		GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[iso file] Invalid number of entries %d in co64\n", ptr->nb_entries));
 		return GF_ISOM_INVALID_FILE;
 	}
+	if (gf_isom_box_defer_table(s, bs, &ptr->lazy, start, payload_size)) return GF_OK;
 
 	ptr->offsets = (u64 *) gf_malloc(ptr->nb_entries * sizeof(u64) );
 	if (ptr->offsets == NULL) return GF_OUT_OF_MEM;
@@ -379,6 +382,8 @@ GF_Err ctts_Read(GF_Box *s, GF_BitStream *bs)
 	u32 i;
 	u32 sampleCount;
 	GF_CompositionOffsetBox *ptr = (GF_CompositionOffsetBox *)s;
+	u64 start = gf_bs_get_position(bs);
+	u64 payload_size = s->size;
 
 	ptr->nb_entries = gf_bs_read_u32(bs);
 	ISOM_DECREASE_SIZE(ptr, 4);
@@ -387,6 +392,7 @@ GF_Err ctts_Read(GF_Box *s, GF_BitStream *bs)
 		GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[iso file] Invalid number of entries %d in ctts\n", ptr->nb_entries));
 		return GF_ISOM_INVALID_FILE;
 	}
+	if (gf_isom_box_defer_table(s, bs, &ptr->lazy, start, payload_size)) return GF_OK;
 
 	ptr->alloc_size = ptr->nb_entries;
 	ptr->entries = (GF_DttsEntry *)gf_malloc(sizeof(GF_DttsEntry)*ptr->alloc_size);
@@ -5404,6 +5410,10 @@ GF_Err stbl_Size(GF_Box *s)
 	GF_Err e;
 	GF_SampleTableBox *ptr = (GF_SampleTableBox *)s;
 
+	//tables deferred by a lazy open must be loaded before sizing/writing
+	e = stbl_LoadLazyTables(ptr);
+	if (e) return e;
+
 	//Mandatory boxs (but not internally :)
 	if (ptr->SampleDescription) {
 		e = gf_isom_box_size((GF_Box *) ptr->SampleDescription);
@@ -5508,6 +5518,8 @@ GF_Err stco_Read(GF_Box *s, GF_BitStream *bs)
 {
 	u32 entries;
 	GF_ChunkOffsetBox *ptr = (GF_ChunkOffsetBox *)s;
+	u64 start = gf_bs_get_position(bs);
+	u64 payload_size = s->size;
 
 	ptr->nb_entries = gf_bs_read_u32(bs);
 	ISOM_DECREASE_SIZE(ptr, 4);
@@ -5515,6 +5527,7 @@ GF_Err stco_Read(GF_Box *s, GF_BitStream *bs)
 		GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[iso file] Invalid number of entries %d in stco\n", ptr->nb_entries));
 		return GF_ISOM_INVALID_FILE;
 	}
+	if (gf_isom_box_defer_table(s, bs, &ptr->lazy, start, payload_size)) return GF_OK;
 
 	if (ptr->nb_entries) {
 		ptr->offsets = (u32 *) gf_malloc(ptr->nb_entries * sizeof(u32) );
@@ -5639,6 +5652,8 @@ GF_Err stsc_Read(GF_Box *s, GF_BitStream *bs)
 {
 	u32 i;
 	GF_SampleToChunkBox *ptr = (GF_SampleToChunkBox *)s;
+	u64 start = gf_bs_get_position(bs);
+	u64 payload_size = s->size;
 
 	ptr->nb_entries = gf_bs_read_u32(bs);
 	ISOM_DECREASE_SIZE(ptr, 4);
@@ -5646,6 +5661,7 @@ GF_Err stsc_Read(GF_Box *s, GF_BitStream *bs)
 		GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[iso file] Invalid number of entries %d in stsc\n", ptr->nb_entries));
 		return GF_ISOM_INVALID_FILE;
 	}
+	if (gf_isom_box_defer_table(s, bs, &ptr->lazy, start, payload_size)) return GF_OK;
 
 	ptr->alloc_size = ptr->nb_entries;
 	ptr->entries = gf_malloc(sizeof(GF_StscEntry)*ptr->alloc_size);
@@ -5875,6 +5891,8 @@ GF_Err stss_Read(GF_Box *s, GF_BitStream *bs)
 {
 	u32 i;
 	GF_SyncSampleBox *ptr = (GF_SyncSampleBox *)s;
+	u64 start = gf_bs_get_position(bs);
+	u64 payload_size = s->size;
 
 	ptr->nb_entries = gf_bs_read_u32(bs);
 	ISOM_DECREASE_SIZE(ptr, 4);
@@ -5882,6 +5900,7 @@ GF_Err stss_Read(GF_Box *s, GF_BitStream *bs)
 		GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[iso file] Invalid number of entries %d in stss\n", ptr->nb_entries));
 		return GF_ISOM_INVALID_FILE;
 	}
+	if (gf_isom_box_defer_table(s, bs, &ptr->lazy, start, payload_size)) return GF_OK;
 
 	ptr->alloc_size = ptr->nb_entries;
 	ptr->sampleNumbers = (u32 *) gf_malloc( ptr->alloc_size * sizeof(u32));
@@ -5939,8 +5958,11 @@ void stsz_del(GF_Box *s)
 GF_Err stsz_Read(GF_Box *s, GF_BitStream *bs)
 {
 	u32 i, estSize;
+	u64 start, payload_size;
 	GF_SampleSizeBox *ptr = (GF_SampleSizeBox *)s;
 	if (ptr == NULL) return GF_BAD_PARAM;
+	start = gf_bs_get_position(bs);
+	payload_size = s->size;
 
 	//support for CompactSizes
 	if (s->type == GF_ISOM_BOX_TYPE_STSZ) {
@@ -5984,6 +6006,7 @@ GF_Err stsz_Read(GF_Box *s, GF_BitStream *bs)
 				GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[iso file] Invalid number of entries %d in stsz\n", ptr->sampleCount));
 				return GF_ISOM_INVALID_FILE;
 			}
+			if (gf_isom_box_defer_table(s, bs, &ptr->lazy, start, payload_size)) return GF_OK;
 			ptr->sizes = (u32 *) gf_malloc(ptr->sampleCount * sizeof(u32));
 			ptr->alloc_size = ptr->sampleCount;
 			if (! ptr->sizes) return GF_OUT_OF_MEM;
@@ -6003,6 +6026,7 @@ GF_Err stsz_Read(GF_Box *s, GF_BitStream *bs)
 				return GF_ISOM_INVALID_FILE;
 			}
 		}
+		if (gf_isom_box_defer_table(s, bs, &ptr->lazy, start, payload_size)) return GF_OK;
 		//note we could optimize the mem usage by keeping the table compact
 		//in memory. But that would complicate both caching and editing
 		//we therefore keep all sizes as u32 and uncompress the table
@@ -6167,6 +6191,8 @@ GF_Err stts_Read(GF_Box *s, GF_BitStream *bs)
 {
 	u32 i;
 	GF_TimeToSampleBox *ptr = (GF_TimeToSampleBox *)s;
+	u64 start = gf_bs_get_position(bs);
+	u64 payload_size = s->size;
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
 	ptr->w_LastDTS = 0;
@@ -6177,6 +6203,7 @@ GF_Err stts_Read(GF_Box *s, GF_BitStream *bs)
 		GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[iso file] Invalid number of entries %d in stts\n", ptr->nb_entries));
 		return GF_ISOM_INVALID_FILE;
 	}
+	if (gf_isom_box_defer_table(s, bs, &ptr->lazy, start, payload_size)) return GF_OK;
 
 	ptr->alloc_size = ptr->nb_entries;
 	ptr->entries = gf_malloc(sizeof(GF_SttsEntry)*ptr->alloc_size);
@@ -6911,7 +6938,7 @@ static void gf_isom_check_sample_desc(GF_TrackBox *trak)
 			u64 pos = gf_bs_get_position(bs); \
 			u32 count_subb = 0; \
 			GF_Err e;\
-			gf_bs_set_cookie(bs, 1);\
+			gf_bs_set_cookie(bs, GF_ISOM_BS_COOKIE_NO_LOGS);\
 			e = gf_isom_box_array_read((GF_Box *) _box, bs, gf_isom_box_add_default); \
 			count_subb = _box->other_boxes ? gf_list_count(_box->other_boxes) : 0; \
 			if (!count_subb || e) { \
@@ -334,6 +334,7 @@ GF_Err stbl_dump(GF_Box *a, FILE * trace)
 {
 	GF_SampleTableBox *p;
 	p = (GF_SampleTableBox *)a;
+	stbl_LoadLazyTables(p);
 	gf_isom_box_dump_start(a, "SampleTableBox", trace);
 	fprintf(trace, ">\n");
 
@@ -96,7 +96,7 @@ GF_Err gf_isom_box_parse_ex(GF_Box **outBox, GF_BitStream *bs, u32 parent_type,
 	char uuid[16];
 	GF_Err e;
 	GF_Box *newBox;
-	Bool skip_logs = gf_bs_get_cookie(bs) ? GF_TRUE : GF_FALSE;
+	Bool skip_logs = (gf_bs_get_cookie(bs) & GF_ISOM_BS_COOKIE_NO_LOGS) ? GF_TRUE : GF_FALSE;
 
 	if ((bs == NULL) || (outBox == NULL) ) return GF_BAD_PARAM;
 	*outBox = NULL;
@@ -1328,12 +1328,39 @@ void gf_isom_registry_disable(u32 boxCode, Bool disable)
 	}
 }
 
+#define BOX_REG_HASH_SIZE	256
+#define BOX_REG_HASH(_4cc)	(((_4cc) ^ ((_4cc)>>8) ^ ((_4cc)>>16) ^ ((_4cc)>>24)) & (BOX_REG_HASH_SIZE-1))
+#define BOX_REG_COUNT	(sizeof(box_registry) / sizeof(struct box_registry_entry))
+
+/*registry entries sharing the same 4CC hash, chained in registry order. The index is built by gf_sys_init before any thread
+is started and is only read afterwards; until it is built, lookups scan the whole registry*/
+#define BOX_REG_END	0xFFFF
+static u16 box_reg_hash[BOX_REG_HASH_SIZE];
+static u16 box_reg_next[BOX_REG_COUNT];
+static Bool box_reg_hash_init = GF_FALSE;
+
+void gf_isom_registry_init()
+{
+	u32 i;
+	if (box_reg_hash_init) return;
+
+	for (i=0; i<BOX_REG_HASH_SIZE; i++) box_reg_hash[i] = BOX_REG_END;
+	for (i=BOX_REG_COUNT-1; i>0; i--) {
+		u32 h = BOX_REG_HASH(box_registry[i].box_4cc);
+		box_reg_next[i] = box_reg_hash[h];
+		box_reg_hash[h] = i;
+	}
+	box_reg_hash_init = GF_TRUE;
+}
+
 static u32 get_box_reg_idx(u32 boxCode, u32 parent_type)
 {
 	u32 i=0, count = gf_isom_get_num_supported_boxes();
 	const char *parent_name = parent_type ? gf_4cc_to_str(parent_type) : NULL;
 
-	for (i=1; i<count; i++) {
+	/*only check the registry entries with the same 4CC hash, in registry order*/
+	i = box_reg_hash_init ? box_reg_hash[BOX_REG_HASH(boxCode)] : 1;
+	while ((i != BOX_REG_END) && (i<count)) {
 		if (box_registry[i].box_4cc==boxCode) {
 			if (!parent_type) return i;
 			if (strstr(box_registry[i].parents_4cc, parent_name) != NULL) return i;
@@ -1344,6 +1371,7 @@ static u32 get_box_reg_idx(u32 boxCode, u32 parent_type)
 					return i;
 			}
 		}
+		i = box_reg_hash_init ? box_reg_next[i] : i+1;
 	}
 	return 0;
 }
@@ -1412,7 +1440,7 @@ GF_Err gf_isom_box_array_read_ex(GF_Box *parent, GF_BitStream *bs, GF_Err (*add_
 {
 	GF_Err e;
 	GF_Box *a = NULL;
-	Bool skip_logs = gf_bs_get_cookie(bs) ? GF_TRUE : GF_FALSE;
+	Bool skip_logs = (gf_bs_get_cookie(bs) & GF_ISOM_BS_COOKIE_NO_LOGS) ? GF_TRUE : GF_FALSE;
 
 	//we may have terminators in some QT files (4 bytes set to 0 ...)
 	while (parent->size>=8) {
@@ -1528,6 +1556,68 @@ GF_Err gf_isom_box_read(GF_Box *a, GF_BitStream *bs)
 	return a->registry->read_fn(a, bs);
 }
 
+/*tables smaller than this are parsed in place, seeking back to them later would cost more than parsing*/
+#define ISOM_LAZY_TABLE_MIN_SIZE	4096
+
+Bool gf_isom_box_defer_table(GF_Box *s, GF_BitStream *bs, GF_LazyTable *lazy, u64 payload_start, u64 payload_size)
+{
+	if (! (gf_bs_get_cookie(bs) & GF_ISOM_BS_COOKIE_LAZY_TABLES)) return GF_FALSE;
+	if (s->size < ISOM_LAZY_TABLE_MIN_SIZE) return GF_FALSE;
+
+	lazy->bs = bs;
+	lazy->offset = payload_start;
+	lazy->size = payload_size;
+	gf_bs_skip_bytes(bs, s->size);
+	s->size = 0;
+	return GF_TRUE;
+}
+
+GF_Err gf_isom_box_load_table(GF_Box *s, GF_LazyTable *lazy)
+{
+	GF_Err e;
+	u64 pos, size;
+	GF_BitStream *bs = lazy->bs;
+	if (!bs) return GF_OK;
+	lazy->bs = NULL;
+
+	pos = gf_bs_get_position(bs);
+	size = s->size;
+	gf_bs_seek(bs, lazy->offset);
+	s->size = lazy->size;
+	e = gf_isom_box_read(s, bs);
+	s->size = size;
+	gf_bs_seek(bs, pos);
+	if (!e) return GF_OK;
+
+	GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[iso file] Failed to load table %s at position "LLU": %s\n", gf_4cc_to_str(s->type), lazy->offset, gf_error_to_string(e) ));
+	/*entries may be partially parsed, don't expose them*/
+	switch (s->type) {
+	case GF_ISOM_BOX_TYPE_STTS:
+		((GF_TimeToSampleBox *)s)->nb_entries = 0;
+		break;
+	case GF_ISOM_BOX_TYPE_CTTS:
+		((GF_CompositionOffsetBox *)s)->nb_entries = 0;
+		break;
+	case GF_ISOM_BOX_TYPE_STSS:
+		((GF_SyncSampleBox *)s)->nb_entries = 0;
+		break;
+	case GF_ISOM_BOX_TYPE_STSC:
+		((GF_SampleToChunkBox *)s)->nb_entries = 0;
+		break;
+	case GF_ISOM_BOX_TYPE_STCO:
+		((GF_ChunkOffsetBox *)s)->nb_entries = 0;
+		break;
+	case GF_ISOM_BOX_TYPE_CO64:
+		((GF_ChunkLargeOffsetBox *)s)->nb_entries = 0;
+		break;
+	case GF_ISOM_BOX_TYPE_STSZ:
+	case GF_ISOM_BOX_TYPE_STZ2:
+		((GF_SampleSizeBox *)s)->sampleCount = 0;
+		break;
+	}
+	return e;
+}
+
 #ifndef GPAC_DISABLE_ISOM_WRITE
 
 GF_Err gf_isom_box_write_listing(GF_Box *a, GF_BitStream *bs)
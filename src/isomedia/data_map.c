@@ -28,6 +28,10 @@
 
 #ifndef GPAC_DISABLE_ISOM
 
+/*write-behind buffer used by data maps opened for writing when no size is set through gf_isom_set_output_buffering.
+Samples are appended one by one, this keeps the number of write calls independent of the sample count*/
+#define GF_ISOM_DEFAULT_WRITE_BUFFER	(1024*1024)
+
 static u32 default_write_buffering_size = 0;
 
 GF_EXPORT
@@ -45,6 +49,125 @@ GF_Err gf_isom_set_output_buffering(GF_ISOFile *movie, u32 size)
 #endif
 }
 
+/*byte ranges closer than this are read at once*/
+#define GF_ISOM_PREFETCH_MAX_GAP	(64*1024)
+/*max size of a single prefetched range*/
+#define GF_ISOM_PREFETCH_MAX_RANGE	(64*1024*1024)
+
+static int gf_isom_range_cmp(const void *a, const void *b)
+{
+	u64 o1 = ((GF_DataMapRange *)a)->offset;
+	u64 o2 = ((GF_DataMapRange *)b)->offset;
+	if (o1 < o2) return -1;
+	if (o1 > o2) return 1;
+	return 0;
+}
+
+GF_EXPORT
+GF_Err gf_isom_prefetch_samples(GF_ISOFile *movie, u32 nb_tracks, u32 *tracks, u32 *first_samples, u32 *last_samples, u32 max_size)
+{
+	GF_Err e = GF_OK;
+	u32 i, j, nb_ranges, alloc_ranges, nb_merged;
+	u64 total;
+	GF_DataMapRange *ranges;
+	GF_FileDataMap *fdm;
+
+	if (!movie) return GF_BAD_PARAM;
+	if (movie->openMode != GF_ISOM_OPEN_READ) return GF_NOT_SUPPORTED;
+	fdm = (GF_FileDataMap *) movie->movieFileMap;
+	if (!fdm || (fdm->type != GF_ISOM_DATA_FILE)) return GF_NOT_SUPPORTED;
+	if (!nb_tracks) return gf_isom_fdm_prefetch(fdm, NULL, 0);
+
+	/*gather byte ranges of all samples*/
+	nb_ranges = alloc_ranges = 0;
+	ranges = NULL;
+	for (i=0; i<nb_tracks; i++) {
+		u32 last_di = 0, first, last;
+		u32 cache_index, cache_first_sample, cache_chunk, cache_ghost;
+		Bool self_contained = GF_FALSE;
+		GF_SampleTableBox *stbl;
+		GF_TrackBox *trak = gf_isom_get_track_from_file(movie, tracks[i]);
+		if (!trak) continue;
+		stbl = trak->Media->information->sampleTable;
+		if (!stbl->SampleSize || !stbl->SampleToChunk) continue;
+
+		first = first_samples[i];
+		last = last_samples[i];
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+		if (last <= trak->sample_count_at_seg_start) continue;
+		first = (first > trak->sample_count_at_seg_start) ? first - trak->sample_count_at_seg_start : 1;
+		last -= trak->sample_count_at_seg_start;
+#endif
+		/*walking the tables moves the chunk cache, restore it so that the caller keeps reading from its position*/
+		cache_index = stbl->SampleToChunk->currentIndex;
+		cache_first_sample = stbl->SampleToChunk->firstSampleInCurrentChunk;
+		cache_chunk = stbl->SampleToChunk->currentChunk;
+		cache_ghost = stbl->SampleToChunk->ghostNumber;
+
+		for (j=first; j<=last; j++) {
+			u32 di, chunk, size;
+			u64 offset;
+			if (stbl_GetSampleInfos(stbl, j, &offset, &chunk, &di, NULL) != GF_OK) break;
+			if (stbl_GetSampleSize(stbl->SampleSize, j, &size) != GF_OK) break;
+			if (di != last_di) {
+				last_di = di;
+				self_contained = gf_isom_is_self_contained(movie, tracks[i], di);
+			}
+			if (!self_contained || !size) continue;
+
+			if (nb_ranges == alloc_ranges) {
+				GF_DataMapRange *new_ranges;
+				alloc_ranges = alloc_ranges ? 2*alloc_ranges : 256;
+				new_ranges = (GF_DataMapRange *)gf_realloc(ranges, sizeof(GF_DataMapRange) * alloc_ranges);
+				if (!new_ranges) {
+					e = GF_OUT_OF_MEM;
+					break;
+				}
+				ranges = new_ranges;
+			}
+			ranges[nb_ranges].offset = offset;
+			ranges[nb_ranges].size = size;
+			ranges[nb_ranges].data = NULL;
+			nb_ranges++;
+		}
+		stbl->SampleToChunk->currentIndex = cache_index;
+		stbl->SampleToChunk->firstSampleInCurrentChunk = cache_first_sample;
+		stbl->SampleToChunk->currentChunk = cache_chunk;
+		stbl->SampleToChunk->ghostNumber = cache_ghost;
+		if (e) {
+			gf_free(ranges);
+			return e;
+		}
+	}
+	if (!nb_ranges) return gf_isom_fdm_prefetch(fdm, NULL, 0);
+
+	/*sort by offset and merge close ranges*/
+	qsort(ranges, nb_ranges, sizeof(GF_DataMapRange), gf_isom_range_cmp);
+	nb_merged = 0;
+	total = 0;
+	for (i=0; i<nb_ranges; i++) {
+		GF_DataMapRange *r = &ranges[i];
+		if (nb_merged) {
+			GF_DataMapRange *prev = &ranges[nb_merged-1];
+			u64 end = prev->offset + prev->size;
+			if ((r->offset <= end + GF_ISOM_PREFETCH_MAX_GAP) && (r->offset + r->size - prev->offset <= GF_ISOM_PREFETCH_MAX_RANGE)) {
+				u64 new_end = MAX(end, r->offset + r->size);
+				if (max_size && (total + new_end - end > max_size)) break;
+				total += new_end - end;
+				prev->size = (u32) (new_end - prev->offset);
+				continue;
+			}
+		}
+		if (max_size && (total + r->size > max_size)) break;
+		total += r->size;
+		ranges[nb_merged] = *r;
+		nb_merged++;
+	}
+	e = gf_isom_fdm_prefetch(fdm, ranges, nb_merged);
+	gf_free(ranges);
+	return e;
+}
+
 void gf_isom_datamap_del(GF_DataMap *ptr)
 {
 	if (!ptr) return;
@@ -363,9 +486,7 @@ GF_DataMap *gf_isom_fdm_new_temp(const char *sPath)
 		return NULL;
 	}
 
-	if (default_write_buffering_size) {
-		gf_bs_set_output_buffering(tmp->bs, default_write_buffering_size);
-	}
+	gf_bs_set_output_buffering(tmp->bs, default_write_buffering_size ? default_write_buffering_size : GF_ISOM_DEFAULT_WRITE_BUFFER);
 
 	return (GF_DataMap *)tmp;
 }
@@ -456,15 +577,14 @@ GF_DataMap *gf_isom_fdm_new(const char *sPath, u8 mode)
 		gf_free(tmp);
 		return NULL;
 	}
-	if (default_write_buffering_size) {
-		gf_bs_set_output_buffering(tmp->bs, default_write_buffering_size);
-	}
+	gf_bs_set_output_buffering(tmp->bs, default_write_buffering_size ? default_write_buffering_size : GF_ISOM_DEFAULT_WRITE_BUFFER);
 	return (GF_DataMap *)tmp;
 }
 
 void gf_isom_fdm_del(GF_FileDataMap *ptr)
 {
 	if (!ptr || (ptr->type != GF_ISOM_DATA_FILE && ptr->type != GF_ISOM_DATA_MEM)) return;
+	gf_isom_fdm_prefetch(ptr, NULL, 0);
 	if (ptr->bs) gf_bs_del(ptr->bs);
 	if (ptr->stream && !ptr->is_stdout)
 		gf_fclose(ptr->stream);
@@ -478,9 +598,84 @@ void gf_isom_fdm_del(GF_FileDataMap *ptr)
 	gf_free(ptr);
 }
 
+static GF_DataMapRange *gf_isom_fdm_find_range(GF_FileDataMap *ptr, u64 fileOffset, u32 size)
+{
+	u32 lo, hi;
+	GF_DataMapRange *r;
+	if (!ptr->nb_ranges) return NULL;
+	/*last range starting at or before fileOffset*/
+	lo = 0;
+	hi = ptr->nb_ranges;
+	while (hi - lo > 1) {
+		u32 mid = (lo + hi) / 2;
+		if (ptr->ranges[mid].offset <= fileOffset) lo = mid;
+		else hi = mid;
+	}
+	r = &ptr->ranges[lo];
+	if (r->offset > fileOffset) return NULL;
+	if (fileOffset + size > r->offset + r->size) return NULL;
+	return r;
+}
+
+GF_Err gf_isom_fdm_prefetch(GF_FileDataMap *ptr, GF_DataMapRange *ranges, u32 nb_ranges)
+{
+	u32 i;
+	u64 size, pos;
+	if (!ptr) return GF_BAD_PARAM;
+
+	ptr->nb_ranges = 0;
+	if (!nb_ranges) {
+		if (ptr->ranges) gf_free(ptr->ranges);
+		if (ptr->prefetch_buf) gf_free(ptr->prefetch_buf);
+		ptr->ranges = NULL;
+		ptr->prefetch_buf = NULL;
+		ptr->nb_alloc_ranges = 0;
+		ptr->prefetch_buf_size = 0;
+		return GF_OK;
+	}
+
+	if (ptr->nb_alloc_ranges < nb_ranges) {
+		GF_DataMapRange *new_ranges = (GF_DataMapRange *)gf_realloc(ptr->ranges, sizeof(GF_DataMapRange) * nb_ranges);
+		/*keep the previous array, it is released with the data map*/
+		if (!new_ranges) return GF_OUT_OF_MEM;
+		ptr->ranges = new_ranges;
+		ptr->nb_alloc_ranges = nb_ranges;
+	}
+	size = 0;
+	for (i=0; i<nb_ranges; i++) size += ranges[i].size;
+	if (ptr->prefetch_buf_size < size) {
+		if (ptr->prefetch_buf) gf_free(ptr->prefetch_buf);
+		ptr->prefetch_buf = (char *)gf_malloc(sizeof(char) * (size_t) size);
+		ptr->prefetch_buf_size = ptr->prefetch_buf ? size : 0;
+		if (!ptr->prefetch_buf) return GF_OUT_OF_MEM;
+	}
+
+	pos = 0;
+	for (i=0; i<nb_ranges; i++) {
+		GF_DataMapRange *r = &ptr->ranges[ptr->nb_ranges];
+		*r = ranges[i];
+		r->data = ptr->prefetch_buf + pos;
+		if (r->offset + r->size > gf_bs_get_size(ptr->bs)) continue;
+		if (gf_bs_seek(ptr->bs, r->offset) != GF_OK) continue;
+		if (gf_bs_read_data(ptr->bs, r->data, r->size) != r->size) continue;
+		pos += r->size;
+		ptr->nb_ranges++;
+	}
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[iso file] Prefetched %d byte ranges ("LLU" bytes)\n", ptr->nb_ranges, pos));
+	return GF_OK;
+}
+
 u32 gf_isom_fdm_get_data(GF_FileDataMap *ptr, char *buffer, u32 bufferLength, u64 fileOffset)
 {
 	u32 bytesRead;
+	GF_DataMapRange *r;
+
+	//prefetched data
+	r = gf_isom_fdm_find_range(ptr, fileOffset, bufferLength);
+	if (r) {
+		memcpy(buffer, r->data + (fileOffset - r->offset), bufferLength);
+		return bufferLength;
+	}
 
 	//can we seek till that point ???
 	if (fileOffset > gf_bs_get_size(ptr->bs)) return 0;
@@ -547,8 +742,8 @@ GF_Err FDM_AddData(GF_FileDataMap *ptr, char *data, u32 dataSize)
 		return GF_IO_ERR;
 	}
 	ptr->curPos = gf_bs_get_position(ptr->bs);
-	//flush the stream !!
-	if (ptr->stream) fflush(ptr->stream);
+	/*data is kept in the write-behind buffer of the bitstream and written when the buffer is full, when the data map
+	is read or flushed (gf_isom_datamap_flush), or when it is closed*/
 	return GF_OK;
 }
 
@@ -532,6 +532,25 @@ GF_ISOFile *gf_isom_new_movie()
 	return mov;
 }
 
+/*fragmented files may swap the movie file map, in which case deferred tables can no longer be located: load them right away*/
+static GF_Err gf_isom_load_lazy_tables(GF_ISOFile *mov)
+{
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+	u32 i;
+	GF_Err e;
+	GF_TrackBox *trak;
+	if (!mov->moov || !mov->moov->mvex) return GF_OK;
+
+	i=0;
+	while ((trak = (GF_TrackBox *)gf_list_enum(mov->moov->trackList, &i))) {
+		if (!trak->Media || !trak->Media->information || !trak->Media->information->sampleTable) continue;
+		e = stbl_LoadLazyTables(trak->Media->information->sampleTable);
+		if (e) return e;
+	}
+#endif
+	return GF_OK;
+}
+
 extern Bool use_dump_mode;
 
 //Create and parse the movie for READ - EDIT only
@@ -542,6 +561,13 @@ GF_ISOFile *gf_isom_open_file(const char *fileName, u32 OpenMode, const char *tm
 	GF_ISOFile *mov = gf_isom_new_movie();
 	if (!mov || !fileName) return NULL;
 
+	if (OpenMode & GF_ISOM_OPEN_LAZY) {
+		OpenMode &= ~GF_ISOM_OPEN_LAZY;
+		//only read-only files can defer table parsing
+		if ((OpenMode == GF_ISOM_OPEN_READ) || (OpenMode == GF_ISOM_OPEN_READ_DUMP))
+			mov->lazy_tables = GF_TRUE;
+	}
+
 	mov->fileName = gf_strdup(fileName);
 	mov->openMode = OpenMode;
 
@@ -612,7 +638,12 @@ GF_ISOFile *gf_isom_open_file(const char *fileName, u32 OpenMode, const char *tm
 	use_dump_mode = mov->dump_mode_alloc;
 
 	//OK, let's parse the movie...
+	if (mov->lazy_tables) gf_bs_set_cookie(mov->movieFileMap->bs, GF_ISOM_BS_COOKIE_LAZY_TABLES);
 	mov->LastError = gf_isom_parse_movie_boxes(mov, &bytes, 0);
+	if (mov->lazy_tables) {
+		gf_bs_set_cookie(mov->movieFileMap->bs, 0);
+		if (!mov->LastError) mov->LastError = gf_isom_load_lazy_tables(mov);
+	}
 
 	if (!mov->LastError && (OpenMode == GF_ISOM_OPEN_CAT_FRAGMENTS)) {
 		gf_isom_datamap_del(mov->movieFileMap);
@@ -1498,10 +1498,13 @@ GF_EXPORT
 u32 gf_isom_get_constant_sample_duration(GF_ISOFile *the_file, u32 trackNumber)
 {
 	GF_TrackBox *trak;
+	GF_TimeToSampleBox *stts;
 	trak = gf_isom_get_track_from_file(the_file, trackNumber);
 	if (!trak) return 0;
-	if (trak->Media->information->sampleTable->TimeToSample->nb_entries != 1) return 0;
-	return trak->Media->information->sampleTable->TimeToSample->entries[0].sampleDelta;
+	stts = trak->Media->information->sampleTable->TimeToSample;
+	if (stts->nb_entries != 1) return 0;
+	if (gf_isom_box_load_table((GF_Box *)stts, &stts->lazy)) return 0;
+	return stts->entries[0].sampleDelta;
 }
 
 GF_EXPORT
@@ -1516,6 +1519,7 @@ Bool gf_isom_enable_raw_pack(GF_ISOFile *the_file, u32 trackNumber, u32 pack_num
 	if (trak->Media->handler->handlerType != GF_ISOM_MEDIA_AUDIO) return GF_FALSE;
 	//and sample duration of 1
 	if (trak->Media->information->sampleTable->TimeToSample->nb_entries != 1) return GF_FALSE;
+	if (stbl_LoadLazyTables(trak->Media->information->sampleTable)) return GF_FALSE;
 	if (trak->Media->information->sampleTable->TimeToSample->entries[0].sampleDelta != 1) return GF_FALSE;
 	//and sample with constant size
 	if (!trak->Media->information->sampleTable->SampleSize->sampleSize) return GF_FALSE;
@@ -1534,6 +1538,7 @@ u32 gf_isom_has_time_offset(GF_ISOFile *the_file, u32 trackNumber)
 
 	//return true at the first offset found
 	ctts = trak->Media->information->sampleTable->CompositionOffset;
+	if (gf_isom_box_load_table((GF_Box *)ctts, &ctts->lazy)) return 0;
 	for (i=0; i<ctts->nb_entries; i++) {
 		if (ctts->entries[i].decodingOffset && ctts->entries[i].sampleCount) return ctts->version ? 2 : 1;
 	}
@@ -2410,6 +2415,7 @@ GF_Err gf_isom_get_chunks_infos(GF_ISOFile *movie, u32 trackNumber, u32 *dur_min
 	stsc = trak->Media->information->sampleTable->SampleToChunk;
 	stts = trak->Media->information->sampleTable->TimeToSample;
 	if (!stsc || !stts) return GF_ISOM_INVALID_FILE;
+	ISOM_LOAD_LAZY_TABLE(stsc)
 
 	dmin = smin = (u32) -1;
 	dmax = smax = 0;
@@ -2496,6 +2502,8 @@ GF_Err gf_isom_get_fragment_defaults(GF_ISOFile *the_file, u32 trackNumber,
 
 	stbl = trak->Media->information->sampleTable;
 	if (!stbl->TimeToSample || !stbl->SampleSize || !stbl->SampleToChunk) return GF_ISOM_INVALID_FILE;
+	ISOM_LOAD_LAZY_TABLE(stbl->TimeToSample)
+	ISOM_LOAD_LAZY_TABLE(stbl->SampleToChunk)
 
 
 	//duration
@@ -2649,6 +2657,8 @@ GF_Err gf_isom_reset_data_offset(GF_ISOFile *movie, u64 *top_box_start)
 	return GF_OK;
 }
 
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+
 #define RECREATE_BOX(_a, __cast)	\
     if (_a) {	\
         type = _a->type;\
@@ -2656,19 +2666,83 @@ GF_Err gf_isom_reset_data_offset(GF_ISOFile *movie, u64 *top_box_start)
         _a = __cast gf_isom_box_new(type);\
     }\
 
+/*empties a table box in place, keeping its entries allocated so that the next segment merge does not reallocate them*/
+#define RESET_TABLE_BOX(_a, __cast, __type, _entries)	\
+    if (_a && !_a->other_boxes) {	\
+        __type *__tab = (__type *) _a;	\
+        void *__entries = __tab->_entries;	\
+        u32 __alloc_size = __tab->alloc_size;	\
+        const struct box_registry_entry *__registry = __tab->registry;	\
+        type = __tab->type;	\
+        memset(__tab, 0, sizeof(__type));	\
+        __tab->type = type;	\
+        __tab->registry = __registry;	\
+        __tab->_entries = __entries;	\
+        __tab->alloc_size = __alloc_size;	\
+    } else {	\
+        RECREATE_BOX(_a, __cast);	\
+    }\
+
+/*resets the sample tables of a track before merging the fragments of a new segment*/
+static void isom_reset_fragment_tables(GF_SampleTableBox *stbl)
+{
+	u32 j, type;
+	GF_Box *a;
+
+	if (stbl->ChunkOffset && (stbl->ChunkOffset->type==GF_ISOM_BOX_TYPE_CO64)) {
+		RESET_TABLE_BOX(stbl->ChunkOffset, (GF_Box *), GF_ChunkLargeOffsetBox, offsets);
+	} else {
+		RESET_TABLE_BOX(stbl->ChunkOffset, (GF_Box *), GF_ChunkOffsetBox, offsets);
+	}
+	RESET_TABLE_BOX(stbl->CompositionOffset, (GF_CompositionOffsetBox *), GF_CompositionOffsetBox, entries);
+	RESET_TABLE_BOX(stbl->SampleSize, (GF_SampleSizeBox *), GF_SampleSizeBox, sizes);
+	RESET_TABLE_BOX(stbl->SampleToChunk, (GF_SampleToChunkBox *), GF_SampleToChunkBox, entries);
+	RESET_TABLE_BOX(stbl->SyncSample, (GF_SyncSampleBox *), GF_SyncSampleBox, sampleNumbers);
+	RESET_TABLE_BOX(stbl->TimeToSample, (GF_TimeToSampleBox *), GF_TimeToSampleBox, entries);
+
+	RECREATE_BOX(stbl->DegradationPriority, (GF_DegradationPriorityBox *));
+	RECREATE_BOX(stbl->PaddingBits, (GF_PaddingBitsBox *));
+	RECREATE_BOX(stbl->SampleDep, (GF_SampleDependencyTypeBox *));
+	RECREATE_BOX(stbl->ShadowSync, (GF_ShadowSyncBox *));
+
+	gf_isom_box_array_del(stbl->sai_offsets);
+	stbl->sai_offsets = NULL;
+
+	gf_isom_box_array_del(stbl->sai_sizes);
+	stbl->sai_sizes = NULL;
+
+	gf_isom_box_array_del(stbl->sampleGroups);
+	stbl->sampleGroups = NULL;
+
+	j = stbl->nb_sgpd_in_stbl;
+	while ((a = (GF_Box *)gf_list_enum(stbl->sampleGroupsDescription, &j))) {
+		gf_isom_box_del(a);
+		j--;
+		gf_list_rem(stbl->sampleGroupsDescription, j);
+	}
+
+	j = stbl->nb_other_boxes_in_stbl;
+	while ((a = (GF_Box *)gf_list_enum(stbl->other_boxes, &j))) {
+		gf_isom_box_del(a);
+		j--;
+		gf_list_rem(stbl->other_boxes, j);
+	}
+}
+
+#endif
+
 
 GF_EXPORT
 GF_Err gf_isom_reset_tables(GF_ISOFile *movie, Bool reset_sample_count)
 {
 #ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
-	u32 i, j;
-	GF_Box *a;
+	u32 i;
 
 	if (!movie || !movie->moov || !movie->moov->mvex) return GF_BAD_PARAM;
 	for (i=0; i<gf_list_count(movie->moov->trackList); i++) {
 		GF_TrackBox *trak = (GF_TrackBox *)gf_list_get(movie->moov->trackList, i);
 
-		u32 type, dur;
+		u32 dur;
 		u64 dts;
 		GF_SampleTableBox *stbl = trak->Media->information->sampleTable;
 
@@ -2681,39 +2755,7 @@ GF_Err gf_isom_reset_tables(GF_ISOFile *movie, Bool reset_sample_count)
 			}
 		}
 
-		RECREATE_BOX(stbl->ChunkOffset, (GF_Box *));
-		RECREATE_BOX(stbl->CompositionOffset, (GF_CompositionOffsetBox *));
-		RECREATE_BOX(stbl->DegradationPriority, (GF_DegradationPriorityBox *));
-		RECREATE_BOX(stbl->PaddingBits, (GF_PaddingBitsBox *));
-		RECREATE_BOX(stbl->SampleDep, (GF_SampleDependencyTypeBox *));
-		RECREATE_BOX(stbl->SampleSize, (GF_SampleSizeBox *));
-		RECREATE_BOX(stbl->SampleToChunk, (GF_SampleToChunkBox *));
-		RECREATE_BOX(stbl->ShadowSync, (GF_ShadowSyncBox *));
-		RECREATE_BOX(stbl->SyncSample, (GF_SyncSampleBox *));
-		RECREATE_BOX(stbl->TimeToSample, (GF_TimeToSampleBox *));
-
-		gf_isom_box_array_del(stbl->sai_offsets);
-		stbl->sai_offsets = NULL;
-
-		gf_isom_box_array_del(stbl->sai_sizes);
-		stbl->sai_sizes = NULL;
-
-		gf_isom_box_array_del(stbl->sampleGroups);
-		stbl->sampleGroups = NULL;
-
-		j = stbl->nb_sgpd_in_stbl;
-		while ((a = (GF_Box *)gf_list_enum(stbl->sampleGroupsDescription, &j))) {
-			gf_isom_box_del(a);
-			j--;
-			gf_list_rem(stbl->sampleGroupsDescription, j);
-		}
-
-		j = stbl->nb_other_boxes_in_stbl;
-		while ((a = (GF_Box *)gf_list_enum(stbl->other_boxes, &j))) {
-			gf_isom_box_del(a);
-			j--;
-			gf_list_rem(stbl->other_boxes, j);
-		}
+		isom_reset_fragment_tables(stbl);
 
 		if (reset_sample_count) {
 			trak->Media->information->sampleTable->SampleSize->sampleCount = 0;
@@ -2757,7 +2799,7 @@ GF_Err gf_isom_release_segment(GF_ISOFile *movie, Bool reset_tables)
 
 
 		if (reset_tables) {
-			u32 type, dur;
+			u32 dur;
 			u64 dts;
 			GF_SampleTableBox *stbl = trak->Media->information->sampleTable;
 
@@ -2787,26 +2829,6 @@ GF_Err gf_isom_release_segment(GF_ISOFile *movie, Bool reset_tables)
 				}
 			}
 
-			RECREATE_BOX(stbl->ChunkOffset, (GF_Box *));
-			RECREATE_BOX(stbl->CompositionOffset, (GF_CompositionOffsetBox *));
-			RECREATE_BOX(stbl->DegradationPriority, (GF_DegradationPriorityBox *));
-			RECREATE_BOX(stbl->PaddingBits, (GF_PaddingBitsBox *));
-			RECREATE_BOX(stbl->SampleDep, (GF_SampleDependencyTypeBox *));
-			RECREATE_BOX(stbl->SampleSize, (GF_SampleSizeBox *));
-			RECREATE_BOX(stbl->SampleToChunk, (GF_SampleToChunkBox *));
-			RECREATE_BOX(stbl->ShadowSync, (GF_ShadowSyncBox *));
-			RECREATE_BOX(stbl->SyncSample, (GF_SyncSampleBox *));
-			RECREATE_BOX(stbl->TimeToSample, (GF_TimeToSampleBox *));
-
-			gf_isom_box_array_del(stbl->sai_offsets);
-			stbl->sai_offsets = NULL;
-
-			gf_isom_box_array_del(stbl->sai_sizes);
-			stbl->sai_sizes = NULL;
-
-			gf_isom_box_array_del(stbl->sampleGroups);
-			stbl->sampleGroups = NULL;
-
 			if (trak->sample_encryption) {
 				gf_list_del_item(trak->other_boxes, trak->sample_encryption);
 				if (trak->Media->information->sampleTable->other_boxes) {
@@ -2816,20 +2838,7 @@ GF_Err gf_isom_release_segment(GF_ISOFile *movie, Bool reset_tables)
 				trak->sample_encryption = NULL;
 			}
 
-			j = stbl->nb_sgpd_in_stbl;
-			while ((a = (GF_Box *)gf_list_enum(stbl->sampleGroupsDescription, &j))) {
-				gf_isom_box_del(a);
-				j--;
-				gf_list_rem(stbl->sampleGroupsDescription, j);
-			}
-
-
-			j = stbl->nb_other_boxes_in_stbl;
-			while ((a = (GF_Box *)gf_list_enum(stbl->other_boxes, &j))) {
-				gf_isom_box_del(a);
-				j--;
-				gf_list_rem(stbl->other_boxes, j);
-			}
+			isom_reset_fragment_tables(stbl);
 		}
 
 
@@ -3251,6 +3260,7 @@ u64 gf_isom_get_media_data_size(GF_ISOFile *movie, u32 trackNumber)
 	if (!tk) return 0;
 	stsz = tk->Media->information->sampleTable->SampleSize;
 	if (stsz->sampleSize) return stsz->sampleSize*stsz->sampleCount;
+	if (gf_isom_box_load_table((GF_Box *)stsz, &stsz->lazy)) return 0;
 	size = 0;
 	for (i=0; i<stsz->sampleCount; i++) size += stsz->sizes[i];
 	return size;
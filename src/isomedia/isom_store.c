@@ -31,6 +31,9 @@
 #define GPAC_ISOM_CPRT_NOTICE "IsoMedia File Produced with GPAC"
 #define GPAC_ISOM_CPRT_NOTICE_VERSION GPAC_ISOM_CPRT_NOTICE" "GPAC_FULL_VERSION
 
+/*block size used when moving media data within the output file*/
+#define GF_ISOM_MOVE_BLOCK_SIZE	(1024*1024)
+
 static GF_Err gf_isom_insert_copyright(GF_ISOFile *movie)
 {
 	u32 i;
@@ -91,6 +94,8 @@ typedef struct
 	u32 size;
 	GF_ISOFile *movie;
 	u32 total_samples, nb_done;
+	/*IO counters: media data copied from the input/temp files, and media data moved within the output file*/
+	u64 copied_bytes, moved_bytes;
 } MovieWriter;
 
 void CleanWriters(GF_List *writers)
@@ -399,6 +404,7 @@ GF_Err WriteSample(MovieWriter *mw, u32 size, u64 offset, u8 isEdited, GF_BitStr
 	if (bytes != size)
 		return GF_IO_ERR;
 
+	mw->copied_bytes += size;
 	mw->nb_done+=nb_samp;
 	gf_set_progress("ISO File Writing", mw->nb_done, mw->total_samples);
 	return GF_OK;
@@ -686,6 +692,84 @@ GF_Err DoWrite(MovieWriter *mw, GF_List *writers, GF_BitStream *bs, u8 Emulation
 }
 
 
+//move the data in [start, end[ of the output file by shift bytes towards the end of the file
+static GF_Err MoveDataForward(MovieWriter *mw, GF_BitStream *bs, u64 start, u64 end, u64 shift)
+{
+	GF_Err e;
+	u32 size;
+	u64 done;
+
+	if (mw->size < GF_ISOM_MOVE_BLOCK_SIZE) {
+		mw->buffer = (char*)gf_realloc(mw->buffer, GF_ISOM_MOVE_BLOCK_SIZE);
+		if (!mw->buffer) return GF_OUT_OF_MEM;
+		mw->size = GF_ISOM_MOVE_BLOCK_SIZE;
+	}
+	//grow the file first, since we cannot seek past its end
+	e = gf_bs_seek(bs, end);
+	if (e) return e;
+	memset(mw->buffer, 0, mw->size);
+	done = 0;
+	while (done < shift) {
+		size = (shift - done > mw->size) ? mw->size : (u32) (shift - done);
+		if (gf_bs_write_data(bs, mw->buffer, size) != size) return GF_IO_ERR;
+		done += size;
+	}
+	//copy from the end so that we never overwrite data not yet moved
+	while (end > start) {
+		size = (end - start > mw->size) ? mw->size : (u32) (end - start);
+		end -= size;
+		e = gf_bs_seek(bs, end);
+		if (e) return e;
+		if (gf_bs_read_data(bs, mw->buffer, size) != size) return GF_IO_ERR;
+		e = gf_bs_seek(bs, end + shift);
+		if (e) return e;
+		if (gf_bs_write_data(bs, mw->buffer, size) != size) return GF_IO_ERR;
+		mw->moved_bytes += size;
+	}
+	return GF_OK;
+}
+
+//capture mode with moov reservation: write the moov in the free box reserved before the mdat. If the moov does not fit
+//the mdat (and everything after it) is moved, and mdat_start is updated
+static GF_Err WriteReservedMoov(MovieWriter *mw, GF_List *writers, GF_BitStream *bs, u64 *mdat_start)
+{
+	GF_Err e;
+	u64 moov_size, avail, shift, end, reserve_start;
+	GF_ISOFile *movie = mw->movie;
+
+	reserve_start = *mdat_start - movie->moov_reserve;
+	end = gf_bs_get_position(bs);
+
+	shift = 0;
+	while (1) {
+		moov_size = GetMoovAndMetaSize(movie, writers);
+		avail = movie->moov_reserve + shift;
+		//the moov fits exactly or leaves room for a free box
+		if ((moov_size == avail) || (moov_size + 8 <= avail)) break;
+		//estimate exceeded, shift the chunk offsets - this may switch to 64 bit offsets, hence the loop
+		e = ShiftOffset(movie, writers, moov_size + 8 - avail);
+		if (e) return e;
+		shift += moov_size + 8 - avail;
+	}
+	if (shift) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[IsoMedia] moov size "LLU" bytes does not fit in the reserved "LLU" bytes, moving media data\n", moov_size, (u64) movie->moov_reserve));
+		e = MoveDataForward(mw, bs, *mdat_start, end, shift);
+		if (e) return e;
+		*mdat_start += shift;
+		end += shift;
+	}
+
+	e = gf_bs_seek(bs, reserve_start);
+	if (e) return e;
+	e = WriteMoovAndMeta(movie, writers, bs);
+	if (e) return e;
+	if (avail > moov_size) {
+		gf_bs_write_u32(bs, (u32) (avail - moov_size));
+		gf_bs_write_u32(bs, GF_ISOM_BOX_TYPE_FREE);
+	}
+	return gf_bs_seek(bs, end);
+}
+
 //write the file track by track, with moov box before or after the mdat
 GF_Err WriteFlat(MovieWriter *mw, u8 moovFirst, GF_BitStream *bs)
 {
@@ -735,6 +819,7 @@ GF_Err WriteFlat(MovieWriter *mw, u8 moovFirst, GF_BitStream *bs)
 				if (movie->is_jp2) begin += 12;
 				if (movie->brand) begin += movie->brand->size;
 				if (movie->pdin) begin += movie->pdin->size;
+				begin += movie->moov_reserve;
 			}
 			totSize -= begin;
 		} else {
@@ -798,7 +883,11 @@ GF_Err WriteFlat(MovieWriter *mw, u8 moovFirst, GF_BitStream *bs)
 		}
 
 		//OK, write the movie box.
-		e = WriteMoovAndMeta(movie, writers, bs);
+		if ((movie->openMode == GF_ISOM_OPEN_WRITE) && movie->moov_reserve && totSize) {
+			e = WriteReservedMoov(mw, writers, bs, &begin);
+		} else {
+			e = WriteMoovAndMeta(movie, writers, bs);
+		}
 		if (e) goto exit;
 
 #ifndef GPAC_DISABLE_ISOM_ADOBE
@@ -1360,6 +1449,7 @@ GF_Err WriteToFile(GF_ISOFile *movie)
 	FILE *stream;
 	GF_BitStream *bs;
 	MovieWriter mw;
+	u64 file_size = 0;
 	GF_Err e = GF_OK;
 	if (!movie) return GF_BAD_PARAM;
 
@@ -1392,6 +1482,7 @@ GF_Err WriteToFile(GF_ISOFile *movie)
 	//capture mode: we don't need a new bitstream
 	if (movie->openMode == GF_ISOM_OPEN_WRITE) {
 		e = WriteFlat(&mw, 0, movie->editFileMap->bs);
+		file_size = gf_bs_get_size(movie->editFileMap->bs);
 	} else {
 		u32 buffer_size = movie->editFileMap ? gf_bs_get_output_buffering(movie->editFileMap->bs) : 0;
 		Bool is_stdout = 0;
@@ -1434,6 +1525,7 @@ GF_Err WriteToFile(GF_ISOFile *movie)
 			break;
 		}
 
+		file_size = gf_bs_get_position(bs);
 		gf_bs_del(bs);
 		if (!is_stdout)
 			gf_fclose(stream);
@@ -1442,6 +1534,9 @@ GF_Err WriteToFile(GF_ISOFile *movie)
 	if (mw.nb_done<mw.total_samples) {
 		gf_set_progress("ISO File Writing", mw.total_samples, mw.total_samples);
 	}
+	if (!e) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[IsoMedia] File written: "LLU" bytes - "LLU" bytes of media data copied, "LLU" bytes moved in place\n", file_size, mw.copied_bytes, mw.moved_bytes));
+	}
 	return e;
 }
 
@@ -75,6 +75,13 @@ GF_Err FlushCaptureMode(GF_ISOFile *movie)
 		if (e) return e;
 	}
 
+	/*reserve space for the moov: a free box that will be overwritten by the moov at close time*/
+	if (movie->moov_reserve) {
+		gf_bs_write_u32(movie->editFileMap->bs, movie->moov_reserve);
+		gf_bs_write_u32(movie->editFileMap->bs, GF_ISOM_BOX_TYPE_FREE);
+		gf_bs_write_byte(movie->editFileMap->bs, 0, movie->moov_reserve - 8);
+	}
+
 	/*we have a trick here: the data will be stored on the fly, so the first
 	thing in the file is the MDAT. As we don't know if we have a large file (>4 GB) or not
 	do as if we had one and write 16 bytes: 4 (type) + 4 (size) + 8 (largeSize)...*/
@@ -1554,6 +1561,23 @@ GF_Err gf_isom_set_storage_mode(GF_ISOFile *movie, u8 storageMode)
 	}
 }
 
+GF_EXPORT
+GF_Err gf_isom_reserve_moov_space(GF_ISOFile *movie, u32 reserved_size)
+{
+	GF_Err e;
+	e = CanAccessMovie(movie, GF_ISOM_OPEN_WRITE);
+	if (e) return e;
+	/*only in capture mode, where media data is written in place*/
+	if (movie->openMode != GF_ISOM_OPEN_WRITE) return GF_NOT_SUPPORTED;
+	e = CheckNoData(movie);
+	if (e) return e;
+
+	/*we need at least a free box header*/
+	if (reserved_size && (reserved_size < 8)) reserved_size = 8;
+	movie->moov_reserve = reserved_size;
+	return GF_OK;
+}
+
 GF_EXPORT
 void gf_isom_force_64bit_chunk_offset(GF_ISOFile *file, Bool set_on)
 {
@@ -88,6 +88,7 @@ static GF_Err gf_isom_get_3gpp_audio_esd(GF_SampleTableBox *stbl, GF_GenericAudi
 		GF_SttsEntry *ent;
 		/*only map CBR*/
 		sample_size = stbl->SampleSize->sampleSize;
+		ISOM_LOAD_LAZY_TABLE(stbl->TimeToSample)
 		(*out_esd)->decoderConfig->objectTypeIndication = GPAC_OTI_AUDIO_13K_VOICE;
 		bs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
 		gf_bs_write_data(bs, "QLCMfmt ", 8);
@@ -38,6 +38,7 @@ GF_Err stbl_findEntryForTime(GF_SampleTableBox *stbl, u64 DTS, u8 useCTS, u32 *s
 	(*prevSampleNumber) = 0;
 
 	if (!stbl->TimeToSample) return GF_ISOM_INVALID_FILE;
+	ISOM_LOAD_LAZY_TABLE(stbl->TimeToSample)
 	/*if (!stbl->CompositionOffset) useCTS = 0;
 	FIXME: CTS is ALWAYS disabled for now to make sure samples are fetched in
 	decoding order. */
@@ -126,6 +127,7 @@ entry_found:
 GF_Err stbl_GetSampleSize(GF_SampleSizeBox *stsz, u32 SampleNumber, u32 *Size)
 {
 	if (!stsz || !SampleNumber || SampleNumber > stsz->sampleCount) return GF_BAD_PARAM;
+	ISOM_LOAD_LAZY_TABLE(stsz)
 
 	(*Size) = 0;
 
@@ -147,8 +149,9 @@ GF_Err stbl_GetSampleCTS(GF_CompositionOffsetBox *ctts, u32 SampleNumber, s32 *C
 	(*CTSoffset) = 0;
 	//test on SampleNumber is done before
 	if (!ctts || !SampleNumber) return GF_BAD_PARAM;
+	ISOM_LOAD_LAZY_TABLE(ctts)
 
-	if (ctts->r_FirstSampleInEntry && (ctts->r_FirstSampleInEntry < SampleNumber) ) {
+	if (ctts->r_FirstSampleInEntry && (ctts->r_FirstSampleInEntry <= SampleNumber) ) {
 		i = ctts->r_currentEntryIndex;
 	} else {
 		ctts->r_FirstSampleInEntry = 1;
@@ -180,6 +183,7 @@ GF_Err stbl_GetSampleDTS_and_Duration(GF_TimeToSampleBox *stts, u32 SampleNumber
 		*duration = 0;
 	}
 	if (!stts || !SampleNumber) return GF_BAD_PARAM;
+	ISOM_LOAD_LAZY_TABLE(stts)
 
 	ent = NULL;
 	//use our cache
@@ -238,8 +242,9 @@ GF_Err stbl_GetSampleRAP(GF_SyncSampleBox *stss, u32 SampleNumber, SAPType *IsRA
 
 	(*IsRAP) = RAP_NO;
 	if (!stss || !SampleNumber) return GF_BAD_PARAM;
+	ISOM_LOAD_LAZY_TABLE(stss)
 
-	if (stss->r_LastSyncSample && (stss->r_LastSyncSample < SampleNumber) ) {
+	if (stss->r_LastSyncSample && (stss->r_LastSyncSample <= SampleNumber) ) {
 		i = stss->r_LastSampleIndex;
 	} else {
 		i = 0;
@@ -401,6 +406,12 @@ GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offse
 	if (out_ent) (*out_ent) = NULL;
 	if (!stbl || !sampleNumber) return GF_BAD_PARAM;
 	if (!stbl->ChunkOffset || !stbl->SampleToChunk) return GF_ISOM_INVALID_FILE;
+	ISOM_LOAD_LAZY_TABLE(stbl->SampleToChunk)
+	if (stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_STCO) {
+		ISOM_LOAD_LAZY_TABLE((GF_ChunkOffsetBox *)stbl->ChunkOffset)
+	} else {
+		ISOM_LOAD_LAZY_TABLE((GF_ChunkLargeOffsetBox *)stbl->ChunkOffset)
+	}
 
 	if (stbl->SampleToChunk->nb_entries == stbl->SampleSize->sampleCount) {
 		ent = &stbl->SampleToChunk->entries[sampleNumber-1];
@@ -420,7 +431,7 @@ GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offse
 
 	//check our cache
 	if (stbl->SampleToChunk->firstSampleInCurrentChunk &&
-	        (stbl->SampleToChunk->firstSampleInCurrentChunk < sampleNumber)) {
+	        (stbl->SampleToChunk->firstSampleInCurrentChunk <= sampleNumber)) {
 
 		i = stbl->SampleToChunk->currentIndex;
 //		ent = gf_list_get(stbl->SampleToChunk->entryList, i);
@@ -577,4 +588,20 @@ GF_Err stbl_GetSampleDepType(GF_SampleDependencyTypeBox *sdep, u32 SampleNumber,
 }
 
 
+GF_Err stbl_LoadLazyTables(GF_SampleTableBox *stbl)
+{
+	if (!stbl) return GF_BAD_PARAM;
+	ISOM_LOAD_LAZY_TABLE(stbl->TimeToSample)
+	ISOM_LOAD_LAZY_TABLE(stbl->CompositionOffset)
+	ISOM_LOAD_LAZY_TABLE(stbl->SyncSample)
+	ISOM_LOAD_LAZY_TABLE(stbl->SampleSize)
+	ISOM_LOAD_LAZY_TABLE(stbl->SampleToChunk)
+	if (stbl->ChunkOffset && (stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_STCO)) {
+		ISOM_LOAD_LAZY_TABLE((GF_ChunkOffsetBox *)stbl->ChunkOffset)
+	} else if (stbl->ChunkOffset && (stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_CO64)) {
+		ISOM_LOAD_LAZY_TABLE((GF_ChunkLargeOffsetBox *)stbl->ChunkOffset)
+	}
+	return GF_OK;
+}
+
 #endif /*GPAC_DISABLE_ISOM*/
@@ -1429,35 +1429,48 @@ void stbl_AppendTime(GF_SampleTableBox *stbl, u32 duration, u32 nb_pack)
 void stbl_AppendSize(GF_SampleTableBox *stbl, u32 size, u32 nb_pack)
 {
 	u32 i;
+	Bool init_table;
+	GF_SampleSizeBox *stsz = stbl->SampleSize;
 	if (!nb_pack) nb_pack = 1;
 
-	if (!stbl->SampleSize->sampleCount) {
-		stbl->SampleSize->sampleSize = size;
-		stbl->SampleSize->sampleCount += nb_pack;
+	if (!stsz->sampleCount) {
+		/*table kept allocated by a previous segment: keep its first entries valid in case the size is 0, as this cannot be distinguished from table mode*/
+		if (stsz->sizes && (nb_pack <= stsz->alloc_size)) {
+			for (i=0; i<nb_pack; i++)
+				stsz->sizes[i] = size;
+		} else if (stsz->sizes) {
+			gf_free(stsz->sizes);
+			stsz->sizes = NULL;
+			stsz->alloc_size = 0;
+		}
+		stsz->sampleSize = size;
+		stsz->sampleCount += nb_pack;
 		return;
 	}
-	if (stbl->SampleSize->sampleSize && (stbl->SampleSize->sampleSize==size)) {
-		stbl->SampleSize->sampleCount += nb_pack;
+	if (stsz->sampleSize && (stsz->sampleSize==size)) {
+		stsz->sampleCount += nb_pack;
 		return;
 	}
-	if (!stbl->SampleSize->sizes || (stbl->SampleSize->sampleCount==stbl->SampleSize->alloc_size)) {
-		Bool init_table = (stbl->SampleSize->sizes==NULL) ? 1 : 0;
-		ALLOC_INC(stbl->SampleSize->alloc_size);
-		if (stbl->SampleSize->sampleCount >= stbl->SampleSize->alloc_size)
-			stbl->SampleSize->alloc_size = stbl->SampleSize->sampleCount+1;
-
-		stbl->SampleSize->sizes = (u32 *)gf_realloc(stbl->SampleSize->sizes, sizeof(u32)*stbl->SampleSize->alloc_size);
-		if (!stbl->SampleSize->sizes) return;
-		memset(&stbl->SampleSize->sizes[stbl->SampleSize->sampleCount], 0, sizeof(u32) * (stbl->SampleSize->alloc_size - stbl->SampleSize->sampleCount) );
-
-		if (init_table) {
-			for (i=0; i<stbl->SampleSize->sampleCount; i++)
-				stbl->SampleSize->sizes[i] = stbl->SampleSize->sampleSize;
-		}
-	}
-	stbl->SampleSize->sampleSize = 0;
-	stbl->SampleSize->sizes[stbl->SampleSize->sampleCount] = size;
-	stbl->SampleSize->sampleCount += nb_pack;
+	/*switching from constant size to table mode*/
+	init_table = (!stsz->sizes || stsz->sampleSize) ? GF_TRUE : GF_FALSE;
+	if (!stsz->sizes || (stsz->sampleCount + nb_pack > stsz->alloc_size)) {
+		ALLOC_INC(stsz->alloc_size);
+		if (stsz->sampleCount + nb_pack > stsz->alloc_size)
+			stsz->alloc_size = stsz->sampleCount + nb_pack;
+
+		stsz->sizes = (u32 *)gf_realloc(stsz->sizes, sizeof(u32)*stsz->alloc_size);
+		if (!stsz->sizes) return;
+	}
+	if (init_table) {
+		for (i=0; i<stsz->sampleCount; i++)
+			stsz->sizes[i] = stsz->sampleSize;
+	}
+	stsz->sampleSize = 0;
+	stsz->sizes[stsz->sampleCount] = size;
+	/*packed samples other than the first one are signaled with a 0 size*/
+	for (i=1; i<nb_pack; i++)
+		stsz->sizes[stsz->sampleCount + i] = 0;
+	stsz->sampleCount += nb_pack;
 }
 
 
@@ -1486,26 +1499,26 @@ void stbl_AppendChunk(GF_SampleTableBox *stbl, u64 offset)
 			return;
 		}
 		//we're fine
-		new_offsets = (u32*)gf_malloc(sizeof(u32)*(stco->nb_entries+1));
-		if (!new_offsets) return;
-		for (i=0; i<stco->nb_entries; i++) new_offsets[i] = stco->offsets[i];
-		new_offsets[i] = (u32) offset;
-		if (stco->offsets) gf_free(stco->offsets);
-		stco->offsets = new_offsets;
+		if (stco->nb_entries==stco->alloc_size) {
+			ALLOC_INC(stco->alloc_size);
+			new_offsets = (u32*)gf_realloc(stco->offsets, sizeof(u32)*stco->alloc_size);
+			if (!new_offsets) return;
+			stco->offsets = new_offsets;
+		}
+		stco->offsets[stco->nb_entries] = (u32) offset;
 		stco->nb_entries += 1;
-		stco->alloc_size = stco->nb_entries;
 	}
 	//large offsets
 	else {
 		co64 = (GF_ChunkLargeOffsetBox *)stbl->ChunkOffset;
-		off_64 = (u64*)gf_malloc(sizeof(u64)*(co64->nb_entries+1));
-		if (!off_64) return;
-		for (i=0; i<co64->nb_entries; i++) off_64[i] = co64->offsets[i];
-		off_64[i] = offset;
-		if (co64->offsets) gf_free(co64->offsets);
-		co64->offsets = off_64;
+		if (co64->nb_entries==co64->alloc_size) {
+			ALLOC_INC(co64->alloc_size);
+			off_64 = (u64*)gf_realloc(co64->offsets, sizeof(u64)*co64->alloc_size);
+			if (!off_64) return;
+			co64->offsets = off_64;
+		}
+		co64->offsets[co64->nb_entries] = offset;
 		co64->nb_entries += 1;
-		co64->alloc_size = co64->nb_entries;
 	}
 }
 
@@ -34,6 +34,10 @@
 #define GF_ATSC_MCAST_ADDR	"224.0.23.60"
 #define GF_ATSC_MCAST_PORT	4937
 #define GF_ATSC_SOCK_SIZE	0x80000
+/*number of buckets for (TSI, TOI) object lookup, must be a power of 2*/
+#define GF_ATSC_OBJ_HASH_SIZE	256
+/*max number of packets read on a service socket for a single select*/
+#define GF_ATSC_MAX_PCK_PER_READ	64
 
 typedef struct
 {
@@ -72,7 +76,7 @@ typedef enum
 	GF_LCT_OBJ_DISPATCHED,
 } GF_LCTObjectStatus;
 
-typedef struct
+typedef struct __lct_object
 {
 	u32 toi, tsi;
 	u32 total_length;
@@ -88,6 +92,9 @@ typedef struct
 	GF_ATSCLCTChannel *rlct;
 
 	u32 prev_start_offset;
+
+	/*next object in the same (TSI, TOI) hash bucket of the service*/
+	struct __lct_object *next_in_hash;
 } GF_LCTObject;
 
 
@@ -114,6 +121,8 @@ typedef struct
 	GF_Socket *sock;
 	u32 secondary_sockets;
 	GF_List *objects;
+	/*objects indexed by (TSI, TOI), for TSI 0 the TOI version bits are ignored*/
+	GF_LCTObject *obj_hash[GF_ATSC_OBJ_HASH_SIZE];
 	GF_LCTObject *last_active_obj;
 	char *output_dir;
 	u32 port;
@@ -441,7 +450,7 @@ static GF_Err gf_atsc3_dmx_process_slt(GF_ATSCDmx *atscd, GF_XMLNode *root)
 				continue;
 			}
 			gf_sk_set_buffer_size(service->sock, GF_FALSE, atscd->unz_buffer_size);
-			//gf_sk_set_block_mode(service->sock, GF_TRUE);
+			gf_sk_set_block_mode(service->sock, GF_TRUE);
 
 			service->dst_ip = gf_strdup(dst_ip);
 			service->port = dst_port;
@@ -482,6 +491,45 @@ static GF_Err gf_atsc3_dmx_process_slt(GF_ATSCDmx *atscd, GF_XMLNode *root)
 }
 
 
+static u32 gf_atsc3_obj_hash(u32 tsi, u32 toi)
+{
+	//signaling objects with a different version are matched on the remaining TOI bits
+	if (!tsi) toi &= 0xFFFFFF00;
+	return (((toi ^ (tsi<<16) ^ (tsi>>16)) * 2654435761U) >> 24) & (GF_ATSC_OBJ_HASH_SIZE-1);
+}
+
+static void gf_atsc3_obj_hash_add(GF_ATSCService *s, GF_LCTObject *obj)
+{
+	u32 idx = gf_atsc3_obj_hash(obj->tsi, obj->toi);
+	obj->next_in_hash = s->obj_hash[idx];
+	s->obj_hash[idx] = obj;
+}
+
+static void gf_atsc3_obj_hash_remove(GF_ATSCService *s, GF_LCTObject *obj)
+{
+	GF_LCTObject **prev = &s->obj_hash[gf_atsc3_obj_hash(obj->tsi, obj->toi)];
+	while (*prev) {
+		if (*prev == obj) {
+			*prev = obj->next_in_hash;
+			break;
+		}
+		prev = &(*prev)->next_in_hash;
+	}
+	obj->next_in_hash = NULL;
+}
+
+static GF_LCTObject *gf_atsc3_obj_hash_find(GF_ATSCService *s, u32 tsi, u32 toi)
+{
+	GF_LCTObject *obj, *bundle = NULL;
+	obj = s->obj_hash[gf_atsc3_obj_hash(tsi, toi)];
+	while (obj) {
+		if ((obj->toi == toi) && (obj->tsi == tsi)) return obj;
+		if (!tsi && !obj->tsi && !bundle && ((obj->toi&0xFFFFFF00) == (toi&0xFFFFFF00)) )
+			bundle = obj;
+		obj = obj->next_in_hash;
+	}
+	return bundle;
+}
 static void gf_atsc3_obj_to_reservoir(GF_ATSCDmx *atscd, GF_ATSCService *s, GF_LCTObject *obj)
 {
 	//remove other objects
@@ -507,12 +555,13 @@ static void gf_atsc3_obj_to_reservoir(GF_ATSCDmx *atscd, GF_ATSCService *s, GF_L
 	obj->nb_frags = GF_FALSE;
 	obj->nb_recv_frags = 0;
 	obj->rlct = NULL;
-	obj->toi = 0;
-	obj->tsi = 0;
 	obj->total_length = 0;
 	obj->prev_start_offset = 0;
 	obj->download_time_ms = 0;
 	obj->status = GF_LCT_OBJ_INIT;
+	gf_atsc3_obj_hash_remove(s, obj);
+	obj->toi = 0;
+	obj->tsi = 0;
 	gf_list_del_item(s->objects, obj);
 	gf_list_add(atscd->object_reservoir, obj);
 
@@ -693,7 +742,7 @@ static GF_Err gf_atsc3_service_flush_object(GF_ATSCService *s, GF_LCTObject *obj
 	u64 start_offset = 0;
 	obj->status = GF_LCT_OBJ_DONE;
 	for (i=0; i<obj->nb_frags; i++) {
-		if (start_offset != obj->frags[0].offset) {
+		if (start_offset != obj->frags[i].offset) {
 			obj->status = GF_LCT_OBJ_DONE_ERR;
 			break;
 		}
@@ -709,7 +758,7 @@ static GF_Err gf_atsc3_service_flush_object(GF_ATSCService *s, GF_LCTObject *obj
 static GF_Err gf_atsc3_service_gather_object(GF_ATSCDmx *atscd, GF_ATSCService *s, u32 tsi, u32 toi, u32 start_offset, char *data, u32 size, u32 total_len, Bool close_flag, Bool in_order, GF_ATSCLCTChannel *rlct, GF_LCTObject **gather_obj)
 {
 	Bool inserted, done;
-	u32 i, count;
+	u32 i;
 	GF_LCTObject *obj = s->last_active_obj;
 
 	//in case last packet(s) are duplicated after we sent the object, skip them
@@ -726,21 +775,14 @@ static GF_Err gf_atsc3_service_gather_object(GF_ATSCDmx *atscd, GF_ATSCService *
 	}
 
 	if (!obj || (obj->tsi!=tsi) || (obj->toi!=toi)) {
-		count = gf_list_count(s->objects);
-		for (i=0; i<count; i++) {
-			obj = gf_list_get(s->objects, i);
-			if ((obj->toi == toi) && (obj->tsi==tsi)) break;
-
-			if (!tsi && !obj->tsi && ((obj->toi&0xFFFFFF00) == (toi&0xFFFFFF00)) ) {
-				//change in version of bundle but same other flags: reuse this one
-				obj->nb_frags = obj->nb_recv_frags = 0;
-				obj->nb_bytes = obj->nb_recv_bytes = 0;
-				obj->total_length = total_len;
-				obj->toi = toi;
-				obj->status = GF_LCT_OBJ_INIT;
-				break;
-			}
-			obj = NULL;
+		obj = gf_atsc3_obj_hash_find(s, tsi, toi);
+		if (obj && (obj->toi != toi)) {
+			//change in version of bundle but same other flags: reuse this one
+			obj->nb_frags = obj->nb_recv_frags = 0;
+			obj->nb_bytes = obj->nb_recv_bytes = 0;
+			obj->total_length = total_len;
+			obj->toi = toi;
+			obj->status = GF_LCT_OBJ_INIT;
 		}
 	}
 	if (!obj) {
@@ -768,6 +810,7 @@ static GF_Err gf_atsc3_service_gather_object(GF_ATSCDmx *atscd, GF_ATSCService *
 		}
 		obj->download_time_ms = gf_sys_clock();
 		gf_list_add(s->objects, obj);
+		gf_atsc3_obj_hash_add(s, obj);
 	} else if (!obj->total_length && total_len) {
 		GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[ATSC] Service %d object TSI %u TOI %u was started without total-length assigned, assigning to %u\n", s->service_id, tsi, toi, total_len));
 		obj->total_length = total_len;
@@ -822,51 +865,61 @@ static GF_Err gf_atsc3_service_gather_object(GF_ATSCDmx *atscd, GF_ATSCService *
 		return GF_EOS;
 	}
 	obj->nb_recv_bytes += size;
+
+	/*fragments are kept sorted and merged when contiguous: locate the first fragment starting after this one,
+	checking the last fragment first since fragments are usually received in order*/
+	if (!obj->nb_frags || (obj->frags[obj->nb_frags-1].offset <= start_offset)) {
+		i = obj->nb_frags;
+	} else {
+		u32 lo = 0, hi = obj->nb_frags-1;
+		while (lo < hi) {
+			u32 mid = (lo + hi) / 2;
+			if (obj->frags[mid].offset > start_offset) hi = mid;
+			else lo = mid + 1;
+		}
+		i = lo;
+	}
+	//check overlap with next fragment (not sure if this is legal)
+	if ((i<obj->nb_frags) && (start_offset + size > obj->frags[i].offset)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[ATSC] Service %d Overlapping LCT fragment, not supported\n", s->service_id));
+		return GF_NOT_SUPPORTED;
+	}
 	inserted = GF_FALSE;
-	for (i=0; i<obj->nb_frags; i++) {
-		if ((obj->frags[i].offset <= start_offset) && (obj->frags[i].offset + obj->frags[i].size >= start_offset + size) ) {
+	if (i) {
+		GF_LCTFragInfo *prev = &obj->frags[i-1];
+		if (prev->offset + prev->size >= start_offset + size) {
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[ATSC] Service %d LCT fragment already received\n", s->service_id));
 			return GF_OK;
 		}
-
-		//insert fragment
-		if (obj->frags[i].offset > start_offset) {
-			//check overlap (not sure if this is legal)
-			if (start_offset + size > obj->frags[i].offset) {
-				GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[ATSC] Service %d Overlapping LCT fragment, not supported\n", s->service_id));
-				return GF_NOT_SUPPORTED;
+		//expand fragment
+		if (prev->offset + prev->size == start_offset) {
+			prev->size += size;
+			inserted = GF_TRUE;
+			//and merge with next one if contiguous
+			if ((i<obj->nb_frags) && (prev->offset + prev->size == obj->frags[i].offset)) {
+				prev->size += obj->frags[i].size;
+				memmove(&obj->frags[i], &obj->frags[i+1], sizeof(GF_LCTFragInfo) * (obj->nb_frags - i - 1) );
+				obj->nb_frags--;
 			}
+		}
+	}
+	if (!inserted) {
+		//prepend to next fragment if contiguous
+		if ((i<obj->nb_frags) && (start_offset + size == obj->frags[i].offset)) {
+			obj->frags[i].offset = start_offset;
+			obj->frags[i].size += size;
+		} else {
 			if (obj->nb_frags==obj->nb_alloc_frags) {
 				obj->nb_alloc_frags *= 2;
 				obj->frags = gf_realloc(obj->frags, sizeof(GF_LCTFragInfo)*obj->nb_alloc_frags);
 			}
-			memmove(&obj->frags[i+1], &obj->frags[i], sizeof(GF_LCTFragInfo) * (obj->nb_frags - i)  );
+			memmove(&obj->frags[i+1], &obj->frags[i], sizeof(GF_LCTFragInfo) * (obj->nb_frags - i) );
 			obj->frags[i].offset = start_offset;
 			obj->frags[i].size = size;
-			obj->nb_bytes += size;
 			obj->nb_frags++;
-			inserted = GF_TRUE;
-			break;
 		}
-		//expand fragment
-		if (obj->frags[i].offset + obj->frags[i].size == start_offset) {
-			obj->frags[i].size += size;
-			obj->nb_bytes += size;
-			inserted = GF_TRUE;
-			break;
-		}
-	}
-
-	if (!inserted) {
-		if (obj->nb_frags==obj->nb_alloc_frags) {
-			obj->nb_alloc_frags *= 2;
-			obj->frags = gf_realloc(obj->frags, sizeof(GF_LCTFragInfo)*obj->nb_alloc_frags);
-		}
-		obj->frags[obj->nb_frags].offset = start_offset;
-		obj->frags[obj->nb_frags].size = size;
-		obj->nb_frags++;
-		obj->nb_bytes += size;
 	}
+	obj->nb_bytes += size;
 	obj->nb_recv_frags++;
 
 	assert(obj->toi == toi);
@@ -1048,7 +1101,7 @@ static GF_Err gf_atsc3_service_setup_stsid(GF_ATSCDmx *atscd, GF_ATSCService *s,
 				return e;
 			}
 			gf_sk_set_buffer_size(rsess->sock, GF_FALSE, atscd->unz_buffer_size);
-			//gf_sk_set_block_mode(rsess->sock, GF_TRUE);
+			gf_sk_set_block_mode(rsess->sock, GF_TRUE);
 			s->secondary_sockets++;
 			if (s->tune_mode == GF_ATSC_TUNE_ON) gf_sk_group_register(atscd->active_sockets, rsess->sock);
 		}
@@ -1651,6 +1704,20 @@ static GF_Err gf_atsc3_dmx_process_lls(GF_ATSCDmx *atscd)
 	return GF_OK;
 }
 
+/*service sockets are non-blocking: drain pending packets to limit the number of select calls*/
+static GF_Err gf_atsc3_dmx_read_service(GF_ATSCDmx *atscd, GF_ATSCService *s, GF_ATSCRouteSession *route_sess)
+{
+	u32 i;
+	for (i=0; i<GF_ATSC_MAX_PCK_PER_READ; i++) {
+		GF_Err e = gf_atsc3_dmx_process_service(atscd, s, route_sess);
+		if ((e==GF_IP_SOCK_WOULD_BLOCK) || (e==GF_IP_NETWORK_EMPTY)) break;
+		if (e) return e;
+		//service may have been tuned out by the user callback
+		if (s->tune_mode==GF_ATSC_TUNE_OFF) break;
+	}
+	return GF_OK;
+}
+
 GF_EXPORT
 GF_Err gf_atsc3_dmx_process(GF_ATSCDmx *atscd)
 {
@@ -1675,7 +1742,7 @@ GF_Err gf_atsc3_dmx_process(GF_ATSCDmx *atscd)
 		if (s->tune_mode==GF_ATSC_TUNE_OFF) continue;
 
 		if (gf_sk_group_sock_is_set(atscd->active_sockets, s->sock)) {
-			e = gf_atsc3_dmx_process_service(atscd, s, NULL);
+			e = gf_atsc3_dmx_read_service(atscd, s, NULL);
 			if (e) return e;
 		}
 		if (s->tune_mode!=GF_ATSC_TUNE_ON) continue;
@@ -1684,7 +1751,7 @@ GF_Err gf_atsc3_dmx_process(GF_ATSCDmx *atscd)
 		j=0;
 		while ((rsess = (GF_ATSCRouteSession *)gf_list_enum(s->route_sessions, &j) )) {
 			if (gf_sk_group_sock_is_set(atscd->active_sockets, rsess->sock)) {
-				e = gf_atsc3_dmx_process_service(atscd, s, rsess);
+				e = gf_atsc3_dmx_read_service(atscd, s, rsess);
 				if (e) return e;
 			}
 		}
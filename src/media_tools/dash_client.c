@@ -1430,34 +1430,15 @@ static u64 gf_dash_get_segment_availability_start_time(GF_MPD *mpd, GF_DASH_Grou
 
 static u32 gf_dash_get_index_in_timeline(GF_MPD_SegmentTimeline *timeline, u64 segment_start, u64 start_timescale, u64 timescale)
 {
-	u64 start_time = 0;
-	u32 idx = 0;
-	u32 i, count, repeat;
-	count = gf_list_count(timeline->entries);
-	for (i=0; i<count; i++) {
-		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, i);
-
-		if (!i || ent->start_time) start_time = ent->start_time;
+	u64 start_time;
+	u32 idx;
+	GF_Err e = gf_mpd_segment_timeline_find_segment(timeline, segment_start, start_timescale, timescale, &idx, &start_time);
 
-		repeat = ent->repeat_count+1;
-		while (repeat) {
-			if (start_timescale==timescale) {
-				if (start_time == segment_start ) return idx;
-				if (start_time > segment_start) {
-					GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Warning: segment timeline entry start "LLU" greater than segment start "LLU", using current entry\n", start_time, segment_start));
-					return idx;
-				}
-			} else {
-				if (start_time*start_timescale == segment_start * timescale) return idx;
-				if (start_time*start_timescale > segment_start * timescale) {
-					GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Warning: segment timeline entry start "LLU" greater than segment start "LLU", using current entry\n", start_time, segment_start));
-					return idx;
-				}
-			}
-			start_time+=ent->duration;
-			repeat--;
-			idx++;
+	if (e == GF_OK) {
+		if ((start_timescale==timescale) ? (start_time != segment_start) : (start_time*start_timescale != segment_start * timescale)) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Warning: segment timeline entry start "LLU" greater than segment start "LLU", using current entry\n", start_time, segment_start));
 		}
+		return idx;
 	}
 	//end of list in regular case: segment was the last one of the previous list and no changes happend
 	if (start_timescale==timescale) {
@@ -1474,8 +1455,7 @@ static u32 gf_dash_get_index_in_timeline(GF_MPD_SegmentTimeline *timeline, u64 s
 static GF_Err gf_dash_merge_segment_timeline(GF_DASH_Group *group, GF_DashClient *dash, GF_MPD_SegmentList *old_list, GF_MPD_SegmentTemplate *old_template, GF_MPD_SegmentList *new_list, GF_MPD_SegmentTemplate *new_template, Double min_start_time)
 {
 	GF_MPD_SegmentTimeline *old_timeline, *new_timeline;
-	u32 i, idx, timescale, nb_new_segs;
-	GF_MPD_SegmentTimelineEntry *ent;
+	u32 i, timescale, nb_new_segs;
 
 	old_timeline = new_timeline = NULL;
 	if (old_list && old_list->segment_timeline) {
@@ -1506,11 +1486,7 @@ static GF_Err gf_dash_merge_segment_timeline(GF_DASH_Group *group, GF_DashClient
 		}
 	}
 
-	nb_new_segs = 0;
-	idx=0;
-	while ((ent = gf_list_enum(new_timeline->entries, &idx))) {
-		nb_new_segs += 1 + ent->repeat_count;
-	}
+	nb_new_segs = gf_mpd_segment_timeline_get_segment_count(new_timeline, NULL);
 
 	if (group) {
 		u32 prev_idx = group->download_segment_index;
@@ -1533,6 +1509,7 @@ static GF_Err gf_dash_merge_segment_timeline(GF_DASH_Group *group, GF_DashClient
 
 #ifndef GPAC_DISABLE_LOG
 	if (gf_log_tool_level_on(GF_LOG_DASH, GF_LOG_INFO) ) {
+		u32 idx;
 		GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] New SegmentTimeline: \n"));
 		for (idx=0; idx<gf_list_count(new_timeline->entries); idx++) {
 			GF_MPD_SegmentTimelineEntry *ent = gf_list_get(new_timeline->entries, idx);
@@ -1544,9 +1521,24 @@ static GF_Err gf_dash_merge_segment_timeline(GF_DASH_Group *group, GF_DashClient
 	return GF_OK;
 }
 
+/*removes the first nb_items of the list without shifting the list for each of them, items are not destroyed*/
+static void gf_dash_list_rem_head(GF_List *list, u32 nb_items)
+{
+	if (nb_items == 1) {
+		gf_list_rem(list, 0);
+		return;
+	}
+	gf_list_reverse(list);
+	while (nb_items) {
+		gf_list_rem_last(list);
+		nb_items--;
+	}
+	gf_list_reverse(list);
+}
+
 static u32 gf_dash_purge_segment_timeline(GF_DASH_Group *group, Double min_start_time)
 {
-	u32 nb_removed, time_scale;
+	u32 nb_removed, nb_entries_removed, count, time_scale;
 	u64 start_time, min_start, duration;
 	GF_MPD_SegmentTimeline *timeline=NULL;
 	GF_MPD_Representation *rep = gf_list_get(group->adaptation_set->representations, group->active_rep_index);
@@ -1558,29 +1550,36 @@ static u32 gf_dash_purge_segment_timeline(GF_DASH_Group *group, Double min_start
 	min_start = (u64) (min_start_time*time_scale);
 	start_time = 0;
 	nb_removed=0;
-	while (1) {
-		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, 0);
-		if (!ent) break;
+	nb_entries_removed=0;
+	count = gf_list_count(timeline->entries);
+	while (nb_entries_removed < count) {
+		u32 nb_segs = 0;
+		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, nb_entries_removed);
 		if (ent->start_time) start_time = ent->start_time;
 
-		while (start_time + ent->duration < min_start) {
-			if (! ent->repeat_count) break;
-			ent->repeat_count--;
-			nb_removed++;
-			start_time += ent->duration;
+		/*repeated segments ending before min_start*/
+		if (ent->repeat_count && (start_time + ent->duration < min_start)) {
+			u64 nb_before = ent->duration ? (min_start - start_time - 1) / ent->duration : ent->repeat_count;
+			nb_segs = (nb_before < ent->repeat_count) ? (u32) nb_before : ent->repeat_count;
+			ent->repeat_count -= nb_segs;
+			nb_removed += nb_segs;
+			start_time += (u64) ent->duration * nb_segs;
 		}
-		/*this entry is in our range, keep it and make sure it has a start time*/
+		/*this entry is in our range, keep it and make sure it has the start time of its first remaining segment*/
 		if (start_time + ent->duration >= min_start) {
-			if (!ent->start_time) ent->start_time = start_time;
+			if (!ent->start_time || nb_segs) ent->start_time = start_time;
 			break;
 		}
 		start_time += ent->duration;
-		gf_list_rem(timeline->entries, 0);
 		gf_free(ent);
+		nb_entries_removed++;
 		nb_removed++;
 	}
+	if (nb_entries_removed) gf_dash_list_rem_head(timeline->entries, nb_entries_removed);
+
 	if (nb_removed) {
 		GF_MPD_SegmentList *segment_list;
+		gf_mpd_segment_timeline_reset_index(timeline);
 		/*update next download index*/
 		group->download_segment_index -= nb_removed;
 		assert(group->nb_segments_in_rep >= nb_removed);
@@ -1592,12 +1591,12 @@ static u32 gf_dash_purge_segment_timeline(GF_DASH_Group *group, Double min_start
 		if (rep && rep->segment_list) segment_list = rep->segment_list;
 
 		if (segment_list) {
-			u32 i = nb_removed;
-			while (i) {
-				GF_MPD_SegmentURL *seg_url = gf_list_get(segment_list->segment_URLs, 0);
-				gf_list_rem(segment_list->segment_URLs, 0);
+			u32 i, nb_urls = MIN(nb_removed, gf_list_count(segment_list->segment_URLs));
+			for (i=0; i<nb_urls; i++) {
+				GF_MPD_SegmentURL *seg_url = gf_list_get(segment_list->segment_URLs, i);
 				gf_mpd_segment_url_free(seg_url);
 			}
+			gf_dash_list_rem_head(segment_list->segment_URLs, nb_urls);
 		}
 		group->nb_segments_purged += nb_removed;
 	}
@@ -154,8 +154,23 @@ struct __gf_dash_segmenter
 	Bool strict_cues;
 
 	Bool mvex_after_traks;
+
+	/*if set, HLS master and media playlists are generated along with the MPD*/
+	Bool hls_output;
 };
 
+/*HLS media segment, URL relative to the MPD location - size is 0 if the entire file is used*/
+typedef struct
+{
+	char *url;
+	Double duration;
+	u64 offset, size;
+	Bool discontinuity;
+	/*initialization segment (EXT-X-MAP) for this segment, only set when writing the playlists*/
+	char *init_url;
+	u64 init_offset, init_size;
+} GF_DashHLSSegment;
+
 struct _dash_segment_input
 {
 	char *file_name;
@@ -235,6 +250,14 @@ struct _dash_segment_input
 	Bool no_cache;
 
 	Double clamp_duration;
+
+	/*HLS segments produced during the last call to dasher_segment_file, and associated init segment*/
+	GF_List *hls_segments;
+	char *hls_init_url;
+	u64 hls_init_offset, hls_init_size;
+	u32 hls_bandwidth;
+	char hls_codecs[200];
+	Double hls_frame_rate;
 };
 
 
@@ -438,6 +461,54 @@ GF_Err gf_dasher_store_segment_info(GF_DASHSegmenter *dasher, const char *repres
 	return gf_cfg_set_key(dasher->dash_ctx, "SegmentsStartTimes", SegmentName, szKey);
 }
 
+static void gf_dasher_hls_del_segments(GF_List *segments)
+{
+	while (gf_list_count(segments)) {
+		GF_DashHLSSegment *seg = (GF_DashHLSSegment *)gf_list_pop_back(segments);
+		if (seg->url) gf_free(seg->url);
+		if (seg->init_url) gf_free(seg->init_url);
+		gf_free(seg);
+	}
+	gf_list_del(segments);
+}
+
+static void gf_dasher_hls_reset(GF_DashSegInput *dash_input)
+{
+	if (dash_input->hls_segments) {
+		gf_dasher_hls_del_segments(dash_input->hls_segments);
+		dash_input->hls_segments = NULL;
+	}
+	if (dash_input->hls_init_url) gf_free(dash_input->hls_init_url);
+	dash_input->hls_init_url = NULL;
+	dash_input->hls_init_offset = dash_input->hls_init_size = 0;
+}
+
+/*registers a media segment for the HLS playlists - file is the segment file as written on disk, size is 0 if the entire file is the segment*/
+static void gf_dasher_hls_add_segment(GF_DASHSegmenter *dasher, GF_DashSegInput *dash_input, const char *file, u64 duration, u32 timescale, u64 offset, u64 size)
+{
+	GF_DashHLSSegment *seg;
+	if (!dasher->hls_output || !file || !timescale) return;
+	if (!dash_input->hls_segments) dash_input->hls_segments = gf_list_new();
+
+	GF_SAFEALLOC(seg, GF_DashHLSSegment);
+	if (!seg) return;
+	seg->url = gf_strdup(gf_dasher_strip_output_dir(dasher->mpd_name, file));
+	seg->duration = (Double) (s64) duration;
+	seg->duration /= timescale;
+	seg->offset = offset;
+	seg->size = size;
+	gf_list_add(dash_input->hls_segments, seg);
+}
+
+static void gf_dasher_hls_set_init(GF_DASHSegmenter *dasher, GF_DashSegInput *dash_input, const char *file, u64 offset, u64 size)
+{
+	if (!dasher->hls_output || !file) return;
+	if (dash_input->hls_init_url) gf_free(dash_input->hls_init_url);
+	dash_input->hls_init_url = gf_strdup(gf_dasher_strip_output_dir(dasher->mpd_name, file));
+	dash_input->hls_init_offset = offset;
+	dash_input->hls_init_size = size;
+}
+
 
 #ifndef GPAC_DISABLE_ISOM
 
@@ -768,6 +839,9 @@ typedef struct
 	u32 nb_cues;
 	GF_DASHCueInfo *cues;
 	Bool cues_use_edits;
+
+	/*range of input samples currently prefetched*/
+	u32 prefetch_first_sample, prefetch_last_sample;
 } GF_ISOMTrackFragmenter;
 
 static u64 isom_get_next_sap_time(GF_ISOFile *input, u32 track, u32 sample_count, u32 sample_num, Bool *is_eos)
@@ -1050,6 +1124,67 @@ static u32 cicp_get_channel_config(u32 nb_chan,u32 nb_surr, u32 nb_lfe)
 
 
 
+/*number of fragments for which input media data is prefetched*/
+#define DASH_PREFETCH_FRAGMENTS	4
+/*max amount of input media data prefetched*/
+#define DASH_PREFETCH_MAX_SIZE	(32*1024*1024)
+
+/*loads the input data of the next fragments of all tracks once a track has consumed its prefetched samples, so that
+poorly interleaved inputs are read with a few large reads in file order rather than by seeking back and forth between tracks*/
+static GF_Err isom_prefetch_fragments(GF_ISOFile *input, GF_List *fragmenters, u64 window, u32 window_scale)
+{
+	GF_Err e;
+	u32 i, count, nb_tracks;
+	u32 *tracks, *first_samples, *last_samples;
+	Bool needs_prefetch = GF_FALSE;
+
+	count = gf_list_count(fragmenters);
+	for (i=0; i<count; i++) {
+		GF_ISOMTrackFragmenter *tf = (GF_ISOMTrackFragmenter *)gf_list_get(fragmenters, i);
+		if (tf->done) continue;
+		/*current sample and the next one must be prefetched*/
+		if ((tf->SampleNum + 1 < tf->prefetch_first_sample) || (MIN(tf->SampleNum + 2, tf->SampleCount) > tf->prefetch_last_sample)) {
+			needs_prefetch = GF_TRUE;
+			break;
+		}
+	}
+	if (!needs_prefetch) return GF_OK;
+
+	tracks = (u32 *)gf_malloc(sizeof(u32) * count * 3);
+	if (!tracks) return GF_OUT_OF_MEM;
+	first_samples = tracks + count;
+	last_samples = tracks + 2*count;
+
+	nb_tracks = 0;
+	for (i=0; i<count; i++) {
+		u64 avg_dur, nb_samples;
+		u32 first, last;
+		GF_ISOMTrackFragmenter *tf = (GF_ISOMTrackFragmenter *)gf_list_get(fragmenters, i);
+		tf->prefetch_first_sample = tf->prefetch_last_sample = 0;
+		if (tf->done) continue;
+		first = tf->SampleNum + 1;
+		if (first > tf->SampleCount) continue;
+
+		/*estimate the window from the average sample duration rather than walking the time tables, which would move
+		their read cache away from the samples being fragmented - samples missed by the estimation are simply read from file*/
+		avg_dur = gf_isom_get_media_original_duration(input, tf->OriginalTrack) / tf->SampleCount;
+		if (!avg_dur) avg_dur = 1;
+		nb_samples = window * tf->TimeScale / window_scale / avg_dur;
+		/*the sample following the window is fetched to compute the duration of the last one*/
+		last = (u32) MIN(first + nb_samples + 1, tf->SampleCount);
+
+		tracks[nb_tracks] = tf->OriginalTrack;
+		first_samples[nb_tracks] = first;
+		last_samples[nb_tracks] = last;
+		tf->prefetch_first_sample = first;
+		tf->prefetch_last_sample = last;
+		nb_tracks++;
+	}
+	e = nb_tracks ? gf_isom_prefetch_samples(input, nb_tracks, tracks, first_samples, last_samples, DASH_PREFETCH_MAX_SIZE) : GF_OK;
+	gf_free(tracks);
+	return e;
+}
+
 static GF_Err isom_segment_file(GF_ISOFile *input, const char *output_file, GF_DASHSegmenter *dasher, GF_DashSegInput *dash_input, Bool first_in_set)
 {
 	u8 NbBits;
@@ -1081,6 +1216,7 @@ static GF_Err isom_segment_file(GF_ISOFile *input, const char *output_file, GF_D
 	Bool next_sample_rap = GF_FALSE;
 	Bool flush_all_samples = GF_FALSE;
 	Bool simulation_pass = GF_FALSE;
+	Bool prefetch_input = GF_TRUE;
 	Bool init_segment_deleted = GF_FALSE;
 	Bool first_segment_in_timeline = GF_TRUE;
 	Bool store_utc = GF_FALSE;
@@ -2007,6 +2143,10 @@ restart_fragmentation_pass:
 				Double clamp_duration = dash_input->clamp_duration;
 				if (!clamp_duration) clamp_duration = dash_input->media_duration;
 
+				/*inputs which cannot be prefetched (edited, remote, ...) are read sample by sample*/
+				if (prefetch_input && (isom_prefetch_fragments(input, fragmenters, DASH_PREFETCH_FRAGMENTS * MaxFragmentDuration, dasher->dash_scale) != GF_OK))
+					prefetch_input = GF_FALSE;
+
 				/*first sample in the fragment */
 				if (!sample) {
 					sample = gf_isom_get_sample(input, tf->OriginalTrack, tf->SampleNum + 1, &descIndex);
@@ -2677,6 +2817,11 @@ restart_fragmentation_pass:
 				} else {
 					file_size += gf_isom_get_file_size(output);
 				}
+				if (seg_rad_name) {
+					gf_dasher_hls_add_segment(dasher, dash_input, SegmentName, (u64) last_seg_dur, dasher->dash_scale, 0, 0);
+				} else {
+					gf_dasher_hls_add_segment(dasher, dash_input, gf_isom_get_filename(output), (u64) last_seg_dur, dasher->dash_scale, start_range, end_range + 1 - start_range);
+				}
 			}
 
 			/*next fragment will exceed segment length, abort fragment at next rap (possibly after MaxSegmentDuration)*/
@@ -2745,6 +2890,11 @@ restart_fragmentation_pass:
 		} else {
 			file_size += gf_isom_get_file_size(output);
 		}
+		if (seg_rad_name) {
+			gf_dasher_hls_add_segment(dasher, dash_input, SegmentName, (u64) last_seg_dur, dasher->dash_scale, 0, 0);
+		} else {
+			gf_dasher_hls_add_segment(dasher, dash_input, gf_isom_get_filename(output), (u64) last_seg_dur, dasher->dash_scale, start_range, end_range + 1 - start_range);
+		}
 	}
 	//close timeline
 	if (mpd_timeline_bs) {
@@ -2971,6 +3121,19 @@ write_rep_only:
 		fprintf(dasher->mpd, " dependencyId=\"%s\"", dash_input->dependencyID);
 	fprintf(dasher->mpd, ">\n");
 
+	dash_input->hls_bandwidth = bandwidth;
+	strcpy(dash_input->hls_codecs, szCodecs);
+	dash_input->hls_frame_rate = (width && height && fps_num && fps_denum) ? ((Double) fps_num) / fps_denum : 0;
+	if (is_bs_switching && bs_switching_segment_name) {
+		gf_dasher_hls_set_init(dasher, dash_input, bs_switching_segment_name, 0, 0);
+	} else if (dasher->single_file_mode==1) {
+		gf_dasher_hls_set_init(dasher, dash_input, gf_isom_get_filename(output), 0, index_start_range);
+	} else if (!seg_rad_name) {
+		gf_dasher_hls_set_init(dasher, dash_input, gf_isom_get_filename(output), 0, init_seg_size);
+	} else {
+		gf_dasher_hls_set_init(dasher, dash_input, gf_isom_get_filename(output), 0, 0);
+	}
+
 	/* baseURLs */
 	if (dash_input->nb_baseURL) {
 		for (i=0; i<dash_input->nb_baseURL; i++) {
@@ -3180,6 +3343,7 @@ err_exit:
 	if (langCode) {
 		gf_free(langCode);
 	}
+	if (prefetch_input) gf_isom_prefetch_samples(input, 0, NULL, NULL, NULL, 0);
 	if (fragmenters) {
 		while (gf_list_count(fragmenters)) {
 			tf = (GF_ISOMTrackFragmenter *)gf_list_get(fragmenters, 0);
@@ -4117,6 +4281,15 @@ typedef struct
 	Bool first_pcr_position_valid;
 	u32 prev_last_pcr_position;
 
+	/*pipelined segmentation: chunks of TS indexed but not yet written to segments, a NULL chunk signals the end of indexing*/
+	GF_List *chunks;
+	GF_List *chunk_pool;
+	GF_Mutex *chunks_mx;
+	GF_Semaphore *has_chunks, *has_room;
+	/*offset at which indexing started and offset before which all bytes belong to already indexed segments or to the one being indexed*/
+	u64 index_start_offset, writable_offset;
+	Bool abort_indexing;
+	GF_Err index_error;
 } GF_TSSegmenter;
 
 static void m2ts_sidx_add_entry(GF_SegmentIndexBox *sidx, Bool ref_type,
@@ -4657,9 +4830,300 @@ static GF_Err dasher_mp2t_get_components_info(GF_DashSegInput *dash_input, GF_DA
 
 #define NB_TSPCK_IO_BYTES 18800
 
+/*max number of TS chunks indexed ahead of the segment writer - the data of the segment being indexed which may still
+belong to the next segment is not accounted for*/
+#define DASH_TS_MAX_QUEUED_CHUNKS	64
+
+typedef struct
+{
+	char data[NB_TSPCK_IO_BYTES];
+	u32 size;
+	u64 offset;
+} GF_TSChunk;
+
+typedef struct
+{
+	GF_Thread *th;
+	/*chunks received from the indexer and not entirely written yet*/
+	GF_List *pending;
+	Bool indexing_done;
+	/*segments indexed so far*/
+	GF_SIDXReference *refs;
+	u32 nb_refs, nb_alloc_refs;
+	/*segment being written, its start offset and the offset of the next byte to write*/
+	u32 seg;
+	u64 seg_start, pos;
+	FILE *dst;
+	char szSegName[GF_MAX_PATH];
+	u32 segment_index;
+	GF_Err e;
+
+	GF_DASHSegmenter *dasher;
+	GF_DashSegInput *dash_input;
+	const char *szOutName;
+	u32 bandwidth;
+	u64 pcr_shift;
+	u8 *is_pes;
+} GF_TSSegmentWriter;
+
+/*indexing thread: reads and indexes the TS, then hands the chunks read over to the segment writer*/
+static u32 dasher_mp2t_index_run(void *par)
+{
+	u64 offset;
+	u32 nb_writable = 0;
+	GF_TSSegmenter *ts_seg = (GF_TSSegmenter *)par;
+
+	offset = ts_seg->index_start_offset;
+	while (!feof(ts_seg->src) && !ts_seg->suspend_indexing && !ts_seg->abort_indexing) {
+		u64 writable;
+		s32 size;
+		GF_TSChunk *chunk;
+
+		gf_mx_p(ts_seg->chunks_mx);
+		chunk = (GF_TSChunk *)gf_list_pop_back(ts_seg->chunk_pool);
+		gf_mx_v(ts_seg->chunks_mx);
+		if (!chunk) {
+			chunk = (GF_TSChunk *)gf_malloc(sizeof(GF_TSChunk));
+			if (!chunk) {
+				ts_seg->index_error = GF_OUT_OF_MEM;
+				break;
+			}
+		}
+		size = (s32) fread(chunk->data, 1, NB_TSPCK_IO_BYTES, ts_seg->src);
+		if (size<0) {
+			gf_free(chunk);
+			ts_seg->index_error = GF_IO_ERR;
+			break;
+		}
+		chunk->offset = offset;
+		chunk->size = size;
+		offset += size;
+
+		/*the writer only looks at the index while holding the mutex*/
+		gf_mx_p(ts_seg->chunks_mx);
+		gf_m2ts_process_data(ts_seg->ts, chunk->data, size);
+		gf_list_add(ts_seg->chunks, chunk);
+		/*the next segment boundary will not be before the last PAT (or PES start) seen*/
+		if (ts_seg->suspend_indexing) writable = ts_seg->suspend_indexing;
+		else writable = ts_seg->segment_at_rap ? ts_seg->last_pat_position : ts_seg->last_offset;
+		if (writable > ts_seg->writable_offset) ts_seg->writable_offset = writable;
+		writable = ts_seg->writable_offset;
+		gf_mx_v(ts_seg->chunks_mx);
+		gf_sema_notify(ts_seg->has_chunks, 1);
+
+		/*wait for the writer to catch up with the chunks which can be written*/
+		if (writable > ts_seg->index_start_offset) {
+			while (nb_writable < (writable - ts_seg->index_start_offset) / NB_TSPCK_IO_BYTES) {
+				gf_sema_wait(ts_seg->has_room);
+				nb_writable++;
+			}
+		}
+		if (size<NB_TSPCK_IO_BYTES) break;
+	}
+
+	gf_mx_p(ts_seg->chunks_mx);
+	gf_list_add(ts_seg->chunks, NULL);
+	gf_mx_v(ts_seg->chunks_mx);
+	gf_sema_notify(ts_seg->has_chunks, 1);
+	return 0;
+}
+
+static void dasher_mp2t_writer_del(GF_TSSegmenter *ts_seg, GF_TSSegmentWriter *tsw)
+{
+	/*the writer only returns once indexing is done, the indexing thread is no longer running at this point*/
+	if (tsw->th) gf_th_del(tsw->th);
+	if (tsw->dst) gf_fclose(tsw->dst);
+	if (tsw->pending) {
+		while (gf_list_count(tsw->pending)) gf_free(gf_list_pop_back(tsw->pending));
+		gf_list_del(tsw->pending);
+	}
+	if (ts_seg->chunks) {
+		while (gf_list_count(ts_seg->chunks)) {
+			void *chunk = gf_list_pop_back(ts_seg->chunks);
+			if (chunk) gf_free(chunk);
+		}
+		gf_list_del(ts_seg->chunks);
+	}
+	if (ts_seg->chunk_pool) {
+		while (gf_list_count(ts_seg->chunk_pool)) gf_free(gf_list_pop_back(ts_seg->chunk_pool));
+		gf_list_del(ts_seg->chunk_pool);
+	}
+	if (ts_seg->chunks_mx) gf_mx_del(ts_seg->chunks_mx);
+	if (ts_seg->has_chunks) gf_sema_del(ts_seg->has_chunks);
+	if (ts_seg->has_room) gf_sema_del(ts_seg->has_room);
+	ts_seg->chunks = ts_seg->chunk_pool = NULL;
+	ts_seg->chunks_mx = NULL;
+	ts_seg->has_chunks = ts_seg->has_room = NULL;
+	if (tsw->refs) gf_free(tsw->refs);
+	gf_free(tsw);
+}
+
+/*starts indexing the TS in a dedicated thread, segments are then written while the input is indexed*/
+static GF_TSSegmentWriter *dasher_mp2t_writer_new(GF_TSSegmenter *ts_seg)
+{
+	GF_TSSegmentWriter *tsw;
+	GF_SAFEALLOC(tsw, GF_TSSegmentWriter);
+	if (!tsw) return NULL;
+
+	ts_seg->index_start_offset = gf_ftell(ts_seg->src);
+	ts_seg->writable_offset = 0;
+	ts_seg->abort_indexing = GF_FALSE;
+	ts_seg->index_error = GF_OK;
+	ts_seg->chunks = gf_list_new();
+	ts_seg->chunk_pool = gf_list_new();
+	ts_seg->chunks_mx = gf_mx_new("DASHTSChunks");
+	/*the counts may exceed the number of chunks actually queued, the writer releasing chunks before the indexer waits for them*/
+	ts_seg->has_chunks = gf_sema_new(0xFFFF, 0);
+	ts_seg->has_room = gf_sema_new(0xFFFF, DASH_TS_MAX_QUEUED_CHUNKS);
+	tsw->pending = gf_list_new();
+	tsw->th = gf_th_new("DASHTSIndexer");
+	if (!ts_seg->chunks || !ts_seg->chunk_pool || !ts_seg->chunks_mx || !ts_seg->has_chunks || !ts_seg->has_room || !tsw->pending || !tsw->th
+	        || (gf_th_run(tsw->th, dasher_mp2t_index_run, ts_seg) != GF_OK)) {
+		dasher_mp2t_writer_del(ts_seg, tsw);
+		return NULL;
+	}
+	tsw->seg_start = tsw->pos = ts_seg->base_offset;
+	return tsw;
+}
+
+/*copies the segments indexed so far, or all of them to get the final segment sizes*/
+static GF_Err dasher_mp2t_writer_sync_refs(GF_TSSegmenter *ts_seg, GF_TSSegmentWriter *tsw, Bool all)
+{
+	u32 first = all ? 0 : tsw->nb_refs;
+	if (!ts_seg->sidx || (ts_seg->sidx->nb_refs <= first)) return GF_OK;
+	if (tsw->nb_alloc_refs < ts_seg->sidx->nb_refs) {
+		tsw->nb_alloc_refs = MAX(2*tsw->nb_alloc_refs, ts_seg->sidx->nb_refs);
+		tsw->refs = (GF_SIDXReference *)gf_realloc(tsw->refs, sizeof(GF_SIDXReference)*tsw->nb_alloc_refs);
+		if (!tsw->refs) {
+			tsw->nb_alloc_refs = tsw->nb_refs = 0;
+			return GF_OUT_OF_MEM;
+		}
+	}
+	memcpy(tsw->refs + first, ts_seg->sidx->refs + first, sizeof(GF_SIDXReference)*(ts_seg->sidx->nb_refs - first));
+	tsw->nb_refs = ts_seg->sidx->nb_refs;
+	return GF_OK;
+}
+
+static GF_Err dasher_mp2t_writer_open_segment(GF_TSSegmentWriter *tsw)
+{
+	GF_DASHSegmenter *dasher = tsw->dasher;
+	GF_DashSegInput *dash_input = tsw->dash_input;
+	gf_media_mpd_format_segment_name(GF_DASH_TEMPLATE_SEGMENT, GF_TRUE, tsw->szSegName, tsw->szOutName, dash_input->representationID, dash_input->baseURL ? dash_input->baseURL[0] : NULL, dasher->seg_rad_name, "ts", 0, tsw->bandwidth, tsw->segment_index, dasher->use_segment_timeline);
+	tsw->dst = gf_fopen(tsw->szSegName, "wb");
+	if (!tsw->dst) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Cannot create segment file %s\n", tsw->szSegName));
+		return GF_IO_ERR;
+	}
+	return GF_OK;
+}
+
+static void dasher_mp2t_writer_close_segment(GF_TSSegmentWriter *tsw)
+{
+	gf_fclose(tsw->dst);
+	tsw->dst = NULL;
+	tsw->seg_start += tsw->refs[tsw->seg].reference_size;
+	tsw->seg++;
+	tsw->segment_index++;
+}
+
+static void dasher_mp2t_writer_release_chunk(GF_TSSegmenter *ts_seg, GF_TSSegmentWriter *tsw)
+{
+	GF_TSChunk *chunk = (GF_TSChunk *)gf_list_pop_front(tsw->pending);
+	gf_mx_p(ts_seg->chunks_mx);
+	gf_list_add(ts_seg->chunk_pool, chunk);
+	gf_mx_v(ts_seg->chunks_mx);
+	if (!tsw->indexing_done) gf_sema_notify(ts_seg->has_room, 1);
+}
+
+/*writes the pending chunks to the segments they belong to, up to the writable offset for the segment being indexed*/
+static void dasher_mp2t_writer_process(GF_TSSegmenter *ts_seg, GF_TSSegmentWriter *tsw, u64 writable_offset)
+{
+	while (gf_list_count(tsw->pending)) {
+		u64 limit, end;
+		u32 size;
+		char *data;
+		Bool seg_known = (tsw->seg < tsw->nb_refs) ? GF_TRUE : GF_FALSE;
+		GF_TSChunk *chunk = (GF_TSChunk *)gf_list_get(tsw->pending, 0);
+
+		/*data after the last segment (indexing suspended) or segments we failed to create*/
+		if (tsw->e || (tsw->indexing_done && !seg_known)) {
+			dasher_mp2t_writer_release_chunk(ts_seg, tsw);
+			continue;
+		}
+		if (tsw->pos >= chunk->offset + chunk->size) {
+			dasher_mp2t_writer_release_chunk(ts_seg, tsw);
+			continue;
+		}
+		limit = seg_known ? tsw->seg_start + tsw->refs[tsw->seg].reference_size : writable_offset;
+		if (tsw->pos >= limit) {
+			/*wait for the end of the segment to be known*/
+			if (!seg_known) return;
+			if (!tsw->dst) {
+				tsw->e = dasher_mp2t_writer_open_segment(tsw);
+				if (tsw->e) continue;
+			}
+			dasher_mp2t_writer_close_segment(tsw);
+			continue;
+		}
+		if (!tsw->dst) {
+			tsw->e = dasher_mp2t_writer_open_segment(tsw);
+			if (tsw->e) continue;
+		}
+		/*chunks and segment boundaries are packet-aligned, write straight from the chunk*/
+		end = MIN(chunk->offset + chunk->size, limit);
+		data = chunk->data + (tsw->pos - chunk->offset);
+		size = (u32) (end - tsw->pos);
+		gf_m2ts_restamp(data, size, tsw->pcr_shift, tsw->is_pes);
+		if (fwrite(data, 1, size, tsw->dst) != size) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] IO error while extracting segment %s\n", tsw->szSegName));
+		}
+		tsw->pos = end;
+	}
+}
+
+/*writes segments as they get indexed, until indexing is done*/
+static void dasher_mp2t_writer_run(GF_TSSegmenter *ts_seg, GF_TSSegmentWriter *tsw)
+{
+	while (!tsw->indexing_done) {
+		u64 writable;
+		GF_TSChunk *chunk;
+		gf_sema_wait(ts_seg->has_chunks);
+		gf_mx_p(ts_seg->chunks_mx);
+		chunk = (GF_TSChunk *)gf_list_pop_front(ts_seg->chunks);
+		if (!tsw->e) tsw->e = dasher_mp2t_writer_sync_refs(ts_seg, tsw, GF_FALSE);
+		writable = ts_seg->writable_offset;
+		if (tsw->e) ts_seg->abort_indexing = GF_TRUE;
+		gf_mx_v(ts_seg->chunks_mx);
+
+		if (chunk) {
+			gf_list_add(tsw->pending, chunk);
+			dasher_mp2t_writer_process(ts_seg, tsw, writable);
+		} else {
+			tsw->indexing_done = GF_TRUE;
+		}
+	}
+}
+
+/*writes the remaining segments once the index is complete*/
+static GF_Err dasher_mp2t_writer_flush(GF_TSSegmenter *ts_seg, GF_TSSegmentWriter *tsw)
+{
+	if (!tsw->e) tsw->e = dasher_mp2t_writer_sync_refs(ts_seg, tsw, GF_TRUE);
+	dasher_mp2t_writer_process(ts_seg, tsw, 0);
+	/*segments with no data left*/
+	while (!tsw->e && (tsw->seg < tsw->nb_refs)) {
+		if (!tsw->dst) {
+			tsw->e = dasher_mp2t_writer_open_segment(tsw);
+			if (tsw->e) break;
+		}
+		dasher_mp2t_writer_close_segment(tsw);
+	}
+	return tsw->e;
+}
+
 static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *szOutName, GF_DASHSegmenter *dasher, Bool first_in_set)
 {
 	GF_TSSegmenter ts_seg;
+	GF_TSSegmentWriter *tsw = NULL;
 	Bool rewrite_input = GF_FALSE;
 	u8 is_pes[GF_M2TS_MAX_STREAMS];
 	char szOpt[100];
@@ -4768,16 +5232,71 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 		if (opt) sscanf(opt, LLD, &ts_seg.duration_at_last_pass);
 	}
 
+	memset(is_pes, 0, sizeof(u8)*GF_M2TS_MAX_STREAMS);
+	for (i=0; i<dash_input->nb_components; i++) {
+		is_pes[ dash_input->components[i].ID ] = 1;
+	}
+	pcr_shift = 0;
+
+	bandwidth = dash_input->bandwidth;
+	if (!bandwidth) bandwidth = ts_seg.bandwidth;
+
+	/*segment numbering and timing carried over from the previous calls*/
+	if (dasher->dash_ctx) {
+		opt = gf_cfg_get_key(dasher->dash_ctx, szSectionName, "Setup");
+		if (opt && !strcmp(opt, "yes")) {
+			if (!bandwidth) {
+				opt = gf_cfg_get_key(dasher->dash_ctx, szSectionName, "Bandwidth");
+				if (opt) sscanf(opt, "%u", &bandwidth);
+			}
+
+			opt = gf_cfg_get_key(dasher->dash_ctx, szSectionName, "StartIndex");
+			if (opt) sscanf(opt, "%u", &segment_index);
+
+			opt = gf_cfg_get_key(dasher->dash_ctx, szSectionName, "PCR90kOffset");
+			if (opt) sscanf(opt, LLU, &pcr_shift);
+
+			opt = gf_cfg_get_key(dasher->dash_ctx, szSectionName, "CumulatedDuration");
+			if (opt) {
+				u64 val;
+				sscanf(opt, LLU, &val);
+				cumulated_duration = ((Double) val) / dasher->dash_scale;
+			}
+		}
+	}
+
+	/*when extracting segments, write them while the file is being indexed so that the input is only read once*/
+	if (!dasher->single_file_mode && (dasher->use_url_template != 2)) {
+		tsw = dasher_mp2t_writer_new(&ts_seg);
+		if (tsw) {
+			tsw->dasher = dasher;
+			tsw->dash_input = dash_input;
+			tsw->szOutName = szOutName;
+			tsw->bandwidth = bandwidth;
+			tsw->pcr_shift = pcr_shift;
+			tsw->is_pes = is_pes;
+			tsw->segment_index = segment_index;
+		}
+	}
+
 	/*index the file*/
-	while (!feof(ts_seg.src) && !ts_seg.suspend_indexing) {
-		char data[NB_TSPCK_IO_BYTES];
-		s32 size = (s32) fread(data, 1, NB_TSPCK_IO_BYTES, ts_seg.src);
-		if (size<0) {
-			e = GF_IO_ERR;
+	if (tsw) {
+		dasher_mp2t_writer_run(&ts_seg, tsw);
+		if (ts_seg.index_error) {
+			e = ts_seg.index_error;
 			goto exit;
 		}
-		gf_m2ts_process_data(ts_seg.ts, data, size);
-		if (size<NB_TSPCK_IO_BYTES) break;
+	} else {
+		while (!feof(ts_seg.src) && !ts_seg.suspend_indexing) {
+			char data[NB_TSPCK_IO_BYTES];
+			s32 size = (s32) fread(data, 1, NB_TSPCK_IO_BYTES, ts_seg.src);
+			if (size<0) {
+				e = GF_IO_ERR;
+				goto exit;
+			}
+			gf_m2ts_process_data(ts_seg.ts, data, size);
+			if (size<NB_TSPCK_IO_BYTES) break;
+		}
 	}
 	if (feof(ts_seg.src)) ts_seg.suspend_indexing = 0;
 
@@ -4799,42 +5318,19 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 	m2ts_sidx_finalize_size(&ts_seg, ts_seg.file_size);
 	GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Indexing done (1 sidx, %d entries).\n", ts_seg.sidx->nb_refs));
 
-	gf_media_mpd_format_segment_name(GF_DASH_TEMPLATE_REPINDEX, GF_TRUE, IdxName, basename, dash_input->representationID, dash_input->baseURL ? dash_input->baseURL[0] : NULL, dasher->seg_rad_name ? dasher->seg_rad_name : szOutName, "six", 0, 0, 0, dasher->use_segment_timeline);
-
-
-	memset(is_pes, 0, sizeof(u8)*GF_M2TS_MAX_STREAMS);
-	for (i=0; i<dash_input->nb_components; i++) {
-		is_pes[ dash_input->components[i].ID ] = 1;
+	if (tsw) {
+		e = dasher_mp2t_writer_flush(&ts_seg, tsw);
+		if (e) goto exit;
 	}
-	pcr_shift = 0;
 
-	bandwidth = dash_input->bandwidth;
-	if (!bandwidth) bandwidth = ts_seg.bandwidth;
+	gf_media_mpd_format_segment_name(GF_DASH_TEMPLATE_REPINDEX, GF_TRUE, IdxName, basename, dash_input->representationID, dash_input->baseURL ? dash_input->baseURL[0] : NULL, dasher->seg_rad_name ? dasher->seg_rad_name : szOutName, "six", 0, 0, 0, dasher->use_segment_timeline);
 
-	if (dasher->dash_ctx) {
 
+	if (dasher->dash_ctx) {
 		opt = gf_cfg_get_key(dasher->dash_ctx, szSectionName, "Setup");
 		if (!opt || strcmp(opt, "yes")) {
 			gf_cfg_set_key(dasher->dash_ctx, szSectionName, "Setup", "yes");
 			gf_cfg_set_key(dasher->dash_ctx, szSectionName, "ID", dash_input->representationID);
-		} else {
-			if (!bandwidth) {
-				opt = gf_cfg_get_key(dasher->dash_ctx, szSectionName, "Bandwidth");
-				if (opt) sscanf(opt, "%u", &bandwidth);
-			}
-
-			opt = gf_cfg_get_key(dasher->dash_ctx, szSectionName, "StartIndex");
-			if (opt) sscanf(opt, "%u", &segment_index);
-
-			opt = gf_cfg_get_key(dasher->dash_ctx, szSectionName, "PCR90kOffset");
-			if (opt) sscanf(opt, LLU, &pcr_shift);
-
-			opt = gf_cfg_get_key(dasher->dash_ctx, szSectionName, "CumulatedDuration");
-			if (opt) {
-				u64 val;
-				sscanf(opt, LLU, &val);
-				cumulated_duration = ((Double) val) / dasher->dash_scale;
-			}
 		}
 	}
 
@@ -4877,6 +5373,8 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 	fprintf(dasher->mpd, " startWithSAP=\"%d\"", dasher->segments_start_with_rap ? 1 : 0);
 	fprintf(dasher->mpd, " bandwidth=\"%d\"", bandwidth);
 	fprintf(dasher->mpd, ">\n");
+	dash_input->hls_bandwidth = bandwidth;
+	strcpy(dash_input->hls_codecs, szCodecs);
 
 	/* writing Representation level descriptors */
 	if (dash_input->nb_rep_descs) {
@@ -4975,10 +5473,11 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 			rewrite_input = GF_TRUE;
 
 		} else {
-			FILE *src, *dst;
+			FILE *src = NULL, *dst;
 			u64 pos, end;
 			Double current_time = cumulated_duration, dur;
-			src = gf_fopen(dash_input->file_name, "rb");
+			/*segments have already been extracted while indexing*/
+			if (!tsw) src = gf_fopen(dash_input->file_name, "rb");
 			start = ts_seg.sidx->first_offset;
 			for (i=0; i<ts_seg.sidx->nb_refs; i++) {
 				char buf[NB_TSPCK_IO_BYTES];
@@ -4988,7 +5487,13 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 
 				/*warning - we may introduce repeated sequence number when concatenating files. We should use switching
 				segments to force reset of the continuity counter for all our pids - we don't because most players don't car ...*/
-				if (dasher->use_url_template != 2) {
+				/*segments extracted while indexing only need to be registered*/
+				if (tsw) {
+					dur = ref->subsegment_duration;
+					dur /= 90000;
+					gf_dasher_store_segment_info(dasher, dash_input->representationID, SegName, (u64) (current_time*dasher->dash_scale), (u64) ((current_time+dur)*dasher->dash_scale), dasher->dash_scale);
+					current_time += dur;
+				} else if (dasher->use_url_template != 2) {
 					dst = gf_fopen(SegName, "wb");
 					if (!dst) {
 						gf_fclose(src);
@@ -5026,6 +5531,8 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 					}
 					gf_fclose(dst);
 				}
+				if (dasher->use_url_template != 2)
+					gf_dasher_hls_add_segment(dasher, dash_input, SegName, ref->subsegment_duration, 90000, 0, 0);
 				start += ref->reference_size;
 
 				if (!dasher->use_url_template) {
@@ -5043,7 +5550,7 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 				segment_index++;
 				gf_set_progress("Extracting segment ", i+1, ts_seg.sidx->nb_refs);
 			}
-			gf_fclose(src);
+			if (src) gf_fclose(src);
 		}
 		if (!dasher->seg_rad_name || !dasher->use_url_template) {
 			fprintf(dasher->mpd, "    </SegmentList>\n");
@@ -5061,6 +5568,12 @@ static GF_Err dasher_mp2t_segment_file(GF_DashSegInput *dash_input, const char *
 			e = GF_IO_ERR;
 			goto exit;
 		}
+		start = ts_seg.sidx->first_offset;
+		for (i=0; i<ts_seg.sidx->nb_refs; i++) {
+			GF_SIDXReference *ref = &ts_seg.sidx->refs[i];
+			gf_dasher_hls_add_segment(dasher, dash_input, SegName, ref->subsegment_duration, 90000, start, ref->reference_size);
+			start += ref->reference_size;
+		}
 		in = gf_fopen(dash_input->file_name, "rb");
 		gf_fseek(in, 0, SEEK_END);
 		fsize = gf_ftell(in);
@@ -5125,6 +5638,7 @@ exit:
 		gf_media_mpd_format_segment_name(GF_DASH_TEMPLATE_REPINDEX, GF_TRUE, IdxName, szOutName, dash_input->representationID, dash_input->baseURL ? dash_input->baseURL[0] : NULL, dasher->seg_rad_name, "six", 0, 0, 0, dasher->use_segment_timeline);
 		gf_delete_file(IdxName);
 	}
+	if (tsw) dasher_mp2t_writer_del(&ts_seg, tsw);
 	dasher_del_ts_demux(&ts_seg);
 	return e;
 }
@@ -6062,7 +6576,8 @@ static Bool gf_dasher_cleanup(GF_DASHSegmenter *dasher)
 			}
 
 			e = gf_delete_file(fileName);
-			if (e) {
+			/*if the segment is already gone, still remove it from the context, otherwise the context would grow forever*/
+			if (e && gf_file_exists(fileName)) {
 				GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[DASH] Could not remove file %s: %s\n", fileName, gf_error_to_string(e) ));
 				break;
 			}
@@ -6217,6 +6732,7 @@ void gf_dasher_clean_inputs(GF_DASHSegmenter *dasher)
 		}
 		if (dasher->inputs[i].dependencyID) gf_free(dasher->inputs[i].dependencyID);
 		if (dasher->inputs[i].init_seg_url) gf_free(dasher->inputs[i].init_seg_url);
+		gf_dasher_hls_reset(&dasher->inputs[i]);
 		if (dasher->inputs[i].period_id_not_specified && dasher->inputs[i].periodID) gf_free(dasher->inputs[i].periodID);
 
 		if (dasher->inputs[i].isobmf_input) {
@@ -6512,6 +7028,13 @@ GF_Err gf_dasher_set_isobmff_options(GF_DASHSegmenter *dasher, Bool mvex_after_t
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_dasher_enable_hls(GF_DASHSegmenter *dasher, Bool enable)
+{
+	dasher->hls_output = enable;
+	return GF_OK;
+}
+
 static void dash_input_check_period_id(GF_DASHSegmenter *dasher, GF_DashSegInput *dash_input)
 {
 	if (dash_input->period_id_not_specified) {
@@ -6606,6 +7129,370 @@ GF_Err gf_dasher_add_input(GF_DASHSegmenter *dasher, GF_DashSegmenterInput *inpu
 
 static const char *role_default = "main";
 
+static void gf_dasher_hls_playlist_name(GF_DASHSegmenter *dasher, const char *representationID, char *szName)
+{
+	char *sep;
+	strcpy(szName, dasher->mpd_name);
+	sep = strrchr(szName, '.');
+	if (sep && !strchr(sep, '/') && !strchr(sep, '\\')) sep[0] = 0;
+	if (representationID) {
+		strcat(szName, "_");
+		strcat(szName, representationID);
+	}
+	strcat(szName, ".m3u8");
+}
+
+/*loads segments of previous generations from the DASH context*/
+static void gf_dasher_hls_load_context(GF_DASHSegmenter *dasher, const char *szSecName, GF_List *entries, u32 *media_seq, u32 *disc_seq)
+{
+	u32 i, count;
+	char *init_url = NULL;
+	u64 init_offset = 0, init_size = 0;
+	const char *opt = gf_cfg_get_key(dasher->dash_ctx, szSecName, "MediaSequence");
+	if (opt) *media_seq = atoi(opt);
+	opt = gf_cfg_get_key(dasher->dash_ctx, szSecName, "DiscontinuitySequence");
+	if (opt) *disc_seq = atoi(opt);
+
+	count = gf_cfg_get_key_count(dasher->dash_ctx, szSecName);
+	for (i=0; i<count; i++) {
+		char szKey[100];
+		u32 disc, pos;
+		GF_DashHLSSegment *seg;
+		const char *key_name = gf_cfg_get_key_name(dasher->dash_ctx, szSecName, i);
+		if (!key_name || strncmp(key_name, "Seg", 3)) continue;
+		opt = gf_cfg_get_key(dasher->dash_ctx, szSecName, key_name);
+		if (!opt) continue;
+
+		/*initialization segment is only stored when it changes*/
+		sprintf(szKey, "Map%s", key_name+3);
+		if (gf_cfg_get_key(dasher->dash_ctx, szSecName, szKey)) {
+			const char *map = gf_cfg_get_key(dasher->dash_ctx, szSecName, szKey);
+			pos = 0;
+			if (sscanf(map, LLU" "LLU" %n", &init_offset, &init_size, &pos) == 2) {
+				if (init_url) gf_free(init_url);
+				init_url = gf_strdup(map + pos);
+			}
+		}
+
+		GF_SAFEALLOC(seg, GF_DashHLSSegment);
+		if (!seg) break;
+		pos = disc = 0;
+		if (sscanf(opt, "%lf "LLU" "LLU" %u %n", &seg->duration, &seg->offset, &seg->size, &disc, &pos) != 4) {
+			gf_free(seg);
+			continue;
+		}
+		seg->url = gf_strdup(opt + pos);
+		seg->discontinuity = disc ? GF_TRUE : GF_FALSE;
+		if (init_url) {
+			seg->init_url = gf_strdup(init_url);
+			seg->init_offset = init_offset;
+			seg->init_size = init_size;
+		}
+		gf_list_add(entries, seg);
+	}
+	if (init_url) gf_free(init_url);
+}
+
+static void gf_dasher_hls_save_context(GF_DASHSegmenter *dasher, const char *szSecName, GF_List *entries, u32 media_seq, u32 disc_seq)
+{
+	u32 i, count;
+	char szKey[100], szVal[GF_MAX_PATH+100];
+	const char *prev_init = NULL;
+	u64 prev_init_offset = 0, prev_init_size = 0;
+
+	gf_cfg_del_section(dasher->dash_ctx, szSecName);
+	sprintf(szVal, "%u", media_seq);
+	gf_cfg_set_key(dasher->dash_ctx, szSecName, "MediaSequence", szVal);
+	sprintf(szVal, "%u", disc_seq);
+	gf_cfg_set_key(dasher->dash_ctx, szSecName, "DiscontinuitySequence", szVal);
+
+	count = gf_list_count(entries);
+	for (i=0; i<count; i++) {
+		GF_DashHLSSegment *seg = (GF_DashHLSSegment *)gf_list_get(entries, i);
+		if (seg->init_url && (!prev_init || strcmp(prev_init, seg->init_url) || (prev_init_offset != seg->init_offset) || (prev_init_size != seg->init_size))) {
+			sprintf(szKey, "Map%u", media_seq + i);
+			sprintf(szVal, LLU" "LLU" %s", seg->init_offset, seg->init_size, seg->init_url);
+			gf_cfg_set_key(dasher->dash_ctx, szSecName, szKey, szVal);
+			prev_init = seg->init_url;
+			prev_init_offset = seg->init_offset;
+			prev_init_size = seg->init_size;
+		}
+		sprintf(szKey, "Seg%u", media_seq + i);
+		sprintf(szVal, "%g "LLU" "LLU" %u %s", seg->duration, seg->offset, seg->size, seg->discontinuity ? 1 : 0, seg->url);
+		gf_cfg_set_key(dasher->dash_ctx, szSecName, szKey, szVal);
+	}
+}
+
+/*writes the media playlist of the given representation, gathering its segments across all periods*/
+static GF_Err gf_dasher_hls_write_media_playlist(GF_DASHSegmenter *dasher, const char *representationID, u32 max_period, u32 *version)
+{
+	u32 i, p, count, media_seq, disc_seq, prev_period;
+	Double max_dur, total_dur;
+	char szName[GF_MAX_PATH], szSecName[200];
+	const char *prev_init;
+	u64 prev_init_offset, prev_init_size;
+	GF_List *entries;
+	FILE *m3u8;
+
+	entries = gf_list_new();
+	if (!entries) return GF_OUT_OF_MEM;
+	media_seq = disc_seq = 0;
+	sprintf(szSecName, "HLS_%s", representationID);
+	if (dasher->dash_ctx)
+		gf_dasher_hls_load_context(dasher, szSecName, entries, &media_seq, &disc_seq);
+
+	/*append segments produced by this generation, in period order*/
+	prev_period = 0;
+	for (p=1; p<=max_period; p++) {
+		for (i=0; i<dasher->nb_inputs; i++) {
+			u32 j;
+			GF_DashSegInput *dash_input = &dasher->inputs[i];
+			if ((dash_input->period != p) || strcmp(dash_input->representationID, representationID)) continue;
+			if (!dash_input->hls_segments) continue;
+
+			for (j=0; j<gf_list_count(dash_input->hls_segments); j++) {
+				GF_DashHLSSegment *src = (GF_DashHLSSegment *)gf_list_get(dash_input->hls_segments, j);
+				GF_DashHLSSegment *seg;
+				GF_SAFEALLOC(seg, GF_DashHLSSegment);
+				if (!seg) break;
+				seg->url = gf_strdup(src->url);
+				seg->duration = src->duration;
+				seg->offset = src->offset;
+				seg->size = src->size;
+				if (!j && prev_period && (prev_period != p))
+					seg->discontinuity = GF_TRUE;
+				if (dash_input->hls_init_url) {
+					seg->init_url = gf_strdup(dash_input->hls_init_url);
+					seg->init_offset = dash_input->hls_init_offset;
+					seg->init_size = dash_input->hls_init_size;
+				}
+				gf_list_add(entries, seg);
+			}
+			prev_period = p;
+		}
+	}
+
+	/*live sliding window: only keep the segments within the time shift buffer*/
+	if (dasher->dash_mode && (dasher->time_shift_depth >= 0)) {
+		total_dur = 0;
+		count = gf_list_count(entries);
+		for (i=0; i<count; i++) {
+			GF_DashHLSSegment *seg = (GF_DashHLSSegment *)gf_list_get(entries, i);
+			total_dur += seg->duration;
+		}
+		while ((gf_list_count(entries)>1) && (total_dur > dasher->time_shift_depth)) {
+			GF_DashHLSSegment *seg = (GF_DashHLSSegment *)gf_list_get(entries, 0);
+			if (total_dur - seg->duration < dasher->time_shift_depth) break;
+			total_dur -= seg->duration;
+			media_seq++;
+			if (seg->discontinuity) disc_seq++;
+			gf_list_rem(entries, 0);
+			if (seg->url) gf_free(seg->url);
+			if (seg->init_url) gf_free(seg->init_url);
+			gf_free(seg);
+		}
+	}
+
+	if (dasher->dash_ctx)
+		gf_dasher_hls_save_context(dasher, szSecName, entries, media_seq, disc_seq);
+
+	*version = 3;
+	max_dur = 0;
+	count = gf_list_count(entries);
+	for (i=0; i<count; i++) {
+		GF_DashHLSSegment *seg = (GF_DashHLSSegment *)gf_list_get(entries, i);
+		if (seg->duration > max_dur) max_dur = seg->duration;
+		/*EXT-X-MAP outside of I-frame playlists requires version 6, byte ranges version 4*/
+		if (seg->init_url) *version = 7;
+		else if (seg->size && (*version < 4)) *version = 4;
+	}
+
+	gf_dasher_hls_playlist_name(dasher, representationID, szName);
+	m3u8 = gf_fopen(szName, "wt");
+	if (!m3u8) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Cannot create HLS playlist file %s\n", szName));
+		gf_dasher_hls_del_segments(entries);
+		return GF_IO_ERR;
+	}
+
+	fprintf(m3u8, "#EXTM3U\n");
+	fprintf(m3u8, "#EXT-X-VERSION:%u\n", *version);
+	fprintf(m3u8, "#EXT-X-TARGETDURATION:%u\n", (u32) (max_dur + 0.5));
+	fprintf(m3u8, "#EXT-X-MEDIA-SEQUENCE:%u\n", media_seq);
+	if (disc_seq)
+		fprintf(m3u8, "#EXT-X-DISCONTINUITY-SEQUENCE:%u\n", disc_seq);
+	if (!dasher->dash_mode)
+		fprintf(m3u8, "#EXT-X-PLAYLIST-TYPE:VOD\n");
+
+	prev_init = NULL;
+	prev_init_offset = prev_init_size = 0;
+	for (i=0; i<count; i++) {
+		GF_DashHLSSegment *seg = (GF_DashHLSSegment *)gf_list_get(entries, i);
+		if (seg->discontinuity)
+			fprintf(m3u8, "#EXT-X-DISCONTINUITY\n");
+
+		if (seg->init_url && (!prev_init || strcmp(prev_init, seg->init_url) || (prev_init_offset != seg->init_offset) || (prev_init_size != seg->init_size))) {
+			fprintf(m3u8, "#EXT-X-MAP:URI=\"%s\"", seg->init_url);
+			if (seg->init_size)
+				fprintf(m3u8, ",BYTERANGE=\""LLU"@"LLU"\"", seg->init_size, seg->init_offset);
+			fprintf(m3u8, "\n");
+			prev_init = seg->init_url;
+			prev_init_offset = seg->init_offset;
+			prev_init_size = seg->init_size;
+		}
+		fprintf(m3u8, "#EXTINF:%.3f,\n", seg->duration);
+		if (seg->size)
+			fprintf(m3u8, "#EXT-X-BYTERANGE:"LLU"@"LLU"\n", seg->size, seg->offset);
+		fprintf(m3u8, "%s\n", seg->url);
+	}
+	if (!dasher->dash_mode)
+		fprintf(m3u8, "#EXT-X-ENDLIST\n");
+
+	gf_fclose(m3u8);
+	gf_dasher_hls_del_segments(entries);
+	return GF_OK;
+}
+
+/*writes HLS master and media playlists for all representations - alternate audio representations are signaled as EXT-X-MEDIA when video is present*/
+static GF_Err gf_dasher_write_hls(GF_DASHSegmenter *dasher)
+{
+	u32 i, j, max_period, version, max_version, max_audio_bandwidth;
+	Bool has_video, has_audio, first_audio;
+	char szName[GF_MAX_PATH], szCodecs[200], szAudioCodecs[200];
+	FILE *m3u8;
+	GF_Err e;
+
+	max_period = 0;
+	for (i=0; i<dasher->nb_inputs; i++) {
+		if (dasher->inputs[i].period > max_period) max_period = dasher->inputs[i].period;
+	}
+
+	/*media playlists, one per representation ID*/
+	max_version = 3;
+	for (i=0; i<dasher->nb_inputs; i++) {
+		GF_DashSegInput *dash_input = &dasher->inputs[i];
+		if (!dash_input->period) continue;
+		for (j=0; j<i; j++) {
+			if (dasher->inputs[j].period && !strcmp(dasher->inputs[j].representationID, dash_input->representationID)) break;
+		}
+		if (j<i) continue;
+
+		e = gf_dasher_hls_write_media_playlist(dasher, dash_input->representationID, max_period, &version);
+		if (e) return e;
+		if (version > max_version) max_version = version;
+	}
+
+	/*check for video and alternate audio renditions*/
+	has_video = has_audio = GF_FALSE;
+	max_audio_bandwidth = 0;
+	szAudioCodecs[0] = 0;
+	for (i=0; i<dasher->nb_inputs; i++) {
+		GF_DashSegInput *dash_input = &dasher->inputs[i];
+		if (!dash_input->period) continue;
+		for (j=0; j<dash_input->nb_components; j++) {
+			if (dash_input->components[j].width && dash_input->components[j].height) break;
+		}
+		if (j<dash_input->nb_components) {
+			has_video = GF_TRUE;
+		} else if (dash_input->nb_components && dash_input->components[0].sample_rate) {
+			has_audio = GF_TRUE;
+			if (dash_input->hls_bandwidth > max_audio_bandwidth) max_audio_bandwidth = dash_input->hls_bandwidth;
+			if (!szAudioCodecs[0]) strcpy(szAudioCodecs, dash_input->hls_codecs);
+		}
+	}
+
+	if (!has_video) has_audio = GF_FALSE;
+
+	gf_dasher_hls_playlist_name(dasher, NULL, szName);
+	m3u8 = gf_fopen(szName, "wt");
+	if (!m3u8) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Cannot create HLS playlist file %s\n", szName));
+		return GF_IO_ERR;
+	}
+	fprintf(m3u8, "#EXTM3U\n");
+	fprintf(m3u8, "#EXT-X-VERSION:%u\n", max_version);
+
+	first_audio = GF_TRUE;
+	for (i=0; i<dasher->nb_inputs; i++) {
+		Bool is_audio;
+		GF_DashSegInput *dash_input = &dasher->inputs[i];
+		if (!dash_input->period) continue;
+		for (j=0; j<i; j++) {
+			if (dasher->inputs[j].period && !strcmp(dasher->inputs[j].representationID, dash_input->representationID)) break;
+		}
+		if (j<i) continue;
+
+		for (j=0; j<dash_input->nb_components; j++) {
+			if (dash_input->components[j].width && dash_input->components[j].height) break;
+		}
+		is_audio = ((j==dash_input->nb_components) && dash_input->nb_components && dash_input->components[0].sample_rate) ? GF_TRUE : GF_FALSE;
+		gf_dasher_hls_playlist_name(dasher, dash_input->representationID, szName);
+
+		if (has_audio && is_audio) {
+			fprintf(m3u8, "#EXT-X-MEDIA:TYPE=AUDIO,GROUP-ID=\"audio\",NAME=\"%s\"", dash_input->representationID);
+			if (dash_input->components[0].lang && strcmp(dash_input->components[0].lang, "und"))
+				fprintf(m3u8, ",LANGUAGE=\"%s\"", dash_input->components[0].lang);
+			fprintf(m3u8, ",AUTOSELECT=YES,DEFAULT=%s", first_audio ? "YES" : "NO");
+			if (dash_input->components[0].channels)
+				fprintf(m3u8, ",CHANNELS=\"%u\"", dash_input->components[0].channels);
+			fprintf(m3u8, ",URI=\"%s\"\n", gf_dasher_strip_output_dir(dasher->mpd_name, szName));
+			first_audio = GF_FALSE;
+		}
+	}
+
+	for (i=0; i<dasher->nb_inputs; i++) {
+		u32 bandwidth;
+		GF_DashSegInput *dash_input = &dasher->inputs[i];
+		struct _dash_component *vcomp = NULL;
+		if (!dash_input->period) continue;
+		for (j=0; j<i; j++) {
+			if (dasher->inputs[j].period && !strcmp(dasher->inputs[j].representationID, dash_input->representationID)) break;
+		}
+		if (j<i) continue;
+
+		for (j=0; j<dash_input->nb_components; j++) {
+			if (dash_input->components[j].width && dash_input->components[j].height) {
+				vcomp = &dash_input->components[j];
+				break;
+			}
+		}
+		/*audio renditions have already been declared*/
+		if (has_audio && !vcomp && dash_input->nb_components && dash_input->components[0].sample_rate)
+			continue;
+
+		/*representation may be split across several periods*/
+		bandwidth = 0;
+		for (j=i; j<dasher->nb_inputs; j++) {
+			if (!dasher->inputs[j].period || strcmp(dasher->inputs[j].representationID, dash_input->representationID)) continue;
+			if (dasher->inputs[j].hls_bandwidth > bandwidth) bandwidth = dasher->inputs[j].hls_bandwidth;
+		}
+		strcpy(szCodecs, dash_input->hls_codecs);
+		if (vcomp && has_audio) {
+			bandwidth += max_audio_bandwidth;
+			if (szAudioCodecs[0] && !strstr(szCodecs, szAudioCodecs) && (strlen(szCodecs) + strlen(szAudioCodecs) + 2 < 200)) {
+				if (szCodecs[0]) strcat(szCodecs, ",");
+				strcat(szCodecs, szAudioCodecs);
+			}
+		}
+		fprintf(m3u8, "#EXT-X-STREAM-INF:BANDWIDTH=%u", bandwidth);
+		if (szCodecs[0])
+			fprintf(m3u8, ",CODECS=\"%s\"", szCodecs);
+		if (vcomp) {
+			fprintf(m3u8, ",RESOLUTION=%ux%u", vcomp->width, vcomp->height);
+			if (dash_input->hls_frame_rate)
+				fprintf(m3u8, ",FRAME-RATE=%.3f", dash_input->hls_frame_rate);
+			else if (vcomp->fps_num && vcomp->fps_denum)
+				fprintf(m3u8, ",FRAME-RATE=%.3f", ((Double) vcomp->fps_num) / vcomp->fps_denum);
+			if (has_audio)
+				fprintf(m3u8, ",AUDIO=\"audio\"");
+		}
+		gf_dasher_hls_playlist_name(dasher, dash_input->representationID, szName);
+		fprintf(m3u8, "\n%s\n", gf_dasher_strip_output_dir(dasher->mpd_name, szName));
+	}
+	gf_fclose(m3u8);
+	return GF_OK;
+}
+
 GF_EXPORT
 GF_Err gf_dasher_process(GF_DASHSegmenter *dasher, Double sub_duration)
 {
@@ -6685,6 +7572,7 @@ GF_Err gf_dasher_process(GF_DASHSegmenter *dasher, Double sub_duration)
 		GF_DashSegInput *dash_input = &dasher->inputs[i];
 		dash_input->period = 0;
 		dash_input_check_period_id(dasher, dash_input);
+		gf_dasher_hls_reset(dash_input);
 
 		dash_input->moof_seqnum_increase = dash_input->nb_representations;
 		if (!dash_input->moof_seqnum_increase) dash_input->moof_seqnum_increase=1;
@@ -7711,6 +8599,12 @@ GF_Err gf_dasher_process(GF_DASHSegmenter *dasher, Double sub_duration)
 			GF_LOG(GF_LOG_WARNING, GF_LOG_AUTHOR, ("[DASH] Manifest MPD is too big for HbbTV 1.5. Limit is 100kB, current size is "LLU"kB\n", gf_ftell(mpd)/1024));
 	}
 
+	if (dasher->hls_output) {
+		e = gf_dasher_write_hls(dasher);
+		if (e) goto exit;
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] HLS playlists done\n"));
+	}
+
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Done dashing\n"));
 	dasher->nb_secs_to_discard = 0;
 
@@ -750,85 +750,68 @@ void gf_m2ts_target_ip(GF_M2TS_IP_Stream* ip_str, u8 * data)
 /*generate RS code and fullfill the RS table of MPE_FEC_FRAME*/
 void encode_fec(MPE_FEC_FRAME * mff)
 {
-#if 0
 	u8 adt_rs_en_buffer [ MPE_ADT_COLS + MPE_RS_COLS ];
-	u32 rows = mff->rows;
-	u32 i = 0;
-	u32 cols = 0;
+	u32 i;
 
-	cols = mff->col_adt;
-	for ( i = 0; i < rows; i ++ ) {
+	initialize_ecc ();
+	for ( i = 0; i < mff->rows; i ++ ) {
 		/* read a row from ADT into buffer */
 		getRowFromADT(mff, i, adt_rs_en_buffer);
-		/* ************** */
 		/* Encode data into codeword, adding NPAR parity bytes */
-		encode_data(adt_rs_en_buffer, cols, adt_rs_en_buffer);
-		fprintf(stderr, "Encoded data is   : \"%s\"\n", adt_rs_en_buffer);
-		fprintf(stderr, "data with error is: \"%s\"\n", adt_rs_en_buffer);
+		encode_data(adt_rs_en_buffer, mff->col_adt, adt_rs_en_buffer);
 		/*set a row of RS into RS table*/
-		setRowRS ( mff, i , (unsigned char *)(adt_rs_en_buffer + cols) );
+		setRowRS ( mff, i, adt_rs_en_buffer + mff->col_adt );
 	}
-#endif
 }
 
 /*decode the MPE_FEC_FRAME*/
 void decode_fec(MPE_FEC_FRAME * mff)
 {
-	u32 i,ML,offset;
-	u8 *data;
+	u32 i, j, r, nb_cols;
+	u8 *cols[255];
+	u8 syn[NPAR*RS_BLOCK_ROWS];
 	u8 linebuffer[255];
-
-	//fprintf(stderr, "Starting FEC decoding ...\n");
-
-	data = gf_malloc((mff->rows*191)*sizeof(char));
-	memset(data,0,sizeof(data));
+	int erasures[255];
 
 	initialize_ecc ();
-	ML = 255;
-	memset(linebuffer, 0, 255);
-	offset = 0;
-
-	/*fprintf(stderr, "ADT data\n");
-	print_bytes(mff->p_adt, 32, 1, 0);
-	print_bytes(mff->p_adt+512, 32, 1, 0);
-	print_bytes(mff->p_adt+512+512, 32, 1, 0);
-	print_bytes(mff->p_adt+512+512+512, 32, 1, 1);
-	fprintf(stderr, "RS data\n");
-	print_bytes(mff->p_rs, 32, 1, 0);
-	print_bytes(mff->p_rs+512, 32, 1, 0);
-	print_bytes(mff->p_rs+512+512, 32, 1, 0);
-	print_bytes(mff->p_rs+512+512+512, 32, 1, 1);*/
-
-	for ( i = 0; i < mff->rows; i ++ )	{
-		u8 tmp[255];
-
-		getRowFromADT(mff, i, linebuffer);
-		getRowFromRS(mff, i, linebuffer + mff->col_adt);
-
-		encode_data(linebuffer, 191, tmp);
-
-		decode_data(linebuffer, ML);
-		if (check_syndrome () != 0) {
-			u32 nerasures = 0;
-			u32 *erasures = NULL;
-
-			/* TODO: set the erasures and errors based on the MFF */
-			if(correct_errors_erasures (linebuffer, ML, nerasures,  erasures) == 0)
-			{
-				//fprintf(stderr, "Correction Error line %d \n", i);
+	nb_cols = mff->col_adt + mff->col_rs;
+	if (nb_cols > 255) return;
+
+	/*the frame is stored column by column: bytes at a given position of RS_BLOCK_ROWS successive rows are contiguous,
+	syndromes are computed for all these rows at once*/
+	for (i = 0; i < mff->rows; i += RS_BLOCK_ROWS) {
+		for (j = 0; j < mff->col_adt; j++) cols[j] = mff->p_adt + j*mff->rows + i;
+		for (j = 0; j < mff->col_rs; j++) cols[mff->col_adt + j] = mff->p_rs + j*mff->rows + i;
+
+		decode_data_interleaved(cols, nb_cols, syn);
+
+		for (r = 0; r < RS_BLOCK_ROWS; r++) {
+			u32 k, nerasures = 0;
+			int ok = 0;
+
+			for (k = 0; k < NPAR; k++) synBytes[k] = syn[k*RS_BLOCK_ROWS + r];
+			if (!check_syndrome()) continue;
+
+			/*gather the row, erasures are the bytes of sections with a bad CRC*/
+			for (k = 0; k < nb_cols; k++) {
+				u32 err;
+				linebuffer[k] = cols[k][r];
+				if (k < mff->col_adt) err = mff->p_error_adt[k*mff->rows + i + r];
+				else err = mff->p_error_rs[(k - mff->col_adt)*mff->rows + i + r];
+				if (err) erasures[nerasures++] = nb_cols - 1 - k;
 			}
+			if (nerasures > NPAR) nerasures = 0;
 
-			/* TODO: replace the current line in MFF */
+			if (nerasures) ok = correct_erasures(linebuffer, nb_cols, nerasures, erasures);
+			if (!ok) ok = correct_errors_erasures(linebuffer, nb_cols, nerasures, erasures);
+			if (!ok) {
+				GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MPE-FEC] Cannot correct row %d\n", i + r));
+				continue;
+			}
+			/*replace the current line in MFF*/
+			for (k = 0; k < mff->col_adt; k++) cols[k][r] = linebuffer[k];
 		}
-
-		memcpy(data+offset,linebuffer,sizeof(data));
-		offset += 191;
 	}
-	//fprintf(stderr, "FEC decoding done.\n");
-	memcpy(mff->p_adt,data,sizeof(data));
-	//gf_m2ts_ipdatagram_reader(mff->p_adt,ip_datagram);
-
-
 }
 
 
@@ -36,6 +36,9 @@
 #include <gpac/filestreamer.h>
 #include <gpac/rtp_streamer.h>
 
+/*max number of RTP packets pushed to the socket at once*/
+#define GF_ISOM_STREAMER_BATCH_SIZE	32
+
 typedef struct __tag_rtp_track
 {
 	struct __tag_rtp_track *next;
@@ -88,6 +91,10 @@ struct __isom_rtp_streamer
 
 	Bool first_RTCP_sent;
     u64 last_min_dts;
+
+	/*scheduler wheel link, and absolute wheel tick at which the session is due*/
+	struct __isom_rtp_streamer *sched_next;
+	u64 sched_tick;
 };
 
 
@@ -244,25 +251,19 @@ void gf_isom_streamer_reset(GF_ISOMRTPStreamer *streamer, Bool is_loop)
 	if (is_loop) streamer->timelineOrigin = 0;
 }
 
-GF_EXPORT
-GF_Err gf_isom_streamer_send_next_packet(GF_ISOMRTPStreamer *streamer, s32 send_ahead_delay, s32 max_sleep_time)
+/*loads the next AU of each track and returns the most mature one, NULL if no more data*/
+static GF_RTPTrack *isom_streamer_load_next(GF_ISOMRTPStreamer *streamer)
 {
-	GF_Err e = GF_OK;
 	GF_RTPTrack *track, *to_send;
-	u32 duration;
-	s32 diff;
-	u64 min_ts, dts, cts, clock;
-
-	if (!streamer) return GF_BAD_PARAM;
+	u64 min_ts, clock;
 
 	/*browse all sessions and locate most mature stream*/
 	to_send = NULL;
 	min_ts = (u64) -1;
 
-	clock = gf_sys_clock_high_res();
-
 	/*init session timeline - all sessions are sync'ed for packet scheduling purposes*/
 	if (!streamer->timelineOrigin) {
+		clock = gf_sys_clock_high_res();
 		streamer->timelineOrigin = clock;
 		GF_LOG(GF_LOG_INFO, GF_LOG_RTP, ("[FileStreamer] RTP session %s initialized - time origin set to "LLU"\n", gf_isom_get_filename(streamer->isom), clock));
 	}
@@ -270,8 +271,8 @@ GF_Err gf_isom_streamer_send_next_packet(GF_ISOMRTPStreamer *streamer, s32 send_
 	track = streamer->stream;
 	while (track) {
 		/*load next AU*/
-		gf_isom_set_nalu_extract_mode(streamer->isom, track->track_num, GF_ISOM_NALU_EXTRACT_LAYER_ONLY);
 		if (!track->au) {
+			gf_isom_set_nalu_extract_mode(streamer->isom, track->track_num, GF_ISOM_NALU_EXTRACT_LAYER_ONLY);
 			if (track->current_au >= track->nb_aus) {
 				Double scale;
 				if (!streamer->loop) {
@@ -303,10 +304,29 @@ GF_Err gf_isom_streamer_send_next_packet(GF_ISOMRTPStreamer *streamer, s32 send_
 		track = track->next;
 	}
 
-	/*no input data ...*/
-	if( !to_send) return GF_EOS;
+	if (to_send) streamer->last_min_dts = min_ts;
+	return to_send;
+}
 
-    streamer->last_min_dts = min_ts;
+/*waits until the given time in microseconds: coarse sleep while far from the deadline, then poll the high-res clock
+for the last fraction of millisecond so that the packet is not delayed by the OS timer granularity*/
+static void isom_streamer_wait(u64 target_us)
+{
+	while (1) {
+		u64 now = gf_sys_clock_high_res();
+		if (now >= target_us) return;
+		if (target_us - now > 1500) gf_sleep((u32) ((target_us - now - 500) / 1000));
+		else gf_sleep(0);
+	}
+}
+
+/*packetizes and sends the loaded AU of the given track*/
+static GF_Err isom_streamer_send_au(GF_ISOMRTPStreamer *streamer, GF_RTPTrack *to_send)
+{
+	GF_Err e = GF_OK;
+	GF_RTPTrack *track;
+	u32 duration;
+	u64 dts, cts;
 
 	/*we are about to send scalable base: trigger RTCP reports with the same NTP. This avoids
 	NTP drift due to system clock precision which could break sync decoding*/
@@ -325,29 +345,6 @@ GF_Err gf_isom_streamer_send_next_packet(GF_ISOMRTPStreamer *streamer, s32 send_
 		streamer->first_RTCP_sent = 1;
 	}
 
-	min_ts /= 1000;
-
-	if (max_sleep_time) {
-		diff = ((u32) min_ts) - gf_sys_clock();
-		if (diff>max_sleep_time)
-			return GF_OK;
-	}
-
-
-	/*sleep until TS is mature*/
-	while (1) {
-		diff = ((u32) min_ts) - gf_sys_clock();
-
-		if (diff > send_ahead_delay) {
-			gf_sleep(1);
-		} else {
-			if (diff<10) {
-				GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("WARNING: RTP session %s stream %d - sending packet %d ms too late\n", gf_isom_get_filename(streamer->isom), to_send->track_num, -diff));
-			}
-			break;
-		}
-	}
-
 	/*send packets*/
 	dts = to_send->au->DTS + to_send->ts_offset;
 	cts = to_send->au->DTS + to_send->au->CTS_Offset + to_send->ts_offset;
@@ -387,12 +384,49 @@ GF_Err gf_isom_streamer_send_next_packet(GF_ISOMRTPStreamer *streamer, s32 send_
 	} else {
 		e = gf_rtp_streamer_send_data(to_send->rtp, to_send->au->data, to_send->au->dataLength, to_send->au->dataLength, cts, dts, (to_send->au->IsRAP==RAP) ? 1 : 0, 1, 1, to_send->current_au, duration, to_send->sample_desc_index);
 	}
+	/*push all packets of the AU in one go*/
+	if (!e) e = gf_rtp_streamer_flush(to_send->rtp);
+	else gf_rtp_streamer_flush(to_send->rtp);
+
 	/*delete sample*/
 	gf_isom_sample_del(&to_send->au);
 
 	return e;
 }
 
+GF_EXPORT
+GF_Err gf_isom_streamer_send_next_packet(GF_ISOMRTPStreamer *streamer, s32 send_ahead_delay, s32 max_sleep_time)
+{
+	GF_RTPTrack *to_send;
+	s64 diff;
+	u64 min_ts;
+
+	if (!streamer) return GF_BAD_PARAM;
+
+	to_send = isom_streamer_load_next(streamer);
+	/*no input data ...*/
+	if (!to_send) return GF_EOS;
+
+	min_ts = streamer->last_min_dts;
+
+	if (max_sleep_time) {
+		diff = (s64) min_ts - (s64) gf_sys_clock_high_res();
+		if (diff > (s64) max_sleep_time * 1000)
+			return GF_OK;
+	}
+
+	/*sleep until TS is mature*/
+	if ((s64) min_ts > (s64) send_ahead_delay * 1000) {
+		isom_streamer_wait(min_ts - send_ahead_delay * 1000);
+	}
+	diff = (s64) min_ts - (s64) gf_sys_clock_high_res();
+	if (diff < -10000) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("WARNING: RTP session %s stream %d - sending packet %d ms too late\n", gf_isom_get_filename(streamer->isom), to_send->track_num, (s32) (-diff/1000)));
+	}
+
+	return isom_streamer_send_au(streamer, to_send);
+}
+
 GF_EXPORT
 Double gf_isom_streamer_get_current_time(GF_ISOMRTPStreamer *streamer)
 {
@@ -634,6 +668,9 @@ GF_ISOMRTPStreamer *gf_isom_streamer_new(const char *file_name, const char *ip_d
 			goto exit;
 		}
 
+		/*packets of an AU are formed in memory and pushed in one go*/
+		gf_rtp_streamer_set_batch(track->rtp, GF_ISOM_STREAMER_BATCH_SIZE);
+
 		payt++;
 		track->microsec_ts_scale = 1000000;
 		track->microsec_ts_scale /= gf_isom_get_media_timescale(streamer->isom, track->track_num);
@@ -677,4 +714,116 @@ void gf_isom_streamer_del(GF_ISOMRTPStreamer *streamer)
 	gf_free(streamer);
 }
 
+
+/*number of slots in the scheduler wheel*/
+#define RTP_SCHED_WHEEL_SIZE	256
+
+struct __isom_rtp_scheduler
+{
+	/*duration of a wheel slot in microseconds*/
+	u32 slot_us;
+	/*hashed timing wheel: sessions due at tick T are linked in slot T % RTP_SCHED_WHEEL_SIZE, sessions due more
+	than one revolution ahead stay in their slot until their tick is reached*/
+	GF_ISOMRTPStreamer *wheel[RTP_SCHED_WHEEL_SIZE];
+	/*next tick to process*/
+	u64 cur_tick;
+	u32 nb_active;
+};
+
+GF_EXPORT
+GF_ISOMRTPScheduler *gf_isom_streamer_scheduler_new(u32 slot_us)
+{
+	GF_ISOMRTPScheduler *sched;
+	GF_SAFEALLOC(sched, GF_ISOMRTPScheduler);
+	if (!sched) return NULL;
+	sched->slot_us = slot_us ? slot_us : 500;
+	sched->cur_tick = gf_sys_clock_high_res() / sched->slot_us;
+	return sched;
+}
+
+GF_EXPORT
+void gf_isom_streamer_scheduler_del(GF_ISOMRTPScheduler *sched)
+{
+	if (sched) gf_free(sched);
+}
+
+static void isom_scheduler_insert(GF_ISOMRTPScheduler *sched, GF_ISOMRTPStreamer *streamer, u64 due_us)
+{
+	u32 slot;
+	streamer->sched_tick = due_us / sched->slot_us;
+	/*never schedule in the past, the slot would only be visited at the next revolution*/
+	if (streamer->sched_tick < sched->cur_tick) streamer->sched_tick = sched->cur_tick;
+	slot = (u32) (streamer->sched_tick % RTP_SCHED_WHEEL_SIZE);
+	streamer->sched_next = sched->wheel[slot];
+	sched->wheel[slot] = streamer;
+}
+
+GF_EXPORT
+GF_Err gf_isom_streamer_scheduler_add(GF_ISOMRTPScheduler *sched, GF_ISOMRTPStreamer *streamer)
+{
+	if (!sched || !streamer) return GF_BAD_PARAM;
+	if (!isom_streamer_load_next(streamer)) return GF_EOS;
+	isom_scheduler_insert(sched, streamer, streamer->last_min_dts);
+	sched->nb_active++;
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_isom_streamer_scheduler_process(GF_ISOMRTPScheduler *sched, u32 max_wait_us)
+{
+	u32 i;
+	u64 now, now_tick, next_slot;
+	if (!sched) return GF_BAD_PARAM;
+	if (!sched->nb_active) return GF_EOS;
+
+	now = gf_sys_clock_high_res();
+	now_tick = now / sched->slot_us;
+
+	while (sched->cur_tick <= now_tick) {
+		u32 slot = (u32) (sched->cur_tick % RTP_SCHED_WHEEL_SIZE);
+		GF_ISOMRTPStreamer *streamer = sched->wheel[slot];
+		/*slot end: everything before is sent now, at most one slot ahead of its time*/
+		u64 slot_end = (sched->cur_tick + 1) * sched->slot_us;
+		sched->wheel[slot] = NULL;
+		sched->cur_tick++;
+
+		while (streamer) {
+			GF_RTPTrack *to_send;
+			GF_ISOMRTPStreamer *next = streamer->sched_next;
+
+			/*not this revolution*/
+			if (streamer->sched_tick >= sched->cur_tick) {
+				streamer->sched_next = sched->wheel[slot];
+				sched->wheel[slot] = streamer;
+				streamer = next;
+				continue;
+			}
+			while (1) {
+				to_send = isom_streamer_load_next(streamer);
+				if (!to_send || (streamer->last_min_dts >= slot_end)) break;
+				isom_streamer_send_au(streamer, to_send);
+			}
+			if (to_send) {
+				isom_scheduler_insert(sched, streamer, streamer->last_min_dts);
+			} else {
+				sched->nb_active--;
+			}
+			streamer = next;
+		}
+	}
+	if (!sched->nb_active) return GF_EOS;
+
+	/*wait for the next slot with a session due*/
+	for (i=0; i<RTP_SCHED_WHEEL_SIZE; i++) {
+		u64 tick = sched->cur_tick + i;
+		GF_ISOMRTPStreamer *streamer = sched->wheel[tick % RTP_SCHED_WHEEL_SIZE];
+		while (streamer && (streamer->sched_tick != tick)) streamer = streamer->sched_next;
+		if (streamer) break;
+	}
+	next_slot = (sched->cur_tick + i) * sched->slot_us;
+	if (max_wait_us && (next_slot > now + max_wait_us)) next_slot = now + max_wait_us;
+	isom_streamer_wait(next_slot);
+	return GF_OK;
+}
+
 #endif /* !defined(GPAC_DISABLE_ISOM) && !defined(GPAC_DISABLE_STREAMING) */
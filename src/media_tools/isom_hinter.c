@@ -29,6 +29,7 @@
 #include <gpac/constants.h>
 #include <gpac/maths.h>
 #include <gpac/ietf.h>
+#include <gpac/thread.h>
 
 #ifndef GPAC_DISABLE_ISOM
 
@@ -89,6 +90,9 @@ void gf_media_get_sample_average_infos(GF_ISOFile *file, u32 Track, u32 *avgSize
 #ifndef GPAC_DISABLE_ISOM_HINTING
 
 /*RTP track hinter*/
+/*max number of media samples read at once when hinting tracks in parallel*/
+#define HINTER_READ_BATCH	32
+
 struct __tag_isom_hinter
 {
 	GF_ISOFile *file;
@@ -113,6 +117,14 @@ struct __tag_isom_hinter
 
 	/*stats*/
 	u32 TotalSample, CurrentSample;
+
+	/*file access lock when several tracks are hinted in parallel, NULL otherwise*/
+	GF_Mutex *mx;
+	/*media samples fetched under a single lock*/
+	GF_ISOSample *batch[HINTER_READ_BATCH];
+	u32 batch_desc[HINTER_READ_BATCH], batch_dur[HINTER_READ_BATCH];
+	u8 batch_pad[HINTER_READ_BATCH];
+	u32 batch_first, batch_count;
 };
 
 
@@ -164,6 +176,16 @@ void InitSL_NULL(GF_SLConfig *slc)
 
 
 
+/*hint samples are appended to the file edit map, which is shared between parallel hinters*/
+static GF_Err MP4T_EndHintSample(GF_RTPHinter *tkHint, u8 IsRAP)
+{
+	GF_Err e;
+	if (tkHint->mx) gf_mx_p(tkHint->mx);
+	e = gf_isom_end_hint_sample(tkHint->file, tkHint->HintTrack, IsRAP);
+	if (tkHint->mx) gf_mx_v(tkHint->mx);
+	return e;
+}
+
 void MP4T_OnPacketDone(void *cbk, GF_RTPHeader *header)
 {
 	u8 disposable;
@@ -221,7 +243,7 @@ void MP4T_OnNewPacket(void *cbk, GF_RTPHeader *header)
 	/*do we need a new sample*/
 	if (!tkHint->HintSample || (tkHint->RTPTime != header->TimeStamp)) {
 		/*close current sample*/
-		if (tkHint->HintSample) gf_isom_end_hint_sample(tkHint->file, tkHint->HintTrack, tkHint->SampleIsRAP);
+		if (tkHint->HintSample) MP4T_EndHintSample(tkHint, tkHint->SampleIsRAP);
 
 		/*start new sample: We use DTS as the sampling instant (RTP TS) to make sure
 		all packets are sent in order*/
@@ -678,15 +700,65 @@ void gf_hinter_track_get_payload_name(GF_RTPHinter *tkHinter, char *payloadName)
 	gf_rtp_builder_get_payload_name(tkHinter->rtp_p, payloadName, mediaName);
 }
 
+static void hinter_reset_batch(GF_RTPHinter *tkHint)
+{
+	u32 i;
+	for (i=0; i<tkHint->batch_count; i++) {
+		if (tkHint->batch[i]) gf_isom_sample_del(&tkHint->batch[i]);
+	}
+	tkHint->batch_count = 0;
+}
+
 GF_EXPORT
 void gf_hinter_track_del(GF_RTPHinter *tkHinter)
 {
 	if (!tkHinter) return;
 
+	hinter_reset_batch(tkHinter);
 	if (tkHinter->rtp_p) gf_rtp_builder_del(tkHinter->rtp_p);
 	gf_free(tkHinter);
 }
 
+static GF_ISOSample *hinter_get_sample(GF_RTPHinter *tkHint, u32 sampleNumber, u32 *descIndex, u32 *duration, u8 *PadBits)
+{
+	u32 i;
+	GF_ISOSample *samp;
+
+	if (!tkHint->mx) {
+		samp = gf_isom_get_sample(tkHint->file, tkHint->TrackNum, sampleNumber, descIndex);
+		*PadBits = 0;
+		if (tkHint->rtp_p->sl_config.usePaddingFlag)
+			gf_isom_get_sample_padding_bits(tkHint->file, tkHint->TrackNum, sampleNumber, PadBits);
+		*duration = gf_isom_get_sample_duration(tkHint->file, tkHint->TrackNum, sampleNumber);
+		return samp;
+	}
+
+	/*parallel hinting: the file is shared, fetch the next samples in one go*/
+	if ((sampleNumber < tkHint->batch_first) || (sampleNumber >= tkHint->batch_first + tkHint->batch_count)) {
+		hinter_reset_batch(tkHint);
+		tkHint->batch_first = sampleNumber;
+		gf_mx_p(tkHint->mx);
+		for (i=0; (i<HINTER_READ_BATCH) && (sampleNumber + i <= tkHint->TotalSample); i++) {
+			tkHint->batch[i] = gf_isom_get_sample(tkHint->file, tkHint->TrackNum, sampleNumber + i, &tkHint->batch_desc[i]);
+			if (!tkHint->batch[i]) break;
+			tkHint->batch_pad[i] = 0;
+			if (tkHint->rtp_p->sl_config.usePaddingFlag)
+				gf_isom_get_sample_padding_bits(tkHint->file, tkHint->TrackNum, sampleNumber + i, &tkHint->batch_pad[i]);
+			tkHint->batch_dur[i] = gf_isom_get_sample_duration(tkHint->file, tkHint->TrackNum, sampleNumber + i);
+			tkHint->batch_count++;
+		}
+		gf_mx_v(tkHint->mx);
+		if (!tkHint->batch_count) return NULL;
+	}
+	i = sampleNumber - tkHint->batch_first;
+	samp = tkHint->batch[i];
+	tkHint->batch[i] = NULL;
+	*descIndex = tkHint->batch_desc[i];
+	*duration = tkHint->batch_dur[i];
+	*PadBits = tkHint->batch_pad[i];
+	return samp;
+}
+
 GF_EXPORT
 GF_Err gf_hinter_track_process(GF_RTPHinter *tkHint)
 {
@@ -705,8 +777,11 @@ GF_Err gf_hinter_track_process(GF_RTPHinter *tkHint)
 
 	e = GF_OK;
 	for (i=0; i<tkHint->TotalSample; i++) {
-		samp = gf_isom_get_sample(tkHint->file, tkHint->TrackNum, i+1, &descIndex);
-		if (!samp) return GF_IO_ERR;
+		samp = hinter_get_sample(tkHint, i+1, &descIndex, &duration, &PadBits);
+		if (!samp) {
+			hinter_reset_batch(tkHint);
+			return GF_IO_ERR;
+		}
 
 		//setup SL
 		tkHint->CurrentSample = i + 1;
@@ -741,14 +816,7 @@ GF_Err gf_hinter_track_process(GF_RTPHinter *tkHint)
 			gf_isom_ismacryp_delete_sample(s);
 		}
 
-		if (tkHint->rtp_p->sl_config.usePaddingFlag) {
-			gf_isom_get_sample_padding_bits(tkHint->file, tkHint->TrackNum, i+1, &PadBits);
-			tkHint->rtp_p->sl_header.paddingBits = PadBits;
-		} else {
-			tkHint->rtp_p->sl_header.paddingBits = 0;
-		}
-
-		duration = gf_isom_get_sample_duration(tkHint->file, tkHint->TrackNum, i+1);
+		tkHint->rtp_p->sl_header.paddingBits = PadBits;
 //		ts = (u32) (ft * (s64) (duration));
 
 		/*unpack nal units*/
@@ -785,22 +853,133 @@ GF_Err gf_hinter_track_process(GF_RTPHinter *tkHint)
 		}
 		tkHint->rtp_p->sl_header.packetSequenceNumber += 1;
 
-		//signal some progress
-		gf_set_progress("Hinting", tkHint->CurrentSample, tkHint->TotalSample);
+		//signal some progress - done by the caller in parallel mode
+		if (!tkHint->mx) gf_set_progress("Hinting", tkHint->CurrentSample, tkHint->TotalSample);
 
 		tkHint->rtp_p->sl_header.AU_sequenceNumber += 1;
 		gf_isom_sample_del(&samp);
 
-		if (e) return e;
+		if (e) {
+			hinter_reset_batch(tkHint);
+			return e;
+		}
 	}
 
 	//flush
 	gf_rtp_builder_process(tkHint->rtp_p, NULL, 0, 1, 0, 0, 0);
 
-	gf_isom_end_hint_sample(tkHint->file, tkHint->HintTrack, (u8) tkHint->SampleIsRAP);
+	MP4T_EndHintSample(tkHint, (u8) tkHint->SampleIsRAP);
 	return GF_OK;
 }
 
+typedef struct
+{
+	GF_RTPHinter **hinters;
+	GF_Err *errors;
+	u32 nb_hinters, next_hinter;
+	GF_Mutex *mx;
+} GF_HinterPool;
+
+static u32 gf_hinter_pool_run(void *par)
+{
+	GF_HinterPool *pool = (GF_HinterPool *)par;
+	while (1) {
+		u32 idx;
+		gf_mx_p(pool->mx);
+		idx = pool->next_hinter;
+		pool->next_hinter++;
+		gf_mx_v(pool->mx);
+		if (idx >= pool->nb_hinters) break;
+
+		pool->errors[idx] = gf_hinter_track_process(pool->hinters[idx]);
+	}
+	return 0;
+}
+
+GF_EXPORT
+GF_Err gf_hinter_tracks_process(GF_RTPHinter **hinters, u32 nb_hinters, u32 nb_threads, GF_Err *track_errors)
+{
+	GF_Err e;
+	u32 i, nb_th, nb_samples;
+	GF_Thread **threads;
+	GF_HinterPool pool;
+
+	if (!hinters || !nb_hinters) return GF_BAD_PARAM;
+
+	if (nb_threads > nb_hinters) nb_threads = nb_hinters;
+	/*serial hinting*/
+	if (nb_threads <= 1) {
+		e = GF_OK;
+		for (i=0; i<nb_hinters; i++) {
+			GF_Err tk_e = gf_hinter_track_process(hinters[i]);
+			if (track_errors) track_errors[i] = tk_e;
+			if (tk_e && !e) e = tk_e;
+		}
+		return e;
+	}
+
+	memset(&pool, 0, sizeof(GF_HinterPool));
+	pool.hinters = hinters;
+	pool.nb_hinters = nb_hinters;
+	pool.errors = (GF_Err *)gf_malloc(sizeof(GF_Err) * nb_hinters);
+	threads = (GF_Thread **)gf_malloc(sizeof(GF_Thread *) * nb_threads);
+	pool.mx = gf_mx_new("HinterPool");
+	if (!pool.errors || !threads || !pool.mx) {
+		if (pool.errors) gf_free(pool.errors);
+		if (threads) gf_free(threads);
+		if (pool.mx) gf_mx_del(pool.mx);
+		return GF_OUT_OF_MEM;
+	}
+	memset(threads, 0, sizeof(GF_Thread *) * nb_threads);
+
+	/*all hinters share the same lock for file access*/
+	nb_samples = 0;
+	for (i=0; i<nb_hinters; i++) {
+		pool.errors[i] = GF_OK;
+		hinters[i]->mx = pool.mx;
+		hinters[i]->CurrentSample = 0;
+		nb_samples += gf_isom_get_sample_count(hinters[i]->file, hinters[i]->TrackNum);
+	}
+
+	nb_th = 0;
+	for (i=0; i<nb_threads; i++) {
+		threads[i] = gf_th_new("TrackHinter");
+		if (!threads[i]) break;
+		if (gf_th_run(threads[i], gf_hinter_pool_run, &pool) != GF_OK) break;
+		nb_th++;
+	}
+	/*no thread could be started, process in this thread*/
+	if (!nb_th) gf_hinter_pool_run(&pool);
+
+	while (nb_th) {
+		u32 nb_done = 0;
+		Bool running = GF_FALSE;
+		for (i=0; i<nb_threads; i++) {
+			if (threads[i] && (gf_th_status(threads[i]) == GF_THREAD_STATUS_RUN)) running = GF_TRUE;
+		}
+		for (i=0; i<nb_hinters; i++) nb_done += hinters[i]->CurrentSample;
+		gf_set_progress("Hinting", running ? nb_done : nb_samples, nb_samples);
+		if (!running) break;
+		gf_sleep(10);
+	}
+	for (i=0; i<nb_threads; i++) {
+		if (!threads[i]) continue;
+		gf_th_stop(threads[i]);
+		gf_th_del(threads[i]);
+	}
+
+	e = GF_OK;
+	for (i=0; i<nb_hinters; i++) {
+		hinters[i]->mx = NULL;
+		if (track_errors) track_errors[i] = pool.errors[i];
+		if (pool.errors[i] && !e) e = pool.errors[i];
+	}
+	gf_mx_del(pool.mx);
+	gf_free(pool.errors);
+	gf_free(threads);
+	return e;
+}
+
 static u32 write_nalu_config_array(char *sdpLine, GF_List *nalus)
 {
 	u32 i, count, b64s;
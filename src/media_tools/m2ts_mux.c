@@ -2144,6 +2144,7 @@ GF_M2TS_Mux_Stream *gf_m2ts_program_stream_add(GF_M2TS_Mux_Program *program, str
 		program->streams = stream;
 	}
 	if (program->pmt) program->pmt->table_needs_update = GF_TRUE;
+	program->mux->sched_reset = GF_TRUE;
 	stream->bit_rate = ifce->bit_rate;
 	stream->scheduling_priority = 1;
 
@@ -2343,6 +2344,7 @@ GF_M2TS_Mux_Program *gf_m2ts_mux_program_add(GF_M2TS_Mux *muxer, u32 program_num
 	program->initial_disc_set = initial_disc;
 	program->pmt->set_initial_disc = initial_disc;
 	muxer->pat->table_needs_update = GF_TRUE;
+	muxer->sched_reset = GF_TRUE;
 	program->pmt->process = gf_m2ts_stream_process_pmt;
 	program->pmt->refresh_rate_ms = pmt_refresh_rate ? pmt_refresh_rate : (u32) -1;
 	return program;
@@ -2480,6 +2482,8 @@ void gf_m2ts_mux_del(GF_M2TS_Mux *mux)
 	}
 	gf_m2ts_mux_stream_del(mux->pat);
 	if (mux->sdt) gf_m2ts_mux_stream_del(mux->sdt);
+	if (mux->sched_heap) gf_free(mux->sched_heap);
+	if (mux->sched_poll) gf_free(mux->sched_poll);
 	gf_free(mux);
 }
 
@@ -2529,6 +2533,8 @@ void gf_m2ts_mux_update_config(GF_M2TS_Mux *mux, Bool reset_time)
 		mux->time.sec = mux->time.nanosec = 0;
 		mux->init_sys_time = 0;
 	}
+	/*stream times may have changed, rebuild the scheduler*/
+	mux->sched_reset = GF_TRUE;
 }
 
 GF_EXPORT
@@ -2571,13 +2577,139 @@ GF_Err gf_m2ts_mux_enable_pcr_only_packets(GF_M2TS_Mux *muxer, Bool enable_force
 }
 
 
+/*a PES stream in the middle of a packet always returns its scheduling priority when processed, and its time only changes
+when one of its TS packets is sent: such streams are kept in a heap ordered by send time instead of being processed at each call*/
+static Bool gf_m2ts_sched_is_stable(GF_M2TS_Mux_Stream *stream)
+{
+	if (stream->mpeg2_stream_type==GF_M2TS_SYSTEMS_MPEG4_SECTIONS) return GF_FALSE;
+	if (stream->pcr_only_mode || stream->refresh_rate_ms || !stream->scheduling_priority) return GF_FALSE;
+	if (!stream->curr_pck.data_len || (stream->pck_offset >= stream->curr_pck.data_len)) return GF_FALSE;
+	return GF_TRUE;
+}
+
+/*same order as the per-stream scan: earliest time first, then highest priority, then the last base stream
+or if none, the first dependent stream in program order*/
+static Bool gf_m2ts_sched_before(GF_M2TS_Mux_Stream *a, u32 prio_a, GF_M2TS_Mux_Stream *b, u32 prio_b)
+{
+	if (!gf_m2ts_time_equal(&a->time, &b->time))
+		return gf_m2ts_time_less(&a->time, &b->time);
+	if (prio_a != prio_b)
+		return (prio_a > prio_b) ? GF_TRUE : GF_FALSE;
+	if (!a->ifce->depends_on_stream != !b->ifce->depends_on_stream)
+		return a->ifce->depends_on_stream ? GF_FALSE : GF_TRUE;
+	if (!a->ifce->depends_on_stream)
+		return (a->sched_order > b->sched_order) ? GF_TRUE : GF_FALSE;
+	return (a->sched_order < b->sched_order) ? GF_TRUE : GF_FALSE;
+}
+
+static void gf_m2ts_sched_heap_set(GF_M2TS_Mux *muxer, u32 pos, GF_M2TS_Mux_Stream *stream)
+{
+	muxer->sched_heap[pos] = stream;
+	stream->sched_heap_pos = pos+1;
+}
+
+static void gf_m2ts_sched_heap_update(GF_M2TS_Mux *muxer, u32 pos)
+{
+	GF_M2TS_Mux_Stream *stream = muxer->sched_heap[pos];
+	while (pos) {
+		u32 parent = (pos-1) / 2;
+		GF_M2TS_Mux_Stream *p = muxer->sched_heap[parent];
+		if (!gf_m2ts_sched_before(stream, stream->scheduling_priority, p, p->scheduling_priority)) break;
+		gf_m2ts_sched_heap_set(muxer, pos, p);
+		pos = parent;
+	}
+	while (1) {
+		GF_M2TS_Mux_Stream *c;
+		u32 child = 2*pos + 1;
+		if (child >= muxer->sched_heap_count) break;
+		c = muxer->sched_heap[child];
+		if (child+1 < muxer->sched_heap_count) {
+			GF_M2TS_Mux_Stream *c2 = muxer->sched_heap[child+1];
+			if (gf_m2ts_sched_before(c2, c2->scheduling_priority, c, c->scheduling_priority)) {
+				child++;
+				c = c2;
+			}
+		}
+		if (!gf_m2ts_sched_before(c, c->scheduling_priority, stream, stream->scheduling_priority)) break;
+		gf_m2ts_sched_heap_set(muxer, pos, c);
+		pos = child;
+	}
+	gf_m2ts_sched_heap_set(muxer, pos, stream);
+}
+
+static void gf_m2ts_sched_heap_add(GF_M2TS_Mux *muxer, GF_M2TS_Mux_Stream *stream)
+{
+	gf_m2ts_sched_heap_set(muxer, muxer->sched_heap_count, stream);
+	muxer->sched_heap_count++;
+	gf_m2ts_sched_heap_update(muxer, muxer->sched_heap_count-1);
+}
+
+static void gf_m2ts_sched_heap_rem(GF_M2TS_Mux *muxer, GF_M2TS_Mux_Stream *stream)
+{
+	u32 pos = stream->sched_heap_pos - 1;
+	stream->sched_heap_pos = 0;
+	muxer->sched_heap_count--;
+	if (pos == muxer->sched_heap_count) return;
+	gf_m2ts_sched_heap_set(muxer, pos, muxer->sched_heap[muxer->sched_heap_count]);
+	gf_m2ts_sched_heap_update(muxer, pos);
+}
+
+/*keeps the poll list in program order*/
+static void gf_m2ts_sched_poll_add(GF_M2TS_Mux *muxer, GF_M2TS_Mux_Stream *stream)
+{
+	u32 i = muxer->sched_poll_count;
+	while (i && (muxer->sched_poll[i-1]->sched_order > stream->sched_order)) {
+		muxer->sched_poll[i] = muxer->sched_poll[i-1];
+		i--;
+	}
+	muxer->sched_poll[i] = stream;
+	muxer->sched_poll_count++;
+}
+
+static void gf_m2ts_sched_rebuild(GF_M2TS_Mux *muxer)
+{
+	GF_M2TS_Mux_Program *program;
+	u32 nb_streams = 0;
+
+	program = muxer->programs;
+	while (program) {
+		GF_M2TS_Mux_Stream *stream = program->streams;
+		while (stream) {
+			nb_streams++;
+			stream = stream->next;
+		}
+		program = program->next;
+	}
+	if (nb_streams > muxer->sched_alloc) {
+		muxer->sched_alloc = nb_streams;
+		muxer->sched_heap = gf_realloc(muxer->sched_heap, sizeof(GF_M2TS_Mux_Stream *) * nb_streams);
+		muxer->sched_poll = gf_realloc(muxer->sched_poll, sizeof(GF_M2TS_Mux_Stream *) * nb_streams);
+	}
+	/*everything is processed at the next call, stable streams then move to the heap*/
+	muxer->sched_heap_count = muxer->sched_poll_count = 0;
+	program = muxer->programs;
+	while (program) {
+		GF_M2TS_Mux_Stream *stream = program->streams;
+		while (stream) {
+			stream->sched_order = muxer->sched_poll_count;
+			stream->sched_heap_pos = 0;
+			muxer->sched_poll[muxer->sched_poll_count++] = stream;
+			stream = stream->next;
+		}
+		program = program->next;
+	}
+	muxer->sched_nb_streams = nb_streams;
+	muxer->sched_pmt_time_valid = GF_FALSE;
+	muxer->sched_reset = GF_FALSE;
+}
+
 GF_EXPORT
 const char *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, u32 *status, u32 *usec_till_next)
 {
 	GF_M2TS_Mux_Program *program;
 	GF_M2TS_Mux_Stream *stream, *stream_to_process;
 	GF_M2TS_Time time, max_time;
-	u32 nb_streams, nb_streams_done;
+	u32 i, nb_streams, nb_streams_done;
 	u64 now_us;
 	char *ret;
 	u32 res, highest_priority;
@@ -2626,6 +2758,8 @@ const char *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, u32 *status, u32 *usec_till_
 		gf_m2ts_mux_update_config(muxer, GF_FALSE);
 		muxer->needs_reconfig = GF_FALSE;
 	}
+	if (muxer->sched_reset)
+		gf_m2ts_sched_rebuild(muxer);
 
 	if (muxer->flush_pes_at_rap && muxer->force_pat) {
 		program = muxer->programs;
@@ -2671,19 +2805,24 @@ const char *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, u32 *status, u32 *usec_till_
 			}
 		}
 
-		/*PMT, for each program*/
-		program = muxer->programs;
-		while (program) {
-			res = program->pmt->process(muxer, program->pmt);
-			if ((res && gf_m2ts_time_less_or_equal(&program->pmt->time, &time)) || (muxer->force_pat_pmt_state==GF_SEG_BOUNDARY_FORCE_PMT)) {
-				time = program->pmt->time;
-				stream_to_process = program->pmt;
-				if (muxer->force_pat_pmt_state==GF_SEG_BOUNDARY_FORCE_PMT)
-					muxer->force_pat_pmt_state = GF_SEG_BOUNDARY_FORCE_PCR;
-				/*force sending the PMT regardless of other streams*/
-				goto send_pck;
+		/*PMT, for each program - skipped until the earliest PMT is due*/
+		if (!muxer->sched_pmt_time_valid || (muxer->force_pat_pmt_state==GF_SEG_BOUNDARY_FORCE_PMT) || gf_m2ts_time_less_or_equal(&muxer->sched_pmt_time, &time)) {
+			program = muxer->programs;
+			while (program) {
+				res = program->pmt->process(muxer, program->pmt);
+				if ((res && gf_m2ts_time_less_or_equal(&program->pmt->time, &time)) || (muxer->force_pat_pmt_state==GF_SEG_BOUNDARY_FORCE_PMT)) {
+					time = program->pmt->time;
+					stream_to_process = program->pmt;
+					if (muxer->force_pat_pmt_state==GF_SEG_BOUNDARY_FORCE_PMT)
+						muxer->force_pat_pmt_state = GF_SEG_BOUNDARY_FORCE_PCR;
+					/*force sending the PMT regardless of other streams*/
+					goto send_pck;
+				}
+				if ((program == muxer->programs) || gf_m2ts_time_less(&program->pmt->time, &muxer->sched_pmt_time))
+					muxer->sched_pmt_time = program->pmt->time;
+				program = program->next;
 			}
-			program = program->next;
+			muxer->sched_pmt_time_valid = muxer->programs ? GF_TRUE : GF_FALSE;
 		}
 	}
 
@@ -2716,9 +2855,9 @@ const char *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, u32 *status, u32 *usec_till_
 	}
 #endif
 
-	/*all streams for each program*/
+	/*all streams for each program when flushing PES, otherwise polled streams and scheduler heap below*/
 	highest_priority = 0;
-	program = muxer->programs;
+	program = flush_all_pes ? muxer->programs : NULL;
 	while (program) {
 		stream = program->streams;
 		while (stream) {
@@ -2771,6 +2910,63 @@ const char *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, u32 *status, u32 *usec_till_
 		program = program->next;
 	}
 
+	if (!flush_all_pes) {
+		/*streams not in the scheduler heap, in program order*/
+		i = 0;
+		while (i < muxer->sched_poll_count) {
+			stream = muxer->sched_poll[i];
+			res = stream->process(muxer, stream);
+			/*next is rap on this stream, check flushing of other pes*/
+			if (muxer->force_pat)
+				return gf_m2ts_mux_process(muxer, status, usec_till_next);
+
+			if (res) {
+				/*always schedule the earliest data*/
+				if (gf_m2ts_time_less(&stream->time, &time)) {
+					highest_priority = res;
+					time = stream->time;
+					stream_to_process = stream;
+				}
+				else if (gf_m2ts_time_equal(&stream->time, &time)) {
+					/*if the same priority schedule base stream first*/
+					if ((res > highest_priority) || ((res == highest_priority) && !stream->ifce->depends_on_stream)) {
+						highest_priority = res;
+						time = stream->time;
+						stream_to_process = stream;
+					}
+				} else if (check_max_time && gf_m2ts_time_less(&max_time, &stream->time)) {
+					max_time = stream->time;
+				}
+			}
+			if ((stream->ifce->caps & GF_ESI_STREAM_IS_OVER) && (!res || stream->refresh_rate_ms) )
+				nb_streams_done ++;
+
+			if (gf_m2ts_sched_is_stable(stream)) {
+				muxer->sched_poll_count--;
+				memmove(&muxer->sched_poll[i], &muxer->sched_poll[i+1], sizeof(GF_M2TS_Mux_Stream *) * (muxer->sched_poll_count - i));
+				gf_m2ts_sched_heap_add(muxer, stream);
+			} else {
+				i++;
+			}
+		}
+		nb_streams = muxer->sched_nb_streams;
+
+		/*earliest stream in the heap - these streams are never over*/
+		if (muxer->sched_heap_count) {
+			stream = muxer->sched_heap[0];
+			if (stream_to_process ? gf_m2ts_sched_before(stream, stream->scheduling_priority, stream_to_process, highest_priority) : gf_m2ts_time_less_or_equal(&stream->time, &time)) {
+				highest_priority = stream->scheduling_priority;
+				time = stream->time;
+				stream_to_process = stream;
+			} else if (check_max_time && !stream_to_process) {
+				for (i=0; i<muxer->sched_heap_count; i++) {
+					if (gf_m2ts_time_less(&max_time, &muxer->sched_heap[i]->time))
+						max_time = muxer->sched_heap[i]->time;
+				}
+			}
+		}
+	}
+
 send_pck:
 
 	ret = NULL;
@@ -2788,6 +2984,14 @@ send_pck:
 		}
 	} else {
 
+		/*stream time changes once sent, move it back to the streams processed at each call*/
+		if (stream_to_process->sched_heap_pos) {
+			gf_m2ts_sched_heap_rem(muxer, stream_to_process);
+			gf_m2ts_sched_poll_add(muxer, stream_to_process);
+		} else if (stream_to_process->program && (stream_to_process == stream_to_process->program->pmt)) {
+			muxer->sched_pmt_time_valid = GF_FALSE;
+		}
+
 		if (stream_to_process->tables) {
 			gf_m2ts_mux_table_get_next_packet(stream_to_process, muxer->dst_pck);
 		} else {
@@ -28,6 +28,7 @@
 #include <gpac/internal/isomedia_dev.h>
 #include <gpac/mpegts.h>
 #include <gpac/constants.h>
+#include <gpac/thread.h>
 
 #ifndef GPAC_DISABLE_MEDIA_EXPORT
 
@@ -752,11 +753,28 @@ static const char *QCP_SMV_GUID = "\x75\x2B\x7C\x8D\x97\xA7\x46\xED\x98\x5E\xD5\
 	} \
 
 
-GF_Err gf_media_export_native(GF_MediaExporter *dumper)
+#ifndef GPAC_DISABLE_AV_PARSERS
+
+/*state of a native track export, shared between the setup, sample writing and closing steps*/
+typedef struct
+{
+	GF_MediaExporter *dumper;
+	u32 track, m_stype, count;
+	FILE *out;
+	Bool is_stdout, has_qcp_pad;
+	/*NULL if the export was completed during setup (ogg, vobsub, webvtt, probe)*/
+	GF_BitStream *bs;
+	char *dsi;
+	u32 dsi_size;
+	GF_AVCConfig *avccfg, *svccfg, *mvccfg;
+	GF_HEVCConfig *hevccfg, *lhvccfg;
+	GF_M4ADecSpecInfo a_cfg;
+	u32 aac_mode, aac_type, qcp_type, rt_cnt, nal_unit_size;
+	unsigned int *qcp_rates;
+} GF_NativeExport;
+
+static GF_Err gf_media_export_native_open(GF_MediaExporter *dumper, GF_NativeExport *nex)
 {
-#ifdef GPAC_DISABLE_AV_PARSERS
-	return GF_NOT_SUPPORTED;
-#else
 	GF_Err e = GF_OK;
 	Bool add_ext;
 	GF_DecoderConfig *dcfg;
@@ -769,7 +787,7 @@ GF_Err gf_media_export_native(GF_MediaExporter *dumper)
 	GF_M4ADecSpecInfo a_cfg;
 	const char *stxtcfg;
 	GF_BitStream *bs;
-	u32 track, i, di, count, m_type, m_stype, dsi_size, qcp_type;
+	u32 track, i, count, m_type, m_stype, dsi_size, qcp_type;
 	Bool is_ogg, has_qcp_pad, is_vobsub;
 	u32 aac_type, aac_mode;
 	char *dsi;
@@ -1415,115 +1433,435 @@ GF_Err gf_media_export_native(GF_MediaExporter *dumper)
 		gf_isom_enable_raw_pack(dumper->file, track, 2048);
 	}
 
-	/* Start exporting samples */
-	for (i=0; i<count; i++) {
-		GF_ISOSample *samp = gf_isom_get_sample(dumper->file, track, i+1, &di);
-		if (!samp) {
-			e = gf_isom_last_error(dumper->file);
-			break;
-		}
-		/*AVC sample to NALU*/
-		if (avccfg || svccfg || mvccfg || hevccfg || lhvccfg) {
-			u32 j, nal_size, remain, nal_unit_size;
-			Bool is_rap;
-			char *ptr = samp->data;
-			nal_unit_size = 0;
-			if (avccfg) nal_unit_size= avccfg->nal_unit_size;
-			else if (svccfg) nal_unit_size = svccfg->nal_unit_size;
-			else if (mvccfg) nal_unit_size = mvccfg->nal_unit_size;
-			else if (hevccfg) nal_unit_size = hevccfg->nal_unit_size;
-			else if (lhvccfg) nal_unit_size = lhvccfg->nal_unit_size;
-
-			is_rap = samp->IsRAP;
-			//patch for opengop
-			if (!is_rap) {
-				gf_isom_get_sample_rap_roll_info(dumper->file, track, i+1, &is_rap, NULL, NULL);
-
-				if (!is_rap) {
-					u32 is_leading, dependsOn, dependedOn, redundant;
-					gf_isom_get_sample_flags(dumper->file, track, i+1, &is_leading, &dependsOn, &dependedOn, &redundant);
-					if (dependsOn==2) is_rap = GF_TRUE;
-				}
-			}
+	nex->dumper = dumper;
+	nex->track = track;
+	nex->m_stype = m_stype;
+	nex->count = count;
+	nex->out = out;
+	nex->is_stdout = is_stdout;
+	nex->has_qcp_pad = has_qcp_pad;
+	nex->bs = bs;
+	nex->dsi = dsi;
+	nex->dsi_size = dsi_size;
+	nex->avccfg = avccfg;
+	nex->svccfg = svccfg;
+	nex->mvccfg = mvccfg;
+	nex->hevccfg = hevccfg;
+	nex->lhvccfg = lhvccfg;
+	nex->a_cfg = a_cfg;
+	nex->aac_mode = aac_mode;
+	nex->aac_type = aac_type;
+	nex->qcp_type = qcp_type;
+	nex->qcp_rates = qcp_rates;
+	nex->rt_cnt = rt_cnt;
+	if (avccfg) nex->nal_unit_size = avccfg->nal_unit_size;
+	else if (svccfg) nex->nal_unit_size = svccfg->nal_unit_size;
+	else if (mvccfg) nex->nal_unit_size = mvccfg->nal_unit_size;
+	else if (hevccfg) nex->nal_unit_size = hevccfg->nal_unit_size;
+	else if (lhvccfg) nex->nal_unit_size = lhvccfg->nal_unit_size;
+	return GF_OK;
 
-			if (i && dsi && is_rap) {
-				gf_bs_write_data(bs, dsi, dsi_size);
-			}
+exit:
+	if (avccfg) gf_odf_avc_cfg_del(avccfg);
+	if (svccfg) gf_odf_avc_cfg_del(svccfg);
+	if (mvccfg) gf_odf_avc_cfg_del(mvccfg);
+	if (hevccfg) gf_odf_hevc_cfg_del(hevccfg);
+	if (lhvccfg) gf_odf_hevc_cfg_del(lhvccfg);
+	gf_bs_del(bs);
+	if (dsi) gf_free(dsi);
+	if (!is_stdout)
+		gf_fclose(out);
+	return e;
+}
 
-			remain = samp->dataLength;
-			while (remain) {
-				nal_size = 0;
-				if (remain<nal_unit_size) {
-					GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("Sample %d (size %d): Corrupted NAL Unit: header size %d - bytes left %d\n", i+1, samp->dataLength, nal_unit_size, remain) );
-					break;
-				}
-				for (j=0; j<nal_unit_size; j++) {
-					nal_size |= ((u8) *ptr);
-					if (j+1<nal_unit_size) nal_size<<=8;
-					remain--;
-					ptr++;
-				}
-				gf_bs_write_u32(bs, 1);
-				if (remain < nal_size) {
-					GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("Sample %d (size %d): Corrupted NAL Unit: size %d - bytes left %d\n", i+1, samp->dataLength, nal_size, remain) );
-					nal_size = remain;
-				}
-				gf_bs_write_data(bs, ptr, nal_size);
-				ptr += nal_size;
-				remain -= nal_size;
-			}
+/*open-GOP and leading pictures: parameter sets are repeated before any random access point, not only sync samples*/
+static Bool gf_media_export_native_is_rap(GF_NativeExport *nex, GF_ISOSample *samp, u32 sample_num)
+{
+	Bool is_rap = samp->IsRAP ? GF_TRUE : GF_FALSE;
+	if (!nex->nal_unit_size) return is_rap;
+	if (!is_rap) {
+		gf_isom_get_sample_rap_roll_info(nex->dumper->file, nex->track, sample_num, &is_rap, NULL, NULL);
+
+		if (!is_rap) {
+			u32 is_leading, dependsOn, dependedOn, redundant;
+			gf_isom_get_sample_flags(nex->dumper->file, nex->track, sample_num, &is_leading, &dependsOn, &dependedOn, &redundant);
+			if (dependsOn==2) is_rap = GF_TRUE;
 		}
-		/*adts frame header*/
-		else if (aac_mode > 0) {
-			gf_bs_write_int(bs, 0xFFF, 12);/*sync*/
-			gf_bs_write_int(bs, (aac_mode==1) ? 1 : 0, 1);/*mpeg2 aac*/
-			gf_bs_write_int(bs, 0, 2); /*layer*/
-			gf_bs_write_int(bs, 1, 1); /* protection_absent*/
-			gf_bs_write_int(bs, aac_type, 2);
-			gf_bs_write_int(bs, a_cfg.base_sr_index, 4);
-			gf_bs_write_int(bs, 0, 1);
-			gf_bs_write_int(bs, a_cfg.nb_chan, 3);
-			gf_bs_write_int(bs, 0, 4);
-			gf_bs_write_int(bs, 7+samp->dataLength, 13);
-			gf_bs_write_int(bs, 0x7FF, 11);
-			gf_bs_write_int(bs, 0, 2);
+	}
+	return is_rap;
+}
+
+static void gf_media_export_native_sample(GF_NativeExport *nex, GF_ISOSample *samp, u32 sample_num, Bool is_rap)
+{
+	GF_BitStream *bs = nex->bs;
+
+	/*AVC sample to NALU*/
+	if (nex->nal_unit_size) {
+		u32 j, nal_size, remain;
+		char *ptr = samp->data;
+
+		if ((sample_num>1) && nex->dsi && is_rap) {
+			gf_bs_write_data(bs, nex->dsi, nex->dsi_size);
 		}
-		/*fix rate octet for QCP*/
-		else if (qcp_type) {
-			u32 j;
-			for (j=0; j<rt_cnt; j++) {
-				if (qcp_rates[2*j+1]==1+samp->dataLength) {
-					gf_bs_write_u8(bs, qcp_rates[2*j]);
-					break;
-				}
+
+		remain = samp->dataLength;
+		while (remain) {
+			nal_size = 0;
+			if (remain<nex->nal_unit_size) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("Sample %d (size %d): Corrupted NAL Unit: header size %d - bytes left %d\n", sample_num, samp->dataLength, nex->nal_unit_size, remain) );
+				break;
+			}
+			for (j=0; j<nex->nal_unit_size; j++) {
+				nal_size |= ((u8) *ptr);
+				if (j+1<nex->nal_unit_size) nal_size<<=8;
+				remain--;
+				ptr++;
+			}
+			gf_bs_write_u32(bs, 1);
+			if (remain < nal_size) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("Sample %d (size %d): Corrupted NAL Unit: size %d - bytes left %d\n", sample_num, samp->dataLength, nal_size, remain) );
+				nal_size = remain;
+			}
+			gf_bs_write_data(bs, ptr, nal_size);
+			ptr += nal_size;
+			remain -= nal_size;
+		}
+		return;
+	}
+	/*adts frame header*/
+	if (nex->aac_mode > 0) {
+		gf_bs_write_int(bs, 0xFFF, 12);/*sync*/
+		gf_bs_write_int(bs, (nex->aac_mode==1) ? 1 : 0, 1);/*mpeg2 aac*/
+		gf_bs_write_int(bs, 0, 2); /*layer*/
+		gf_bs_write_int(bs, 1, 1); /* protection_absent*/
+		gf_bs_write_int(bs, nex->aac_type, 2);
+		gf_bs_write_int(bs, nex->a_cfg.base_sr_index, 4);
+		gf_bs_write_int(bs, 0, 1);
+		gf_bs_write_int(bs, nex->a_cfg.nb_chan, 3);
+		gf_bs_write_int(bs, 0, 4);
+		gf_bs_write_int(bs, 7+samp->dataLength, 13);
+		gf_bs_write_int(bs, 0x7FF, 11);
+		gf_bs_write_int(bs, 0, 2);
+	}
+	/*fix rate octet for QCP*/
+	else if (nex->qcp_type) {
+		u32 j;
+		for (j=0; j<nex->rt_cnt; j++) {
+			if (nex->qcp_rates[2*j+1]==1+samp->dataLength) {
+				gf_bs_write_u8(bs, nex->qcp_rates[2*j]);
+				break;
 			}
 		}
-		/*AV1: add Temporal Unit Delimiters*/
-		else if (m_stype == GF_ISOM_SUBTYPE_AV01) {
-			gf_bs_write_u8(bs, 0x12);
-			gf_bs_write_u8(bs, 0x00);
-		}
-		if (!avccfg && !svccfg && !mvccfg && !hevccfg && !lhvccfg &!is_webvtt) {
-			gf_bs_write_data(bs, samp->data, samp->dataLength);
+	}
+	/*AV1: add Temporal Unit Delimiters*/
+	else if (nex->m_stype == GF_ISOM_SUBTYPE_AV01) {
+		gf_bs_write_u8(bs, 0x12);
+		gf_bs_write_u8(bs, 0x00);
+	}
+	gf_bs_write_data(bs, samp->data, samp->dataLength);
+}
+
+static void gf_media_export_native_close(GF_NativeExport *nex)
+{
+	if (!nex->bs) return;
+	if (nex->has_qcp_pad) gf_bs_write_u8(nex->bs, 0);
+	if (nex->avccfg) gf_odf_avc_cfg_del(nex->avccfg);
+	if (nex->svccfg) gf_odf_avc_cfg_del(nex->svccfg);
+	if (nex->mvccfg) gf_odf_avc_cfg_del(nex->mvccfg);
+	if (nex->hevccfg) gf_odf_hevc_cfg_del(nex->hevccfg);
+	if (nex->lhvccfg) gf_odf_hevc_cfg_del(nex->lhvccfg);
+	gf_bs_del(nex->bs);
+	nex->bs = NULL;
+	if (nex->dsi) gf_free(nex->dsi);
+	if (!nex->is_stdout)
+		gf_fclose(nex->out);
+}
+
+#endif /*GPAC_DISABLE_AV_PARSERS*/
+
+GF_Err gf_media_export_native(GF_MediaExporter *dumper)
+{
+#ifdef GPAC_DISABLE_AV_PARSERS
+	return GF_NOT_SUPPORTED;
+#else
+	GF_Err e;
+	u32 i, di;
+	GF_NativeExport nex;
+
+	memset(&nex, 0, sizeof(GF_NativeExport));
+	e = gf_media_export_native_open(dumper, &nex);
+	if (e || !nex.bs) return e;
+
+	/* Start exporting samples */
+	for (i=0; i<nex.count; i++) {
+		Bool is_rap;
+		GF_ISOSample *samp = gf_isom_get_sample(dumper->file, nex.track, i+1, &di);
+		if (!samp) {
+			e = gf_isom_last_error(dumper->file);
+			break;
 		}
+		is_rap = gf_media_export_native_is_rap(&nex, samp, i+1);
+		gf_media_export_native_sample(&nex, samp, i+1, is_rap);
 		if (samp->nb_pack)
 			i += samp->nb_pack-1;
 
 		gf_isom_sample_del(&samp);
-		gf_set_progress("Media Export", i+1, count);
+		gf_set_progress("Media Export", i+1, nex.count);
 		if (dumper->flags & GF_EXPORT_DO_ABORT) break;
 	}
-	if (has_qcp_pad) gf_bs_write_u8(bs, 0);
+	gf_media_export_native_close(&nex);
+	return e;
+#endif /*GPAC_DISABLE_AV_PARSERS*/
+}
+
+#ifndef GPAC_DISABLE_AV_PARSERS
+
+/*number of samples handed over at once to a track writer when exporting several tracks*/
+#define EXPORT_BATCH_SIZE	128
+/*max number of batches queued per track*/
+#define EXPORT_MAX_QUEUED_BATCHES	8
+/*output buffer size of each track when exporting several tracks*/
+#define EXPORT_OUTPUT_BUFFER_SIZE	(1<<20)
+
+typedef struct
+{
+	GF_ISOSample *samp;
+	u32 sample_num;
+	Bool is_rap;
+} GF_ExportQueuedSample;
+
+typedef struct
+{
+	GF_ExportQueuedSample samples[EXPORT_BATCH_SIZE];
+	u32 count;
+} GF_ExportBatch;
+
+typedef struct
+{
+	GF_NativeExport nex;
+	GF_Thread *th;
+	/*batches of samples read but not yet written, a NULL batch signals the end of the track*/
+	GF_List *queue;
+	GF_Mutex *mx;
+	GF_Semaphore *has_samples, *has_room;
+	/*batch being filled by the reader*/
+	GF_ExportBatch *batch;
+	/*next sample to read and its offset in the file*/
+	u32 next_sample;
+	u64 next_offset;
+	Bool done;
+} GF_TrackExportWriter;
+
+static void gf_media_export_batch_del(GF_ExportBatch *batch)
+{
+	u32 i;
+	if (!batch) return;
+	for (i=0; i<batch->count; i++) {
+		gf_isom_sample_del(&batch->samples[i].samp);
+	}
+	gf_free(batch);
+}
+
+static u32 gf_media_export_writer_run(void *par)
+{
+	GF_TrackExportWriter *tkw = (GF_TrackExportWriter *)par;
+	while (1) {
+		u32 i;
+		GF_ExportBatch *batch;
+		gf_sema_wait(tkw->has_samples);
+		gf_mx_p(tkw->mx);
+		batch = (GF_ExportBatch *)gf_list_pop_front(tkw->queue);
+		gf_mx_v(tkw->mx);
+		gf_sema_notify(tkw->has_room, 1);
+		if (!batch) break;
+
+		for (i=0; i<batch->count; i++) {
+			GF_ExportQueuedSample *qs = &batch->samples[i];
+			gf_media_export_native_sample(&tkw->nex, qs->samp, qs->sample_num, qs->is_rap);
+		}
+		gf_media_export_batch_del(batch);
+	}
+	return 0;
+}
+
+/*hands the current batch over to the writer thread, or signals the end of the track if no batch*/
+static void gf_media_export_writer_flush(GF_TrackExportWriter *tkw)
+{
+	GF_ExportBatch *batch = tkw->batch;
+	tkw->batch = NULL;
+	gf_sema_wait(tkw->has_room);
+	gf_mx_p(tkw->mx);
+	gf_list_add(tkw->queue, batch);
+	gf_mx_v(tkw->mx);
+	gf_sema_notify(tkw->has_samples, 1);
+}
+
+static GF_Err gf_media_export_writer_push(GF_TrackExportWriter *tkw, GF_ISOSample *samp, u32 sample_num, Bool is_rap)
+{
+	GF_ExportQueuedSample *qs;
+	if (!tkw->batch) {
+		tkw->batch = (GF_ExportBatch *)gf_malloc(sizeof(GF_ExportBatch));
+		if (!tkw->batch) return GF_OUT_OF_MEM;
+		tkw->batch->count = 0;
+	}
+	qs = &tkw->batch->samples[tkw->batch->count];
+	qs->samp = samp;
+	qs->sample_num = sample_num;
+	qs->is_rap = is_rap;
+	tkw->batch->count++;
+	if (tkw->batch->count == EXPORT_BATCH_SIZE)
+		gf_media_export_writer_flush(tkw);
+	return GF_OK;
+}
+
+static void gf_media_export_writer_next(GF_TrackExportWriter *tkw)
+{
+	u32 di;
+	GF_ISOSample *samp;
+	if (tkw->next_sample > tkw->nex.count) {
+		tkw->done = GF_TRUE;
+		return;
+	}
+	samp = gf_isom_get_sample_info(tkw->nex.dumper->file, tkw->nex.track, tkw->next_sample, &di, &tkw->next_offset);
+	if (!samp) {
+		tkw->done = GF_TRUE;
+		return;
+	}
+	gf_isom_sample_del(&samp);
+}
+
+#endif /*GPAC_DISABLE_AV_PARSERS*/
+
+static Bool gf_media_export_can_merge(GF_MediaExporter *dumper, GF_ISOFile *file)
+{
+	if (!dumper->file || (dumper->file != file)) return GF_FALSE;
+	if (!(dumper->flags & GF_EXPORT_NATIVE)) return GF_FALSE;
+	/*merged and piped outputs must be written one track after the other*/
+	if (dumper->flags & (GF_EXPORT_MERGE | GF_EXPORT_PROBE_ONLY)) return GF_FALSE;
+	if (!dumper->out_name || !strcmp(dumper->out_name, "std")) return GF_FALSE;
+	if (dumper->in_name) return GF_FALSE;
+	return GF_TRUE;
+}
+
+GF_EXPORT
+GF_Err gf_media_export_tracks(GF_MediaExporter *dumpers, u32 nb_dumpers)
+{
+#ifdef GPAC_DISABLE_AV_PARSERS
+	u32 i;
+	for (i=0; i<nb_dumpers; i++) {
+		GF_Err e = gf_media_export(&dumpers[i]);
+		if (e) return e;
+	}
+	return GF_OK;
+#else
+	GF_Err e = GF_OK;
+	u32 i, nb_writers, nb_done, nb_samples;
+	GF_ISOFile *file;
+	GF_TrackExportWriter *writers;
+
+	if (!dumpers || !nb_dumpers) return GF_BAD_PARAM;
+	file = dumpers[0].file;
+
+	writers = (GF_TrackExportWriter *)gf_malloc(sizeof(GF_TrackExportWriter) * nb_dumpers);
+	if (!writers) return GF_OUT_OF_MEM;
+	memset(writers, 0, sizeof(GF_TrackExportWriter) * nb_dumpers);
+
+	/*setup all exports - tracks which cannot be written sample by sample are fully exported here*/
+	nb_writers = 0;
+	nb_samples = 0;
+	for (i=0; i<nb_dumpers; i++) {
+		GF_TrackExportWriter *tkw = &writers[nb_writers];
+		if (!gf_media_export_can_merge(&dumpers[i], file)) {
+			e = gf_media_export(&dumpers[i]);
+			if (e) goto exit;
+			continue;
+		}
+		e = gf_media_export_native_open(&dumpers[i], &tkw->nex);
+		if (e) goto exit;
+		/*export completed during setup*/
+		if (!tkw->nex.bs) {
+			memset(tkw, 0, sizeof(GF_TrackExportWriter));
+			continue;
+		}
+
+		nb_writers++;
+		nb_samples += tkw->nex.count;
+		gf_bs_set_output_buffering(tkw->nex.bs, EXPORT_OUTPUT_BUFFER_SIZE);
+		tkw->queue = gf_list_new();
+		tkw->mx = gf_mx_new("MediaExportQueue");
+		tkw->has_samples = gf_sema_new(EXPORT_MAX_QUEUED_BATCHES+1, 0);
+		tkw->has_room = gf_sema_new(EXPORT_MAX_QUEUED_BATCHES, EXPORT_MAX_QUEUED_BATCHES);
+		tkw->th = gf_th_new("MediaExport");
+		tkw->next_sample = 1;
+		gf_media_export_writer_next(tkw);
+		if (!tkw->queue || !tkw->mx || !tkw->has_samples || !tkw->has_room || !tkw->th) {
+			e = GF_OUT_OF_MEM;
+			goto exit;
+		}
+		e = gf_th_run(tkw->th, gf_media_export_writer_run, tkw);
+		if (e) goto exit;
+	}
+
+	/*read samples of all tracks in file order and dispatch them to the track writers*/
+	nb_done = 0;
+	while (nb_writers) {
+		u32 di, nb_pack;
+		Bool is_rap;
+		GF_ISOSample *samp;
+		GF_TrackExportWriter *tkw = NULL;
+		for (i=0; i<nb_writers; i++) {
+			if (writers[i].done) continue;
+			if (!tkw || (writers[i].next_offset < tkw->next_offset)) tkw = &writers[i];
+		}
+		if (!tkw) break;
+
+		samp = gf_isom_get_sample(file, tkw->nex.track, tkw->next_sample, &di);
+		if (!samp) {
+			e = gf_isom_last_error(file);
+			tkw->done = GF_TRUE;
+			if (e) break;
+			continue;
+		}
+		is_rap = gf_media_export_native_is_rap(&tkw->nex, samp, tkw->next_sample);
+		nb_pack = samp->nb_pack ? samp->nb_pack : 1;
+		/*the sample is owned by the writer from now on*/
+		e = gf_media_export_writer_push(tkw, samp, tkw->next_sample, is_rap);
+		if (e) {
+			gf_isom_sample_del(&samp);
+			break;
+		}
+		tkw->next_sample += nb_pack;
+		nb_done += nb_pack;
+		gf_media_export_writer_next(tkw);
+
+		gf_set_progress("Media Export", nb_done, nb_samples);
+		if (dumpers[0].flags & GF_EXPORT_DO_ABORT) break;
+	}
+
 exit:
-	if (avccfg) gf_odf_avc_cfg_del(avccfg);
-	if (svccfg) gf_odf_avc_cfg_del(svccfg);
-	if (mvccfg) gf_odf_avc_cfg_del(mvccfg);
-	if (hevccfg) gf_odf_hevc_cfg_del(hevccfg);
-	if (lhvccfg) gf_odf_hevc_cfg_del(lhvccfg);
-	gf_bs_del(bs);
-	if (dsi) gf_free(dsi);
-	if (!is_stdout)
-		gf_fclose(out);
+	for (i=0; i<nb_dumpers; i++) {
+		GF_TrackExportWriter *tkw = &writers[i];
+		if (tkw->th) {
+			if (gf_th_status(tkw->th) == GF_THREAD_STATUS_RUN) {
+				/*pending samples and end of track marker*/
+				if (tkw->batch) gf_media_export_writer_flush(tkw);
+				gf_media_export_writer_flush(tkw);
+			}
+			gf_th_del(tkw->th);
+		}
+		gf_media_export_batch_del(tkw->batch);
+		if (tkw->queue) {
+			while (gf_list_count(tkw->queue)) {
+				gf_media_export_batch_del((GF_ExportBatch *)gf_list_pop_front(tkw->queue));
+			}
+			gf_list_del(tkw->queue);
+		}
+		if (tkw->mx) gf_mx_del(tkw->mx);
+		if (tkw->has_samples) gf_sema_del(tkw->has_samples);
+		if (tkw->has_room) gf_sema_del(tkw->has_room);
+		gf_media_export_native_close(&tkw->nex);
+	}
+	gf_free(writers);
 	return e;
 #endif /*GPAC_DISABLE_AV_PARSERS*/
 }
@@ -2963,10 +3301,13 @@ GF_Err gf_media_export_saf(GF_MediaExporter *dumper)
 			samp_done ++;
 		}
 		while (1) {
-			gf_saf_mux_for_time(mux, (u32) -1, 0, &data, &size);
-			if (!data) break;
-			gf_fwrite(data, size, 1, saf_f);
-			gf_free(data);
+			u32 j, nb_chunks;
+			const GF_SAFChunk *chunks;
+			gf_saf_mux_for_time_vec(mux, (u32) -1, 0, &chunks, &nb_chunks);
+			if (!nb_chunks) break;
+			for (j=0; j<nb_chunks; j++) {
+				gf_fwrite(chunks[j].data, chunks[j].size, 1, saf_f);
+			}
 		}
 		gf_set_progress("SAF Export", samp_done, tot_samp);
 		if (dumper->flags & GF_EXPORT_DO_ABORT) break;
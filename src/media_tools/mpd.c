@@ -850,9 +850,178 @@ void gf_mpd_segment_timeline_free(void *_item)
 {
 	GF_MPD_SegmentTimeline *ptr = (GF_MPD_SegmentTimeline *)_item;
 	gf_mpd_del_list(ptr->entries, gf_mpd_segment_entry_free, 0);
+	if (ptr->index) gf_free(ptr->index);
 	gf_free(ptr);
 }
 
+GF_EXPORT
+void gf_mpd_segment_timeline_reset_index(GF_MPD_SegmentTimeline *timeline)
+{
+	if (timeline) timeline->nb_indexed = 0;
+}
+
+/*updates the timeline index and gets the number of entries. Entries are usually only appended (or the last one repeated),
+so only the last indexed entry and the new ones are processed*/
+static GF_Err gf_mpd_segment_timeline_update_index(GF_MPD_SegmentTimeline *timeline, u32 *nb_entries)
+{
+	u32 i, count = gf_list_count(timeline->entries);
+
+	*nb_entries = count;
+
+	if (timeline->nb_indexed > count) {
+		timeline->nb_indexed = 0;
+	} else if (timeline->nb_indexed) {
+		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, timeline->nb_indexed-1);
+		if (ent->repeat_count != timeline->last_indexed_repeat) timeline->nb_indexed--;
+	}
+	if (timeline->nb_indexed == count) return GF_OK;
+
+	if (timeline->index_alloc < count) {
+		u32 index_alloc = MAX(count, 2*timeline->index_alloc);
+		GF_MPD_SegmentTimelineIndex *index = gf_realloc(timeline->index, sizeof(GF_MPD_SegmentTimelineIndex) * index_alloc);
+		/*the entries indexed so far are still valid*/
+		if (!index) {
+			*nb_entries = 0;
+			return GF_OUT_OF_MEM;
+		}
+		timeline->index = index;
+		timeline->index_alloc = index_alloc;
+	}
+	if (!timeline->nb_indexed) timeline->index_unordered = GF_FALSE;
+
+	for (i=timeline->nb_indexed; i<count; i++) {
+		GF_MPD_SegmentTimelineIndex *idx = &timeline->index[i];
+		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, i);
+		if (i) {
+			GF_MPD_SegmentTimelineIndex *prev = &timeline->index[i-1];
+			GF_MPD_SegmentTimelineEntry *prev_ent = gf_list_get(timeline->entries, i-1);
+			u32 nb_segs = 1 + prev_ent->repeat_count;
+			idx->first_segment = prev->first_segment + nb_segs;
+			idx->start_time = ent->start_time ? ent->start_time : prev->start_time + (u64) prev_ent->duration * nb_segs;
+			/*entry starting before the last segment of the previous one*/
+			if (nb_segs && (idx->start_time < prev->start_time + (u64) prev_ent->duration * (nb_segs-1)))
+				timeline->index_unordered = GF_TRUE;
+		} else {
+			idx->first_segment = 0;
+			idx->start_time = ent->start_time;
+		}
+		if (ent->repeat_count == (u32) -1) timeline->index_unordered = GF_TRUE;
+	}
+	timeline->nb_indexed = count;
+	if (count) {
+		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, count-1);
+		timeline->last_indexed_repeat = ent->repeat_count;
+	}
+	return GF_OK;
+}
+
+GF_EXPORT
+u32 gf_mpd_segment_timeline_get_segment_count(GF_MPD_SegmentTimeline *timeline, u64 *end_time)
+{
+	u32 count;
+	GF_MPD_SegmentTimelineEntry *ent;
+	if (end_time) *end_time = 0;
+	if (!timeline) return 0;
+
+	if (gf_mpd_segment_timeline_update_index(timeline, &count) != GF_OK) return 0;
+	if (!count) return 0;
+	ent = gf_list_get(timeline->entries, count-1);
+	if (end_time) *end_time = timeline->index[count-1].start_time + (u64) ent->duration * (1 + ent->repeat_count);
+	return timeline->index[count-1].first_segment + 1 + ent->repeat_count;
+}
+
+GF_EXPORT
+GF_Err gf_mpd_segment_timeline_get_segment(GF_MPD_SegmentTimeline *timeline, u32 segment_index, u64 *start_time, u32 *duration)
+{
+	GF_Err e;
+	u32 count, low, high;
+	GF_MPD_SegmentTimelineIndex *idx;
+	GF_MPD_SegmentTimelineEntry *ent;
+	if (start_time) *start_time = 0;
+	if (!timeline) return GF_BAD_PARAM;
+
+	e = gf_mpd_segment_timeline_update_index(timeline, &count);
+	if (e) return e;
+	if (!count) return GF_EOS;
+
+	/*last entry starting at or before the segment*/
+	low = 0;
+	high = count;
+	while (high - low > 1) {
+		u32 mid = (low + high) / 2;
+		if (timeline->index[mid].first_segment <= segment_index) low = mid;
+		else high = mid;
+	}
+	idx = &timeline->index[low];
+	ent = gf_list_get(timeline->entries, low);
+	/*can only happen for the last entry*/
+	if (segment_index - idx->first_segment >= (u32) (1 + ent->repeat_count)) {
+		if (start_time) *start_time = idx->start_time + (u64) ent->duration * (1 + ent->repeat_count);
+		return GF_EOS;
+	}
+	if (start_time) *start_time = idx->start_time + (u64) ent->duration * (segment_index - idx->first_segment);
+	if (duration) *duration = ent->duration;
+	return GF_OK;
+}
+
+static GFINLINE Bool gf_mpd_segment_starts_after(u64 seg_start, u64 time, u64 time_scale, u64 timeline_scale)
+{
+	if (time_scale == timeline_scale) return (seg_start >= time) ? GF_TRUE : GF_FALSE;
+	return (seg_start * time_scale >= time * timeline_scale) ? GF_TRUE : GF_FALSE;
+}
+
+GF_EXPORT
+GF_Err gf_mpd_segment_timeline_find_segment(GF_MPD_SegmentTimeline *timeline, u64 time, u64 time_scale, u64 timeline_scale, u32 *segment_index, u64 *segment_start)
+{
+	GF_Err e;
+	u32 i, count, nb_segs, low, high;
+	GF_MPD_SegmentTimelineIndex *idx;
+	GF_MPD_SegmentTimelineEntry *ent;
+	if (!timeline || !segment_index || !segment_start) return GF_BAD_PARAM;
+
+	e = gf_mpd_segment_timeline_update_index(timeline, &count);
+	if (e) return e;
+	/*first entry with its last segment starting at or after time*/
+	if (!timeline->index_unordered) {
+		low = 0;
+		high = count;
+		while (low < high) {
+			u32 mid = (low + high) / 2;
+			ent = gf_list_get(timeline->entries, mid);
+			idx = &timeline->index[mid];
+			if (gf_mpd_segment_starts_after(idx->start_time + (u64) ent->duration * ent->repeat_count, time, time_scale, timeline_scale)) high = mid;
+			else low = mid + 1;
+		}
+		i = low;
+	} else {
+		for (i=0; i<count; i++) {
+			ent = gf_list_get(timeline->entries, i);
+			idx = &timeline->index[i];
+			if ((ent->repeat_count != (u32) -1) && gf_mpd_segment_starts_after(idx->start_time + (u64) ent->duration * ent->repeat_count, time, time_scale, timeline_scale))
+				break;
+		}
+	}
+	if (i == count) {
+		*segment_index = gf_mpd_segment_timeline_get_segment_count(timeline, segment_start);
+		return GF_EOS;
+	}
+
+	/*first segment of the entry starting at or after time*/
+	ent = gf_list_get(timeline->entries, i);
+	idx = &timeline->index[i];
+	nb_segs = 1 + ent->repeat_count;
+	low = 0;
+	high = nb_segs - 1;
+	while (low < high) {
+		u32 mid = low + (high - low) / 2;
+		if (gf_mpd_segment_starts_after(idx->start_time + (u64) ent->duration * mid, time, time_scale, timeline_scale)) high = mid;
+		else low = mid + 1;
+	}
+	*segment_index = idx->first_segment + low;
+	*segment_start = idx->start_time + (u64) ent->duration * low;
+	return GF_OK;
+}
+
 void gf_mpd_segment_list_free(void *_item)
 {
 	GF_MPD_SegmentList *ptr = (GF_MPD_SegmentList *)_item;
@@ -2847,38 +3016,27 @@ GF_Err gf_mpd_resolve_url(GF_MPD *mpd, GF_MPD_Representation *rep, GF_MPD_Adapta
 				strcat(solved_template, "$Time$");
 			} else if (timeline) {
 				/*uses segment timeline*/
-				u32 k, nb_seg, cur_idx, nb_repeat;
-				u64 time, start_time;
-				nb_seg = gf_list_count(timeline->entries);
-				cur_idx = 0;
-				start_time=0;
-				for (k=0; k<nb_seg; k++) {
-					GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, k);
-					if (item_index>cur_idx+ent->repeat_count) {
-						cur_idx += 1 + ent->repeat_count;
-						if (ent->start_time) start_time = ent->start_time;
-						if (k<nb_seg-1) {
-							start_time += ent->duration * (1 + ent->repeat_count);
-							continue;
-						} else {
-							gf_free(url);
-							gf_free(solved_template);
-							second_sep[0] = '$';
-							return GF_EOS;
-						}
+				u64 time;
+				u32 seg_duration;
+				GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, 0);
+				if (ent) {
+					/*open-ended first entry: repeated until the end of the period*/
+					if (ent->repeat_count == (u32) -1) {
+						seg_duration = ent->duration;
+						time = ent->start_time + (u64) item_index * ent->duration;
+					} else if (gf_mpd_segment_timeline_get_segment(timeline, item_index, &time, &seg_duration) != GF_OK) {
+						gf_free(url);
+						gf_free(solved_template);
+						second_sep[0] = '$';
+						return GF_EOS;
 					}
-					*segment_duration_in_ms = ent->duration;
-					*segment_duration_in_ms = (u32) ((Double) (*segment_duration_in_ms) * 1000.0 / timescale);
-					nb_repeat = item_index - cur_idx;
-					time = ent->start_time ? ent->start_time : start_time;
-					time += nb_repeat * ent->duration;
+					*segment_duration_in_ms = (u32) ((Double) seg_duration * 1000.0 / timescale);
 
 					/*replace final 'd' with LLD (%lld or I64d)*/
 					szPrintFormat[strlen(szPrintFormat)-1] = 0;
 					strcat(szPrintFormat, &LLD[1]);
 					sprintf(szFormat, szPrintFormat, time);
 					strcat(solved_template, szFormat);
-					break;
 				}
 			} else if (duration) {
 				u64 time = item_index * duration;
@@ -3000,22 +3158,10 @@ void gf_mpd_resolve_segment_duration(GF_MPD_Representation *rep, GF_MPD_Adaptati
 
 static u64 gf_mpd_segment_timeline_start(GF_MPD_SegmentTimeline *timeline, u32 segment_index, u64 *segment_duration)
 {
-	u64 start_time = 0;
-	u32 i, idx, k;
-	idx = 0;
-	for (i = 0; i<gf_list_count(timeline->entries); i++) {
-		GF_MPD_SegmentTimelineEntry *ent = gf_list_get(timeline->entries, i);
-		if (ent->start_time) start_time = ent->start_time;
-		for (k = 0; k<ent->repeat_count + 1; k++) {
-			if (idx == segment_index) {
-				if (segment_duration)
-					*segment_duration = ent->duration;
-				return start_time;
-			}
-			idx++;
-			start_time += ent->duration;
-		}
-	}
+	u64 start_time;
+	u32 duration;
+	if ((gf_mpd_segment_timeline_get_segment(timeline, segment_index, &start_time, &duration) == GF_OK) && segment_duration)
+		*segment_duration = duration;
 	return start_time;
 }
 
@@ -192,7 +192,7 @@ static u32 gf_m2ts_reframe_reset(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, Bool sam
 		gf_free(pes->prev_data);
 		pes->prev_data = NULL;
 	}
-	pes->prev_data_len = 0;
+	pes->prev_data_len = pes->prev_alloc_len = 0;
 	pes->pes_len = 0;
 	pes->prev_PTS = 0;
 	pes->reframe = NULL;
@@ -1253,9 +1253,14 @@ static u32 gf_m2ts_sync(GF_M2TS_Demuxer *ts, Bool simple_check)
 
 	while (i<ts->buffer_size) {
 		if (i+188>ts->buffer_size) return ts->buffer_size;
+		if (i+188==ts->buffer_size) {
+			/*exactly one packet starting with a sync byte, we cannot check the next sync byte*/
+			if (!i && (ts->buffer[0]==0x47)) break;
+			return ts->buffer_size;
+		}
 		if ((ts->buffer[i]==0x47) && (ts->buffer[i+188]==0x47))
 			break;
-		if ((ts->buffer[i]==0x47) && (ts->buffer[i+192]==0x47)) {
+		if ((i+192<ts->buffer_size) && (ts->buffer[i]==0x47) && (ts->buffer[i+192]==0x47)) {
 			ts->prefix_present = 1;
 			break;
 		}
@@ -2957,12 +2962,13 @@ void gf_m2ts_flush_pes(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes)
 			if (! ts->start_range)
 				remain = pes->reframe(ts, pes, same_pts, pes->pck_data+offset, pes->pck_data_len-offset, &pesh);
 
-			//CLEANUP alloc stuff
-			if (pes->prev_data) gf_free(pes->prev_data);
-			pes->prev_data = NULL;
+			/*keep the unconsumed bytes for the next PES, reusing the previous allocation*/
 			pes->prev_data_len = 0;
 			if (remain) {
-				pes->prev_data = gf_malloc(sizeof(char)*remain);
+				if (pes->prev_alloc_len < remain) {
+					pes->prev_alloc_len = remain;
+					pes->prev_data = (u8*)gf_realloc(pes->prev_data, sizeof(char)*pes->prev_alloc_len);
+				}
 				assert(pes->pck_data_len >= remain);
 				memcpy(pes->prev_data, pes->pck_data + pes->pck_data_len - remain, remain);
 				pes->prev_data_len = remain;
@@ -2976,6 +2982,24 @@ void gf_m2ts_flush_pes(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes)
 	pes->rap = 0;
 }
 
+/*makes sure the reassembly buffer can hold size bytes. When the PES length is known the whole packet is reserved at once,
+otherwise the buffer grows geometrically so that unbounded video PES don't realloc on every TS packet*/
+static void gf_m2ts_pes_reserve(GF_M2TS_PES *pes, u32 size)
+{
+	u32 new_size;
+	if (size <= pes->pck_alloc_len) return;
+
+	if (pes->pes_len && (size <= pes->pes_len + 6)) {
+		new_size = pes->pes_len + 6;
+	} else {
+		new_size = 2 * pes->pck_alloc_len;
+		if (new_size < 4096) new_size = 4096;
+		if (new_size < size) new_size = size;
+	}
+	pes->pck_alloc_len = new_size;
+	pes->pck_data = (u8*)gf_realloc(pes->pck_data, pes->pck_alloc_len);
+}
+
 static void gf_m2ts_process_pes(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, GF_M2TS_Header *hdr, unsigned char *data, u32 data_size, GF_M2TS_AdaptationField *paf)
 {
 	u8 expect_cc;
@@ -3030,10 +3054,7 @@ static void gf_m2ts_process_pes(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, GF_M2TS_H
 	} else if (pes->pes_len && (pes->pck_data_len + data_size == pes->pes_len + 6)) {
 		/* 6 = startcode+stream_id+length*/
 		/*reassemble pes*/
-		if (pes->pck_data_len + data_size > pes->pck_alloc_len) {
-			pes->pck_alloc_len = pes->pck_data_len + data_size;
-			pes->pck_data = (u8*)gf_realloc(pes->pck_data, pes->pck_alloc_len);
-		}
+		gf_m2ts_pes_reserve(pes, pes->pck_data_len + data_size);
 		memcpy(pes->pck_data+pes->pck_data_len, data, data_size);
 		pes->pck_data_len += data_size;
 		/*force discard*/
@@ -3052,10 +3073,7 @@ static void gf_m2ts_process_pes(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, GF_M2TS_H
 		return;
 	}
 	/*reassemble*/
-	if (pes->pck_data_len + data_size > pes->pck_alloc_len ) {
-		pes->pck_alloc_len = pes->pck_data_len + data_size;
-		pes->pck_data = (u8*)gf_realloc(pes->pck_data, pes->pck_alloc_len);
-	}
+	gf_m2ts_pes_reserve(pes, pes->pck_data_len + data_size);
 	memcpy(pes->pck_data + pes->pck_data_len, data, data_size);
 	pes->pck_data_len += data_size;
 
@@ -3459,6 +3477,29 @@ GF_Err gf_m2ts_process_data(GF_M2TS_Demuxer *ts, char *data, u32 data_size)
 	u32 pos, pck_size;
 	Bool is_align = 1;
 	if (ts->buffer) {
+		pck_size = ts->prefix_present ? 192 : 188;
+		/*pending bytes are the start of a packet and the new data resumes right after it: only copy what is needed
+		to complete this packet, and process the rest of the input in place rather than appending it to the pending bytes*/
+		if ((ts->buffer_size < pck_size) && (ts->buffer[0]==0x47) && (ts->buffer_size + data_size > pck_size) && (data[pck_size - ts->buffer_size]==0x47)) {
+			pos = pck_size - ts->buffer_size;
+			if (ts->alloc_size < pck_size) {
+				ts->alloc_size = pck_size;
+				ts->buffer = (char*)gf_realloc(ts->buffer, sizeof(char)*ts->alloc_size);
+			}
+			memcpy(ts->buffer + ts->buffer_size, data, sizeof(char)*pos);
+			e = gf_m2ts_process_packet(ts, (unsigned char *)ts->buffer);
+			/*no other complete packet, keep the remaining bytes in our buffer*/
+			if (!ts->abort_parsing && (data_size - pos < pck_size)) {
+				ts->buffer_size = data_size - pos;
+				memcpy(ts->buffer, data + pos, sizeof(char)*ts->buffer_size);
+				return e;
+			}
+			gf_free(ts->buffer);
+			ts->buffer = NULL;
+			ts->buffer_size = 0;
+			if (ts->abort_parsing) return e;
+			return e | gf_m2ts_process_data(ts, data + pos, data_size - pos);
+		}
 		if (ts->alloc_size < ts->buffer_size+data_size) {
 			ts->alloc_size = ts->buffer_size+data_size;
 			ts->buffer = (char*)gf_realloc(ts->buffer, sizeof(char)*ts->alloc_size);
@@ -3579,8 +3620,6 @@ void gf_m2ts_reset_parsers_for_program(GF_M2TS_Demuxer *ts, GF_M2TS_Program *pro
 			pes->cc = -1;
 			pes->frame_state = 0;
 			pes->pck_data_len = 0;
-			if (pes->prev_data) gf_free(pes->prev_data);
-			pes->prev_data = NULL;
 			pes->prev_data_len = 0;
 			pes->PTS = pes->DTS = 0;
 //			pes->prev_PTS = 0;
@@ -18,6 +18,10 @@
 
 #ifdef GPAC_ENABLE_MPE
 
+#if defined(__SSSE3__)
+# include <tmmintrin.h>
+# define GPAC_HAS_SSSE3
+#endif
 
 /* This is one of 14 irreducible polynomials
  * of degree 8 and cycle length 255. (Ch 5, pp. 275, Magnetic Recording)
@@ -29,15 +33,33 @@
 int gexp[512];
 int glog[256];
 
+/* split multiplication tables: for a constant c, c*a = gf_mul_lo[c][a & 0xF] ^ gf_mul_hi[c][a >> 4]
+ * Each table is 16 bytes, which is the layout used by PSHUFB-style multiplication */
+static u8 gf_mul_lo[256][16];
+static u8 gf_mul_hi[256][16];
+static int gf_tables_ready = 0;
 
 static void init_exp_table (void);
 
+#define GF_MUL_NIBBLE(_c, _a) (gf_mul_lo[_c][(_a) & 0xF] ^ gf_mul_hi[_c][(_a) >> 4])
 
 void
 init_galois_tables (void)
 {
+	int c, n;
+	/* tables only depend on the field, this is called for each FEC frame */
+	if (gf_tables_ready) return;
+
 	/* initialize the table of powers of alpha */
 	init_exp_table();
+
+	for (c = 0; c < 256; c++) {
+		for (n = 0; n < 16; n++) {
+			gf_mul_lo[c][n] = (u8) gmult(c, n);
+			gf_mul_hi[c][n] = (u8) gmult(c, n << 4);
+		}
+	}
+	gf_tables_ready = 1;
 }
 
 
@@ -68,13 +90,9 @@ init_exp_table (void)
 		gexp[i+255] = gexp[i];
 	}
 
-	for (i = 1; i < 256; i++) {
-		for (z = 0; z < 256; z++) {
-			if (gexp[z] == i) {
-				glog[i] = z;
-				break;
-			}
-		}
+	/* alpha is primitive, gexp[0..254] covers each non-zero element once */
+	for (z = 0; z < 255; z++) {
+		glog[gexp[z]] = z;
 	}
 }
 
@@ -189,12 +207,15 @@ Modified_Berlekamp_Massey (void)
 void
 compute_modified_omega ()
 {
-	int i;
-	int product[MAXDEG*2];
+	int i, k;
 
-	mult_polys(product, Lambda, synBytes);
+	/* only the NPAR low order terms of the product are needed */
 	zero_poly(Omega);
-	for(i = 0; i < NPAR; i++) Omega[i] = product[i];
+	for(i = 0; i < NPAR; i++) {
+		int sum = 0;
+		for (k = 0; k <= i; k++) sum ^= gmult(Lambda[k], synBytes[i-k]);
+		Omega[i] = sum;
+	}
 
 }
 
@@ -311,22 +332,79 @@ static void mul_z_poly (int src[])
 void
 Find_Roots (void)
 {
-	int sum, r, k;
+	int r, k, deg;
 	NErrors = 0;
 
-	for (r = 1; r < 256; r++) {
-		sum = 0;
-		/* evaluate lambda at r */
-		for (k = 0; k < NPAR+1; k++) {
-			sum ^= gmult(gexp[(k*r)%255], Lambda[k]);
+	/* roots beyond the degree of lambda cannot exist */
+	deg = NPAR;
+	while ((deg > 0) && !Lambda[deg]) deg--;
+	if (!deg) return;
+
+#ifdef GPAC_HAS_SSSE3
+	{
+		/* evaluate lambda at 16 successive powers of alpha at once. pows[k] holds alpha^(k*r) for r in [r0, r0+16[ */
+		__m128i pows[NPAR+1];
+		const __m128i mask = _mm_set1_epi8(0x0F);
+		int r0;
+
+		for (k = 0; k <= deg; k++) {
+			u8 init[16];
+			for (r = 0; r < 16; r++) init[r] = (u8) gexp[(k*r) % 255];
+			pows[k] = _mm_loadu_si128((const __m128i *) init);
+		}
+		for (r0 = 0; r0 < 256; r0 += 16) {
+			__m128i sum = _mm_setzero_si128();
+			int zeros;
+			for (k = 0; k <= deg; k++) {
+				__m128i v = pows[k];
+				__m128i v_lo = _mm_and_si128(v, mask);
+				__m128i v_hi = _mm_and_si128(_mm_srli_epi64(v, 4), mask);
+				int step = gexp[(16*k) % 255];
+				if (Lambda[k]) {
+					sum = _mm_xor_si128(sum, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) gf_mul_lo[Lambda[k]]), v_lo));
+					sum = _mm_xor_si128(sum, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) gf_mul_hi[Lambda[k]]), v_hi));
+				}
+				/* move on to the next 16 powers */
+				pows[k] = _mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) gf_mul_lo[step]), v_lo),
+				                        _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) gf_mul_hi[step]), v_hi));
+			}
+			zeros = _mm_movemask_epi8(_mm_cmpeq_epi8(sum, _mm_setzero_si128()));
+			if (!r0) zeros &= ~1;
+			while (zeros) {
+				r = 0;
+				while (!(zeros & (1<<r))) r++;
+				zeros &= ~(1<<r);
+				ErrorLocs[NErrors] = (255-(r0+r));
+				NErrors++;
+				if (RS_DEBUG) fprintf(stderr, "Root found at r = %d, (255-r) = %d\n", r0+r, (255-r0-r));
+			}
+			if (NErrors == deg) break;
 		}
-		if (sum == 0)
-		{
-			ErrorLocs[NErrors] = (255-r);
-			NErrors++;
-			if (RS_DEBUG) fprintf(stderr, "Root found at r = %d, (255-r) = %d\n", r, (255-r));
+	}
+#else
+	{
+		/* Chien search: term k of lambda evaluated at alpha^r is Lambda[k]*alpha^(k*r),
+		 * obtained from the previous one by a constant multiplication by alpha^k */
+		u8 terms[NPAR+1];
+		for (k = 0; k <= deg; k++) terms[k] = (u8) Lambda[k];
+
+		for (r = 1; r < 256; r++) {
+			u8 sum = terms[0];
+			for (k = 1; k <= deg; k++) {
+				terms[k] = GF_MUL_NIBBLE(gexp[k], terms[k]);
+				sum ^= terms[k];
+			}
+			if (sum == 0)
+			{
+				ErrorLocs[NErrors] = (255-r);
+				NErrors++;
+				if (RS_DEBUG) fprintf(stderr, "Root found at r = %d, (255-r) = %d\n", r, (255-r));
+				/* all roots found */
+				if (NErrors == deg) break;
+			}
 		}
 	}
+#endif
 }
 
 /* Combined Erasure And Error Magnitude Computation
@@ -342,30 +420,17 @@ Find_Roots (void)
  *
  */
 
-int
-correct_errors_erasures (unsigned char codeword[],
-                         int csize,
-                         int nerasures,
-                         int erasures[])
+static int
+correct_magnitudes (unsigned char codeword[], int csize)
 {
 	int r, i, j, err;
 
-	/* If you want to take advantage of erasure correction, be sure to
-	   set NErasures and ErasureLocs[] with the locations of erasures.
-	   */
-	NErasures = nerasures;
-	for (i = 0; i < NErasures; i++) ErasureLocs[i] = erasures[i];
-
-	Modified_Berlekamp_Massey();
-	Find_Roots();
-
-
 	if ((NErrors <= NPAR) && NErrors > 0) {
 
 		/* first check for illegal error locs */
 		for (r = 0; r < NErrors; r++) {
 			if (ErrorLocs[r] >= csize) {
-				if (RS_DEBUG) fprintf(stderr, "Error loc i=%d outside of codeword length %d\n", i, csize);
+				if (RS_DEBUG) fprintf(stderr, "Error loc i=%d outside of codeword length %d\n", ErrorLocs[r], csize);
 				return(0);
 			}
 		}
@@ -375,15 +440,17 @@ correct_errors_erasures (unsigned char codeword[],
 			i = ErrorLocs[r];
 			/* evaluate Omega at alpha^(-i) */
 
+			/* Horner evaluation, Omega has degree lower than NPAR */
 			num = 0;
-			for (j = 0; j < MAXDEG; j++)
-				num ^= gmult(Omega[j], gexp[((255-i)*j)%255]);
+			for (j = NPAR-1; j >= 0; j--)
+				num = Omega[j] ^ gmult(num, gexp[255-i]);
 
 			/* evaluate Lambda' (derivative) at alpha^(-i) ; all odd powers disappear */
 			denom = 0;
-			for (j = 1; j < MAXDEG; j += 2) {
-				denom ^= gmult(Lambda[j], gexp[((255-i)*(j-1)) % 255]);
+			for (j = MAXDEG-1; j >= 1; j -= 2) {
+				denom = Lambda[j] ^ gmult(denom, gexp[2*(255-i)]);
 			}
+			if (!denom) return(0);
 
 			err = gmult(num, ginv(denom));
 			if (RS_DEBUG) fprintf(stderr, "Error magnitude %#x at loc %d\n", err, csize-i);
@@ -398,6 +465,66 @@ correct_errors_erasures (unsigned char codeword[],
 	}
 }
 
+int
+correct_errors_erasures (unsigned char codeword[],
+                         int csize,
+                         int nerasures,
+                         int erasures[])
+{
+	int i;
+
+	/* If you want to take advantage of erasure correction, be sure to
+	   set NErasures and ErasureLocs[] with the locations of erasures.
+	   */
+	NErasures = nerasures;
+	for (i = 0; i < NErasures; i++) ErasureLocs[i] = erasures[i];
+
+	Modified_Berlekamp_Massey();
+	Find_Roots();
+
+	return correct_magnitudes(codeword, csize);
+}
+
+/* Erasure-only correction
+ *
+ * When all corrupted bytes are known (e.g. from CRC-failed sections), the error
+ * locator is the erasure locator and the error locations are the erasures themselves,
+ * so neither Berlekamp-Massey nor the Chien search are needed.
+ *
+ * synBytes must hold the syndromes of the codeword. Returns 1 if the codeword was corrected,
+ * or 0 (leaving codeword and synBytes untouched) if errors remain outside of the erasures,
+ * in which case correct_errors_erasures should be used.
+ */
+int
+correct_erasures (unsigned char codeword[],
+                  int csize,
+                  int nerasures,
+                  int erasures[])
+{
+	int i;
+	unsigned char save[255];
+
+	if (!nerasures || (nerasures > NPAR) || (csize > 255)) return(0);
+
+	NErasures = nerasures;
+	for (i = 0; i < NErasures; i++) ErasureLocs[i] = erasures[i];
+
+	init_gamma(Lambda);
+	compute_modified_omega();
+	NErrors = nerasures;
+	for (i = 0; i < NErrors; i++) ErrorLocs[i] = erasures[i];
+
+	memcpy(save, codeword, csize);
+	if (correct_magnitudes(codeword, csize)) {
+		decode_data(codeword, csize);
+		if (!check_syndrome()) return(1);
+	}
+	/* unmarked errors, restore codeword and syndromes */
+	memcpy(codeword, save, csize);
+	decode_data(codeword, csize);
+	return(0);
+}
+
 
 
 /*
@@ -483,14 +610,56 @@ build_codeword (unsigned char msg[], int nbytes, unsigned char dst[])
 void
 decode_data(unsigned char data[], int nbytes)
 {
-	int i, j, sum;
+	int i, j;
+	u8 syn[NPAR];
+	memset(syn, 0, sizeof(syn));
+	/* Horner evaluation of all syndromes at once, multiplications by the constant alpha^(j+1) use nibble tables */
+	for (i = 0; i < nbytes; i++) {
+		u8 d = data[i];
+		for (j = 0; j < NPAR;  j++) {
+			syn[j] = d ^ GF_MUL_NIBBLE(gexp[j+1], syn[j]);
+		}
+	}
+	for (j = 0; j < NPAR;  j++) synBytes[j] = syn[j];
+}
+
+/* Computes the syndromes of RS_BLOCK_ROWS interleaved codewords, as found in MPE-FEC frames
+ * where codewords are rows of a column-ordered table.
+ * cols[i] points to the RS_BLOCK_ROWS bytes at position i of the codewords.
+ * Syndrome j of codeword r is stored in syn[j*RS_BLOCK_ROWS + r]
+ */
+void
+decode_data_interleaved(unsigned char *cols[], int nbytes, unsigned char syn[])
+{
+	int i, j;
+#ifdef GPAC_HAS_SSSE3
+	const __m128i mask = _mm_set1_epi8(0x0F);
 	for (j = 0; j < NPAR;  j++) {
-		sum = 0;
+		const __m128i t_lo = _mm_loadu_si128((const __m128i *) gf_mul_lo[gexp[j+1]]);
+		const __m128i t_hi = _mm_loadu_si128((const __m128i *) gf_mul_hi[gexp[j+1]]);
+		__m128i s = _mm_setzero_si128();
 		for (i = 0; i < nbytes; i++) {
-			sum = data[i] ^ gmult(gexp[j+1], sum);
+			__m128i s_lo = _mm_shuffle_epi8(t_lo, _mm_and_si128(s, mask));
+			__m128i s_hi = _mm_shuffle_epi8(t_hi, _mm_and_si128(_mm_srli_epi64(s, 4), mask));
+			s = _mm_xor_si128(_mm_loadu_si128((const __m128i *) cols[i]), _mm_xor_si128(s_lo, s_hi));
+		}
+		_mm_storeu_si128((__m128i *) (syn + j*RS_BLOCK_ROWS), s);
+	}
+#else
+	int r;
+	memset(syn, 0, NPAR*RS_BLOCK_ROWS);
+	for (i = 0; i < nbytes; i++) {
+		const u8 *d = cols[i];
+		for (j = 0; j < NPAR;  j++) {
+			const u8 *t_lo = gf_mul_lo[gexp[j+1]];
+			const u8 *t_hi = gf_mul_hi[gexp[j+1]];
+			u8 *s = syn + j*RS_BLOCK_ROWS;
+			for (r = 0; r < RS_BLOCK_ROWS; r++) {
+				s[r] = d[r] ^ t_lo[s[r] & 0xF] ^ t_hi[s[r] >> 4];
+			}
 		}
-		synBytes[j]  = sum;
 	}
+#endif
 }
 
 
@@ -64,6 +64,10 @@ typedef struct
 	/*0: not declared yet; 1: declared; (1<<1) : done but end of stream not sent yet*/
 	u32 state;
 	u32 last_au_sn, last_au_ts;
+
+	/*serialized stream declaration (AU header and payload), built once and reused for carousel repetitions*/
+	char *decl;
+	u32 decl_len;
 } GF_SAFStream;
 
 struct __saf_muxer
@@ -72,6 +76,19 @@ struct __saf_muxer
 	/*0: nothing to do, 1: should regenerate, (1<<1): end of session has been sent*/
 	u32 state;
 	GF_Mutex *mx;
+
+	/*recycled AU structures*/
+	GF_List *au_pool;
+	/*AUs and removed streams referenced by the last vectored output, released at the next mux call*/
+	GF_List *sent_aus, *removed_streams;
+	/*SAF packet headers of the last vectored output*/
+	char *hdr_buf;
+	u32 hdr_size, hdr_alloc;
+	/*last vectored output*/
+	GF_SAFChunk *chunks;
+	u32 nb_chunks, chunks_alloc;
+	/*stream declarations shall be sent again at the next mux call*/
+	Bool repeat_headers;
 };
 
 GF_SAFMuxer *gf_saf_mux_new()
@@ -81,22 +98,30 @@ GF_SAFMuxer *gf_saf_mux_new()
 	if (!mux) return NULL;
 	mux->mx = gf_mx_new("SAF");
 	mux->streams = gf_list_new();
+	mux->au_pool = gf_list_new();
+	mux->sent_aus = gf_list_new();
+	mux->removed_streams = gf_list_new();
 	return mux;
 }
 
+static void saf_au_del_list(GF_List *aus)
+{
+	while (gf_list_count(aus)) {
+		GF_SAFSample *au = (GF_SAFSample *)gf_list_last(aus);
+		gf_list_rem_last(aus);
+		if (au->data) gf_free(au->data);
+		gf_free(au);
+	}
+	gf_list_del(aus);
+}
+
 static void saf_stream_del(GF_SAFStream *str)
 {
 	if (str->mime_type) gf_free(str->mime_type);
 	if (str->remote_url) gf_free(str->remote_url);
 	if (str->dsi) gf_free(str->dsi);
-
-	while (gf_list_count(str->aus)) {
-		GF_SAFSample *au = (GF_SAFSample *)gf_list_last(str->aus);
-		gf_list_rem_last(str->aus);
-		if (au->data) gf_free(au->data);
-		gf_free(au);
-	}
-	gf_list_del(str->aus);
+	if (str->decl) gf_free(str->decl);
+	saf_au_del_list(str->aus);
 	gf_free(str);
 }
 
@@ -108,6 +133,15 @@ void gf_saf_mux_del(GF_SAFMuxer *mux)
 		saf_stream_del(str);
 	}
 	gf_list_del(mux->streams);
+	while (gf_list_count(mux->removed_streams)) {
+		GF_SAFStream *str = (GF_SAFStream *)gf_list_pop_back(mux->removed_streams);
+		saf_stream_del(str);
+	}
+	gf_list_del(mux->removed_streams);
+	saf_au_del_list(mux->sent_aus);
+	saf_au_del_list(mux->au_pool);
+	if (mux->hdr_buf) gf_free(mux->hdr_buf);
+	if (mux->chunks) gf_free(mux->chunks);
 	gf_mx_del(mux->mx);
 	gf_free(mux);
 }
@@ -132,7 +166,10 @@ GF_Err gf_saf_mux_stream_add(GF_SAFMuxer *mux, u32 stream_id, u32 ts_res, u32 bu
 	gf_mx_p(mux->mx);
 
 	GF_SAFEALLOC(str, GF_SAFStream);
-	if (!str) return GF_OUT_OF_MEM;
+	if (!str) {
+		gf_mx_v(mux->mx);
+		return GF_OUT_OF_MEM;
+	}
 	str->stream_id = stream_id;
 	str->ts_resolution = ts_res;
 	str->buffersize_db = buffersize_db;
@@ -177,8 +214,14 @@ GF_Err gf_saf_mux_add_au(GF_SAFMuxer *mux, u32 stream_id, u32 CTS, char *data, u
 
 	gf_mx_p(mux->mx);
 
-	GF_SAFEALLOC(au, GF_SAFSample);
-	if (!au) return GF_OUT_OF_MEM;
+	au = (GF_SAFSample *)gf_list_pop_back(mux->au_pool);
+	if (!au) {
+		GF_SAFEALLOC(au, GF_SAFSample);
+		if (!au) {
+			gf_mx_v(mux->mx);
+			return GF_OUT_OF_MEM;
+		}
+	}
 	au->data = data;
 	au->data_size = data_len;
 	au->is_rap = is_rap;
@@ -190,74 +233,147 @@ GF_Err gf_saf_mux_add_au(GF_SAFMuxer *mux, u32 stream_id, u32 CTS, char *data, u
 	return GF_OK;
 }
 
+GF_Err gf_saf_mux_repeat_headers(GF_SAFMuxer *mux)
+{
+	if (!mux) return GF_BAD_PARAM;
+	if (mux->state == 2) return GF_BAD_PARAM;
+	gf_mx_p(mux->mx);
+	mux->repeat_headers = GF_TRUE;
+	mux->state = 1;
+	gf_mx_v(mux->mx);
+	return GF_OK;
+}
+
+static void saf_stream_build_decl(GF_SAFStream *str)
+{
+	GF_BitStream *bs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
+	gf_bs_write_int(bs, str->remote_url ? SAF_REMOTE_STREAM_HEADER : SAF_STREAM_HEADER, 4);
+	gf_bs_write_int(bs, str->stream_id, 12);
+
+	gf_bs_write_u8(bs, str->object_type);
+	gf_bs_write_u8(bs, str->stream_type);
+	gf_bs_write_int(bs, str->ts_resolution, 24);
+	gf_bs_write_u16(bs, str->buffersize_db);
+	if (str->mime_type) {
+		u32 len = (u32) strlen(str->mime_type);
+		gf_bs_write_u16(bs, len);
+		gf_bs_write_data(bs, str->mime_type, len);
+	}
+	if (str->remote_url) {
+		u32 len = (u32) strlen(str->remote_url);
+		gf_bs_write_u16(bs, len);
+		gf_bs_write_data(bs, str->remote_url, len);
+	}
+	if (str->dsi) {
+		gf_bs_write_data(bs, str->dsi, str->dsi_len);
+	}
+	gf_bs_get_content(bs, &str->decl, &str->decl_len);
+	gf_bs_del(bs);
+}
 
-GF_Err gf_saf_mux_for_time(GF_SAFMuxer *mux, u32 time_ms, Bool force_end_of_session, char **out_data, u32 *out_size)
+static void saf_add_chunk(GF_SAFMuxer *mux, char *data, u32 size)
 {
-	u32 i, count, dlen;
-	char *data;
+	/*merge with previous chunk if contiguous*/
+	if (mux->nb_chunks && (mux->chunks[mux->nb_chunks-1].data + mux->chunks[mux->nb_chunks-1].size == data)) {
+		mux->chunks[mux->nb_chunks-1].size += size;
+		return;
+	}
+	if (mux->nb_chunks == mux->chunks_alloc) {
+		mux->chunks_alloc = mux->chunks_alloc ? 2*mux->chunks_alloc : 16;
+		mux->chunks = (GF_SAFChunk*)gf_realloc(mux->chunks, sizeof(GF_SAFChunk)*mux->chunks_alloc);
+	}
+	mux->chunks[mux->nb_chunks].data = data;
+	mux->chunks[mux->nb_chunks].size = size;
+	mux->nb_chunks++;
+}
+
+/*writes a SAF packet header followed by the 2-byte AU header if au_type is not 0, and adds it to the output*/
+static void saf_write_packet_header(GF_SAFMuxer *mux, Bool is_rap, u32 sn, u32 ts, u32 au_len, u32 au_type, u32 stream_id)
+{
+	char *ptr = mux->hdr_buf + mux->hdr_size;
+	u32 v = (1<<30) | (ts & 0x3FFFFFFF);
+	ptr[0] = (is_rap ? 0x80 : 0) | ((sn >> 8) & 0x7F);
+	ptr[1] = sn & 0xFF;
+	ptr[2] = (v >> 24) & 0xFF;
+	ptr[3] = (v >> 16) & 0xFF;
+	ptr[4] = (v >> 8) & 0xFF;
+	ptr[5] = v & 0xFF;
+	ptr[6] = (au_len >> 8) & 0xFF;
+	ptr[7] = au_len & 0xFF;
+	if (au_type) {
+		ptr[8] = (au_type << 4) | ((stream_id >> 8) & 0x0F);
+		ptr[9] = stream_id & 0xFF;
+	}
+	saf_add_chunk(mux, ptr, au_type ? 10 : 8);
+	mux->hdr_size += au_type ? 10 : 8;
+}
+
+GF_Err gf_saf_mux_for_time_vec(GF_SAFMuxer *mux, u32 time_ms, Bool force_end_of_session, const GF_SAFChunk **out_chunks, u32 *out_nb_chunks)
+{
+	u32 i, count, max_hdr_size;
 	GF_SAFStream *str;
 	GF_SAFSample*au;
-	GF_BitStream *bs, *payload;
 
-	*out_data = NULL;
-	*out_size = 0;
+	*out_chunks = NULL;
+	*out_nb_chunks = 0;
 
 	gf_mx_p(mux->mx);
+
+	/*release AUs from previous call*/
+	while (gf_list_count(mux->sent_aus)) {
+		au = (GF_SAFSample *)gf_list_pop_back(mux->sent_aus);
+		if (au->data) gf_free(au->data);
+		au->data = NULL;
+		gf_list_add(mux->au_pool, au);
+	}
+	while (gf_list_count(mux->removed_streams)) {
+		str = (GF_SAFStream *)gf_list_pop_back(mux->removed_streams);
+		saf_stream_del(str);
+	}
+	mux->nb_chunks = 0;
+	mux->hdr_size = 0;
+
 	if (!force_end_of_session && (mux->state!=1)) {
 		gf_mx_v(mux->mx);
 		return GF_OK;
 	}
 
-	bs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
-
 	count = gf_list_count(mux->streams);
 
+	/*reserve all packet headers we may write so that chunk pointers stay valid*/
+	max_hdr_size = 10;
+	for (i=0; i<count; i++) {
+		str = (GF_SAFStream *)gf_list_get(mux->streams, i);
+		max_hdr_size += 10 * (gf_list_count(str->aus) + 2);
+	}
+	if (max_hdr_size > mux->hdr_alloc) {
+		mux->hdr_alloc = max_hdr_size;
+		mux->hdr_buf = (char*)gf_realloc(mux->hdr_buf, sizeof(char)*mux->hdr_alloc);
+		if (!mux->hdr_buf) {
+			mux->hdr_alloc = 0;
+			gf_mx_v(mux->mx);
+			return GF_OUT_OF_MEM;
+		}
+	}
+
 	/*1: write all stream headers*/
 	for (i=0; i<count; i++) {
 		str = (GF_SAFStream *)gf_list_get(mux->streams, i);
-		if (str->state & 1) continue;
+		if ((str->state & 1) && !mux->repeat_headers) continue;
 
 		au = (GF_SAFSample *)gf_list_get(str->aus, 0);
 
 		/*write stream declaration*/
-		payload = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
-		gf_bs_write_int(payload, str->remote_url ? SAF_REMOTE_STREAM_HEADER : SAF_STREAM_HEADER, 4);
-		gf_bs_write_int(payload, str->stream_id, 12);
-
-		gf_bs_write_u8(payload, str->object_type);
-		gf_bs_write_u8(payload, str->stream_type);
-		gf_bs_write_int(payload, str->ts_resolution, 24);
-		gf_bs_write_u16(payload, str->buffersize_db);
-		if (str->mime_type) {
-			u32 len = (u32) strlen(str->mime_type);
-			gf_bs_write_u16(payload, len);
-			gf_bs_write_data(payload, str->mime_type, len);
-		}
-		if (str->remote_url) {
-			u32 len = (u32) strlen(str->remote_url);
-			gf_bs_write_u16(payload, len);
-			gf_bs_write_data(payload, str->remote_url, len);
-		}
-		if (str->dsi) {
-			gf_bs_write_data(payload, str->dsi, str->dsi_len);
-		}
-
-		gf_bs_get_content(payload, &data, &dlen);
-		gf_bs_del(payload);
+		if (!str->decl) saf_stream_build_decl(str);
 
 		/*write SAF packet header*/
-		gf_bs_write_int(bs, 1, 1);
-		gf_bs_write_int(bs, 0, 15);
-		gf_bs_write_int(bs, 0, 1);
-		gf_bs_write_int(bs, 1, 1);
-		gf_bs_write_int(bs, au ? au->ts : 0, 30);
-		gf_bs_write_int(bs, dlen, 16);
-		gf_bs_write_data(bs, data, dlen);
-		gf_free(data);
+		saf_write_packet_header(mux, GF_TRUE, 0, au ? au->ts : str->last_au_ts, str->decl_len, 0, 0);
+		saf_add_chunk(mux, str->decl, str->decl_len);
 
 		/*mark as signaled*/
 		str->state |= 1;
 	}
+	mux->repeat_headers = GF_FALSE;
 
 	/*write all pending AUs*/
 	while (1) {
@@ -278,21 +394,13 @@ GF_Err gf_saf_mux_for_time(GF_SAFMuxer *mux, u32 time_ms, Bool force_end_of_sess
 		au = (GF_SAFSample*)gf_list_get(src->aus, 0);
 		gf_list_rem(src->aus, 0);
 
-		/*write stream declaration*/
-		gf_bs_write_int(bs, au->is_rap ? 1 : 0, 1);
-		gf_bs_write_int(bs, src->last_au_sn, 15);
-		gf_bs_write_int(bs, 0, 1);
-		gf_bs_write_int(bs, 1, 1);
-		gf_bs_write_int(bs, au->ts, 30);
-		gf_bs_write_u16(bs, 2+au->data_size);
-		gf_bs_write_int(bs, SAF_ACCESS_UNIT, 4);
-		gf_bs_write_int(bs, src->stream_id, 12);
-		gf_bs_write_data(bs, au->data, au->data_size);
+		/*write AU packet header and reference AU payload*/
+		saf_write_packet_header(mux, au->is_rap, src->last_au_sn, au->ts, 2+au->data_size, SAF_ACCESS_UNIT, src->stream_id);
+		if (au->data_size) saf_add_chunk(mux, au->data, au->data_size);
 
 		src->last_au_sn ++;
 		src->last_au_ts = au->ts;
-		gf_free(au->data);
-		gf_free(au);
+		gf_list_add(mux->sent_aus, au);
 	}
 
 	/*3: write all end of stream*/
@@ -303,35 +411,48 @@ GF_Err gf_saf_mux_for_time(GF_SAFMuxer *mux, u32 time_ms, Bool force_end_of_sess
 		if (gf_list_count(str->aus)) continue;
 
 		/*write stream declaration*/
-		gf_bs_write_int(bs, 1, 1);
-		gf_bs_write_int(bs, str->last_au_sn, 15);
-		gf_bs_write_int(bs, 0, 1);
-		gf_bs_write_int(bs, 1, 1);
-		gf_bs_write_int(bs, str->last_au_ts, 30);
-		gf_bs_write_int(bs, 2, 16);
-		gf_bs_write_int(bs, SAF_END_OF_STREAM, 4);
-		gf_bs_write_int(bs, str->stream_id, 12);
+		saf_write_packet_header(mux, GF_TRUE, str->last_au_sn, str->last_au_ts, 2, SAF_END_OF_STREAM, str->stream_id);
 
 		/*remove stream*/
 		gf_list_rem(mux->streams, i);
 		i--;
 		count--;
-		saf_stream_del(str);
+		/*its declaration may be referenced by the output, destroy at next call*/
+		gf_list_add(mux->removed_streams, str);
 	}
 	mux->state = 0;
 	if (force_end_of_session) {
-		gf_bs_write_int(bs, 1, 1);
-		gf_bs_write_int(bs, 0, 15);
-		gf_bs_write_int(bs, 0, 1);
-		gf_bs_write_int(bs, 1, 1);
-		gf_bs_write_int(bs, 0, 30);
-		gf_bs_write_int(bs, 2, 16);
-		gf_bs_write_int(bs, SAF_END_OF_SESSION, 4);
-		gf_bs_write_int(bs, 0, 12);
+		saf_write_packet_header(mux, GF_TRUE, 0, 0, 2, SAF_END_OF_SESSION, 0);
 		mux->state = 2;
 	}
-	gf_bs_get_content(bs, out_data, out_size);
-	gf_bs_del(bs);
+	*out_chunks = mux->nb_chunks ? mux->chunks : NULL;
+	*out_nb_chunks = mux->nb_chunks;
 	gf_mx_v(mux->mx);
 	return GF_OK;
 }
+
+GF_Err gf_saf_mux_for_time(GF_SAFMuxer *mux, u32 time_ms, Bool force_end_of_session, char **out_data, u32 *out_size)
+{
+	u32 i, nb_chunks, size;
+	const GF_SAFChunk *chunks;
+	GF_Err e;
+
+	*out_data = NULL;
+	*out_size = 0;
+
+	e = gf_saf_mux_for_time_vec(mux, time_ms, force_end_of_session, &chunks, &nb_chunks);
+	if (e || !nb_chunks) return e;
+
+	/*single copy of the gathered output*/
+	size = 0;
+	for (i=0; i<nb_chunks; i++) size += chunks[i].size;
+	*out_data = (char*)gf_malloc(sizeof(char)*size);
+	if (! *out_data) return GF_OUT_OF_MEM;
+	size = 0;
+	for (i=0; i<nb_chunks; i++) {
+		memcpy(*out_data + size, chunks[i].data, chunks[i].size);
+		size += chunks[i].size;
+	}
+	*out_size = size;
+	return GF_OK;
+}
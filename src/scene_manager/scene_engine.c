@@ -80,8 +80,13 @@ static GF_Err gf_sm_setup_bifsenc(GF_SceneEngine *seng, GF_StreamContext *sc, GF
 
 	if (!esd->decoderConfig || (esd->decoderConfig->streamType != GF_STREAM_SCENE)) return GF_BAD_PARAM;
 
-	if (!seng->bifsenc)
+	if (!seng->bifsenc) {
 		seng->bifsenc = gf_bifs_encoder_new(seng->ctx->scene_graph);
+		/*carousels re-encode the whole scene, only re-serialize modified subtrees. Cached subtrees are invalidated by
+		gf_seng_on_node_modified, which is only installed on scene graphs owned by the engine*/
+		if (seng->owns_context)
+			gf_bifs_encoder_set_node_cache(seng->bifsenc, GF_TRUE);
+	}
 
 	delete_bcfg = 0;
 	/*inputctx is not properly setup, do it*/
@@ -821,6 +826,7 @@ void gf_seng_terminate(GF_SceneEngine *seng)
 {
 #ifndef GPAC_DISABLE_BIFS_ENC
 	if (seng->bifsenc) gf_bifs_encoder_del(seng->bifsenc);
+	seng->bifsenc = NULL;
 #endif
 
 #ifndef GPAC_DISABLE_LASER
@@ -890,6 +896,7 @@ static void seng_conditional_reverse_activate(GF_Node *node, GF_Route *route)
 
 static void gf_seng_on_node_modified(void *_seng, u32 type, GF_Node *node, void *ctxdata)
 {
+	GF_SceneEngine *seng = (GF_SceneEngine *)_seng;
 	switch (type) {
 #ifndef GPAC_DISABLE_VRML
 	case GF_SG_CALLBACK_INIT:
@@ -903,6 +910,15 @@ static void gf_seng_on_node_modified(void *_seng, u32 type, GF_Node *node, void
 #endif
 	case GF_SG_CALLBACK_MODIFIED:
 		gf_node_dirty_parents(node);
+#ifndef GPAC_DISABLE_BIFS_ENC
+		/*drop cached encodings of all subtrees containing this node*/
+		if (seng && seng->bifsenc) gf_bifs_encoder_node_modified(seng->bifsenc, node);
+#endif
+		break;
+	case GF_SG_CALLBACK_NODE_DESTROY:
+#ifndef GPAC_DISABLE_BIFS_ENC
+		if (seng && seng->bifsenc) gf_bifs_encoder_node_modified(seng->bifsenc, node);
+#endif
 		break;
 	}
 }
@@ -999,6 +1015,8 @@ GF_SceneEngine *gf_seng_init_from_string(void *calling_object, char * inputConte
 	seng->dump_path = dump_path;
 	/*Step 1: create context and load input*/
 	seng->sg = gf_sg_new();
+	gf_sg_set_node_callback(seng->sg, gf_seng_on_node_modified);
+	gf_sg_set_private(seng->sg, seng);
 	seng->ctx = gf_sm_new(seng->sg);
 	seng->owns_context = 1;
 	memset(& seng->loader, 0, sizeof(GF_SceneLoader));
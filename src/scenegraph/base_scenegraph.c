@@ -43,6 +43,160 @@ static void node_modif_stub(GF_SceneGraph *sg, GF_Node *node, GF_FieldInfo *info
 {
 }
 
+/*DEF node indexes: the id_node list is kept sorted by ID (needed for ID allocation and graph reset), and mirrored
+in open-addressing hash tables so that lookups by ID, name or node no longer walk the list*/
+#define SG_NODE_INDEX_MIN_SIZE	64
+
+static GFINLINE u32 sg_index_hash_id(u32 ID)
+{
+	ID ^= ID >> 16;
+	ID *= 0x45d9f3b;
+	ID ^= ID >> 16;
+	return ID;
+}
+
+static GFINLINE u32 sg_index_hash_name(const char *name)
+{
+	u32 h = 2166136261U;
+	while (*name) {
+		h ^= (u8) *name;
+		h *= 16777619U;
+		name++;
+	}
+	return h;
+}
+
+static GFINLINE u32 sg_index_hash_node(GF_Node *node)
+{
+	u64 v = (u64) (PTR_TO_U_CAST node);
+	return sg_index_hash_id((u32) (v>>4) ^ (u32) (v>>32));
+}
+
+static GFINLINE u32 sg_index_hash(NodeIDedItem *item, u32 type)
+{
+	switch (type) {
+	case SG_INDEX_NAME:
+		return sg_index_hash_name(item->NodeName);
+	case SG_INDEX_NODE:
+		return sg_index_hash_node(item->node);
+	default:
+		return sg_index_hash_id(item->NodeID);
+	}
+}
+
+static void sg_index_put(NodeIDedItem **index, u32 size, NodeIDedItem *item, u32 type)
+{
+	u32 mask = size-1;
+	u32 pos = sg_index_hash(item, type) & mask;
+	while (index[pos]) pos = (pos+1) & mask;
+	index[pos] = item;
+}
+
+/*rebuild from the sorted list so that entries sharing the same key keep their list order in the probe sequence*/
+static void sg_index_rebuild(GF_SceneGraph *sg, u32 type, u32 size)
+{
+	NodeIDedItem *reg_node;
+	NodeIDedItem **index = (NodeIDedItem **) gf_malloc(sizeof(NodeIDedItem *) * size);
+	if (!index) return;
+	memset(index, 0, sizeof(NodeIDedItem *) * size);
+
+	reg_node = sg->id_node;
+	while (reg_node) {
+		if ((type != SG_INDEX_NAME) || reg_node->NodeName) sg_index_put(index, size, reg_node, type);
+		reg_node = reg_node->next;
+	}
+	if (sg->id_index[type]) gf_free(sg->id_index[type]);
+	sg->id_index[type] = index;
+	sg->id_index_size[type] = size;
+}
+
+static void sg_index_insert(GF_SceneGraph *sg, NodeIDedItem *item, u32 type)
+{
+	sg->id_index_count[type]++;
+	/*keep load factor below 1/2*/
+	if (2*sg->id_index_count[type] > sg->id_index_size[type]) {
+		sg_index_rebuild(sg, type, MAX(SG_NODE_INDEX_MIN_SIZE, 2*sg->id_index_size[type]) );
+	} else {
+		sg_index_put(sg->id_index[type], sg->id_index_size[type], item, type);
+	}
+}
+
+static void sg_index_del(GF_SceneGraph *sg, NodeIDedItem *item, u32 type)
+{
+	u32 hole, next, home, mask;
+	NodeIDedItem **index = sg->id_index[type];
+	if (!index) return;
+	mask = sg->id_index_size[type] - 1;
+	hole = sg_index_hash(item, type) & mask;
+	while (index[hole] != item) {
+		if (!index[hole]) return;
+		hole = (hole+1) & mask;
+	}
+	index[hole] = NULL;
+	sg->id_index_count[type]--;
+
+	/*backward shift deletion: move back any following entry of the cluster whose home slot is not in ]hole, next]*/
+	next = (hole+1) & mask;
+	while (index[next]) {
+		Bool move;
+		home = sg_index_hash(index[next], type) & mask;
+		if (hole <= next) move = ((home <= hole) || (home > next)) ? GF_TRUE : GF_FALSE;
+		else move = ((home <= hole) && (home > next)) ? GF_TRUE : GF_FALSE;
+		if (move) {
+			index[hole] = index[next];
+			index[next] = NULL;
+			hole = next;
+		}
+		next = (next+1) & mask;
+	}
+}
+
+static NodeIDedItem *sg_index_find_id(GF_SceneGraph *sg, u32 nodeID, GF_Node *toExclude)
+{
+	u32 pos, mask;
+	NodeIDedItem **index = sg->id_index[SG_INDEX_ID];
+	if (!index) return NULL;
+	mask = sg->id_index_size[SG_INDEX_ID] - 1;
+	pos = sg_index_hash_id(nodeID) & mask;
+	while (index[pos]) {
+		if ((index[pos]->NodeID == nodeID) && (index[pos]->node != toExclude)) return index[pos];
+		pos = (pos+1) & mask;
+	}
+	return NULL;
+}
+
+static NodeIDedItem *sg_index_find_node(GF_SceneGraph *sg, GF_Node *node)
+{
+	u32 pos, mask;
+	NodeIDedItem **index = sg->id_index[SG_INDEX_NODE];
+	if (!index) return NULL;
+	mask = sg->id_index_size[SG_INDEX_NODE] - 1;
+	pos = sg_index_hash_node(node) & mask;
+	while (index[pos]) {
+		if (index[pos]->node == node) return index[pos];
+		pos = (pos+1) & mask;
+	}
+	return NULL;
+}
+
+/*called once the item is inserted in the id_node list*/
+static void sg_index_add(GF_SceneGraph *sg, NodeIDedItem *item)
+{
+	if (sg_index_find_id(sg, item->NodeID, NULL)) sg->nb_dup_ids++;
+	sg_index_insert(sg, item, SG_INDEX_ID);
+	sg_index_insert(sg, item, SG_INDEX_NODE);
+	if (item->NodeName) sg_index_insert(sg, item, SG_INDEX_NAME);
+}
+
+/*called before the item is destroyed*/
+static void sg_index_remove(GF_SceneGraph *sg, NodeIDedItem *item)
+{
+	sg_index_del(sg, item, SG_INDEX_ID);
+	if (sg->nb_dup_ids && sg_index_find_id(sg, item->NodeID, NULL)) sg->nb_dup_ids--;
+	sg_index_del(sg, item, SG_INDEX_NODE);
+	if (item->NodeName) sg_index_del(sg, item, SG_INDEX_NAME);
+}
+
 GF_EXPORT
 GF_SceneGraph *gf_sg_new()
 {
@@ -169,6 +323,9 @@ void gf_sg_del(GF_SceneGraph *sg)
 	gf_list_del(sg->routes_to_destroy);
 #endif
 	gf_list_del(sg->exported_nodes);
+	if (sg->id_index[SG_INDEX_ID]) gf_free(sg->id_index[SG_INDEX_ID]);
+	if (sg->id_index[SG_INDEX_NAME]) gf_free(sg->id_index[SG_INDEX_NAME]);
+	if (sg->id_index[SG_INDEX_NODE]) gf_free(sg->id_index[SG_INDEX_NODE]);
 	gf_free(sg);
 }
 
@@ -274,25 +431,15 @@ void SG_GraphRemoved(GF_Node *node, GF_SceneGraph *sg)
 	}
 }
 
-GFINLINE GF_Node *SG_SearchForNode(GF_SceneGraph *sg, GF_Node *node)
+GF_Node *SG_SearchForNode(GF_SceneGraph *sg, GF_Node *node)
 {
-	NodeIDedItem *reg_node = sg->id_node;
-	while (reg_node) {
-		if (reg_node->node == node) return reg_node->node;
-		reg_node = reg_node->next;
-	}
-	return NULL;
+	NodeIDedItem *reg_node = sg_index_find_node(sg, node);
+	return reg_node ? reg_node->node : NULL;
 }
 
 static GFINLINE u32 get_num_id_nodes(GF_SceneGraph *sg)
 {
-	u32 count = 0;
-	NodeIDedItem *reg_node = sg->id_node;
-	while (reg_node) {
-		count++;
-		reg_node = reg_node->next;
-	}
-	return count;
+	return sg->id_index_count[SG_INDEX_ID];
 }
 
 GF_EXPORT
@@ -505,26 +652,18 @@ restart:
 }
 
 
-GFINLINE GF_Node *SG_SearchForDuplicateNodeID(GF_SceneGraph *sg, u32 nodeID, GF_Node *toExclude)
+GF_Node *SG_SearchForDuplicateNodeID(GF_SceneGraph *sg, u32 nodeID, GF_Node *toExclude)
 {
-	NodeIDedItem *reg_node = sg->id_node;
-	while (reg_node) {
-		if ((reg_node->node != toExclude) && (reg_node->NodeID == nodeID)) return reg_node->node;
-		reg_node = reg_node->next;
-	}
-	return NULL;
+	NodeIDedItem *reg_node = sg_index_find_id(sg, nodeID, toExclude);
+	return reg_node ? reg_node->node : NULL;
 }
 
 void *gf_node_get_name_address(GF_Node*node)
 {
 	NodeIDedItem *reg_node;
 	if (!(node->sgprivate->flags & GF_NODE_IS_DEF)) return NULL;
-	reg_node = node->sgprivate->scenegraph->id_node;
-	while (reg_node) {
-		if (reg_node->node == node) return &reg_node->NodeName;
-		reg_node = reg_node->next;
-	}
-	return NULL;
+	reg_node = sg_index_find_node(node->sgprivate->scenegraph, node);
+	return reg_node ? &reg_node->NodeName : NULL;
 }
 
 GF_EXPORT
@@ -596,6 +735,7 @@ void remove_node_id(GF_SceneGraph *sg, GF_Node *node)
 		sg->id_node = reg_node->next;
 		if (sg->id_node_last==reg_node)
 			sg->id_node_last = reg_node->next;
+		sg_index_remove(sg, reg_node);
 		if (reg_node->NodeName) gf_free(reg_node->NodeName);
 		gf_free(reg_node);
 	} else {
@@ -610,6 +750,7 @@ void remove_node_id(GF_SceneGraph *sg, GF_Node *node)
 			if (sg->id_node_last==to_del) {
 				sg->id_node_last = reg_node->next ? reg_node->next : reg_node;
 			}
+			sg_index_remove(sg, to_del);
 			if (to_del->NodeName) gf_free(to_del->NodeName);
 			to_del->NodeName = NULL;
 			gf_free(to_del);
@@ -970,6 +1111,7 @@ static GFINLINE void insert_node_def(GF_SceneGraph *sg, GF_Node *def, u32 ID, co
 			if (cur->next->NodeID>ID) {
 				reg_node->next = cur->next;
 				cur->next = reg_node;
+				sg_index_add(sg, reg_node);
 				return;
 			}
 			cur = cur->next;
@@ -978,6 +1120,7 @@ static GFINLINE void insert_node_def(GF_SceneGraph *sg, GF_Node *def, u32 ID, co
 		sg->id_node_last = reg_node;
 		reg_node->next = NULL;
 	}
+	sg_index_add(sg, reg_node);
 }
 
 
@@ -1153,25 +1296,27 @@ GF_SceneGraph *gf_node_get_graph(GF_Node *node)
 GF_EXPORT
 GF_Node *gf_sg_find_node(GF_SceneGraph *sg, u32 nodeID)
 {
-	NodeIDedItem *reg_node = sg->id_node;
-	while (reg_node) {
-		if (reg_node->NodeID == nodeID) return reg_node->node;
-		reg_node = reg_node->next;
-	}
-	return NULL;
+	NodeIDedItem *reg_node = sg_index_find_id(sg, nodeID, NULL);
+	return reg_node ? reg_node->node : NULL;
 }
 
 GF_EXPORT
 GF_Node *gf_sg_find_node_by_name(GF_SceneGraph *sg, char *name)
 {
-	if (name) {
-		NodeIDedItem *reg_node = sg->id_node;
-		while (reg_node) {
-			if (reg_node->NodeName && !strcmp(reg_node->NodeName, name)) return reg_node->node;
-			reg_node = reg_node->next;
-		}
+	u32 pos, mask;
+	NodeIDedItem *found = NULL;
+	NodeIDedItem **index = sg->id_index[SG_INDEX_NAME];
+	if (!name || !index) return NULL;
+
+	mask = sg->id_index_size[SG_INDEX_NAME] - 1;
+	pos = sg_index_hash_name(name) & mask;
+	/*several nodes may share the same name, return the first one in the ID-sorted list as done previously*/
+	while (index[pos]) {
+		if (!strcmp(index[pos]->NodeName, name) && (!found || (index[pos]->NodeID < found->NodeID)))
+			found = index[pos];
+		pos = (pos+1) & mask;
 	}
-	return NULL;
+	return found ? found->node : NULL;
 }
 
 
@@ -1183,6 +1328,9 @@ u32 gf_sg_get_next_available_node_id(GF_SceneGraph *sg)
 	if (!sg->id_node) return 1;
 	reg_node = sg->id_node;
 	ID = reg_node->NodeID;
+	/*no duplicated IDs and as many IDs as the ID range: no gap in the list*/
+	if (!sg->nb_dup_ids && (sg->id_node_last->NodeID - ID + 1 == sg->id_index_count[SG_INDEX_ID]))
+		return sg->id_node_last->NodeID + 1;
 	/*nodes are sorted*/
 	while (reg_node->next) {
 		if (ID+1<reg_node->next->NodeID) return ID+1;
@@ -1243,12 +1391,8 @@ u32 gf_node_get_id(GF_Node*p)
 	if (p == (GF_Node*)sg->pOwningProto) sg = sg->parent_scene;
 #endif
 
-	reg_node = sg->id_node;
-	while (reg_node) {
-		if (reg_node->node==p) return reg_node->NodeID;
-		reg_node = reg_node->next;
-	}
-	return 0;
+	reg_node = sg_index_find_node(sg, p);
+	return reg_node ? reg_node->NodeID : 0;
 }
 
 GF_EXPORT
@@ -1264,12 +1408,8 @@ const char *gf_node_get_name(GF_Node*p)
 	if (p == (GF_Node*)sg->pOwningProto) sg = sg->parent_scene;
 #endif
 
-	reg_node = sg->id_node;
-	while (reg_node) {
-		if (reg_node->node==p) return reg_node->NodeName;
-		reg_node = reg_node->next;
-	}
-	return NULL;
+	reg_node = sg_index_find_node(sg, p);
+	return reg_node ? reg_node->NodeName : NULL;
 }
 
 GF_EXPORT
@@ -1289,13 +1429,10 @@ const char *gf_node_get_name_and_id(GF_Node*p, u32 *id)
 	if (p == (GF_Node*)sg->pOwningProto) sg = sg->parent_scene;
 #endif
 
-	reg_node = sg->id_node;
-	while (reg_node) {
-		if (reg_node->node==p) {
-			*id = reg_node->NodeID;
-			return reg_node->NodeName;
-		}
-		reg_node = reg_node->next;
+	reg_node = sg_index_find_node(sg, p);
+	if (reg_node) {
+		*id = reg_node->NodeID;
+		return reg_node->NodeName;
 	}
 	*id = 0;
 	return NULL;
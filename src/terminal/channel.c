@@ -63,6 +63,93 @@ void gf_es_buffer_on(GF_Channel *ch)
 	}
 }
 
+/*max number of AU buffers kept by a push channel for reuse*/
+#define GF_ES_MAX_POOLED_AU	16
+
+/*returns a list of push mode AUs to the channel pool - buffers beyond the pool limit are destroyed*/
+static void gf_es_pool_release(GF_Channel *ch, GF_DBUnit *au)
+{
+	gf_mx_p(ch->mx);
+	while (au) {
+		GF_DBUnit *next = au->next;
+		if (au->data && (ch->AU_pool_count < GF_ES_MAX_POOLED_AU)) {
+			au->next = ch->AU_pool;
+			ch->AU_pool = au;
+			ch->AU_pool_count++;
+			ch->AU_pool_bytes += au->allocSize;
+		} else {
+			au->next = NULL;
+			gf_db_unit_del(au);
+		}
+		au = next;
+	}
+	gf_mx_v(ch->mx);
+}
+
+/*gets an AU without data from the channel pool*/
+static GF_DBUnit *gf_es_pool_get_unit(GF_Channel *ch)
+{
+	GF_DBUnit *au;
+	gf_mx_p(ch->mx);
+	au = ch->AU_pool_units;
+	if (au) {
+		ch->AU_pool_units = au->next;
+		memset(au, 0, sizeof(GF_DBUnit));
+	}
+	gf_mx_v(ch->mx);
+	if (!au) au = gf_db_unit_new();
+	return au;
+}
+
+/*gets a buffer of at least size bytes from the channel pool, reusing the most recently released one*/
+static char *gf_es_pool_get_buffer(GF_Channel *ch, u32 size, u32 *alloc_size)
+{
+	char *data;
+	GF_DBUnit *au;
+	gf_mx_p(ch->mx);
+	au = ch->AU_pool;
+	if (!au) {
+		gf_mx_v(ch->mx);
+		*alloc_size = size;
+		return (char*)gf_malloc(sizeof(char) * size);
+	}
+	ch->AU_pool = au->next;
+	ch->AU_pool_count--;
+	ch->AU_pool_bytes -= au->allocSize;
+
+	data = au->data;
+	*alloc_size = au->allocSize;
+	au->data = NULL;
+	au->allocSize = 0;
+	au->next = ch->AU_pool_units;
+	ch->AU_pool_units = au;
+	gf_mx_v(ch->mx);
+
+	if (*alloc_size < size) {
+		data = (char*)gf_realloc(data, sizeof(char) * size);
+		*alloc_size = size;
+	}
+	return data;
+}
+
+/*returns the current reassembly buffer to the channel pool*/
+static void gf_es_pool_release_buffer(GF_Channel *ch)
+{
+	GF_DBUnit *au;
+	if (ch->buffer) {
+		au = gf_es_pool_get_unit(ch);
+		if (au) {
+			au->data = ch->buffer;
+			au->allocSize = ch->allocSize;
+			gf_es_pool_release(ch, au);
+		} else {
+			gf_free(ch->buffer);
+		}
+		ch->buffer = NULL;
+	}
+	ch->len = ch->allocSize = 0;
+}
+
 /*reset channel*/
 static void gf_es_reset(GF_Channel *ch, Bool for_start)
 {
@@ -88,11 +175,9 @@ static void gf_es_reset(GF_Channel *ch, Bool for_start)
 	ch->min_computed_cts = 0;
 	gf_es_buffer_off(ch);
 
-	if (ch->buffer) gf_free(ch->buffer);
-	ch->buffer = NULL;
-	ch->len = ch->allocSize = 0;
+	gf_es_pool_release_buffer(ch);
 
-	gf_db_unit_del(ch->AU_buffer_first);
+	gf_es_pool_release(ch, ch->AU_buffer_first);
 	ch->AU_buffer_first = ch->AU_buffer_last = NULL;
 	ch->AU_Count = 0;
 	ch->BufferTime = 0;
@@ -191,6 +276,8 @@ void gf_es_del(GF_Channel *ch)
 		ch->AU_buffer_pull->data = NULL;
 		gf_db_unit_del(ch->AU_buffer_pull);
 	}
+	gf_db_unit_del(ch->AU_pool);
+	gf_db_unit_del(ch->AU_pool_units);
 	if (ch->ipmp_tool)
 		gf_modules_close_interface((GF_BaseInterface *) ch->ipmp_tool);
 
@@ -282,8 +369,7 @@ static void gf_es_wait_rap(GF_Channel *ch)
 	/*if using RAP signal and codec not resilient, wait for rap. If RAP isn't signaled, this will be ignored*/
 	if (ch->codec_resilient != GF_CODEC_RESILIENT_ALWAYS)
 		ch->stream_state = 2;
-	if (ch->buffer) gf_free(ch->buffer);
-	ch->buffer = NULL;
+	gf_es_pool_release_buffer(ch);
 	ch->AULength = 0;
 	ch->au_sn = 0;
 }
@@ -293,11 +379,9 @@ void gf_es_reset_buffers(GF_Channel *ch)
 	GF_LOG(GF_LOG_ERROR, GF_LOG_SYNC, ("[SyncLayer] ES%d (%s): reseting buffers (%d AUs)\n", ch->esd->ESID, ch->odm->net_service->url, ch->AU_Count));
 	gf_mx_p(ch->mx);
 
-	if (ch->buffer) gf_free(ch->buffer);
-	ch->buffer = NULL;
-	ch->len = ch->allocSize = 0;
+	gf_es_pool_release_buffer(ch);
 
-	gf_db_unit_del(ch->AU_buffer_first);
+	gf_es_pool_release(ch, ch->AU_buffer_first);
 	ch->AU_buffer_first = ch->AU_buffer_last = NULL;
 	ch->AU_Count = 0;
 
@@ -314,11 +398,7 @@ void gf_es_reset_timing(GF_Channel *ch, Bool reset_buffer)
 	struct _decoding_buffer *au = ch->AU_buffer_first;
 	gf_mx_p(ch->mx);
 
-	if (reset_buffer) {
-		if (ch->buffer) gf_free(ch->buffer);
-		ch->buffer = NULL;
-		ch->len = ch->allocSize = 0;
-	}
+	if (reset_buffer) gf_es_pool_release_buffer(ch);
 
 	while (au) {
 		au->CTS = au->DTS = 0;
@@ -454,26 +534,18 @@ static void gf_es_dispatch_au(GF_Channel *ch, u32 duration)
 	GF_DBUnit *au;
 
 	if (!ch->buffer || !ch->len) {
-		if (ch->buffer) {
-			gf_free(ch->buffer);
-			ch->buffer = NULL;
-		}
+		gf_es_pool_release_buffer(ch);
 		return;
 	}
 
 	if (ch->odm->codec && ch->odm->codec->decode_only_rap && !ch->IsRap) {
-		if (ch->buffer) {
-			gf_free(ch->buffer);
-			ch->buffer = NULL;
-		}
+		gf_es_pool_release_buffer(ch);
 		return;
 	}
 
-	au = gf_db_unit_new();
+	au = gf_es_pool_get_unit(ch);
 	if (!au) {
-		gf_free(ch->buffer);
-		ch->buffer = NULL;
-		ch->len = 0;
+		gf_es_pool_release_buffer(ch);
 		return;
 	}
 
@@ -493,6 +565,7 @@ static void gf_es_dispatch_au(GF_Channel *ch, u32 duration)
 	}
 	au->data = ch->buffer;
 	au->dataLength = ch->len;
+	au->allocSize = ch->allocSize;
 	au->PaddingBits = ch->padingBits;
 	au->sender_ntp = ch->sender_ntp;
 	ch->sender_ntp = 0;
@@ -503,8 +576,10 @@ static void gf_es_dispatch_au(GF_Channel *ch, u32 duration)
 	au->next = NULL;
 	ch->buffer = NULL;
 
-	if (ch->len + ch->media_padding_bytes != ch->allocSize) {
-		au->data = (char*)gf_realloc(au->data, sizeof(char) * (au->dataLength + ch->media_padding_bytes));
+	/*the reassembly buffer is sized for the padding bytes, so this only happens for buffers not allocated by the channel*/
+	if (ch->len + ch->media_padding_bytes > ch->allocSize) {
+		au->allocSize = au->dataLength + ch->media_padding_bytes;
+		au->data = (char*)gf_realloc(au->data, sizeof(char) * au->allocSize);
 	}
 	if (ch->media_padding_bytes) memset(au->data + au->dataLength, 0, sizeof(char)*ch->media_padding_bytes);
 
@@ -523,7 +598,7 @@ static void gf_es_dispatch_au(GF_Channel *ch, u32 duration)
 			GF_LOG(GF_LOG_ERROR, GF_LOG_SYNC, ("[SyncLayer] ES%d (%s): Something really wrong,  decoding buffer exceeded (%d ms vs %d max) - trashing buffers\n", ch->esd->ESID, ch->odm->net_service->url, ch->BufferTime, ch->MaxBuffer));
 
 		}
-		gf_db_unit_del(ch->AU_buffer_first->next);
+		gf_es_pool_release(ch, ch->AU_buffer_first->next);
 		ch->AU_buffer_first->next = NULL;
 		ch->AU_buffer_last = ch->AU_buffer_first;
 		ch->AU_Count = 1;
@@ -665,8 +740,7 @@ static void gf_es_dispatch_au(GF_Channel *ch, u32 duration)
 				}
 				assert(au_prev);
 				if (au_prev->next && (au_prev->next->DTS==au->DTS)) {
-					gf_free(au->data);
-					gf_free(au);
+					gf_es_pool_release(ch, au);
 				} else {
 					au->next = au_prev->next;
 					au_prev->next = au;
@@ -772,10 +846,10 @@ void gf_es_receive_skip_sl(GF_ClientService *serv, GF_Channel *ch, const char *S
 	if (!StreamLength) return;
 
 	gf_es_lock(ch, 1);
-	au = gf_db_unit_new();
+	au = gf_es_pool_get_unit(ch);
 	au->flags = GF_DB_AU_RAP;
 	au->DTS = gf_clock_time(ch->clock);
-	au->data = (char*)gf_malloc(sizeof(char) * (ch->media_padding_bytes + StreamLength));
+	au->data = gf_es_pool_get_buffer(ch, ch->media_padding_bytes + StreamLength, &au->allocSize);
 	memcpy(au->data, StreamBuf, sizeof(char) * StreamLength);
 	if (ch->media_padding_bytes) memset(au->data + StreamLength, 0, sizeof(char)*ch->media_padding_bytes);
 	au->dataLength = StreamLength;
@@ -1130,10 +1204,8 @@ void gf_es_receive_sl_packet(GF_ClientService *serv, GF_Channel *ch, char *paylo
 			if (!ch->IsClockInit && !ch->skip_time_check_for_pending) gf_es_check_timing(ch);
 			gf_es_dispatch_au(ch, 0);
 		} else {
-			gf_free(ch->buffer);
-			ch->buffer = NULL;
+			gf_es_pool_release_buffer(ch);
 			ch->AULength = 0;
-			ch->len = ch->allocSize = 0;
 		}
 	}
 
@@ -1392,14 +1464,12 @@ void gf_es_receive_sl_packet(GF_ClientService *serv, GF_Channel *ch, char *paylo
 		assert(!ch->buffer);
 		/*ignore length fields*/
 		size = payload_size + ch->media_padding_bytes;
-		ch->buffer = (char*)gf_malloc(sizeof(char) * size);
+		/*reuse a previously dispatched buffer, the payload overwrites it and padding is zeroed at dispatch time*/
+		ch->buffer = gf_es_pool_get_buffer(ch, size, &ch->allocSize);
 		if (!ch->buffer) {
 			assert(0);
 			return;
 		}
-
-		ch->allocSize = size;
-		memset(ch->buffer, 0, sizeof(char) * size);
 		ch->len = 0;
 	}
 	if (!ch->esd->slConfig->usePaddingFlag) hdr.paddingFlag = 0;
@@ -1453,11 +1523,13 @@ void gf_es_receive_sl_packet(GF_ClientService *serv, GF_Channel *ch, char *paylo
 	} else {
 		/*check if enough space*/
 		size = ch->allocSize;
-		if (size && (payload_size + ch->len <= size)) {
+		if (size && (payload_size + ch->len + ch->media_padding_bytes <= size)) {
 			memcpy(ch->buffer+ch->len, payload, payload_size);
 			ch->len += payload_size;
 		} else {
 			size = payload_size + ch->len + ch->media_padding_bytes;
+			/*grow geometrically for AUs spread over many packets*/
+			if (size < 2*ch->allocSize) size = 2*ch->allocSize;
 			ch->buffer = (char*)gf_realloc(ch->buffer, sizeof(char) * size);
 			memcpy(ch->buffer+ch->len, payload, payload_size);
 			ch->allocSize = size;
@@ -1702,7 +1774,7 @@ void gf_es_drop_au(GF_Channel *ch)
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_SYNC, ("[ODM%d] ES%d (%s) Droping AU CTS %d\n", ch->odm->OD->objectDescriptorID, ch->esd->ESID, ch->odm->net_service->url, au->CTS));
 
 	au->next = NULL;
-	gf_db_unit_del(au);
+	gf_es_pool_release(ch, au);
 	ch->AU_Count -= 1;
 
 	if (!ch->AU_Count && ch->AU_buffer_first) {
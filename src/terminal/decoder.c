@@ -561,11 +561,16 @@ refetch_AU:
 			assert(baseAU);
 			if ((*activeChannel)->is_pulling && !(baseAU->flags & GF_DB_AU_REAGGREGATED)) {
 				char *base_au = baseAU->data;
-				baseAU->data = gf_malloc(baseAU->dataLength + AU->dataLength);
+				baseAU->allocSize = baseAU->dataLength + AU->dataLength;
+				baseAU->data = gf_malloc(baseAU->allocSize);
 				memcpy(baseAU->data, base_au, baseAU->dataLength);
 				memcpy(baseAU->data + baseAU->dataLength , AU->data, AU->dataLength);
 			} else {
-				baseAU->data = gf_realloc(baseAU->data, baseAU->dataLength + AU->dataLength);
+				/*push mode buffers may be larger than their data, since they are recycled by the channel*/
+				if (baseAU->allocSize < baseAU->dataLength + AU->dataLength) {
+					baseAU->allocSize = baseAU->dataLength + AU->dataLength;
+					baseAU->data = gf_realloc(baseAU->data, baseAU->allocSize);
+				}
 				memcpy(baseAU->data + baseAU->dataLength , AU->data, AU->dataLength);
 			}
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_CODEC, ("[%s] ODM%d#CH%d (%s) AU DTS %u CTS %u size %d reaggregated on base layer %d - base DTS %d size %d\n", codec->decio->module_name, codec->odm->OD->objectDescriptorID, ch->esd->ESID, ch->odm->net_service->url, AU->DTS, AU->CTS, AU->dataLength, (*activeChannel)->esd->ESID, baseAU->DTS, baseAU->dataLength));
@@ -65,6 +65,8 @@ typedef struct _decoding_buffer
 
 	u32 dataLength;
 	char *data;
+	/*allocated size of data, only used for push mode buffers recycled by the channel*/
+	u32 allocSize;
 } GF_DBUnit;
 
 GF_DBUnit *gf_db_unit_new();
@@ -247,6 +247,7 @@ GF_Err gf_term_get_object_info(GF_Terminal *term, GF_ObjectManager *odm, GF_Medi
 
 	info->buffer = -2;
 	info->db_unit_count = 0;
+	info->db_pool_count = info->db_pool_size = 0;
 
 	/*Warning: is_open==2 means object setup, don't check then*/
 	if (odm->state==GF_ODM_STATE_IN_SETUP) {
@@ -273,6 +274,8 @@ GF_Err gf_term_get_object_info(GF_Terminal *term, GF_ObjectManager *odm, GF_Medi
 			i=0;
 			while ((ch = (GF_Channel*)gf_list_enum(odm->channels, &i))) {
 				info->db_unit_count += ch->AU_Count;
+				info->db_pool_count += ch->AU_pool_count;
+				info->db_pool_size += ch->AU_pool_bytes;
 				if (!ch->is_pulling || ch->MaxBuffer) {
 					if (ch->MaxBuffer) info->buffer = 0;
 					buf += ch->BufferTime;
@@ -188,8 +188,9 @@ static void bs_flush_cache(GF_BitStream *bs)
 {
 	if (bs->buffer_written) {
 		u32 nb_write = (u32) fwrite(bs->buffer_io, 1, bs->buffer_written, bs->stream);
-		bs->size += nb_write;
 		bs->position += nb_write;
+		/*the cache may have been written over existing data*/
+		if (bs->position > bs->size) bs->size = bs->position;
 		bs->buffer_written = 0;
 	}
 }
@@ -223,8 +224,10 @@ void gf_bs_del(GF_BitStream *bs)
 	if (!bs) return;
 	/*if we are in dynamic mode (alloc done by the bitstream), free the buffer if still present*/
 	if ((bs->bsmode == GF_BITSTREAM_WRITE_DYN) && bs->original) gf_free(bs->original);
-	if (bs->buffer_io)
+	if (bs->buffer_io) {
 		bs_flush_cache(bs);
+		gf_free(bs->buffer_io);
+	}
 	gf_free(bs);
 }
 
@@ -756,6 +759,19 @@ u32 gf_bs_write_data(GF_BitStream *bs, const char *data, u32 nbBytes)
 		}
 	}
 
+	/*unaligned write: shift whole bytes through the pending bits rather than writing bit by bit*/
+	if ((bs->bsmode == GF_BITSTREAM_WRITE) || (bs->bsmode == GF_BITSTREAM_WRITE_DYN) || (bs->bsmode == GF_BITSTREAM_FILE_WRITE)) {
+		u32 nb_pending = bs->nbBits;
+		while (nbBytes) {
+			u8 val = (u8) *data;
+			BS_WriteByte(bs, (u8) ((bs->current << (8 - nb_pending)) | (val >> nb_pending)) );
+			bs->current = val & ((1 << nb_pending) - 1);
+			data++;
+			nbBytes--;
+		}
+		return (u32) (bs->position - begin);
+	}
+
 	while (nbBytes) {
 		gf_bs_write_int(bs, (s32) *data, 8);
 		data++;
@@ -976,6 +992,9 @@ static GF_Err BS_SeekIntern(GF_BitStream *bs, u64 offset)
 GF_EXPORT
 GF_Err gf_bs_seek(GF_BitStream *bs, u64 offset)
 {
+	/*write-behind data counts in the size*/
+	if (bs->buffer_io)
+		bs_flush_cache(bs);
 	/*warning: we allow offset = bs->size for WRITE buffers*/
 	if (offset > bs->size) return GF_BAD_PARAM;
 
@@ -1033,8 +1052,10 @@ u64 gf_bs_get_refreshed_size(GF_BitStream *bs)
 GF_EXPORT
 u64 gf_bs_get_size(GF_BitStream *bs)
 {
-	if (bs->buffer_io)
-		return bs->size + bs->buffer_written;
+	if (bs->buffer_io) {
+		if (bs->position + bs->buffer_written > bs->size)
+			return bs->position + bs->buffer_written;
+	}
 	return bs->size;
 }
 
@@ -28,16 +28,34 @@
 
 #define MAX_INI_LINE			2046
 
-typedef struct
+/*initial number of hash buckets for sections and keys, doubled when the number of entries exceeds it*/
+#define INI_HASH_MIN_SIZE		16
+
+/*in journal mode, the file is rewritten once the appended changes exceed the size of the last full write, or this size*/
+#define INI_JOURNAL_MIN_SIZE	65536
+
+typedef struct __ini_key
 {
 	char *name;
 	char *value;
+	u32 hash;
+	struct __ini_key *next;
+	/*modified since last save, for journal mode*/
+	Bool dirty;
 } IniKey;
 
-typedef struct
+typedef struct __ini_section
 {
 	char *section_name;
 	GF_List *keys;
+	u32 hash;
+	struct __ini_section *next;
+	/*keys hashed by name, ordering is given by the keys list*/
+	IniKey **buckets;
+	u32 nb_buckets;
+	/*journal mode: section created or keys removed since last save*/
+	Bool dirty;
+	GF_List *removed_keys;
 } IniSection;
 
 struct __tag_config
@@ -45,8 +63,175 @@ struct __tag_config
 	char *fileName;
 	GF_List *sections;
 	Bool hasChanged, skip_changes;
+	/*sections hashed by name, ordering is given by the sections list*/
+	IniSection **buckets;
+	u32 nb_buckets;
+	/*journal mode: changes are appended to the file, which is compacted (rewritten) when the appended size
+	exceeds the size of the last full write*/
+	Bool journal, needs_rewrite;
+	u64 compact_size, journal_size;
 };
 
+static GFINLINE u32 ini_hash(const char *name)
+{
+	u32 h = 2166136261U;
+	while (*name) {
+		h ^= (u8) *name;
+		h *= 16777619U;
+		name++;
+	}
+	return h;
+}
+
+static IniSection *ini_find_section(GF_Config *iniFile, const char *secName)
+{
+	u32 h;
+	IniSection *sec;
+	if (!iniFile->nb_buckets) return NULL;
+	h = ini_hash(secName);
+	sec = iniFile->buckets[h & (iniFile->nb_buckets-1)];
+	while (sec) {
+		if ((sec->hash == h) && !strcmp(sec->section_name, secName)) return sec;
+		sec = sec->next;
+	}
+	return NULL;
+}
+
+static IniKey *ini_find_key(IniSection *sec, const char *keyName)
+{
+	u32 h;
+	IniKey *key;
+	if (!sec->nb_buckets) return NULL;
+	h = ini_hash(keyName);
+	key = sec->buckets[h & (sec->nb_buckets-1)];
+	while (key) {
+		if ((key->hash == h) && !strcmp(key->name, keyName)) return key;
+		key = key->next;
+	}
+	return NULL;
+}
+
+static void ini_hash_section(GF_Config *iniFile, IniSection *sec)
+{
+	u32 pos;
+	if (gf_list_count(iniFile->sections) > iniFile->nb_buckets) {
+		u32 i, count = gf_list_count(iniFile->sections);
+		iniFile->nb_buckets = iniFile->nb_buckets ? 2*iniFile->nb_buckets : INI_HASH_MIN_SIZE;
+		iniFile->buckets = (IniSection **) gf_realloc(iniFile->buckets, sizeof(IniSection *) * iniFile->nb_buckets);
+		memset(iniFile->buckets, 0, sizeof(IniSection *) * iniFile->nb_buckets);
+		for (i=0; i<count; i++) {
+			IniSection *s = (IniSection *) gf_list_get(iniFile->sections, i);
+			if (s == sec) continue;
+			pos = s->hash & (iniFile->nb_buckets-1);
+			s->next = iniFile->buckets[pos];
+			iniFile->buckets[pos] = s;
+		}
+	}
+	pos = sec->hash & (iniFile->nb_buckets-1);
+	sec->next = iniFile->buckets[pos];
+	iniFile->buckets[pos] = sec;
+}
+
+static void ini_unhash_section(GF_Config *iniFile, IniSection *sec)
+{
+	IniSection **prev = &iniFile->buckets[sec->hash & (iniFile->nb_buckets-1)];
+	while (*prev) {
+		if (*prev == sec) {
+			*prev = sec->next;
+			return;
+		}
+		prev = &(*prev)->next;
+	}
+}
+
+static void ini_hash_key(IniSection *sec, IniKey *key)
+{
+	u32 pos;
+	if (gf_list_count(sec->keys) > sec->nb_buckets) {
+		u32 i, count = gf_list_count(sec->keys);
+		sec->nb_buckets = sec->nb_buckets ? 2*sec->nb_buckets : INI_HASH_MIN_SIZE;
+		sec->buckets = (IniKey **) gf_realloc(sec->buckets, sizeof(IniKey *) * sec->nb_buckets);
+		memset(sec->buckets, 0, sizeof(IniKey *) * sec->nb_buckets);
+		for (i=0; i<count; i++) {
+			IniKey *k = (IniKey *) gf_list_get(sec->keys, i);
+			if (k == key) continue;
+			pos = k->hash & (sec->nb_buckets-1);
+			k->next = sec->buckets[pos];
+			sec->buckets[pos] = k;
+		}
+	}
+	pos = key->hash & (sec->nb_buckets-1);
+	key->next = sec->buckets[pos];
+	sec->buckets[pos] = key;
+}
+
+static void ini_unhash_key(IniSection *sec, IniKey *key)
+{
+	IniKey **prev = &sec->buckets[key->hash & (sec->nb_buckets-1)];
+	while (*prev) {
+		if (*prev == key) {
+			*prev = key->next;
+			return;
+		}
+		prev = &(*prev)->next;
+	}
+}
+
+/*creates a new section at the end of the section list*/
+static IniSection *ini_new_section(GF_Config *iniFile, const char *secName)
+{
+	IniSection *sec;
+	GF_SAFEALLOC(sec, IniSection);
+	if (!sec) return NULL;
+	sec->section_name = gf_strdup(secName);
+	sec->keys = gf_list_new();
+	sec->hash = ini_hash(secName);
+	sec->dirty = GF_TRUE;
+	gf_list_add(iniFile->sections, sec);
+	ini_hash_section(iniFile, sec);
+	return sec;
+}
+
+/*creates a new key at the given position in the section, or at the end if index is -1*/
+static IniKey *ini_new_key(IniSection *sec, const char *keyName, const char *keyValue, s32 index)
+{
+	IniKey *key;
+	GF_SAFEALLOC(key, IniKey);
+	if (!key) return NULL;
+	key->name = gf_strdup(keyName);
+	key->value = gf_strdup(keyValue);
+	key->hash = ini_hash(keyName);
+	key->dirty = GF_TRUE;
+	if (index<0) gf_list_add(sec->keys, key);
+	else gf_list_insert(sec->keys, key, index);
+	ini_hash_key(sec, key);
+	return key;
+}
+
+static void ini_del_key(IniSection *sec, IniKey *key, Bool journal)
+{
+	ini_unhash_key(sec, key);
+	gf_list_del_item(sec->keys, key);
+	if (journal) {
+		if (!sec->removed_keys) sec->removed_keys = gf_list_new();
+		gf_list_add(sec->removed_keys, key->name);
+	} else if (key->name) {
+		gf_free(key->name);
+	}
+	if (key->value) gf_free(key->value);
+	gf_free(key);
+}
+
+static void ini_reset_removed_keys(IniSection *sec)
+{
+	if (!sec->removed_keys) return;
+	while (gf_list_count(sec->removed_keys)) {
+		char *name = (char *) gf_list_pop_back(sec->removed_keys);
+		gf_free(name);
+	}
+	gf_list_del(sec->removed_keys);
+	sec->removed_keys = NULL;
+}
 
 static void DelSection(IniSection *ptr)
 {
@@ -54,14 +239,15 @@ static void DelSection(IniSection *ptr)
 	if (!ptr) return;
 	if (ptr->keys) {
 		while (gf_list_count(ptr->keys)) {
-			k = (IniKey *) gf_list_get(ptr->keys, 0);
+			k = (IniKey *) gf_list_pop_back(ptr->keys);
 			if (k->value) gf_free(k->value);
 			if (k->name) gf_free(k->name);
 			gf_free(k);
-			gf_list_rem(ptr->keys, 0);
 		}
 		gf_list_del(ptr->keys);
 	}
+	ini_reset_removed_keys(ptr);
+	if (ptr->buckets) gf_free(ptr->buckets);
 	if (ptr->section_name) gf_free(ptr->section_name);
 	gf_free(ptr);
 }
@@ -75,12 +261,13 @@ static void gf_cfg_clear(GF_Config * iniFile) {
 	if (!iniFile) return;
 	if (iniFile->sections) {
 		while (gf_list_count(iniFile->sections)) {
-			p = (IniSection *) gf_list_get(iniFile->sections, 0);
+			p = (IniSection *) gf_list_pop_back(iniFile->sections);
 			DelSection(p);
-			gf_list_rem(iniFile->sections, 0);
 		}
 		gf_list_del(iniFile->sections);
 	}
+	if (iniFile->buckets)
+		gf_free(iniFile->buckets);
 	if (iniFile->fileName)
 		gf_free(iniFile->fileName);
 	memset((void *)iniFile, 0, sizeof(GF_Config));
@@ -93,11 +280,17 @@ GF_Err gf_cfg_parse_config_file(GF_Config * tmp, const char * filePath, const ch
 {
 	IniSection *p;
 	IniKey *k;
+	char *name, *value;
+	u32 len;
 	FILE *file;
 	char *ret;
 	char *line;
 	u32 line_alloc = MAX_INI_LINE;
 	char fileName[GF_MAX_PATH];
+	/*size of the lines superseded by later ones (journal mode)*/
+	u64 journal_size = 0, file_size;
+	u32 line_size;
+	Bool in_journal = GF_FALSE;
 
 	gf_cfg_clear(tmp);
 
@@ -133,6 +326,7 @@ GF_Err gf_cfg_parse_config_file(GF_Config * tmp, const char * filePath, const ch
 			nb_pass++;
 		}
 		if (!ret) continue;
+		line_size = read;
 
 		/* get rid of the end of line stuff */
 		while (1) {
@@ -141,49 +335,75 @@ GF_Err gf_cfg_parse_config_file(GF_Config * tmp, const char * filePath, const ch
 			if ((line[len-1] != '\n') && (line[len-1] != '\r')) break;
 			line[len-1] = 0;
 		}
-		if (!strlen(line)) continue;
+		if (!strlen(line)) {
+			if (in_journal) journal_size += line_size;
+			continue;
+		}
 		if (line[0] == '#') continue;
 
 
-		/* new section */
+		/* new section - a section appearing several times (journal mode) is merged with the first one*/
 		if (line[0] == '[') {
-			p = (IniSection *) gf_malloc(sizeof(IniSection));
-			p->keys = gf_list_new();
-			p->section_name = gf_strdup(line + 1);
-			p->section_name[strlen(line) - 2] = 0;
-			while (p->section_name[strlen(p->section_name) - 1] == ']' || p->section_name[strlen(p->section_name) - 1] == ' ') p->section_name[strlen(p->section_name) - 1] = 0;
-			gf_list_add(tmp->sections, p);
+			name = line + 1;
+			len = (u32) strlen(name);
+			while (len && ((name[len-1] == ']') || (name[len-1] == ' '))) len--;
+			name[len] = 0;
+			p = ini_find_section(tmp, name);
+			if (!p) {
+				p = ini_new_section(tmp, name);
+				p->dirty = GF_FALSE;
+				in_journal = GF_FALSE;
+			} else {
+				journal_size += line_size;
+				in_journal = GF_TRUE;
+			}
 		}
-		else if (strlen(line) && (strchr(line, '=') != NULL) ) {
+		else if (strchr(line, '=') != NULL) {
 			if (!p) {
-				gf_list_del(tmp->sections);
-				gf_free(tmp->fileName);
-				gf_free(tmp);
 				gf_fclose(file);
 				gf_free(line);
 				return GF_IO_ERR;
 			}
 
-			k = (IniKey *) gf_malloc(sizeof(IniKey));
-			memset((void *)k, 0, sizeof(IniKey));
 			ret = strchr(line, '=');
-			if (ret) {
-				ret[0] = 0;
-				k->name = gf_strdup(line);
-				while (k->name[strlen(k->name) - 1] == ' ') k->name[strlen(k->name) - 1] = 0;
-				ret[0] = '=';
-				ret += 1;
-				while (ret[0] == ' ') ret++;
-				if ( ret[0] != 0) {
-					k->value = gf_strdup(ret);
-					while (k->value[strlen(k->value) - 1] == ' ') k->value[strlen(k->value) - 1] = 0;
-				} else {
-					k->value = gf_strdup("");
-				}
+			ret[0] = 0;
+			name = line;
+			len = (u32) strlen(name);
+			while (len && (name[len-1] == ' ')) len--;
+			name[len] = 0;
+			value = ret + 1;
+			while (value[0] == ' ') value++;
+			len = (u32) strlen(value);
+			while (len && (value[len-1] == ' ')) len--;
+			value[len] = 0;
+
+			/*a key appearing several times (journal mode) takes the last value*/
+			k = ini_find_key(p, name);
+			if (k) {
+				/*the previous line for this key is superseded*/
+				journal_size += line_size;
+				gf_free(k->value);
+				k->value = gf_strdup(value);
+			} else {
+				k = ini_new_key(p, name, value, -1);
+			}
+			k->dirty = GF_FALSE;
+		}
+		/* key removed (journal mode) */
+		else if ((line[0] == '!') && p) {
+			journal_size += line_size;
+			k = ini_find_key(p, line + 1);
+			if (k) {
+				journal_size += strlen(k->name) + strlen(k->value) + 2;
+				ini_del_key(p, k, GF_FALSE);
 			}
-			gf_list_add(p->keys, k);
 		}
 	}
+	/*the file is the last full write followed by the journal, so that the next save compacts it when needed*/
+	file_size = gf_ftell(file);
+	if (journal_size > file_size) journal_size = file_size;
+	tmp->compact_size = file_size - journal_size;
+	tmp->journal_size = journal_size;
 	gf_free(line);
 	gf_fclose(file);
 	return GF_OK;
@@ -224,38 +444,118 @@ char * gf_cfg_get_filename(GF_Config *iniFile)
 	return iniFile->fileName ? gf_strdup(iniFile->fileName) : NULL;
 }
 
-GF_EXPORT
-GF_Err gf_cfg_save(GF_Config *iniFile)
+/*writes the changed sections and keys at the end of the file*/
+static GF_Err ini_append_changes(GF_Config *iniFile)
 {
 	u32 i, j;
 	IniSection *sec;
 	IniKey *key;
+	char *name;
 	FILE *file;
 
-	if (!iniFile->hasChanged) return GF_OK;
-	if (iniFile->skip_changes) return GF_OK;
-	if (!iniFile->fileName) return GF_OK;
-
-	file = gf_fopen(iniFile->fileName, "wt");
+	file = gf_fopen(iniFile->fileName, "at");
 	if (!file) return GF_IO_ERR;
 
 	i=0;
 	while ( (sec = (IniSection *) gf_list_enum(iniFile->sections, &i)) ) {
+		Bool has_header = GF_FALSE;
 		/*Temporary sections are not saved*/
-		if (!strnicmp(sec->section_name, "Temp", 4)) continue;
+		if (!strnicmp(sec->section_name, "Temp", 4)) {
+			ini_reset_removed_keys(sec);
+			continue;
+		}
 
-		fprintf(file, "[%s]\n", sec->section_name);
+		if (sec->dirty) {
+			fprintf(file, "[%s]\n", sec->section_name);
+			has_header = GF_TRUE;
+		}
+		/*removals first, a key may have been removed then added again*/
+		j=0;
+		while (sec->removed_keys && (name = (char *) gf_list_enum(sec->removed_keys, &j)) ) {
+			if (!has_header) fprintf(file, "[%s]\n", sec->section_name);
+			has_header = GF_TRUE;
+			fprintf(file, "!%s\n", name);
+		}
 		j=0;
 		while ( (key = (IniKey *) gf_list_enum(sec->keys, &j)) ) {
+			if (!key->dirty) continue;
+			if (!has_header) fprintf(file, "[%s]\n", sec->section_name);
+			has_header = GF_TRUE;
 			fprintf(file, "%s=%s\n", key->name, key->value);
 		}
-		/* end of section */
-		fprintf(file, "\n");
+		if (has_header) fprintf(file, "\n");
 	}
+	iniFile->journal_size = gf_ftell(file) - iniFile->compact_size;
 	gf_fclose(file);
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_cfg_save(GF_Config *iniFile)
+{
+	u32 i, j;
+	IniSection *sec;
+	IniKey *key;
+	FILE *file;
+	GF_Err e = GF_OK;
+
+	if (!iniFile->hasChanged) return GF_OK;
+	if (iniFile->skip_changes) return GF_OK;
+	if (!iniFile->fileName) return GF_OK;
+
+	if (iniFile->journal && !iniFile->needs_rewrite && iniFile->compact_size
+	        && (iniFile->journal_size < MAX(iniFile->compact_size, INI_JOURNAL_MIN_SIZE))
+	        && gf_file_exists(iniFile->fileName)) {
+		e = ini_append_changes(iniFile);
+	} else {
+		file = gf_fopen(iniFile->fileName, "wt");
+		if (!file) return GF_IO_ERR;
+
+		i=0;
+		while ( (sec = (IniSection *) gf_list_enum(iniFile->sections, &i)) ) {
+			/*Temporary sections are not saved*/
+			if (!strnicmp(sec->section_name, "Temp", 4)) continue;
+
+			fprintf(file, "[%s]\n", sec->section_name);
+			j=0;
+			while ( (key = (IniKey *) gf_list_enum(sec->keys, &j)) ) {
+				fprintf(file, "%s=%s\n", key->name, key->value);
+			}
+			/* end of section */
+			fprintf(file, "\n");
+		}
+		iniFile->compact_size = gf_ftell(file);
+		iniFile->journal_size = 0;
+		iniFile->needs_rewrite = GF_FALSE;
+		gf_fclose(file);
+	}
+
+	/*everything is on disk, reset change tracking*/
+	if (iniFile->journal) {
+		i=0;
+		while ( (sec = (IniSection *) gf_list_enum(iniFile->sections, &i)) ) {
+			sec->dirty = GF_FALSE;
+			ini_reset_removed_keys(sec);
+			j=0;
+			while ( (key = (IniKey *) gf_list_enum(sec->keys, &j)) ) {
+				key->dirty = GF_FALSE;
+			}
+		}
+	}
+	return e;
+}
+
+GF_EXPORT
+GF_Err gf_cfg_set_journal_mode(GF_Config *iniFile, Bool journal_on)
+{
+	if (!iniFile) return GF_BAD_PARAM;
+	if (iniFile->journal == journal_on) return GF_OK;
+	iniFile->journal = journal_on;
+	/*changes made before switching to journal mode were not tracked*/
+	if (iniFile->hasChanged) iniFile->needs_rewrite = GF_TRUE;
+	return GF_OK;
+}
+
 GF_EXPORT
 GF_Err gf_cfg_discard_changes(GF_Config *iniFile)
 {
@@ -286,22 +586,11 @@ void gf_cfg_remove(GF_Config *iniFile)
 GF_EXPORT
 const char *gf_cfg_get_key(GF_Config *iniFile, const char *secName, const char *keyName)
 {
-	u32 i;
-	IniSection *sec;
 	IniKey *key;
-
-	i=0;
-	while ( (sec = (IniSection *) gf_list_enum(iniFile->sections, &i)) ) {
-		if (!strcmp(secName, sec->section_name)) goto get_key;
-	}
-	return NULL;
-
-get_key:
-	i=0;
-	while ( (key = (IniKey *) gf_list_enum(sec->keys, &i)) ) {
-		if (!strcmp(key->name, keyName)) return key->value;
-	}
-	return NULL;
+	IniSection *sec = ini_find_section(iniFile, secName);
+	if (!sec) return NULL;
+	key = ini_find_key(sec, keyName);
+	return key ? key->value : NULL;
 }
 
 GF_EXPORT
@@ -329,7 +618,6 @@ get_key:
 GF_EXPORT
 GF_Err gf_cfg_set_key(GF_Config *iniFile, const char *secName, const char *keyName, const char *keyValue)
 {
-	u32 i;
 	Bool has_changed = GF_TRUE;
 	IniSection *sec;
 	IniKey *key;
@@ -338,36 +626,26 @@ GF_Err gf_cfg_set_key(GF_Config *iniFile, const char *secName, const char *keyNa
 
 	if (!strnicmp(secName, "temp", 4)) has_changed = GF_FALSE;
 
-	i=0;
-	while ((sec = (IniSection *) gf_list_enum(iniFile->sections, &i)) ) {
-		if (!strcmp(secName, sec->section_name)) goto get_key;
+	sec = ini_find_section(iniFile, secName);
+	if (!sec) {
+		/* need a new section */
+		sec = ini_new_section(iniFile, secName);
+		if (!sec) return GF_OUT_OF_MEM;
+		if (has_changed) iniFile->hasChanged = GF_TRUE;
 	}
-	/* need a new key */
-	sec = (IniSection *) gf_malloc(sizeof(IniSection));
-	sec->section_name = gf_strdup(secName);
-	sec->keys = gf_list_new();
-	if (has_changed) iniFile->hasChanged = GF_TRUE;
-	gf_list_add(iniFile->sections, sec);
 
-get_key:
-	i=0;
-	while ( (key = (IniKey *) gf_list_enum(sec->keys, &i) ) ) {
-		if (!strcmp(key->name, keyName)) goto set_value;
+	key = ini_find_key(sec, keyName);
+	if (!key) {
+		if (!keyValue) return GF_OK;
+		/* need a new key */
+		key = ini_new_key(sec, keyName, keyValue, -1);
+		if (!key) return GF_OUT_OF_MEM;
+		if (has_changed) iniFile->hasChanged = GF_TRUE;
+		return GF_OK;
 	}
-	if (!keyValue) return GF_OK;
-	/* need a new key */
-	key = (IniKey *) gf_malloc(sizeof(IniKey));
-	key->name = gf_strdup(keyName);
-	key->value = gf_strdup("");
-	if (has_changed) iniFile->hasChanged = GF_TRUE;
-	gf_list_add(sec->keys, key);
 
-set_value:
 	if (!keyValue) {
-		gf_list_del_item(sec->keys, key);
-		if (key->name) gf_free(key->name);
-		if (key->value) gf_free(key->value);
-		gf_free(key);
+		ini_del_key(sec, key, iniFile->journal);
 		if (has_changed) iniFile->hasChanged = GF_TRUE;
 		return GF_OK;
 	}
@@ -376,6 +654,7 @@ set_value:
 
 	if (key->value) gf_free(key->value);
 	key->value = gf_strdup(keyValue);
+	key->dirty = GF_TRUE;
 	if (has_changed) iniFile->hasChanged = GF_TRUE;
 	return GF_OK;
 }
@@ -397,71 +676,51 @@ const char *gf_cfg_get_section_name(GF_Config *iniFile, u32 secIndex)
 GF_EXPORT
 u32 gf_cfg_get_key_count(GF_Config *iniFile, const char *secName)
 {
-	u32 i = 0;
-	IniSection *sec;
-	while ( (sec = (IniSection *) gf_list_enum(iniFile->sections, &i)) ) {
-		if (!strcmp(secName, sec->section_name)) return gf_list_count(sec->keys);
-	}
-	return 0;
+	IniSection *sec = ini_find_section(iniFile, secName);
+	return sec ? gf_list_count(sec->keys) : 0;
 }
 
 GF_EXPORT
 const char *gf_cfg_get_key_name(GF_Config *iniFile, const char *secName, u32 keyIndex)
 {
-	u32 i = 0;
-	IniSection *sec;
-	while ( (sec = (IniSection *) gf_list_enum(iniFile->sections, &i) ) ) {
-		if (!strcmp(secName, sec->section_name)) {
-			IniKey *key = (IniKey *) gf_list_get(sec->keys, keyIndex);
-			return key ? key->name : NULL;
-		}
-	}
-	return NULL;
+	IniKey *key;
+	IniSection *sec = ini_find_section(iniFile, secName);
+	if (!sec) return NULL;
+	key = (IniKey *) gf_list_get(sec->keys, keyIndex);
+	return key ? key->name : NULL;
 }
 
 GF_EXPORT
 void gf_cfg_del_section(GF_Config *iniFile, const char *secName)
 {
-	u32 i;
 	IniSection *p;
 	if (!iniFile) return;
 
-	i = 0;
-	while ((p = (IniSection*)gf_list_enum(iniFile->sections, &i))) {
-		if (!strcmp(secName, p->section_name)) {
-			DelSection(p);
-			gf_list_rem(iniFile->sections, i-1);
-			iniFile->hasChanged = GF_TRUE;
-			return;
-		}
-	}
+	p = ini_find_section(iniFile, secName);
+	if (!p) return;
+	ini_unhash_section(iniFile, p);
+	gf_list_del_item(iniFile->sections, p);
+	DelSection(p);
+	iniFile->hasChanged = GF_TRUE;
+	/*section removal cannot be journaled*/
+	iniFile->needs_rewrite = GF_TRUE;
 }
 
 GF_EXPORT
 GF_Err gf_cfg_insert_key(GF_Config *iniFile, const char *secName, const char *keyName, const char *keyValue, u32 index)
 {
-	u32 i;
 	IniSection *sec;
-	IniKey *key;
 
 	if (!iniFile || !secName || !keyName|| !keyValue) return GF_BAD_PARAM;
 
-	i=0;
-	while ( (sec = (IniSection *) gf_list_enum(iniFile->sections, &i) ) ) {
-		if (!strcmp(secName, sec->section_name)) break;
-	}
+	sec = ini_find_section(iniFile, secName);
 	if (!sec) return GF_BAD_PARAM;
+	if (ini_find_key(sec, keyName)) return GF_BAD_PARAM;
 
-	i=0;
-	while ( (key = (IniKey *) gf_list_enum(sec->keys, &i) ) ) {
-		if (!strcmp(key->name, keyName)) return GF_BAD_PARAM;
-	}
-
-	key = (IniKey *) gf_malloc(sizeof(IniKey));
-	key->name = gf_strdup(keyName);
-	key->value = gf_strdup(keyValue);
-	gf_list_insert(sec->keys, key, index);
+	if (!ini_new_key(sec, keyName, keyValue, (s32) index)) return GF_OUT_OF_MEM;
 	iniFile->hasChanged = GF_TRUE;
+	/*key order cannot be journaled*/
+	iniFile->needs_rewrite = GF_TRUE;
 	return GF_OK;
 }
 
@@ -499,5 +758,7 @@ GF_Err gf_cfg_set_filename(GF_Config *iniFile, const char * fileName)
 	if (!fileName) return GF_OK;
 	if (iniFile->fileName) gf_free(iniFile->fileName);
 	iniFile->fileName = gf_strdup(fileName);
+	/*the new file does not hold the journaled state*/
+	iniFile->needs_rewrite = GF_TRUE;
 	return iniFile->fileName ? GF_OK : GF_OUT_OF_MEM;
 }
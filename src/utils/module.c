@@ -276,6 +276,45 @@ Bool gf_module_is_loaded(GF_ModuleManager *pm, char *filename)
 	return GF_FALSE;
 }
 
+/*PluginsCache entries of dynamic modules start with the size and modification time of the module file, so that
+interfaces are queried again (and invalid modules retried) when the module file is replaced*/
+static void gf_modules_get_cache_sig(ModuleInstance *inst, char *szSig)
+{
+	szSig[0] = 0;
+	if (inst->ifce_reg) return;
+	sprintf(szSig, "file:"LLU"-"LLU, inst->file_size, inst->last_modified);
+}
+
+void gf_modules_check_cache(ModuleInstance *inst)
+{
+	char szSig[64];
+	u32 len;
+	const char *opt = gf_cfg_get_key(inst->plugman->cfg, "PluginsCache", inst->name);
+	if (!opt) return;
+
+	gf_modules_get_cache_sig(inst, szSig);
+	len = (u32) strlen(szSig);
+	if (!strncmp(opt, szSig, len) && ((opt[len]==' ') || !opt[len])) return;
+
+	GF_LOG(GF_LOG_INFO, GF_LOG_CORE, ("[Core] Module %s has changed since its interfaces were cached, refreshing\n", inst->name));
+	gf_cfg_set_key(inst->plugman->cfg, "PluginsCache", inst->name, NULL);
+}
+
+static void gf_modules_set_cache(ModuleInstance *inst, const char *value)
+{
+	char szSig[64];
+	char *entry;
+	gf_modules_get_cache_sig(inst, szSig);
+	if (!szSig[0]) {
+		gf_cfg_set_key(inst->plugman->cfg, "PluginsCache", inst->name, value);
+		return;
+	}
+	entry = (char*)gf_malloc(sizeof(char) * (strlen(szSig) + strlen(value) + 2));
+	sprintf(entry, "%s %s", szSig, value);
+	gf_cfg_set_key(inst->plugman->cfg, "PluginsCache", inst->name, entry);
+	gf_free(entry);
+}
+
 GF_EXPORT
 u32 gf_modules_get_count(GF_ModuleManager *pm)
 {
@@ -362,13 +401,13 @@ GF_BaseInterface *gf_modules_load_interface(GF_ModuleManager *pm, u32 whichplug,
 	}
 	if (!gf_modules_load_library(inst)) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_CORE, ("[Core] Cannot load library %s\n", inst->name));
-		gf_cfg_set_key(pm->cfg, "PluginsCache", inst->name, "Invalid Plugin");
+		gf_modules_set_cache(inst, "Invalid Plugin");
 		gf_mx_v(pm->mutex);
 		return NULL;
 	}
 	if (!inst->query_func) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_CORE, ("[Core] Library %s missing GPAC export symbols\n", inst->name));
-		gf_cfg_set_key(pm->cfg, "PluginsCache", inst->name, "Invalid Plugin");
+		gf_modules_set_cache(inst, "Invalid Plugin");
 		goto err_exit;
 	}
 
@@ -381,13 +420,13 @@ GF_BaseInterface *gf_modules_load_interface(GF_ModuleManager *pm, u32 whichplug,
 		const u32 *si = inst->query_func();
 		if (!si) {
 			GF_LOG(GF_LOG_WARNING, GF_LOG_CORE, ("[Core] GPAC module %s has no supported interfaces - disabling\n", inst->name));
-			gf_cfg_set_key(pm->cfg, "PluginsCache", inst->name, "Invalid Plugin");
+			gf_modules_set_cache(inst, "Invalid Plugin");
 			goto err_exit;
 		}
 		i=0;
 		while (si[i]) i++;
 
-		key = (char*)gf_malloc(sizeof(char) * maxKeySize * i);
+		key = (char*)gf_malloc(sizeof(char) * (maxKeySize * i + 1));
 		key[0] = 0;
 		i=0;
 		while (si[i]) {
@@ -396,7 +435,7 @@ GF_BaseInterface *gf_modules_load_interface(GF_ModuleManager *pm, u32 whichplug,
 			if (InterfaceFamily==si[i]) found = GF_TRUE;
 			i++;
 		}
-		gf_cfg_set_key(pm->cfg, "PluginsCache", inst->name, key);
+		gf_modules_set_cache(inst, key);
 		gf_free(key);
 		if (!found) goto err_exit;
 	}
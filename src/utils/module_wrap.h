@@ -53,6 +53,8 @@ typedef struct
 	LoadInterface load_func;
 	ShutdownInterface destroy_func;
 	char* dir;
+	/*size and modification time of the module file, used to validate its PluginsCache entry*/
+	u64 file_size, last_modified;
 } ModuleInstance;
 
 
@@ -80,6 +82,8 @@ extern "C" {
 
 /*returns 1 if a module with the same filename is already loaded*/
 Bool gf_module_is_loaded(GF_ModuleManager *pm, char *filename);
+/*removes the PluginsCache entry of the module if it was built for another version of the module file*/
+void gf_modules_check_cache(ModuleInstance *inst);
 
 /*these are OS specific*/
 void gf_modules_free_module(ModuleInstance *inst);
@@ -25,6 +25,7 @@
 
 #include <gpac/tools.h>
 #include <gpac/network.h>
+#include <gpac/internal/isomedia_dev.h>
 
 #if defined(_WIN32_WCE)
 
@@ -809,6 +810,11 @@ void gf_sys_init(GF_MemTrackerType mem_tracker_type)
 #ifndef _WIN32_WCE
 		setlocale( LC_NUMERIC, "C" );
 #endif
+
+#ifndef GPAC_DISABLE_ISOM
+		/*done before any thread is created, box lookups only read the index*/
+		gf_isom_registry_init();
+#endif
 	}
 	sys_init += 1;
 
@@ -261,6 +261,9 @@ static Bool enum_modules(void *cbck, char *item_name, char *item_path, GF_FileEn
 	inst->name = gf_strdup(item_name);
 	inst->dir = gf_strdup(item_path);
 	gf_url_get_resource_path(item_path, inst->dir);
+	inst->file_size = file_info->size;
+	inst->last_modified = file_info->last_modified;
+	gf_modules_check_cache(inst);
 	GF_LOG(GF_LOG_INFO, GF_LOG_CORE, ("[Core] Added module %s.\n", inst->name));
 	gf_list_add(pm->plug_list, inst);
 	return GF_FALSE;
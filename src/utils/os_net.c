@@ -25,6 +25,11 @@
 
 #ifndef GPAC_DISABLE_CORE_TOOLS
 
+/*for sendmmsg*/
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #if defined(WIN32) || defined(_WIN32_WCE)
 
 #define _WINSOCK_DEPRECATED_NO_WARNINGS
@@ -129,6 +134,10 @@ static int wsa_init = 0;
 typedef s32 SOCKET;
 #define closesocket(v) close(v)
 
+#if defined(__linux__) && defined(__USE_GNU) && !defined(GPAC_ANDROID)
+#define GPAC_HAS_SENDMMSG
+#endif
+
 #endif /*WIN32||_WIN32_WCE*/
 
 
@@ -921,6 +930,65 @@ GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length)
 }
 
 
+GF_EXPORT
+GF_Err gf_sk_send_multi(GF_Socket *sock, char **buffers, u32 *lengths, u32 nb_buffers)
+{
+	u32 i;
+	GF_Err e;
+#ifdef GPAC_HAS_SENDMMSG
+	struct mmsghdr msgs[GF_SK_SEND_MULTI_MAX];
+	struct iovec iovs[GF_SK_SEND_MULTI_MAX];
+#endif
+
+	if (!sock || !sock->socket) return GF_BAD_PARAM;
+	if (!nb_buffers) return GF_OK;
+
+#ifdef GPAC_HAS_SENDMMSG
+	/*datagram sockets only, TCP goes through the regular path to handle partial writes*/
+	if (!(sock->flags & GF_SOCK_IS_TCP)) {
+		while (nb_buffers) {
+			s32 res;
+			u32 nb_msg = MIN(nb_buffers, GF_SK_SEND_MULTI_MAX);
+			memset(msgs, 0, sizeof(struct mmsghdr)*nb_msg);
+			for (i=0; i<nb_msg; i++) {
+				iovs[i].iov_base = buffers[i];
+				iovs[i].iov_len = lengths[i];
+				msgs[i].msg_hdr.msg_iov = &iovs[i];
+				msgs[i].msg_hdr.msg_iovlen = 1;
+				if (sock->flags & GF_SOCK_HAS_PEER) {
+					msgs[i].msg_hdr.msg_name = &sock->dest_addr;
+					msgs[i].msg_hdr.msg_namelen = sock->dest_addr_len;
+				}
+			}
+			res = sendmmsg(sock->socket, msgs, nb_msg, 0);
+			if (res == SOCKET_ERROR) {
+				switch (LASTSOCKERROR) {
+				case EAGAIN:
+					return GF_IP_SOCK_WOULD_BLOCK;
+				case ENOTCONN:
+				case ECONNRESET:
+					return GF_IP_CONNECTION_CLOSED;
+				default:
+					return GF_IP_NETWORK_FAILURE;
+				}
+			}
+			/*partial send (socket buffer full), resume from the first datagram not sent*/
+			buffers += res;
+			lengths += res;
+			nb_buffers -= res;
+		}
+		return GF_OK;
+	}
+#endif
+
+	for (i=0; i<nb_buffers; i++) {
+		e = gf_sk_send(sock, buffers[i], lengths[i]);
+		if (e) return e;
+	}
+	return GF_OK;
+}
+
+
 GF_EXPORT
 u32 gf_sk_is_multicast_address(const char *multi_IPAdd)
 {